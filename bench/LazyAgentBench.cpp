@@ -0,0 +1,146 @@
+// 延迟构造智能体内存基准
+//
+// 登记大量智能体，每个真实智能体持有一块已触碰的上下文缓冲区，只向其中一部分派发任务，
+// 比较立即构造（eager）与延迟构造（lazy）下的峰值与当前常驻内存；lazy 模式最后
+// 休眠全部智能体，再报告一次常驻内存。
+//
+// 用法: OpenClaw-CPP-LazyAgentBench [--key=value ...]
+//   --agents=500        登记的智能体数
+//   --mode=lazy         eager 或 lazy
+//   --active=50         收到任务的智能体数
+//   --context-kb=1024   每个智能体的上下文缓冲区大小（KB）
+
+#include "agent/AgentManager.h"
+#include "events/EventDispatcher.h"
+#include "logging/Logger.h"
+#include "task/Task.h"
+#include "../tests/support/TestAgent.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace openclaw;
+
+namespace {
+
+struct BenchOptions {
+    size_t agents{500};
+    bool lazy{true};
+    size_t active{50};
+    size_t contextKb{1024};
+};
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        try {
+            if (key == "agents") options.agents = std::max<size_t>(1, std::stoul(value));
+            else if (key == "active") options.active = std::stoul(value);
+            else if (key == "context-kb") options.contextKb = std::stoul(value);
+            else if (key == "mode") {
+                if (value != "eager" && value != "lazy") {
+                    std::cerr << "未知模式: " << value << std::endl;
+                    return false;
+                }
+                options.lazy = value == "lazy";
+            } else {
+                std::cerr << "未知参数: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数值无效: " << arg << std::endl;
+            return false;
+        }
+    }
+    options.active = std::min(options.active, options.agents);
+    return true;
+}
+
+size_t contextBytes = 0;
+
+// 模拟持有会话上下文的智能体：构造时分配并触碰缓冲区，使其真正计入常驻内存
+class ContextAgent : public TestAgent {
+public:
+    explicit ContextAgent(const AgentConfig& config) : TestAgent(config), context_(contextBytes) {
+        std::memset(context_.data(), 1, context_.size());
+    }
+
+private:
+    std::vector<char> context_;
+};
+
+// 读取 /proc/self/status 中的内存字段（KB），不可用时返回 0
+size_t readStatusKb(const std::string& field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind(field + ":", 0) == 0) {
+            return std::stoul(line.substr(field.size() + 1));
+        }
+    }
+    return 0;
+}
+
+void report(const std::string& label) {
+    std::cout << label << ": VmHWM " << readStatusKb("VmHWM") / 1024 << " MB, VmRSS "
+              << readStatusKb("VmRSS") / 1024 << " MB" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    Logger::getInstance().setFileOutputEnabled(false);
+    Logger::getInstance().setLogLevel(LogLevel::ERROR);
+    EventDispatcher::getInstance().setEventDispatchEnabled(false);
+    contextBytes = options.contextKb * 1024;
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<ContextAgent>(config); });
+
+    AgentManager manager;
+    for (size_t i = 0; i < options.agents; ++i) {
+        AgentConfig config;
+        config.id = "agent-" + std::to_string(i);
+        config.name = config.id;
+        config.type = AgentType::DEVELOPER;
+        config.lazy = options.lazy;
+        manager.createAgent(config);
+    }
+    manager.startAllAgents();
+
+    TaskConfig taskConfig;
+    taskConfig.id = "bench-task";
+    taskConfig.name = "bench-task";
+    taskConfig.type = TaskType::DEVELOPMENT;
+    Task task(taskConfig);
+    for (size_t i = 0; i < options.active; ++i) {
+        manager.getAgent("agent-" + std::to_string(i))->executeTask(task);
+    }
+
+    std::cout << "模式: " << (options.lazy ? "lazy" : "eager") << ", 智能体: " << options.agents
+              << ", 活跃: " << options.active << ", 上下文: " << options.contextKb << " KB" << std::endl;
+    report("派发后");
+
+    if (options.lazy) {
+        size_t hibernated = manager.hibernateIdleAgents(std::chrono::milliseconds(0));
+        report("休眠 " + std::to_string(hibernated) + " 个后");
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+// 群聊提及路由基准
+//
+// 为若干智能体各生成几个提及模式，构造带少量提及的聊天消息，比较 MentionRouter 的
+// Aho-Corasick 自动机与逐个模式查找（消息转小写后对每个模式 std::string::find）的吞吐。
+//
+// 用法: OpenClaw-CPP-MentionBench [--key=value ...]
+//   --agents=200      智能体数
+//   --patterns=3      每个智能体的模式数
+//   --messages=20000  消息数
+//   --length=240      每条消息的平均字节数
+
+#include "communication/MentionRouter.h"
+#include "logging/Logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace openclaw;
+
+namespace {
+
+struct BenchOptions {
+    size_t agents{200};
+    size_t patterns{3};
+    size_t messages{20000};
+    size_t length{240};
+};
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        try {
+            if (key == "agents") options.agents = std::max<size_t>(1, std::stoul(value));
+            else if (key == "patterns") options.patterns = std::max<size_t>(1, std::stoul(value));
+            else if (key == "messages") options.messages = std::max<size_t>(1, std::stoul(value));
+            else if (key == "length") options.length = std::max<size_t>(16, std::stoul(value));
+            else {
+                std::cerr << "未知参数: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数值无效: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-';
+}
+
+// 对照实现：每个模式单独查找
+size_t routeNaive(const std::vector<std::pair<std::string, std::string>>& patterns, const std::string& message) {
+    std::string lower = message;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    size_t hits = 0;
+    for (const auto& pattern : patterns) {
+        for (size_t pos = lower.find(pattern.second); pos != std::string::npos;
+             pos = lower.find(pattern.second, pos + 1)) {
+            size_t end = pos + pattern.second.size();
+            if ((pos == 0 || !isIdentifierChar(lower[pos - 1])) && (end == lower.size() || !isIdentifierChar(lower[end]))) {
+                hits++;
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    Logger::getInstance().setFileOutputEnabled(false);
+
+    static const char* const kRoles[] = {"coder", "reviewer", "project-manager", "tester", "architect", "ops"};
+    std::unordered_map<std::string, std::vector<std::string>> patterns;
+    std::vector<std::pair<std::string, std::string>> flat;
+    for (size_t a = 0; a < options.agents; ++a) {
+        std::string agentId = std::string(kRoles[a % 6]) + "-" + std::to_string(a);
+        for (size_t p = 0; p < options.patterns; ++p) {
+            std::string pattern = p == 0 ? "@" + agentId : "@" + agentId + "-alias" + std::to_string(p);
+            patterns[agentId].push_back(pattern);
+            flat.emplace_back(agentId, pattern);
+        }
+    }
+
+    std::mt19937 rng(7);
+    static const char* const kWords[] = {"please", "review", "the", "latest", "build", "and", "check", "tests",
+                                         "deploy", "when", "ready", "thanks", "@", "email@example.com"};
+    std::vector<std::string> messages;
+    size_t totalBytes = 0;
+    for (size_t m = 0; m < options.messages; ++m) {
+        std::string message;
+        while (message.size() < options.length) {
+            if (rng() % 20 == 0) {
+                message += flat[rng() % flat.size()].second;
+            } else {
+                message += kWords[rng() % 14];
+            }
+            message += ' ';
+        }
+        totalBytes += message.size();
+        messages.push_back(std::move(message));
+    }
+
+    MentionRouter router;
+    auto start = std::chrono::steady_clock::now();
+    router.setPatterns(patterns);
+    double compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "模式: " << router.getPatternCount() << ", 状态: " << router.getStateCount()
+              << ", 编译耗时 " << compileMs << " ms" << std::endl;
+
+    auto measure = [&](const char* label, auto&& route) {
+        size_t hits = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (const auto& message : messages) {
+            hits += route(message);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << label << ": " << messages.size() / seconds << " 条/秒, "
+                  << totalBytes / seconds / (1 << 20) << " MB/s, 命中 " << hits << std::endl;
+        return seconds;
+    };
+
+    double automaton = measure("自动机  ", [&router](const std::string& message) { return router.route(message).size(); });
+    double naive = measure("逐模式查找", [&flat](const std::string& message) { return routeNaive(flat, message); });
+    std::cout << "加速比: " << naive / automaton << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,142 @@
+// 智能体注册表读竞争基准
+//
+// 多个读者线程反复执行调度器/监控的典型查询（按 ID 查找、按状态列举、计数），
+// 同时可选一个写者线程不断创建/删除智能体，统计读吞吐。
+//
+// 用法: OpenClaw-CPP-RegistryBench [--key=value ...]
+//   --readers=32      读者线程数
+//   --agents=64       常驻智能体数
+//   --seconds=2       运行时长
+//   --churn=1         是否启用写者线程（0/1）
+
+#include "agent/AgentManager.h"
+#include "events/EventDispatcher.h"
+#include "logging/Logger.h"
+#include "task/Task.h"
+#include "../tests/support/TestAgent.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace openclaw;
+
+namespace {
+
+struct BenchOptions {
+    size_t readers{32};
+    size_t agents{64};
+    double seconds{2.0};
+    bool churn{true};
+};
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        try {
+            if (key == "readers") options.readers = std::max<size_t>(1, std::stoul(value));
+            else if (key == "agents") options.agents = std::max<size_t>(1, std::stoul(value));
+            else if (key == "seconds") options.seconds = std::stod(value);
+            else if (key == "churn") options.churn = std::stoi(value) != 0;
+            else {
+                std::cerr << "未知参数: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数值无效: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+AgentConfig makeAgent(const std::string& id) {
+    AgentConfig config;
+    config.id = id;
+    config.name = id;
+    config.type = AgentType::DEVELOPER;
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    Logger::getInstance().setFileOutputEnabled(false);
+    Logger::getInstance().setLogLevel(LogLevel::ERROR);
+    EventDispatcher::getInstance().setEventDispatchEnabled(false);
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<TestAgent>(config); });
+
+    AgentManager manager;
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < options.agents; ++i) {
+        ids.push_back("agent-" + std::to_string(i));
+        manager.createAgent(makeAgent(ids.back()));
+    }
+    manager.startAllAgents();
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> writes{0};
+
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < options.readers; ++r) {
+        readers.emplace_back([&, r] {
+            uint64_t local = 0;
+            size_t index = r;
+            while (!stop.load(std::memory_order_relaxed)) {
+                // 调度器的典型读：按 ID 查找 + 空闲智能体列举 + 计数
+                auto agent = manager.getAgent(ids[index % ids.size()]);
+                auto running = manager.listAgentsByStatus(AgentStatus::RUNNING);
+                local += (agent ? 1 : 0) + (running.empty() ? 0 : 1) + (manager.getAgentCount() > 0 ? 1 : 0);
+                index += 7;
+            }
+            reads.fetch_add(local);
+        });
+    }
+
+    std::thread writer;
+    if (options.churn) {
+        writer = std::thread([&] {
+            uint64_t i = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::string id = "churn-" + std::to_string(i++ % 1024);
+                manager.createAgent(makeAgent(id));
+                manager.deleteAgent(id);
+                writes.fetch_add(2, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    std::cout << "读者线程: " << options.readers << ", 智能体: " << options.agents
+              << ", 写者: " << (options.churn ? "开启" : "关闭") << std::endl;
+    std::cout << "读吞吐: " << static_cast<double>(reads.load()) / options.seconds << " 次/秒" << std::endl;
+    std::cout << "写吞吐: " << static_cast<double>(writes.load()) / options.seconds << " 次/秒" << std::endl;
+    return 0;
+}
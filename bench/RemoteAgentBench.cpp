@@ -0,0 +1,142 @@
+// 进程外智能体往返延迟基准
+//
+// 同一个回显智能体分别在进程内和子进程（RemoteAgent，共享内存环 + futex 唤醒）中运行，
+// 逐个同步执行任务，统计往返延迟分位数。
+//
+// 用法: OpenClaw-CPP-RemoteAgentBench [--key=value ...]
+//   --requests=20000   执行的任务数
+//   --payload=64       每个任务携带的参数字节数
+
+#include "agent/RemoteAgent.h"
+#include "events/EventDispatcher.h"
+#include "logging/Logger.h"
+#include "task/Task.h"
+#include "../tests/support/TestAgent.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace openclaw;
+
+namespace {
+
+struct BenchOptions {
+    size_t requests{20000};
+    size_t payload{64};
+};
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        try {
+            if (key == "requests") options.requests = std::max<size_t>(1, std::stoul(value));
+            else if (key == "payload") options.payload = std::stoul(value);
+            else {
+                std::cerr << "未知参数: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数值无效: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 回显参数的智能体
+class EchoAgent : public TestAgent {
+public:
+    using TestAgent::TestAgent;
+
+    std::shared_ptr<TaskResult> executeTask(const Task& task) override {
+        auto result = std::make_shared<TaskResult>(true);
+        result->output = task.getConfig().parameters;
+        return result;
+    }
+};
+
+void run(const std::string& label, Agent& agent, const Task& task, size_t requests) {
+    // 预热
+    for (size_t i = 0; i < std::min<size_t>(requests / 10, 1000); ++i) {
+        agent.executeTask(task);
+    }
+
+    std::vector<double> micros;
+    micros.reserve(requests);
+    size_t failed = 0;
+    for (size_t i = 0; i < requests; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        auto result = agent.executeTask(task);
+        auto end = std::chrono::steady_clock::now();
+        if (!result || !result->success) {
+            failed++;
+        }
+        micros.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    std::sort(micros.begin(), micros.end());
+    double sum = 0;
+    for (double value : micros) {
+        sum += value;
+    }
+    auto at = [&micros](double q) { return micros[std::min(micros.size() - 1, static_cast<size_t>(q * micros.size()))]; };
+    std::cout << label << ": mean=" << sum / micros.size() << " p50=" << at(0.5) << " p99=" << at(0.99)
+              << " max=" << micros.back() << " (us), 失败 " << failed << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    Logger::getInstance().setFileOutputEnabled(false);
+    Logger::getInstance().setLogLevel(LogLevel::ERROR);
+    EventDispatcher::getInstance().setEventDispatchEnabled(false);
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<EchoAgent>(config); });
+
+    // 本程序同时是子进程的宿主，被重新执行时在这里进入服务循环
+    RemoteAgent::serveIfHost();
+
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    AgentConfig config;
+    config.id = "echo";
+    config.name = "echo";
+    config.type = AgentType::DEVELOPER;
+
+    TaskConfig taskConfig;
+    taskConfig.id = "echo-task";
+    taskConfig.name = "echo-task";
+    taskConfig.type = TaskType::DEVELOPMENT;
+    taskConfig.parameters["payload"] = std::string(options.payload, 'x');
+    Task task(taskConfig);
+
+    std::cout << "任务数: " << options.requests << ", 参数: " << options.payload << " 字节" << std::endl;
+
+    EchoAgent local(config);
+    local.start();
+    run("进程内", local, task, options.requests);
+
+    RemoteAgent remote(config);
+    remote.start();
+    if (remote.getStatus() != AgentStatus::RUNNING) {
+        std::cerr << "无法启动子进程" << std::endl;
+        return 1;
+    }
+    run("子进程", remote, task, options.requests);
+    remote.stop();
+    return 0;
+}
@@ -0,0 +1,506 @@
+// 调度器离散事件仿真器
+//
+// 在虚拟时钟下驱动真实的 TaskScheduler / TaskQueue / ExecutionStrategy，
+// 智能体由 SimAgent 模拟：任务提交后按配置的时长分布在虚拟时间中完成。
+// 用于在上线前评估 maxConcurrentTasks、调度策略和队列容量的取值。
+//
+// 用法: OpenClaw-CPP-Sim [--key=value ...]
+//   --jobs=100000          到达的作业数（每个作业包含 dag-size 个任务）
+//   --agents=16            模拟智能体数量
+//   --max-concurrent=16    最大并发任务数
+//   --queue-size=100000    任务队列容量
+//   --arrival=poisson      到达过程: poisson | uniform | burst
+//   --rate=100             作业到达率（每虚拟秒）
+//   --burst=32             burst 模式下每批到达的作业数
+//   --duration=exp         执行时长分布: const | exp | uniform | lognormal
+//   --mean-ms=100          平均执行时长（虚拟毫秒）
+//   --sigma=1.0            lognormal 分布的形状参数
+//   --dag=none             作业形状: none | chain | forkjoin | random
+//   --dag-size=1           每个作业的任务数
+//   --failure-rate=0       单次执行失败的概率
+//   --max-retries=3        任务最大重试次数
+//   --gang-width=1         组任务需要同时预留的智能体数（resourceRequirements.cpuCores）
+//   --gang-fraction=0      组任务所占比例
+//   --timeout-s=300        任务的 timeoutSeconds，回填调度以它作为运行时间上界
+//   --strategy=default     执行策略（default=轮询 | jsq=最短队列优先）
+//   --seed=42              随机数种子
+
+#include "agent/AgentManager.h"
+#include "events/EventDispatcher.h"
+#include "logging/Logger.h"
+#include "task/TaskScheduler.h"
+#include "../tests/support/TestAgent.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace openclaw;
+
+namespace {
+
+struct SimOptions {
+    size_t jobs{100000};
+    size_t agents{16};
+    size_t maxConcurrent{16};
+    size_t queueSize{100000};
+    std::string arrival{"poisson"};
+    double rate{100.0};
+    size_t burst{32};
+    std::string duration{"exp"};
+    double meanMs{100.0};
+    double sigma{1.0};
+    std::string dag{"none"};
+    size_t dagSize{1};
+    double failureRate{0.0};
+    size_t maxRetries{3};
+    size_t gangWidth{1};
+    double gangFraction{0.0};
+    size_t timeoutSeconds{300};
+    std::string strategy{"default"};
+    uint64_t seed{42};
+};
+
+using StrategyFactory = std::function<std::unique_ptr<ExecutionStrategy>()>;
+
+const std::map<std::string, StrategyFactory>& strategyRegistry() {
+    static const std::map<std::string, StrategyFactory> registry = {
+        {"default", [] { return std::make_unique<DefaultExecutionStrategy>(); }},
+        {"jsq", [] { return std::make_unique<ShortestQueueExecutionStrategy>(); }},
+    };
+    return registry;
+}
+
+bool parseOptions(int argc, char* argv[], SimOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        try {
+            if (key == "jobs") options.jobs = std::stoul(value);
+            else if (key == "agents") options.agents = std::stoul(value);
+            else if (key == "max-concurrent") options.maxConcurrent = std::stoul(value);
+            else if (key == "queue-size") options.queueSize = std::stoul(value);
+            else if (key == "arrival") options.arrival = value;
+            else if (key == "rate") options.rate = std::stod(value);
+            else if (key == "burst") options.burst = std::stoul(value);
+            else if (key == "duration") options.duration = value;
+            else if (key == "mean-ms") options.meanMs = std::stod(value);
+            else if (key == "sigma") options.sigma = std::stod(value);
+            else if (key == "dag") options.dag = value;
+            else if (key == "dag-size") options.dagSize = std::stoul(value);
+            else if (key == "failure-rate") options.failureRate = std::stod(value);
+            else if (key == "max-retries") options.maxRetries = std::stoul(value);
+            else if (key == "gang-width") options.gangWidth = std::stoul(value);
+            else if (key == "gang-fraction") options.gangFraction = std::stod(value);
+            else if (key == "timeout-s") options.timeoutSeconds = std::stoul(value);
+            else if (key == "strategy") options.strategy = value;
+            else if (key == "seed") options.seed = std::stoull(value);
+            else {
+                std::cerr << "未知参数: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数值无效: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.dag == "none") {
+        options.dagSize = 1;
+    }
+    if (options.agents == 0 || options.rate <= 0.0 || options.dagSize == 0 || options.burst == 0) {
+        std::cerr << "agents、rate、dag-size 和 burst 必须大于 0" << std::endl;
+        return false;
+    }
+    if (options.gangWidth == 0 || options.gangWidth > options.agents) {
+        std::cerr << "gang-width 必须在 1 到 agents 之间" << std::endl;
+        return false;
+    }
+    if (strategyRegistry().count(options.strategy) == 0) {
+        std::cerr << "未知执行策略: " << options.strategy << std::endl;
+        return false;
+    }
+    return true;
+}
+
+class Simulation;
+
+// 模拟智能体：不真正执行任务，只把完成事件登记到虚拟时间线上
+class SimAgent : public TestAgent {
+public:
+    SimAgent(const AgentConfig& config, Simulation& simulation)
+        : TestAgent(config), simulation_(simulation) {}
+
+    void submitTask(const std::shared_ptr<Task>& task, TaskCompletion done) override;
+    size_t getQueueDepth() const override { return inFlight_; }
+
+private:
+    Simulation& simulation_;
+    size_t inFlight_{0};   // 仿真单线程运行，无需原子量
+};
+
+class Simulation {
+public:
+    explicit Simulation(const SimOptions& options)
+        : options_(options), rng_(options.seed), scheduler_(agentManager_) {}
+
+    bool run();
+    void report() const;
+
+    // SimAgent 回调：任务在虚拟时间 now_ 被派发
+    void onDispatch(const std::shared_ptr<Task>& task, Agent::TaskCompletion done);
+
+private:
+    struct SimEvent {
+        double timeMs;
+        uint64_t seq;
+        std::function<void()> action;
+    };
+    struct SimEventLater {
+        bool operator()(const SimEvent& a, const SimEvent& b) const {
+            return a.timeMs != b.timeMs ? a.timeMs > b.timeMs : a.seq > b.seq;
+        }
+    };
+
+    void setupAgents();
+    void post(double timeMs, std::function<void()> action);
+    void scheduleNextArrival();
+    void submitJob();
+    std::vector<std::vector<size_t>> buildDag();
+    double sampleDuration();
+    double sampleInterarrival();
+    static size_t taskIndex(const std::string& taskId);
+
+    SimOptions options_;
+    std::mt19937_64 rng_;
+    AgentManager agentManager_;
+    TaskScheduler scheduler_;
+
+    // 虚拟时钟与事件队列
+    double now_{0.0};
+    uint64_t nextSeq_{0};
+    std::priority_queue<SimEvent, std::vector<SimEvent>, SimEventLater> events_;
+
+    // 以任务序号为下标的记录
+    std::vector<double> submitTime_;
+    std::vector<double> finishTime_;
+    std::vector<double> retryReadyTime_;
+    size_t jobsArrived_{0};
+    size_t tasksCreated_{0};
+    size_t tasksRejected_{0};
+
+    // 观测指标
+    std::vector<float> queueWaitsMs_;
+    double busyTimeMs_{0.0};
+    size_t completed_{0};
+    size_t failedAttempts_{0};
+    double wallSeconds_{0.0};
+};
+
+void SimAgent::submitTask(const std::shared_ptr<Task>& task, TaskCompletion done) {
+    inFlight_++;
+    simulation_.onDispatch(task, [this, done = std::move(done)](std::shared_ptr<TaskResult> result) {
+        inFlight_--;
+        done(std::move(result));
+    });
+}
+
+void Simulation::setupAgents() {
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [this](const AgentConfig& config) -> Agent::Ptr {
+            return std::make_shared<SimAgent>(config, *this);
+        });
+
+    for (size_t i = 0; i < options_.agents; ++i) {
+        AgentConfig config;
+        config.id = "sim-agent-" + std::to_string(i);
+        config.type = AgentType::DEVELOPER;
+        config.name = "Simulated Agent " + std::to_string(i);
+        agentManager_.createAgent(config);
+    }
+    agentManager_.startAllAgents();
+}
+
+void Simulation::post(double timeMs, std::function<void()> action) {
+    events_.push(SimEvent{timeMs, nextSeq_++, std::move(action)});
+}
+
+double Simulation::sampleInterarrival() {
+    double meanMs = 1000.0 / options_.rate;
+    if (options_.arrival == "uniform") {
+        return meanMs;
+    }
+    if (options_.arrival == "burst") {
+        // 每 burst 个作业同时到达，批次间隔保持平均到达率
+        return (jobsArrived_ % options_.burst == 0) ? meanMs * options_.burst : 0.0;
+    }
+    std::exponential_distribution<double> dist(1.0 / meanMs);
+    return dist(rng_);
+}
+
+double Simulation::sampleDuration() {
+    const double mean = options_.meanMs;
+    if (options_.duration == "const") {
+        return mean;
+    }
+    if (options_.duration == "uniform") {
+        std::uniform_real_distribution<double> dist(0.0, 2.0 * mean);
+        return dist(rng_);
+    }
+    if (options_.duration == "lognormal") {
+        // 选取 mu 使分布均值等于 mean
+        double mu = std::log(mean) - options_.sigma * options_.sigma / 2.0;
+        std::lognormal_distribution<double> dist(mu, options_.sigma);
+        return dist(rng_);
+    }
+    std::exponential_distribution<double> dist(1.0 / mean);
+    return dist(rng_);
+}
+
+std::vector<std::vector<size_t>> Simulation::buildDag() {
+    const size_t n = options_.dagSize;
+    std::vector<std::vector<size_t>> deps(n);
+
+    if (options_.dag == "chain") {
+        for (size_t i = 1; i < n; ++i) {
+            deps[i].push_back(i - 1);
+        }
+    } else if (options_.dag == "forkjoin" && n >= 2) {
+        // 0 为扇出节点，n-1 为汇聚节点
+        for (size_t i = 1; i + 1 < n; ++i) {
+            deps[i].push_back(0);
+            deps[n - 1].push_back(i);
+        }
+        if (n == 2) {
+            deps[1].push_back(0);
+        }
+    } else if (options_.dag == "random") {
+        std::bernoulli_distribution edge(2.0 / static_cast<double>(n));
+        for (size_t i = 1; i < n; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (edge(rng_)) {
+                    deps[i].push_back(j);
+                }
+            }
+        }
+    }
+    return deps;
+}
+
+size_t Simulation::taskIndex(const std::string& taskId) {
+    return std::stoul(taskId.substr(1));
+}
+
+void Simulation::submitJob() {
+    auto deps = buildDag();
+    const size_t base = tasksCreated_;
+    bool rejected = false;
+
+    for (size_t i = 0; i < deps.size(); ++i) {
+        size_t index = tasksCreated_++;
+        submitTime_.push_back(now_);
+        finishTime_.push_back(-1.0);
+        retryReadyTime_.push_back(-1.0);
+
+        // 作业内某个任务被拒绝后，其后的任务都不再提交，避免永久阻塞
+        if (rejected) {
+            tasksRejected_++;
+            continue;
+        }
+
+        TaskConfig config;
+        config.id = "t" + std::to_string(index);
+        config.name = config.id;
+        config.type = TaskType::DEVELOPMENT;
+        config.maxRetries = options_.maxRetries;
+        config.timeoutSeconds = options_.timeoutSeconds;
+        std::bernoulli_distribution gang(options_.gangFraction);
+        if (options_.gangWidth > 1 && gang(rng_)) {
+            config.resourceRequirements.cpuCores = options_.gangWidth;
+        }
+        for (size_t dep : deps[i]) {
+            config.dependencies.push_back("t" + std::to_string(base + dep));
+        }
+
+        if (!scheduler_.scheduleTask(config)) {
+            tasksRejected_++;
+            rejected = true;
+        }
+    }
+}
+
+void Simulation::scheduleNextArrival() {
+    if (jobsArrived_ >= options_.jobs) {
+        return;
+    }
+    post(now_ + sampleInterarrival(), [this] {
+        jobsArrived_++;
+        submitJob();
+        scheduleNextArrival();
+    });
+}
+
+void Simulation::onDispatch(const std::shared_ptr<Task>& task, Agent::TaskCompletion done) {
+    const size_t index = taskIndex(task->getId());
+
+    // 就绪时刻：提交时刻、所有依赖的完成时刻以及上次失败时刻中的最大值
+    double readyTime = submitTime_[index];
+    for (const auto& dep : task->getDependencies()) {
+        readyTime = std::max(readyTime, finishTime_[taskIndex(dep)]);
+    }
+    readyTime = std::max(readyTime, retryReadyTime_[index]);
+    queueWaitsMs_.push_back(static_cast<float>(now_ - readyTime));
+
+    const double duration = sampleDuration();
+    std::bernoulli_distribution failure(options_.failureRate);
+    const bool success = !failure(rng_);
+    busyTimeMs_ += duration * static_cast<double>(
+        std::max<size_t>(1, task->getConfig().resourceRequirements.cpuCores));
+
+    post(now_ + duration, [this, index, success, done = std::move(done)] {
+        if (success) {
+            finishTime_[index] = now_;
+            completed_++;
+        } else {
+            retryReadyTime_[index] = now_;
+            failedAttempts_++;
+        }
+        auto result = std::make_shared<TaskResult>(success);
+        if (!success) {
+            result->errorMessage = "simulated failure";
+        }
+        done(result);
+    });
+}
+
+bool Simulation::run() {
+    setupAgents();
+    scheduler_.configure(SchedulingStrategy::PRIORITY, options_.maxConcurrent);
+    scheduler_.setTaskQueueMaxSize(options_.queueSize);
+    scheduler_.setExecutionStrategy(strategyRegistry().at(options_.strategy)());
+    scheduler_.setClock([this] {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::duration<double, std::milli>(now_)));
+    });
+
+    const size_t expectedTasks = options_.jobs * options_.dagSize;
+    submitTime_.reserve(expectedTasks);
+    finishTime_.reserve(expectedTasks);
+    retryReadyTime_.reserve(expectedTasks);
+    queueWaitsMs_.reserve(expectedTasks);
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    scheduleNextArrival();
+    size_t processed = 0;
+    while (!events_.empty()) {
+        // priority_queue::top 只提供 const 引用，拷贝后弹出
+        SimEvent event = events_.top();
+        events_.pop();
+        now_ = event.timeMs;
+        event.action();
+
+        // 同一时刻的事件全部处理完后再执行一轮调度
+        if (events_.empty() || events_.top().timeMs > now_) {
+            scheduler_.runSchedulingRound();
+        }
+
+        // 定期清理已结束的任务，控制内存占用
+        if (++processed % 8192 == 0) {
+            scheduler_.cleanupFinishedTasks();
+        }
+    }
+
+    wallSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return true;
+}
+
+double percentile(std::vector<float>& values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+void Simulation::report() const {
+    auto stats = scheduler_.getStats();
+    auto waits = queueWaitsMs_;
+    double meanWait = 0.0;
+    for (float w : waits) {
+        meanWait += w;
+    }
+    if (!waits.empty()) {
+        meanWait /= static_cast<double>(waits.size());
+    }
+
+    const double horizonSeconds = now_ / 1000.0;
+    const double utilisation = now_ > 0.0
+        ? busyTimeMs_ / (now_ * static_cast<double>(options_.agents)) * 100.0 : 0.0;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "=== OpenClaw-CPP 调度仿真结果 ===" << std::endl;
+    std::cout << "工作负载: arrival=" << options_.arrival << " rate=" << options_.rate
+              << "/s duration=" << options_.duration << " mean=" << options_.meanMs
+              << "ms dag=" << options_.dag << "x" << options_.dagSize
+              << " failure=" << options_.failureRate
+              << " gang=" << options_.gangWidth << "@" << options_.gangFraction << std::endl;
+    std::cout << "调度配置: agents=" << options_.agents << " maxConcurrent=" << options_.maxConcurrent
+              << " queueSize=" << options_.queueSize << " strategy=" << options_.strategy << std::endl;
+    std::cout << "作业数: " << jobsArrived_ << ", 任务数: " << tasksCreated_
+              << " (拒绝 " << tasksRejected_ << ")" << std::endl;
+    std::cout << "完成: " << stats.totalTasksCompleted << ", 失败: " << stats.totalTasksFailed
+              << ", 取消: " << stats.totalTasksCancelled << ", 失败执行次数: " << failedAttempts_ << std::endl;
+    std::cout << "虚拟时长: " << horizonSeconds << " s" << std::endl;
+    std::cout << "吞吐量: " << (horizonSeconds > 0.0 ? completed_ / horizonSeconds : 0.0)
+              << " 任务/虚拟秒" << std::endl;
+    std::cout << "排队等待(ms): mean=" << meanWait
+              << " p50=" << percentile(waits, 0.50)
+              << " p90=" << percentile(waits, 0.90)
+              << " p99=" << percentile(waits, 0.99)
+              << " max=" << percentile(waits, 1.0) << std::endl;
+    std::cout << "智能体利用率: " << utilisation << "%" << std::endl;
+    std::cout << "仿真速度: " << std::setprecision(0)
+              << (wallSeconds_ > 0.0 ? queueWaitsMs_.size() / wallSeconds_ : 0.0)
+              << " 次派发/秒 (墙钟 " << std::setprecision(3) << wallSeconds_ << " s)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    // 仿真时关闭日志输出与事件分发，只保留调度路径本身的开销
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    Logger::getInstance().setFileOutputEnabled(false);
+    Logger::getInstance().setLogLevel(LogLevel::ERROR);
+    EventDispatcher::getInstance().setEventDispatchEnabled(false);
+
+    Simulation simulation(options);
+    if (!simulation.run()) {
+        return 1;
+    }
+    simulation.report();
+    return 0;
+}
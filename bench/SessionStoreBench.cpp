@@ -0,0 +1,127 @@
+// 会话记录存储基准
+//
+// 向一个会话写入约 --size MB 的对话轮次，关闭后重新打开存储，测量打开会话并读取最后 N 轮的耗时；
+// 再用多个线程做同步追加，统计组提交合并了多少次 fdatasync。
+//
+// 用法: OpenClaw-CPP-SessionStoreBench [--key=value ...]
+//   --size=100        写入的会话大小（MB）
+//   --turn=1024       每轮内容字节数
+//   --last=50         读取最后多少轮
+//   --threads=8       同步追加的线程数
+//   --syncs=200       每个线程的同步追加次数
+//   --dir=/tmp/openclaw-session-bench
+
+#include "model/SessionStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace openclaw;
+
+namespace {
+
+struct BenchOptions {
+    size_t sizeMb{100};
+    size_t turn{1024};
+    size_t last{50};
+    size_t threads{8};
+    size_t syncs{200};
+    std::string dir{"/tmp/openclaw-session-bench"};
+};
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        try {
+            if (key == "size") options.sizeMb = std::max<size_t>(1, std::stoul(value));
+            else if (key == "turn") options.turn = std::max<size_t>(1, std::stoul(value));
+            else if (key == "last") options.last = std::max<size_t>(1, std::stoul(value));
+            else if (key == "threads") options.threads = std::max<size_t>(1, std::stoul(value));
+            else if (key == "syncs") options.syncs = std::max<size_t>(1, std::stoul(value));
+            else if (key == "dir") options.dir = value;
+            else {
+                std::cerr << "未知参数: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数值无效: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    std::filesystem::remove_all(options.dir);
+
+    const std::string sessionId = "bench-session";
+    const std::string text(options.turn, 'x');
+    const size_t turns = (options.sizeMb << 20) / options.turn;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        SessionStore store(options.dir);
+        for (size_t i = 0; i < turns; ++i) {
+            store.append(sessionId, i % 2 ? "assistant" : "user", text);
+        }
+        store.flush();
+    }
+    double writeMs = elapsedMs(start);
+    std::cout << "写入 " << turns << " 轮 (" << options.sizeMb << " MB): " << writeMs << " ms, "
+              << (options.sizeMb * 1000.0 / writeMs) << " MB/s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    SessionStore store(options.dir);
+    auto last = store.readLast(sessionId, options.last);
+    double coldMs = elapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    last = store.readLast(sessionId, options.last);
+    double warmMs = elapsedMs(start);
+    std::cout << "重新打开并读取最后 " << last.size() << " 轮: " << coldMs << " ms (再次读取 " << warmMs
+              << " ms)" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < options.threads; ++t) {
+        writers.emplace_back([&store, &options, t] {
+            std::string id = "sync-" + std::to_string(t % 4);
+            for (size_t i = 0; i < options.syncs; ++i) {
+                store.append(id, "user", "ping", true);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    double syncMs = elapsedMs(start);
+    auto stats = store.getStats();
+    size_t syncs = options.threads * options.syncs;
+    std::cout << "同步追加 " << syncs << " 次: " << syncMs << " ms, fdatasync " << stats.commits << " 次 (平均每次合并 "
+              << (stats.commits ? static_cast<double>(syncs) / stats.commits : 0.0) << " 轮)" << std::endl;
+
+    std::filesystem::remove_all(options.dir);
+    return 0;
+}
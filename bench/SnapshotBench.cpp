@@ -0,0 +1,129 @@
+// 调度器快照基准
+//
+// 构造含大量任务的调度器状态（部分任务带依赖、参数），测量 snapshot / restore 的耗时与文件大小。
+//
+// 用法: OpenClaw-CPP-SnapshotBench [--key=value ...]
+//   --tasks=1000000        任务数
+//   --chain=4              每条依赖链的长度（链上除首个任务外均处于挂起状态）
+//   --path=scheduler.snap  快照文件路径
+
+#include "agent/AgentManager.h"
+#include "events/EventDispatcher.h"
+#include "logging/Logger.h"
+#include "task/TaskScheduler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace openclaw;
+
+namespace {
+
+struct BenchOptions {
+    size_t tasks{1000000};
+    size_t chain{4};
+    std::string path{"scheduler.snap"};
+};
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        try {
+            if (key == "tasks") options.tasks = std::stoul(value);
+            else if (key == "chain") options.chain = std::max<size_t>(1, std::stoul(value));
+            else if (key == "path") options.path = value;
+            else {
+                std::cerr << "未知参数: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数值无效: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    Logger::getInstance().setFileOutputEnabled(false);
+    Logger::getInstance().setLogLevel(LogLevel::ERROR);
+    EventDispatcher::getInstance().setEventDispatchEnabled(false);
+
+    AgentManager manager;
+    size_t taskCount = 0;
+    double snapshotMs = 0.0;
+    {
+        TaskScheduler scheduler(manager);
+        scheduler.setTaskQueueMaxSize(options.tasks);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < options.tasks; ++i) {
+            TaskConfig config;
+            config.id = "t" + std::to_string(i);
+            config.name = "job-" + std::to_string(i / options.chain);
+            config.type = static_cast<TaskType>(1 + i % 5);
+            config.priority = static_cast<TaskPriority>(i % 4);
+            config.parameters["partitionKey"] = config.name;
+            if (i % options.chain != 0) {
+                config.dependencies.push_back("t" + std::to_string(i - 1));
+            }
+            scheduler.scheduleTask(config);
+        }
+        std::cout << "构造状态: " << elapsedMs(start) << " ms" << std::endl;
+
+        taskCount = scheduler.getAllTasks().size();
+        start = std::chrono::steady_clock::now();
+        if (!scheduler.snapshot(options.path)) {
+            std::cerr << "快照失败" << std::endl;
+            return 1;
+        }
+        snapshotMs = elapsedMs(start);
+    }
+
+    std::FILE* file = std::fopen(options.path.c_str(), "rb");
+    long fileSize = 0;
+    if (file) {
+        std::fseek(file, 0, SEEK_END);
+        fileSize = std::ftell(file);
+        std::fclose(file);
+    }
+
+    TaskScheduler restored(manager);
+    auto start = std::chrono::steady_clock::now();
+    if (!restored.restore(options.path)) {
+        std::cerr << "恢复失败" << std::endl;
+        return 1;
+    }
+    double restoreMs = elapsedMs(start);
+
+    auto stats = restored.getStats();
+    std::cout << "任务数: " << taskCount << " (待执行 " << stats.currentPendingCount << ")" << std::endl;
+    std::cout << "快照: " << snapshotMs << " ms, " << fileSize / 1024 << " KiB ("
+              << (taskCount > 0 ? static_cast<double>(fileSize) / taskCount : 0.0) << " 字节/任务)" << std::endl;
+    std::cout << "恢复: " << restoreMs << " ms" << std::endl;
+
+    std::remove(options.path.c_str());
+    return 0;
+}
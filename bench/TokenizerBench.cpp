@@ -0,0 +1,227 @@
+// BPE 分词吞吐基准
+//
+// 生成混合英文、代码、数字与中文的合成语料，按语料的词频合成与生产词表（cl100k 约 10 万个词元）
+// 同等规模的词表（或加载 tiktoken 格式词表），单线程编码整个语料并报告 MB/s；
+// 另外测量逐段追加时增量编码的耗时。词表规模决定查找表能否留在缓存中，过小的词表会高估吞吐。
+//
+// 用法: OpenClaw-CPP-TokenizerBench [--key=value ...]
+//   --size=32          语料大小（MB）
+//   --vocab=100000     合成的词表大小（未指定 --vocab-file 时）
+//   --words=60000      语料词汇量，词频按 Zipf 分布
+//   --vocab-file=PATH  加载 tiktoken 格式的词表
+//   --append=64        增量编码时每次追加的字节数
+
+#include "model/BpeTokenizer.h"
+#include "logging/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace openclaw;
+
+namespace {
+
+struct BenchOptions {
+    size_t sizeMb{32};
+    size_t vocab{100000};
+    size_t words{60000};
+    std::string vocabFile;
+    size_t append{64};
+};
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "无法识别的参数: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+
+        try {
+            if (key == "size") options.sizeMb = std::max<size_t>(1, std::stoul(value));
+            else if (key == "vocab") options.vocab = std::max<size_t>(256, std::stoul(value));
+            else if (key == "words") options.words = std::max<size_t>(100, std::stoul(value));
+            else if (key == "vocab-file") options.vocabFile = value;
+            else if (key == "append") options.append = std::max<size_t>(1, std::stoul(value));
+            else {
+                std::cerr << "未知参数: " << key << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "参数值无效: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* const kChinese[] = {"智能体", "任务", "调度器", "上下文", "模型", "会话"};
+
+// 由音节拼成的伪词，按生成顺序即词频排名
+std::vector<std::string> makeLexicon(size_t count) {
+    static const char* const kOnsets[] = {"", "b", "c", "d", "f", "g", "h", "k", "l", "m", "n", "p", "r", "s",
+                                          "t", "v", "w", "st", "tr", "pr", "ch", "sh", "th", "gr", "pl"};
+    static const char* const kNuclei[] = {"a", "e", "i", "o", "u", "ea", "ou", "io", "ai", "er", "an", "in"};
+    static const char* const kCodas[] = {"", "", "n", "r", "s", "t", "l", "nd", "ng", "st", "ck", "tion"};
+
+    std::mt19937 rng(7);
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> lexicon;
+    lexicon.reserve(count);
+    while (lexicon.size() < count) {
+        // 高频词较短：排名越靠后，允许的音节越多
+        size_t syllables = 1 + rng() % (1 + std::min<size_t>(3, lexicon.size() / 2000));
+        std::string word;
+        for (size_t s = 0; s < syllables; ++s) {
+            word += kOnsets[rng() % (sizeof(kOnsets) / sizeof(kOnsets[0]))];
+            word += kNuclei[rng() % (sizeof(kNuclei) / sizeof(kNuclei[0]))];
+            word += kCodas[rng() % (sizeof(kCodas) / sizeof(kCodas[0]))];
+        }
+        if (seen.insert(word).second) {
+            lexicon.push_back(std::move(word));
+        }
+    }
+    return lexicon;
+}
+
+// 合成词表：256 个单字节词元之后，依次加入 1 至 3 位数字、中文词，以及按词频排序的每个词
+// （带与不带前导空格）的各级前缀，使每个多字节词元都能由更短的词元与一个字节合并得到
+std::vector<std::string> makeVocabulary(const std::vector<std::string>& lexicon, size_t target) {
+    std::vector<std::string> tokens;
+    std::unordered_set<std::string> seen;
+    auto addChain = [&](const std::string& word) {
+        for (size_t length = 1; length <= word.size() && tokens.size() < target; ++length) {
+            std::string prefix = word.substr(0, length);
+            if (seen.insert(prefix).second) {
+                tokens.push_back(std::move(prefix));
+            }
+        }
+    };
+
+    for (int b = 0; b < 256; ++b) {
+        addChain(std::string(1, static_cast<char>(b)));
+    }
+    for (int n = 0; n < 1000; ++n) {
+        addChain(std::to_string(n));
+    }
+    for (const char* word : kChinese) {
+        addChain(word);
+    }
+    for (size_t i = 0; i < lexicon.size() && tokens.size() < target; ++i) {
+        addChain(" " + lexicon[i]);
+        addChain(lexicon[i]);
+    }
+    return tokens;
+}
+
+std::string makeCorpus(size_t bytes, const std::vector<std::string>& lexicon) {
+    static const char* const kCode[] = {
+        "    if (result->success) {\n", "        return nullptr;\n", "    for (size_t i = 0; i < n; ++i) {\n",
+        "    std::lock_guard<std::mutex> lock(mutex_);\n", "}\n"};
+
+    // 第 k 个词的频率正比于 1/k
+    std::vector<double> weights(lexicon.size());
+    for (size_t k = 0; k < weights.size(); ++k) {
+        weights[k] = 1.0 / static_cast<double>(k + 1);
+    }
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+    std::mt19937 rng(42);
+    std::string corpus;
+    corpus.reserve(bytes + 256);
+    while (corpus.size() < bytes) {
+        switch (rng() % 10) {
+        case 0:
+            corpus += kCode[rng() % 5];
+            break;
+        case 1:
+            corpus += kChinese[rng() % 6];
+            corpus += "，";
+            break;
+        case 2:
+            corpus += ' ' + std::to_string(rng() % 100000);
+            break;
+        default: {
+            size_t words = 4 + rng() % 10;
+            for (size_t w = 0; w < words; ++w) {
+                corpus += ' ';
+                corpus += lexicon[pick(rng)];
+            }
+            corpus += rng() % 3 == 0 ? ".\n" : ",";
+        }
+        }
+    }
+    return corpus;
+}
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    Logger::getInstance().setFileOutputEnabled(false);
+
+    std::vector<std::string> lexicon = makeLexicon(options.words);
+    std::string corpus = makeCorpus(options.sizeMb << 20, lexicon);
+
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<BpeTokenizer> tokenizer;
+    if (!options.vocabFile.empty()) {
+        tokenizer = BpeTokenizer::loadFromFile(options.vocabFile);
+    } else {
+        tokenizer = BpeTokenizer::fromTokens(makeVocabulary(lexicon, options.vocab));
+    }
+    if (!tokenizer) {
+        std::cerr << "无法构建词表" << std::endl;
+        return 1;
+    }
+    std::cout << "词表: " << tokenizer->vocabSize() << " 个词元，构建耗时 " << seconds(start) << " s" << std::endl;
+
+    double mb = static_cast<double>(corpus.size()) / (1 << 20);
+    std::vector<BpeTokenizer::TokenId> tokens;
+    tokens.reserve(corpus.size() / 2);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::pair<size_t, size_t>> chunks;
+    chunks.reserve(corpus.size() / 3);
+    BpeTokenizer::pretokenize(corpus.data(), corpus.size(), chunks);
+    double pretokenizeSeconds = seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    tokenizer->encode(corpus.data(), corpus.size(), tokens);
+    double encodeSeconds = seconds(start);
+
+    std::cout << "语料: " << mb << " MB, " << tokens.size() << " 个词元 ("
+              << static_cast<double>(corpus.size()) / tokens.size() << " 字节/词元)" << std::endl;
+    std::cout << "预分词: " << mb / pretokenizeSeconds << " MB/s" << std::endl;
+    std::cout << "编码:   " << mb / encodeSeconds << " MB/s（单线程）" << std::endl;
+
+    // 增量编码：模拟流式输出逐段追加到上下文
+    size_t incrementalBytes = std::min<size_t>(corpus.size(), 4u << 20);
+    IncrementalTokenizer incremental(tokenizer);
+    start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < incrementalBytes; offset += options.append) {
+        incremental.append(corpus.substr(offset, std::min(options.append, incrementalBytes - offset)));
+    }
+    double incrementalSeconds = seconds(start);
+    std::cout << "增量编码: 每次追加 " << options.append << " 字节, "
+              << static_cast<double>(incrementalBytes) / (1 << 20) / incrementalSeconds << " MB/s, "
+              << incremental.tokenCount() << " 个词元" << std::endl;
+    return 0;
+}
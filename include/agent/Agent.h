@@ -1,12 +1,19 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 #include <atomic>
+#include <chrono>
 #include <functional>
+#include <iosfwd>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include "../events/Event.h"
+#include "../common/StringInterner.h"
+#include "ResourceAccounting.h"
+#include "../task/Task.h"
 
 namespace openclaw {
 
@@ -27,7 +34,8 @@ enum class AgentStatus {
     RUNNING,
     PAUSED,
     STOPPING,
-    ERROR
+    ERROR,
+    HIBERNATED      // 已登记但未驻留内存（延迟构造或空闲休眠），收到任务时自动恢复
 };
 
 // 智能体配置
@@ -42,9 +50,25 @@ struct AgentConfig {
     struct ResourceLimits {
         size_t maxMemoryMB{512};      // 最大内存使用
         size_t maxThreads{4};          // 最大线程数
-        double maxCpuUsage{80.0};     // 最大CPU使用率(%)
+        double maxCpuUsage{0.0};      // 最大CPU使用率(%)，100 表示占满一个核；0 表示 maxThreads 个核全满
     } resourceLimits;
     
+    // 可执行的任务类型，为空表示不限。未指定类型（UNKNOWN）的任务任何智能体都可执行
+    std::vector<TaskType> capabilities;
+    
+    // 为 true 时只登记配置，首个任务到达时才通过工厂构造（见 LazyAgent）
+    bool lazy{false};
+    
+    // 为 true 时智能体在子进程中运行，崩溃或内存膨胀不影响主进程（见 RemoteAgent）
+    bool outOfProcess{false};
+    
+    // 为 true 时任务进入智能体自己的邮箱，由至多 maxThreads 个专属线程执行；
+    // 否则在提交线程上同步执行
+    bool useMailbox{false};
+    
+    // 工作区目录，非空时创建智能体会把它登记到共享的 WorkspaceCache
+    std::string workspace;
+    
     // 验证配置
     bool validate() const;
     std::string toJson() const;
@@ -54,50 +78,172 @@ struct AgentConfig {
 // 任务前向声明
 class Task;
 class TaskResult;
+class Agent;
+class TokenStream;
+
+// 智能体状态变更观察者（由 AgentManager 实现），在状态实际发生变化后于变更线程上调用。
+// 回调处于 EpochManager 读临界区内，解除观察者后经 synchronize 即可确认不再有进行中的回调
+class AgentStatusObserver {
+public:
+    virtual ~AgentStatusObserver() = default;
+    virtual void onAgentStatusChanged(Agent& agent, AgentStatus oldStatus, AgentStatus newStatus) = 0;
+    
+    // 智能体首次（或错过心跳后重新）发出心跳
+    virtual void onAgentHeartbeatStarted(Agent& /*agent*/) {}
+};
 
 // 智能体接口
-class Agent {
+class Agent : public std::enable_shared_from_this<Agent> {
 public:
     using Ptr = std::shared_ptr<Agent>;
     using TaskHandler = std::function<void(const Task&)>;
+    using TaskCompletion = std::function<void(std::shared_ptr<TaskResult>)>;
+    
+    using Message = std::function<void()>;
     
     Agent(const AgentConfig& config);
-    virtual ~Agent() = default;
+    virtual ~Agent();
     
     // 禁用拷贝
     Agent(const Agent&) = delete;
     Agent& operator=(const Agent&) = delete;
     
-    // 生命周期管理
-    virtual void start() = 0;
-    virtual void stop() = 0;
-    virtual void pause() = 0;
-    virtual void resume() = 0;
+    // 生命周期管理。默认实现只切换状态（状态经 setStatus 修改并通知观察者），
+    // 启停时需要分配或释放资源的子类覆盖相应方法，并在其中调用 setStatus
+    virtual void start();
+    virtual void stop();
+    virtual void pause();
+    virtual void resume();
     
     // 任务执行
     virtual std::shared_ptr<TaskResult> executeTask(const Task& task) = 0;
     
+    // 流式执行：输出在产生时分块写入 stream（例如经 ModelGateway::stream），返回前结束 stream。
+    // 完整输出同时放在结果的 output["text"] 中。默认调用 executeTask，再把 output["text"] 作为一个分块
+    virtual std::shared_ptr<TaskResult> executeTaskStreaming(const Task& task, const std::shared_ptr<TokenStream>& stream);
+    
+    // 提交任务：启用邮箱时非阻塞入队，否则同步执行后回调；任务的输出流已被订阅时改为
+    // executeTaskStreaming。提交、开始执行与完成时各发出一次心跳。
+    // 子类可改为其他异步方式，此时须在提交时调用 beginTask、完成回调前调用 endTask
+    virtual void submitTask(const std::shared_ptr<Task>& task, TaskCompletion done);
+    
+    // 向邮箱投递消息，由执行线程按投递顺序取出执行；未启用邮箱或邮箱已关闭时返回 false
+    bool post(Message message);
+    
+    // 已投递但尚未处理完的消息数，供最短队列优先的放置策略使用
+    virtual size_t getQueueDepth() const;
+    
+    // 可同时接收的任务数，调度器据此决定同一智能体上并行派发多少个任务：
+    // 启用邮箱时为执行线程数，否则为 1
+    virtual size_t getConcurrency() const;
+    
+    // 关闭邮箱：不再接受投递，处理完已入队的消息后回收执行线程。
+    // submitTask 入队的任务持有智能体的引用，不会在析构后执行；
+    // 经 post 投递、会访问派生部分的消息，由子类在自己的析构函数中先关闭邮箱
+    void shutdownMailbox();
+    
     // 状态查询
     AgentStatus getStatus() const { return status_.load(); }
-    std::string getId() const { return config_.id; }
-    AgentType getType() const { return config_.type; }
-    std::string getName() const { return config_.name; }
-    AgentConfig getConfig() const { return config_; }
+    const std::string& getId() const { return id_; }
+    StringInterner::Handle getHandle() const { return handle_; }
+    AgentType getType() const { return configSnapshot()->type; }
+    std::string getName() const { return configSnapshot()->name; }
+    AgentConfig getConfig() const { return *configSnapshot(); }
     
     // 配置更新
     virtual bool updateConfig(const AgentConfig& config);
     
+    // 能否执行该类型的任务（按 AgentConfig::capabilities）
+    bool canExecute(TaskType type) const {
+        return (capabilityMask_.load(std::memory_order_relaxed) >> static_cast<size_t>(type)) & 1u;
+    }
+    
+    // 休眠时保存/恢复智能体的内部状态，默认无状态
+    virtual std::string serializeState() const { return std::string(); }
+    virtual bool restoreState(const std::string& /*state*/) { return true; }
+    
+    // 能否休眠：serializeState / restoreState 能完整保存并还原内部状态时返回 true。
+    // 默认不允许，避免未实现序列化的智能体在休眠后丢失状态
+    virtual bool supportsHibernation() const { return false; }
+    
+    // 检查点：把内部状态写入流 / 从流恢复，默认基于 serializeState / restoreState。
+    // 可能在任务执行期间调用，实现只应短暂持锁复制状态；编码、增量比较与写盘由调用方完成
+    virtual bool checkpoint(std::ostream& out) const;
+    virtual bool restore(std::istream& in);
+    
     // 健康检查
     virtual bool isHealthy() const;
     
+    // 实测的资源使用（见 ResourceAccounting），延迟智能体休眠前后共用同一份统计
+    ResourceUsage getResourceUsage() const;
+    
+    // 最近 CPU 利用率或当前内存超过 resourceLimits 时返回 true，调度器据此暂停向其派发任务；
+    // 越界与恢复时各记录一次日志
+    bool exceedsResourceLimits() const;
+    
+    // 心跳：只写入一个原子时间戳；首次心跳或错过后恢复时才通知观察者。
+    // submitTask 会自动发出心跳，单个任务执行时间超过监控器的心跳超时时，实现应在执行中自行调用
+    void heartbeat();
+    
+    // 最近一次心跳时间，从未发出心跳时为 time_point 的零值
+    std::chrono::steady_clock::time_point getLastHeartbeat() const {
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(lastHeartbeat_.load()));
+    }
+    
+    // 由监控器在心跳超时时调用，observed 为监控器上次看到的心跳时间：此后有过心跳返回 BEATING；
+    // 没有任务在执行时返回 IDLE（空闲不需要心跳）；否则标记为不健康并返回 MISSED。
+    // 后两种情况下解除登记，等待下次心跳重新登记
+    enum class HeartbeatCheck { BEATING, IDLE, MISSED };
+    HeartbeatCheck checkHeartbeat(std::chrono::steady_clock::time_point observed);
+    
+    // 设置状态观察者，nullptr 表示解除
+    void setStatusObserver(AgentStatusObserver* observer) { observer_.store(observer); }
+    
     // 获取状态字符串
     static std::string statusToString(AgentStatus status);
     static std::string typeToString(AgentType type);
 
 protected:
-    AgentConfig config_;
-    std::atomic<AgentStatus> status_{AgentStatus::UNKNOWN};
+    // 子类通过此方法切换状态，状态确有变化时通知观察者；返回是否发生变化
+    bool setStatus(AgentStatus status);
+    
+    // 覆盖 submitTask 的子类在提交与完成时调用：计入进行中的任务并发出心跳
+    void beginTask();
+    void endTask();
+    
+    // 当前配置。updateConfig 整体替换为新的不可变副本，读者取得快照后无需加锁
+    std::shared_ptr<const AgentConfig> configSnapshot() const { return std::atomic_load(&config_); }
+    
+    const std::string id_;                  // 智能体 ID，创建后不可修改
+    const StringInterner::Handle handle_;   // 智能体 ID 的驻留句柄
     std::atomic<bool> healthy_{true};
+
+private:
+    std::shared_ptr<const AgentConfig> config_;   // 只经 std::atomic_load / std::atomic_store 访问
+    std::mutex configMutex_;                      // 串行化 updateConfig
+    
+    friend class AgentManager;
+    
+    std::atomic<AgentStatus> status_{AgentStatus::UNKNOWN};
+    std::atomic<AgentStatusObserver*> observer_{nullptr};
+    
+    // submitTask 的执行入口：任务的输出流已打开时调用 executeTaskStreaming，否则调用 executeTask
+    std::shared_ptr<TaskResult> runTask(const Task& task);
+    
+    struct Mailbox;
+    std::shared_ptr<Mailbox> mailbox_;   // 未启用邮箱时为空，执行线程共同持有
+    
+    std::atomic<std::chrono::steady_clock::rep> lastHeartbeat_{0};
+    std::atomic<bool> heartbeatArmed_{false};   // 是否已登记到监控器的截止时间表
+    std::atomic<size_t> activeTasks_{0};        // 已提交尚未完成的任务数
+    
+    // 在 AgentManager 状态桶与能力索引中的登记，由管理器的 statusMutex_ 保护
+    int statusBucket_{-1};      // 当前所在的桶，-1 表示不在任何桶中
+    uint32_t indexedMask_{0};   // 已加入的能力索引列表（第 i 位对应 TaskType i）
+    
+    // 能力位图（第 i 位对应 TaskType i）
+    static uint32_t capabilityMaskOf(const AgentConfig& config);
+    std::atomic<uint32_t> capabilityMask_{0};
 };
 
 // 智能体创建工厂
@@ -1,7 +1,15 @@
 #pragma once
 
 #include "Agent.h"
+#include "CheckpointStore.h"
+#include "../common/EpochManager.h"
+#include "../common/FlatHandleMap.h"
+#include "../common/RcuPtr.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <queue>
 #include <unordered_map>
 #include <thread>
 #include <vector>
@@ -9,14 +17,26 @@
 
 namespace openclaw {
 
+// 批量生命周期操作的结果
+struct LifecycleReport {
+    std::vector<std::string> succeeded;   // 在期限内到达目标状态
+    std::vector<std::string> failed;      // 操作返回后处于其他状态（如 ERROR）
+    std::vector<std::string> timedOut;    // 超过单个智能体的期限仍未完成
+    std::vector<std::string> skipped;     // 当前状态不适用该操作
+    std::chrono::milliseconds elapsed{0};
+    
+    bool allSucceeded() const { return failed.empty() && timedOut.empty(); }
+};
+
 // 智能体管理器
-class AgentManager {
+class AgentManager : private AgentStatusObserver {
 public:
     using AgentPtr = Agent::Ptr;
     using AgentStatusCallback = std::function<void(const std::string&, AgentStatus)>;
+    using HeartbeatListener = std::function<void(const AgentPtr&)>;
     
     AgentManager();
-    ~AgentManager() = default;
+    ~AgentManager() override;
     
     // 禁用拷贝
     AgentManager(const AgentManager&) = delete;
@@ -32,15 +52,79 @@ public:
     std::vector<AgentPtr> listAgentsByType(AgentType type) const;
     std::vector<AgentPtr> listAgentsByStatus(AgentStatus status) const;
     
+    // 无锁遍历：回调在读临界区内以 const AgentPtr& 调用，不复制 shared_ptr。
+    // 回调中不要长时间阻塞（会推迟旧快照回收），需要长期持有时自行复制指针
+    template <typename Fn>
+    void forEachAgent(Fn&& fn) const {
+        EpochManager::Guard guard;
+        registry_.load()->forEach(fn);
+    }
+    
+    // 按状态遍历，只访问该状态桶中的智能体（O(结果数)）。
+    // 无锁读取索引快照，回调在读临界区内执行；回调中改变智能体状态不影响本次遍历
+    template <typename Fn>
+    void forEachAgentWithStatus(AgentStatus status, Fn&& fn) const {
+        size_t bucket = static_cast<size_t>(status);
+        if (bucket >= kStatusCount) {
+            return;
+        }
+        EpochManager::Guard guard;
+        for (Agent* agent : *index_.load()->byStatus[bucket]) {
+            fn(*agent);
+        }
+    }
+    
+    // 按任务类型遍历当前可接收任务（RUNNING 或 HIBERNATED）且具备该能力的智能体，
+    // 直接读取能力索引，开销只与结果数有关。回调约束同 forEachAgentWithStatus
+    template <typename Fn>
+    void forEachAgentForTaskType(TaskType type, Fn&& fn) const {
+        size_t index = static_cast<size_t>(type);
+        if (index >= kTaskTypeCount) {
+            return;
+        }
+        EpochManager::Guard guard;
+        for (Agent* agent : *index_.load()->byTaskType[index]) {
+            fn(*agent);
+        }
+    }
+    size_t getAgentCountForTaskType(TaskType type) const;
+    
+    // 已登记（不论状态）且具备该能力的智能体数，遍历整个注册表
+    size_t getRegisteredAgentCountForTaskType(TaskType type) const;
+    
+    // 当前可接收任务的智能体是否都能执行该类型的任务（此时调度器无需按能力过滤）
+    bool allReadyAgentsCanExecute(TaskType type) const;
+    
+    // 无锁查找：找到时在读临界区内调用回调，返回是否找到
+    template <typename Fn>
+    bool withAgent(const std::string& agentId, Fn&& fn) const {
+        auto handle = StringInterner::getInstance().find(agentId);
+        EpochManager::Guard guard;
+        const AgentPtr* agent = registry_.load()->find(handle);
+        if (!agent) {
+            return false;
+        }
+        fn(*agent);
+        return true;
+    }
+    
     // 智能体状态管理
     AgentStatus getAgentStatus(const std::string& agentId);
     bool updateAgentConfig(const std::string& agentId, const AgentConfig& config);
     
-    // 批量操作
-    void startAllAgents();
-    void stopAllAgents();
-    void pauseAllAgents();
-    void resumeAllAgents();
+    // 批量操作：在至多 parallelism 个工作线程上并行执行（0 表示默认值），
+    // 每个智能体从开始执行起有 deadline 的期限；超时的调用不会被中断，但不再等待它
+    static constexpr std::chrono::milliseconds kDefaultLifecycleDeadline{30000};
+    static constexpr size_t kDefaultLifecycleParallelism = 16;
+    
+    LifecycleReport startAllAgents(std::chrono::milliseconds deadline = kDefaultLifecycleDeadline,
+                                   size_t parallelism = 0);
+    LifecycleReport stopAllAgents(std::chrono::milliseconds deadline = kDefaultLifecycleDeadline,
+                                  size_t parallelism = 0);
+    LifecycleReport pauseAllAgents(std::chrono::milliseconds deadline = kDefaultLifecycleDeadline,
+                                   size_t parallelism = 0);
+    LifecycleReport resumeAllAgents(std::chrono::milliseconds deadline = kDefaultLifecycleDeadline,
+                                    size_t parallelism = 0);
     
     // 监控与统计
     size_t getAgentCount() const;
@@ -53,26 +137,160 @@ public:
     // 状态变更回调
     void setStatusCallback(AgentStatusCallback callback);
     
+    // 心跳登记回调：受管智能体首次（或错过后重新）发出心跳时调用，供 AgentMonitor 登记截止时间。
+    // 回调在 statusMutex_ 内执行，设置为空后保证不再有进行中的调用
+    void setHeartbeatListener(HeartbeatListener listener);
+    
     // 清理已停止的智能体
     size_t cleanupStoppedAgents();
+    
+    // 延迟构造的智能体（AgentConfig::lazy）空闲超过该时长后休眠，0 表示不自动休眠。
+    // 由 AgentMonitor 的监控线程按期执行
+    void setHibernateAfter(std::chrono::milliseconds idle);
+    std::chrono::milliseconds getHibernateAfter() const;
+    
+    // 休眠所有空闲至少 idle 的延迟智能体，返回休眠的个数
+    size_t hibernateIdleAgents(std::chrono::milliseconds idle);
+    
+    // 检查点：经 Agent::checkpoint 导出状态，由 CheckpointStore 写入目录（首次完整，之后增量）。
+    // 智能体只在导出期间参与，编码与写盘都在调用线程完成；未设置目录时检查点操作返回 false
+    void setCheckpointDirectory(const std::string& directory);
+    std::string getCheckpointDirectory() const;
+    bool checkpointAgent(const std::string& agentId);
+    size_t checkpointAllAgents();
+    
+    // 用最近的检查点恢复智能体状态（如迁移或重启后重新创建了同 ID 的智能体）
+    bool restoreAgent(const std::string& agentId);
+    
+    // 导出状态超过该时长时记录警告
+    static constexpr std::chrono::milliseconds kCheckpointPauseBudget{5};
 
 private:
-    mutable std::mutex agentsMutex_;
-    std::unordered_map<std::string, AgentPtr> agents_;
-    AgentStatusCallback statusCallback_;
+    // 不可变的注册表快照。读者经 RcuPtr 无锁读取；写者在 agentsMutex_ 下生成新快照后整体替换。
+    // 快照分两层：多个快照共享的基础层，加上此后增删的增量层。写入只复制增量层，
+    // 增量层超过基础层大小的平方根时才合并成新的基础层，单次写入均摊 O(√n)
+    struct Registry {
+        struct Base {
+            FlatHandleMap<AgentPtr> byHandle;   // 以智能体 ID 的驻留句柄为键
+            std::vector<AgentPtr> agents;       // 按创建顺序，供遍历
+        };
+        std::shared_ptr<const Base> base{std::make_shared<Base>()};
+        FlatHandleMap<AgentPtr> added;      // 基础层之后新增的智能体
+        std::vector<AgentPtr> addedOrder;   // 同上，按创建顺序
+        FlatHandleSet removed;              // 基础层中已删除的智能体
+        size_t count{0};
+        
+        const AgentPtr* find(StringInterner::Handle handle) const {
+            if (const AgentPtr* agent = added.find(handle)) {
+                return agent;
+            }
+            if (!removed.empty() && removed.contains(handle)) {
+                return nullptr;
+            }
+            return base->byHandle.find(handle);
+        }
+        
+        template <typename Fn>
+        void forEach(Fn&& fn) const {
+            for (const auto& agent : base->agents) {
+                if (removed.empty() || !removed.contains(agent->getHandle())) {
+                    fn(agent);
+                }
+            }
+            for (const auto& agent : addedOrder) {
+                fn(agent);
+            }
+        }
+        
+        // 返回加入 / 移除一个智能体后的新快照
+        Registry* inserted(const AgentPtr& agent) const;
+        Registry* erased(StringInterner::Handle handle) const;
+        
+        // 只含满足条件的智能体的新快照，直接合并为基础层
+        template <typename Predicate>
+        Registry* filtered(Predicate keep) const {
+            auto base = std::make_shared<Base>();
+            base->byHandle.reserve(count);
+            base->agents.reserve(count);
+            forEach([&](const AgentPtr& agent) {
+                if (keep(agent)) {
+                    base->byHandle.emplace(agent->getHandle(), agent);
+                    base->agents.push_back(agent);
+                }
+            });
+            auto* next = new Registry();
+            next->count = base->agents.size();
+            next->base = std::move(base);
+            return next;
+        }
+        
+        void compactIfNeeded();
+    };
+    
+    LifecycleReport runLifecycle(const std::string& operation,
+                                 const std::function<bool(AgentStatus)>& eligible,
+                                 const std::function<void(Agent&)>& action,
+                                 AgentStatus target,
+                                 std::chrono::milliseconds deadline,
+                                 size_t parallelism);
+    
+    static constexpr size_t kStatusCount = static_cast<size_t>(AgentStatus::HIBERNATED) + 1;
+    
+    // 状态桶与能力索引（任务类型 -> 可接收任务且具备该能力的智能体）的不可变快照。
+    // 各列表由多个快照共享，写者在 statusMutex_ 下只复制变化的列表后整体发布；
+    // 列表中的智能体由注册表持有，从索引移除先于从注册表移除，读临界区内指针始终有效
+    struct AgentIndex {
+        using List = std::vector<Agent*>;
+        std::array<std::shared_ptr<const List>, kStatusCount> byStatus;
+        std::array<std::shared_ptr<const List>, kTaskTypeCount> byTaskType;
+        
+        AgentIndex();
+    };
+    
+    void onAgentStatusChanged(Agent& agent, AgentStatus oldStatus, AgentStatus newStatus) override;
+    void onAgentHeartbeatStarted(Agent& agent) override;
+    void track(Agent& agent);
+    void untrack(Agent& agent);
+    
+    // 把智能体移出原有的桶与能力列表，keep 时按当前状态与能力重新加入，然后发布新索引。
+    // 调用方持有 statusMutex_；旧快照由调用方在释放锁后回收
+    void reindex(Agent& agent, bool keep);
+    
+    mutable std::mutex agentsMutex_;   // 只串行化写者
+    RcuPtr<Registry> registry_;
+    
+    mutable std::mutex statusMutex_;   // 串行化索引写者
+    RcuPtr<AgentIndex> index_;
+    
+    AgentStatusCallback statusCallback_;   // 由 statusMutex_ 保护
+    HeartbeatListener heartbeatListener_;  // 由 statusMutex_ 保护
+    std::atomic<std::chrono::milliseconds::rep> hibernateAfter_{0};
+    
+    mutable std::mutex checkpointMutex_;
+    std::shared_ptr<CheckpointStore> checkpointStore_;   // 由 checkpointMutex_ 保护，替换后进行中的操作仍持有旧实例
+    std::shared_ptr<CheckpointStore> getCheckpointStore() const;
     
     // 通知状态变更
     void notifyStatusChange(const std::string& agentId, AgentStatus oldStatus, AgentStatus newStatus);
 };
 
-// 智能体监控器
+// 智能体监控器：按间隔扫描不健康的智能体，并基于心跳检测停顿的智能体。
+// 发出过心跳的智能体按截止时间（最近心跳 + 超时）放入最小堆，监控线程只在最早的截止时间
+// 或下一次扫描时醒来；到期时若心跳已更新则顺延，有任务在执行却没有心跳则判定为错过心跳。
+// 停止监控立即生效。
 class AgentMonitor {
 public:
     AgentMonitor(AgentManager& manager);
     ~AgentMonitor();
     
+    // 每 intervalSeconds 秒扫描一次不健康的智能体
     void startMonitoring(size_t intervalSeconds);
     void stopMonitoring();
+    
+    // 心跳超时（默认 60 秒）：执行任务的智能体超过该时间没有新心跳即视为不健康。
+    // 在 startMonitoring 之前设置
+    void setHeartbeatTimeout(std::chrono::milliseconds timeout);
+    std::chrono::milliseconds getHeartbeatTimeout() const;
     bool isMonitoring() const;
     
     // 获取监控统计
@@ -82,16 +300,40 @@ public:
         size_t stoppedAgents;
         size_t errorAgents;
         size_t unhealthyAgents;
+        size_t missedHeartbeats;   // 累计检测到的心跳超时次数
+        size_t overLimitAgents;    // 实测资源超过 resourceLimits 的智能体数
     };
     MonitorStats getStats() const;
 
 private:
+    struct Deadline {
+        std::chrono::steady_clock::time_point due;
+        std::chrono::steady_clock::time_point observed;   // 登记时看到的心跳时间
+        std::weak_ptr<Agent> agent;
+        StringInterner::Handle handle;
+        
+        bool operator>(const Deadline& other) const { return due > other.due; }
+    };
+    
+    void arm(const Agent::Ptr& agent);    // 调用方持有 mutex_
+    void monitorLoop();
+    void scanUnhealthyAgents();
+    
+    // 到期时执行休眠扫描，返回下一次扫描时间；未启用休眠时返回 time_point::max()
+    std::chrono::steady_clock::time_point sweepIdleAgents(std::unique_lock<std::mutex>& lock,
+                                                          std::chrono::steady_clock::time_point nextSweep);
+    
     AgentManager& manager_;
     std::atomic<bool> monitoring_{false};
     std::thread monitorThread_; // 添加线程支持
-    size_t intervalSeconds_{60};
+    std::chrono::seconds scanInterval_{60};
+    std::chrono::milliseconds heartbeatTimeout_{60000};
     
-    void monitorLoop();
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;
+    FlatHandleSet armed_;   // 已在堆中的智能体，避免重复登记
+    std::atomic<size_t> missedHeartbeats_{0};
 };
 
 } // namespace openclaw
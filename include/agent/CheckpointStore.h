@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace openclaw {
+
+// 智能体检查点存储。
+// 每个智能体一个文件 <directory>/<agentId>.ckpt，文件头之后是若干帧：首帧为完整状态，
+// 其后为增量帧，只记录与上一次相比内容变化的定长块。每帧带长度前缀和校验和，恢复时
+// 依次应用，遇到写了一半的尾帧即停止并使用此前的状态。增量链过长或增量超过完整状态
+// 一半时，先写临时文件再原子替换为单个完整帧。
+// 不同智能体的保存可以并行，同一智能体的保存串行执行。
+class CheckpointStore {
+public:
+    static constexpr size_t kBlockSize = 4096;
+    static constexpr size_t kMaxDeltaChain = 16;
+
+    explicit CheckpointStore(std::string directory);
+
+    CheckpointStore(const CheckpointStore&) = delete;
+    CheckpointStore& operator=(const CheckpointStore&) = delete;
+
+    const std::string& getDirectory() const { return directory_; }
+
+    // 保存一份状态，能写增量时只追加变化的块
+    bool save(const std::string& agentId, const std::string& state);
+
+    // 读取最近一次完整保存的状态，没有检查点或文件头损坏时返回 false
+    bool load(const std::string& agentId, std::string& state);
+
+    // 删除智能体的检查点
+    bool remove(const std::string& agentId);
+
+    struct Stats {
+        size_t fullCheckpoints{0};
+        size_t deltaCheckpoints{0};
+        size_t bytesWritten{0};
+    };
+    Stats getStats() const;
+
+private:
+    // 每个智能体上一次保存的状态摘要：只保留各块的散列，用于找出变化的块
+    struct Entry {
+        std::mutex mutex;
+        std::vector<uint64_t> blocks;   // 每 kBlockSize 字节一个散列
+        size_t size{0};                 // 上一次保存的状态长度
+        uint64_t sequence{0};
+        size_t chain{0};       // 最近完整帧之后的增量帧数
+        bool known{false};     // 摘要是否与文件内容一致，否则下次写完整帧
+    };
+
+    std::shared_ptr<Entry> entryFor(const std::string& agentId);
+    std::string pathFor(const std::string& agentId) const;
+
+    bool writeFull(const std::string& path, Entry& entry, const std::string& state, std::vector<uint64_t>& blocks);
+    bool appendDelta(const std::string& path, Entry& entry, const std::string& frame, size_t size,
+                     std::vector<uint64_t>& blocks);
+
+    const std::string directory_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+    Stats stats_;   // 由 mutex_ 保护
+};
+
+} // namespace openclaw
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Agent.h"
+#include <condition_variable>
+#include <mutex>
+
+namespace openclaw {
+
+// 延迟构造的智能体代理。
+// 登记时只保存配置，启动后处于 HIBERNATED 状态、不占用实际智能体的内存；
+// 首个任务到达时通过 AgentFactory 构造真实智能体并转交任务。空闲超过期限后可以休眠：
+// 保存状态、释放真实智能体，下一个任务到达时再透明地恢复。
+class LazyAgent : public Agent {
+public:
+    explicit LazyAgent(const AgentConfig& config);
+    ~LazyAgent() override;
+
+    void start() override;
+    void stop() override;
+    void pause() override;
+    void resume() override;
+
+    std::shared_ptr<TaskResult> executeTask(const Task& task) override;
+    std::shared_ptr<TaskResult> executeTaskStreaming(const Task& task, const std::shared_ptr<TokenStream>& stream) override;
+    void submitTask(const std::shared_ptr<Task>& task, TaskCompletion done) override;
+    size_t getQueueDepth() const override;
+    size_t getConcurrency() const override;
+
+    // 已驻留时转交真实智能体，休眠时读写保存的状态，不会因检查点而构造真实智能体
+    bool checkpoint(std::ostream& out) const override;
+    bool restore(std::istream& in) override;
+
+    // 真实智能体是否已驻留
+    bool isMaterialized() const;
+
+    // 没有执行中的任务且已空闲至少 idleFor 时休眠，返回是否休眠；
+    // 真实智能体不支持休眠（见 Agent::supportsHibernation）时始终返回 false
+    bool hibernate(std::chrono::milliseconds idleFor = std::chrono::milliseconds(0));
+
+    // 距最近一次任务完成（或启动）的时长
+    std::chrono::milliseconds idleTime() const;
+
+private:
+    // 构造或恢复真实智能体后在其上执行 run，期间计入执行中的任务
+    std::shared_ptr<TaskResult> runOnInner(const std::function<std::shared_ptr<TaskResult>(Agent&)>& run);
+
+    // 返回真实智能体，未驻留时构造或恢复；构造与启动在锁外进行，
+    // 同时到达的调用等待同一次构造。成功时计入一个执行中的任务
+    Agent::Ptr acquireInner();
+    
+    // 等待进行中的构造结束，调用方持有 lock
+    void waitForMaterialize(std::unique_lock<std::mutex>& lock) const;
+    
+    // 通过 AgentFactory 构造真实智能体、还原 state 并启动，不持有 mutex_
+    Agent::Ptr materialize(const std::string& state);
+    
+    // 按是否驻留在 RUNNING / HIBERNATED 之间同步状态；fromStopped 为 true 时也适用于其他状态（启动、恢复）
+    void syncStatus(bool fromStopped);
+    void touch();
+
+    const bool useMailbox_;   // 真实智能体是否启用邮箱
+    
+    mutable std::mutex mutex_;
+    mutable std::condition_variable materialized_;
+    Agent::Ptr inner_;        // 未驻留时为空
+    std::string state_;       // 休眠时保存的状态
+    size_t inFlight_{0};      // 执行中的任务数，由 mutex_ 保护
+    bool materializing_{false};   // 是否有线程正在锁外构造真实智能体
+    std::atomic<std::chrono::steady_clock::rep> lastActive_{0};
+};
+
+} // namespace openclaw
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Agent.h"
+#include "../model/ModelGateway.h"
+
+namespace openclaw {
+
+// 由模型执行任务的智能体：提示词取任务参数 prompt，缺省时为任务描述；模型取配置属性 model
+// （省略时使用网关的默认提供方），系统提示词取属性 system，属性 subagent 为 "true" 时占用子智能体额度。
+// 完整回复放在结果的 output["text"]；流式执行时经 ModelGateway::stream 边生成边写出
+class ModelAgent : public Agent {
+public:
+    explicit ModelAgent(const AgentConfig& config, ModelGateway& gateway = ModelGateway::getInstance());
+
+    std::shared_ptr<TaskResult> executeTask(const Task& task) override;
+    std::shared_ptr<TaskResult> executeTaskStreaming(const Task& task, const std::shared_ptr<TokenStream>& stream) override;
+
+private:
+    ModelRequest buildRequest(const Task& task) const;
+    static std::shared_ptr<TaskResult> toResult(const ModelResponse& response);
+
+    ModelGateway& gateway_;
+};
+
+} // namespace openclaw
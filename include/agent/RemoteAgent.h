@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Agent.h"
+#include "../common/ShmRing.h"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace openclaw {
+
+// 在子进程中运行的智能体代理（AgentConfig::outOfProcess）。
+// start 时用 posix_spawn 重新执行宿主程序（默认为当前程序），宿主程序在 main 开头调用 serveIfHost，
+// 据继承的共享内存构造真实智能体并进入服务循环；父子之间用共享内存中的一对 ShmRing 传递请求和结果。
+// 子进程不继承父进程的线程与锁状态，因此不会卡在 fork 时被其他线程持有的锁上。
+// 子进程崩溃、心跳停止超过 kHangTimeout 或任务超过 timeoutSeconds 时，未完成的任务以失败结果回调，
+// 随后自动重新派生；连续失败超过 kMaxConsecutiveCrashes 次则进入 ERROR 状态。
+class RemoteAgent : public Agent {
+public:
+    explicit RemoteAgent(const AgentConfig& config);
+    ~RemoteAgent() override;
+
+    void start() override;
+    void stop() override;
+    void pause() override;
+    void resume() override;
+
+    // 同步执行：投递后等待子进程返回结果
+    std::shared_ptr<TaskResult> executeTask(const Task& task) override;
+    void submitTask(const std::shared_ptr<Task>& task, TaskCompletion done) override;
+    size_t getQueueDepth() const override;
+
+    // 宿主入口：当前进程由 RemoteAgent 派生时构造智能体并进入服务循环，不再返回；否则立即返回 false。
+    // 需要在子进程中构造的智能体类型应在调用前登记到 AgentFactory
+    static bool serveIfHost();
+
+    // 当前进程是否由 RemoteAgent 派生（据环境变量判断，serveIfHost 之前可用于登记智能体类型）
+    static bool isHostProcess();
+
+    // 子进程执行的宿主程序，默认 /proc/self/exe
+    static void setHostExecutable(const std::string& path);
+
+    // 当前子进程的 pid，未运行时为 -1
+    int getPid() const { return pid_.load(); }
+
+    // 子进程崩溃后重新派生的次数
+    size_t getRestartCount() const { return restarts_.load(); }
+
+    static constexpr size_t kRingCapacity = size_t(1) << 20;
+    static constexpr size_t kMaxConsecutiveCrashes = 5;
+    static constexpr std::chrono::milliseconds kHeartbeatInterval{100};
+    static constexpr std::chrono::milliseconds kHangTimeout{3000};       // 心跳停止多久视为卡死
+    static constexpr std::chrono::milliseconds kStartupTimeout{5000};    // 等待子进程就绪的时长
+
+private:
+    struct Channel;
+    struct Pending {
+        TaskCompletion done;
+        std::chrono::steady_clock::time_point deadline;   // time_point::max() 表示不限时
+    };
+
+    // 派生子进程，调用方持有 sendMutex_
+    bool spawn();
+    // 结束子进程并回收，调用方持有 sendMutex_
+    void terminate();
+
+    bool send(uint64_t id, const Task& task, TaskCompletion done);
+    void readerLoop();
+    // 检查心跳与任务期限，结束了子进程时返回 true（超时任务移入 expired），调用方随后按崩溃处理
+    bool checkLiveness(std::vector<TaskCompletion>& expired);
+    // 替换子进程后回调未完成的任务：expired 以超时失败，其余以崩溃失败
+    void handleCrash(std::vector<TaskCompletion> expired);
+    void failPending(const std::string& reason);
+
+    mutable std::mutex sendMutex_;   // 串行化请求环的生产者，保护 channel_ 与子进程的替换
+    std::shared_ptr<Channel> channel_;   // 发送方持有引用，等待期间通道被替换也不会被释放
+    std::atomic<int> pid_{-1};
+
+    mutable std::mutex pendingMutex_;
+    std::unordered_map<uint64_t, Pending> pending_;
+    std::atomic<uint64_t> nextRequest_{1};
+
+    std::mutex lifecycleMutex_;      // 串行化 start/stop
+    std::thread reader_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> restarts_{0};
+    size_t consecutiveCrashes_{0};   // 仅读取线程访问
+};
+
+} // namespace openclaw
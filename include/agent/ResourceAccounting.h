@@ -0,0 +1,119 @@
+#pragma once
+
+#include "../common/StringInterner.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace openclaw {
+
+// 某个智能体的资源使用快照
+struct ResourceUsage {
+    std::chrono::nanoseconds cpuTime{0};   // 累计 CPU 时间
+    double cpuPercent{0.0};                // 最近窗口内的 CPU 利用率，100 表示占满一个核
+    int64_t memoryBytes{0};                // 登记在该智能体名下、尚未释放的内存（见 chargeMemory）
+    int64_t peakMemoryBytes{0};
+    uint64_t allocations{0};               // 累计登记次数
+
+    double memoryMB() const { return static_cast<double>(memoryBytes) / (1024.0 * 1024.0); }
+};
+
+// 按智能体（以 ID 的驻留句柄为键）统计实际资源消耗。
+// CPU：在执行任务的线程上用 CLOCK_THREAD_CPUTIME_ID 计量 Scope 内消耗的 CPU 时间，
+// 嵌套的其他智能体的 Scope 所用时间不重复计入外层。
+// 内存：按需登记。智能体自己持有的大块数据（上下文、缓存等）用 AccountedAllocator 分配，
+// 或直接调用 chargeMemory / releaseMemory；其余分配不计入，不给全局分配增加开销。
+// 利用率是按时间指数衰减的 CPU 时间除以窗口长度，空闲后自然回落，不需要采样线程。
+class ResourceAccounting {
+public:
+    static ResourceAccounting& getInstance();
+
+    // 作用域内当前线程的 CPU 时间记到 handle 名下；同一句柄嵌套时只有最外层计量
+    class Scope {
+    public:
+        explicit Scope(StringInterner::Handle handle);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StringInterner::Handle handle_;
+        StringInterner::Handle previous_;
+        int64_t previousNested_{0};
+        int64_t cpuStart_{0};
+        bool active_{false};
+    };
+
+    ResourceUsage getUsage(StringInterner::Handle handle) const;
+
+    // 登记 / 扣除 handle 名下的内存，两者须成对且字节数一致
+    void chargeMemory(StringInterner::Handle handle, size_t bytes);
+    void releaseMemory(StringInterner::Handle handle, size_t bytes);
+
+    // 记录超限标记，返回标记是否发生变化（用于只在越界/恢复时记录一次）
+    bool setOverLimit(StringInterner::Handle handle, bool over);
+
+    // 利用率窗口（指数衰减的时间常数），默认 10 秒
+    void setUtilizationWindow(std::chrono::milliseconds window);
+    std::chrono::milliseconds getUtilizationWindow() const;
+
+    // 当前线程已消耗的 CPU 时间（纳秒）
+    static int64_t threadCpuNanos();
+
+    // 当前线程所在 Scope 的句柄，不在任何 Scope 中时为 kInvalidHandle
+    static StringInterner::Handle currentAccount();
+
+private:
+    ResourceAccounting() = default;
+
+    ResourceAccounting(const ResourceAccounting&) = delete;
+    ResourceAccounting& operator=(const ResourceAccounting&) = delete;
+
+    void chargeCpu(StringInterner::Handle handle, int64_t nanos);
+
+    std::atomic<int64_t> windowNanos_{10'000'000'000};
+};
+
+// 计入智能体内存统计的分配器。构造时绑定句柄（默认取当前线程所在 Scope），分配与释放都记在
+// 该句柄名下，与在哪个线程释放无关。只用于智能体自己长期持有的数据；交给调用方的结果不应使用，
+// 否则会一直记在智能体名下
+template <typename T>
+class AccountedAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    AccountedAllocator() noexcept : handle_(ResourceAccounting::currentAccount()) {}
+    explicit AccountedAllocator(StringInterner::Handle handle) noexcept : handle_(handle) {}
+    template <typename U>
+    AccountedAllocator(const AccountedAllocator<U>& other) noexcept : handle_(other.handle()) {}
+
+    T* allocate(size_t count) {
+        T* pointer = std::allocator<T>().allocate(count);
+        ResourceAccounting::getInstance().chargeMemory(handle_, count * sizeof(T));
+        return pointer;
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        ResourceAccounting::getInstance().releaseMemory(handle_, count * sizeof(T));
+        std::allocator<T>().deallocate(pointer, count);
+    }
+
+    StringInterner::Handle handle() const noexcept { return handle_; }
+
+    template <typename U>
+    bool operator==(const AccountedAllocator<U>& other) const noexcept { return handle_ == other.handle(); }
+    template <typename U>
+    bool operator!=(const AccountedAllocator<U>& other) const noexcept { return handle_ != other.handle(); }
+
+private:
+    StringInterner::Handle handle_;
+};
+
+} // namespace openclaw
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace openclaw {
+
+struct WorkspaceCacheOptions {
+    size_t maxBytes{256u << 20};   // 缓存中映射的文件总字节数上限，超出时按 LRU 淘汰
+    bool watch{true};              // 为 false 时不启动 inotify 监视，只能手动 invalidate
+};
+
+// 智能体工作区文件缓存，多个智能体共享：
+//   - 文件以只读 mmap 映射，读取得到指向映射的 string_view，不拷贝内容
+//   - 映射时计算内容散列（FNV-1a），可用于判断内容是否变化或去重
+//   - addWorkspace 时递归建立目录树索引（有序的文件路径集合），listFiles 按目录前缀查询
+//   - 后台线程读取 inotify 事件：文件被修改、删除、移动时使缓存失效，新建目录自动加入监视
+// 未变化文件的重复读取只是一次散列表查找。
+//
+// View 持有映射的引用，淘汰或失效只是从缓存中移除，已取得的 View 仍然有效。
+// 文件被原地截断时访问旧映射可能触发 SIGBUS；智能体写文件应先写临时文件再 rename。
+class WorkspaceCache {
+public:
+    static WorkspaceCache& getInstance();
+
+    explicit WorkspaceCache(const WorkspaceCacheOptions& options = WorkspaceCacheOptions());
+    ~WorkspaceCache();
+
+    WorkspaceCache(const WorkspaceCache&) = delete;
+    WorkspaceCache& operator=(const WorkspaceCache&) = delete;
+
+    class Mapping;
+
+    class View {
+    public:
+        View() = default;
+
+        explicit operator bool() const { return mapping_ != nullptr; }
+        std::string_view data() const;
+        uint64_t hash() const;
+        const std::string& path() const;
+
+    private:
+        friend class WorkspaceCache;
+        explicit View(std::shared_ptr<const Mapping> mapping) : mapping_(std::move(mapping)) {}
+
+        std::shared_ptr<const Mapping> mapping_;
+    };
+
+    // 登记工作区根目录：建立索引并（启用监视时）监视其下所有目录；重复登记返回 true
+    bool addWorkspace(const std::string& root);
+    void removeWorkspace(const std::string& root);
+
+    // 读取文件，path 可以是相对当前目录的路径；文件不存在或无法映射时返回空 View
+    View read(const std::string& path);
+
+    // 目录 dir 下（递归）已索引的文件，按路径排序
+    std::vector<std::string> listFiles(const std::string& dir) const;
+
+    // 手动使某个文件失效（未启用监视或在监视线程处理事件之前需要立即生效时）
+    void invalidate(const std::string& path);
+
+    // 每处理一批 inotify 事件加一，可用于等待失效生效
+    uint64_t getEventGeneration() const { return eventGeneration_.load(); }
+
+    struct Stats {
+        size_t hits{0};
+        size_t misses{0};
+        size_t invalidations{0};
+        size_t evictions{0};
+        size_t cachedFiles{0};
+        size_t cachedBytes{0};
+        size_t indexedFiles{0};
+        size_t watchedDirectories{0};
+    };
+    Stats getStats() const;
+
+    static std::string normalizePath(const std::string& path);
+
+private:
+    struct Entry {
+        std::shared_ptr<const Mapping> mapping;
+        std::list<std::string>::iterator lru;
+    };
+
+    void indexDirectory(const std::string& dir);
+    void dropLocked(const std::string& path);
+    void watchLoop();
+    void handleEvents(const char* buffer, size_t length);
+
+    const WorkspaceCacheOptions options_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;                  // 最近使用的在前
+    size_t cachedBytes_{0};
+    std::set<std::string> roots_;
+    std::set<std::string> files_;                 // 目录树索引
+    std::unordered_map<int, std::string> watches_;   // inotify 监视描述符 -> 目录
+    size_t hits_{0};
+    size_t misses_{0};
+    size_t invalidations_{0};                     // 因文件变化而移出缓存的条目数
+    size_t evictions_{0};
+    uint64_t generation_{0};                      // 每次失效加一，包括未缓存的路径
+
+    int inotifyFd_{-1};
+    int wakeupPipe_[2]{-1, -1};
+    std::thread watcher_;
+    std::atomic<uint64_t> eventGeneration_{0};
+};
+
+} // namespace openclaw
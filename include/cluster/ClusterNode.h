@@ -0,0 +1,148 @@
+#pragma once
+
+#include "../task/TaskScheduler.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+namespace openclaw {
+
+// 集群节点配置
+struct ClusterConfig {
+    std::string host{"127.0.0.1"};
+    uint16_t port{0};                              // 0 表示由系统分配
+    std::vector<std::string> seeds;                // 种子节点 "host:port"
+    std::chrono::milliseconds heartbeatInterval{500};
+    std::chrono::milliseconds failureTimeout{2000};
+    size_t stealBatchSize{16};                     // 单次最多窃取的任务数
+    size_t stealThreshold{4};                      // 对端积压达到该值才窃取
+
+    // 从 ConfigManager 读取：cluster_host、cluster_port、cluster_seeds（逗号分隔）、
+    // cluster_heartbeat_interval、cluster_failure_timeout（毫秒）、cluster_steal_batch、cluster_steal_threshold
+    static ClusterConfig fromConfig();
+};
+
+// 分布式调度节点：每个节点包装一个本地 TaskScheduler，按任务 ID（或 partitionKey 参数）
+// 的哈希分区决定归属节点并转发提交；空闲节点从繁忙节点窃取就绪任务。
+// 成员关系通过 TCP 心跳 gossip 维护，只需种子地址，无需外部协调者。
+//
+// 窃取的任务由窃取方确认后才算移交，未确认的任务放回原节点（确认丢失时可能重复执行，不会丢失）。
+// 依赖关系只在单个节点内解析，同一 DAG 中的任务应使用相同的 partitionKey；被依赖的任务不会被窃取，
+// 已迁出的任务在原节点上视为未知，之后依赖它的任务会被拒绝而不是挂起。
+class ClusterNode {
+public:
+    struct Member {
+        std::string nodeId;                        // "host:port"
+        std::string host;
+        uint16_t port{0};
+        size_t pendingTasks{0};
+        size_t availableAgents{0};
+        std::chrono::steady_clock::time_point lastSeen;
+    };
+
+    struct ClusterStats {
+        size_t forwardedTasks{0};                  // 转发给其他节点的任务
+        size_t receivedTasks{0};                   // 其他节点转发来的任务
+        size_t stolenTasks{0};                     // 从其他节点窃取的任务
+        size_t givenTasks{0};                      // 被其他节点窃取的任务
+    };
+
+    ClusterNode(TaskScheduler& scheduler, const ClusterConfig& config);
+    ~ClusterNode();
+
+    // 禁用拷贝
+    ClusterNode(const ClusterNode&) = delete;
+    ClusterNode& operator=(const ClusterNode&) = delete;
+
+    // 生命周期
+    bool start();
+    void stop();
+    bool isRunning() const { return running_; }
+
+    // 节点信息（start 之后有效）
+    std::string getNodeId() const { return nodeId_; }
+    uint16_t getPort() const { return port_; }
+
+    // 提交任务：归属本节点时直接调度，否则转发；转发失败时退回本地调度
+    bool submitTask(const TaskConfig& config);
+
+    // 任务归属的节点 ID（基于当前存活成员视图的最高随机权重哈希）
+    std::string ownerOf(const TaskConfig& config) const;
+
+    // 存活成员（包含本节点），按节点 ID 排序
+    std::vector<Member> getMembers() const;
+
+    ClusterStats getStats() const;
+
+private:
+    enum class MessageType : uint8_t {
+        HEARTBEAT = 1,
+        MEMBERS,
+        SUBMIT,
+        ACK,
+        STEAL,
+        TASKS
+    };
+
+    TaskScheduler& scheduler_;
+    ClusterConfig config_;
+    std::string nodeId_;
+    uint16_t port_{0};
+    int listenFd_{-1};
+
+    std::atomic<bool> running_{false};
+    std::thread acceptThread_;
+    std::thread gossipThread_;
+    std::mutex stopMutex_;
+    std::condition_variable stopCv_;
+    size_t activeHandlers_{0};                     // 正在处理的连接数，由 stopMutex_ 保护
+
+    // 成员视图：只有直接通信成功过的节点才算成员，gossip 得知的地址先进入候选
+    mutable std::mutex membersMutex_;
+    std::unordered_map<std::string, Member> members_;
+    std::unordered_set<std::string> candidates_;
+
+    // 联系不上的候选与种子地址按指数退避重试，避免每轮都在失效地址上耗满连接超时
+    struct Backoff {
+        std::chrono::steady_clock::time_point nextAttempt;
+        std::chrono::milliseconds delay{0};
+    };
+    std::unordered_map<std::string, Backoff> unreachable_;
+
+    mutable std::mutex statsMutex_;
+    ClusterStats stats_;
+
+    // 线程主循环
+    void acceptLoop();
+    void gossipLoop();
+
+    // 协议处理（每个连接一个线程，慢连接不阻塞其他节点的心跳）
+    void handleConnection(int fd);
+    void handleSteal(int fd, const std::string& payload);
+    void encodeHeartbeat(std::string& payload) const;
+    void mergeHeartbeat(const std::string& payload);
+    bool request(const std::string& host, uint16_t port, MessageType type,
+                 const std::string& payload, MessageType expected, std::string& response) const;
+
+    // 向多个地址并发发送同一请求：非阻塞连接由单个 poll 循环推进，整体不超过单次请求的超时。
+    // reached[i] 表示 targets[i] 按期返回了 expected 类型的响应，此时 responses[i] 为其负载
+    void exchangeAll(const std::vector<std::string>& targets, MessageType type, const std::string& payload,
+                     MessageType expected, std::vector<std::string>& responses, std::vector<char>& reached) const;
+
+    // 周期任务
+    void gossipRound();
+    void trySteal();
+
+    void touchMember(const std::string& nodeId, size_t pendingTasks, size_t availableAgents);
+    std::vector<Member> liveMembers() const;
+    static bool parseAddress(const std::string& address, std::string& host, uint16_t& port);
+};
+
+} // namespace openclaw
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace openclaw {
+
+// 紧凑二进制编码：小端定长整数 + LEB128 变长整数 + 长度前缀字符串
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::string& out) : out_(out) {}
+
+    void writeU8(uint8_t value) { out_.push_back(static_cast<char>(value)); }
+
+    void writeU32(uint32_t value) {
+        char bytes[4];
+        for (int i = 0; i < 4; ++i) {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        out_.append(bytes, 4);
+    }
+
+    void writeU64(uint64_t value) {
+        char bytes[8];
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        out_.append(bytes, 8);
+    }
+
+    void writeVarint(uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<char>(value));
+    }
+
+    void writeDouble(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeU64(bits);
+    }
+
+    void writeString(const std::string& value) {
+        writeVarint(value.size());
+        out_.append(value);
+    }
+
+    void writeBytes(const char* data, size_t size) { out_.append(data, size); }
+
+    size_t size() const { return out_.size(); }
+
+private:
+    std::string& out_;
+};
+
+// 与 BinaryWriter 对应的读取器，所有读取都做越界检查，失败后保持失败状态
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size) : data_(data), size_(size) {}
+    explicit BinaryReader(const std::string& data) : data_(data.data()), size_(data.size()) {}
+
+    bool ok() const { return ok_; }
+    size_t position() const { return pos_; }
+    size_t remaining() const { return size_ - pos_; }
+    const char* current() const { return data_ + pos_; }
+
+    bool readU8(uint8_t& value) {
+        if (!require(1)) return false;
+        value = static_cast<uint8_t>(data_[pos_++]);
+        return true;
+    }
+
+    bool readU32(uint32_t& value) {
+        if (!require(4)) return false;
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(data_[pos_ + i])) << (8 * i);
+        }
+        pos_ += 4;
+        return true;
+    }
+
+    bool readU64(uint64_t& value) {
+        if (!require(8)) return false;
+        value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[pos_ + i])) << (8 * i);
+        }
+        pos_ += 8;
+        return true;
+    }
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!require(1)) return false;
+            uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        ok_ = false;
+        return false;
+    }
+
+    bool readDouble(double& value) {
+        uint64_t bits;
+        if (!readU64(bits)) return false;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        uint64_t length;
+        if (!readVarint(length) || !require(length)) return false;
+        value.assign(data_ + pos_, length);
+        pos_ += length;
+        return true;
+    }
+
+    bool skip(size_t count) {
+        if (!require(count)) return false;
+        pos_ += count;
+        return true;
+    }
+
+private:
+    bool require(uint64_t count) {
+        if (!ok_ || count > size_ - pos_) {
+            ok_ = false;
+            return false;
+        }
+        return true;
+    }
+
+    const char* data_;
+    size_t size_;
+    size_t pos_{0};
+    bool ok_{true};
+};
+
+} // namespace openclaw
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace openclaw {
+
+// 崩溃安全的整文件替换：写入 path.tmp 并 fsync，rename 覆盖 path，再 fsync 所在目录，
+// 使新内容与目录项都落盘。任一步失败时删除临时文件并返回 false，原文件保持不变
+bool writeFileDurably(const std::string& path, const char* data, size_t size);
+
+// fsync path 所在的目录，使其中的创建、重命名等目录项变更落盘
+bool syncParentDirectory(const std::string& path);
+
+} // namespace openclaw
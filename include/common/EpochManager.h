@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace openclaw {
+
+// 基于纪元的延迟回收（RCU 风格）。
+// 读者进入临界区时公布当前纪元，期间读取到的共享快照不会被释放；
+// 写者替换指针后把旧快照交给 retire，待所有可能看到它的读者离开后才执行回收。
+// 读路径只有两次原子存储，不加锁、不修改引用计数。
+class EpochManager {
+public:
+    static EpochManager& getInstance();
+
+    // 读临界区（可嵌套），作用域内读到的快照保持有效
+    class Guard {
+    public:
+        Guard();
+        ~Guard();
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    // 登记待回收对象；deleter 在没有读者可能引用它之后执行
+    void retire(std::function<void()> deleter);
+
+    // 执行已经安全的回收，返回回收数量
+    size_t reclaim();
+
+    // 等待当前所有读者离开后回收全部待回收对象（仅用于关闭与测试）
+    void synchronize();
+
+    size_t pendingCount() const;
+
+private:
+    EpochManager() = default;
+    ~EpochManager() = default;
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    // 每个读者线程占用一个缓存行对齐的槽位，0 表示不在临界区
+    static constexpr size_t kMaxReaders = 256;
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<bool> owned{false};
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        std::function<void()> deleter;
+    };
+
+    friend class Guard;
+    struct ThreadState;
+    static ThreadState& threadState();
+    ReaderSlot* acquireSlot();
+    void releaseSlot(ReaderSlot* slot);
+    void enter();
+    void leave();
+
+    // 所有活跃读者中最小的纪元；存在无槽位读者时返回 0（暂不回收）
+    uint64_t minActiveEpoch() const;
+
+    std::atomic<uint64_t> globalEpoch_{1};
+    std::array<ReaderSlot, kMaxReaders> slots_;
+    std::atomic<size_t> overflowReaders_{0};   // 槽位耗尽时的读者计数
+
+    mutable std::mutex retiredMutex_;
+    std::vector<Retired> retired_;
+};
+
+} // namespace openclaw
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace openclaw {
+
+// 把任意 ID 转为单个安全的文件名。字母、数字与 "-_." 保持原样，其余字节按 %XX（大写十六进制）转义；
+// 开头的 '.' 也转义，避免得到 "."、".." 或隐藏文件。
+// 转义结果写入了检查点与会话目录的文件名，修改规则会使已有文件无法按 ID 找到
+inline std::string escapeFileName(std::string_view id) {
+    static const char* hex = "0123456789ABCDEF";
+    std::string name;
+    name.reserve(id.size());
+    for (size_t i = 0; i < id.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(id[i]);
+        bool safe = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                    c == '-' || c == '_' || (c == '.' && i > 0);
+        if (safe) {
+            name.push_back(static_cast<char>(c));
+        } else {
+            name.push_back('%');
+            name.push_back(hex[c >> 4]);
+            name.push_back(hex[c & 0xF]);
+        }
+    }
+    return name;
+}
+
+// escapeFileName 的逆变换；不完整的 %XX 按原样保留
+inline std::string unescapeFileName(std::string_view name) {
+    auto digit = [](char c) -> int {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    };
+    std::string id;
+    id.reserve(name.size());
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (name[i] == '%' && i + 2 < name.size() && digit(name[i + 1]) >= 0 &&
+            digit(name[i + 2]) >= 0) {
+            id.push_back(static_cast<char>(digit(name[i + 1]) * 16 + digit(name[i + 2])));
+            i += 2;
+        } else {
+            id.push_back(name[i]);
+        }
+    }
+    return id;
+}
+
+} // namespace openclaw
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "StringInterner.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace openclaw {
+
+// 以驻留句柄为键的开放寻址哈希表（线性探测 + 删除时后移，无墓碑）。
+// 槽位连续存放，查找只做一次整数散列和少量相邻比较；句柄 0 表示空槽。
+// 不是线程安全的，由持有者的锁保护。
+template <typename V>
+class FlatHandleMap {
+public:
+    using Handle = StringInterner::Handle;
+    using value_type = std::pair<Handle, V>;
+
+    template <typename Slot, typename Owner>
+    class IteratorBase {
+    public:
+        IteratorBase(Owner* owner, size_t index) : owner_(owner), index_(index) { skipEmpty(); }
+
+        Slot& operator*() const { return owner_->slots_[index_]; }
+        Slot* operator->() const { return &owner_->slots_[index_]; }
+        IteratorBase& operator++() {
+            ++index_;
+            skipEmpty();
+            return *this;
+        }
+        bool operator==(const IteratorBase& other) const { return index_ == other.index_; }
+        bool operator!=(const IteratorBase& other) const { return index_ != other.index_; }
+
+    private:
+        void skipEmpty() {
+            while (index_ < owner_->slots_.size() && owner_->slots_[index_].first == StringInterner::kInvalidHandle) {
+                ++index_;
+            }
+        }
+
+        Owner* owner_;
+        size_t index_;
+    };
+    using iterator = IteratorBase<value_type, FlatHandleMap>;
+    using const_iterator = IteratorBase<const value_type, const FlatHandleMap>;
+
+    FlatHandleMap() = default;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, slots_.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, slots_.size()); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        slots_.clear();
+        size_ = 0;
+    }
+
+    void reserve(size_t count) {
+        size_t capacity = 16;
+        while (capacity * 3 < count * 4) {
+            capacity <<= 1;
+        }
+        if (capacity > slots_.size()) {
+            rehash(capacity);
+        }
+    }
+
+    V* find(Handle key) {
+        size_t index = locate(key);
+        return index == npos ? nullptr : &slots_[index].second;
+    }
+
+    const V* find(Handle key) const {
+        size_t index = locate(key);
+        return index == npos ? nullptr : &slots_[index].second;
+    }
+
+    bool contains(Handle key) const { return locate(key) != npos; }
+
+    // 键不存在时插入，返回值的指针以及是否发生了插入
+    std::pair<V*, bool> emplace(Handle key, V value) {
+        if (key == StringInterner::kInvalidHandle) {
+            return {nullptr, false};
+        }
+        growIfNeeded();
+
+        size_t mask = slots_.size() - 1;
+        for (size_t index = hash(key) & mask;; index = (index + 1) & mask) {
+            auto& slot = slots_[index];
+            if (slot.first == key) {
+                return {&slot.second, false};
+            }
+            if (slot.first == StringInterner::kInvalidHandle) {
+                slot.first = key;
+                slot.second = std::move(value);
+                ++size_;
+                return {&slot.second, true};
+            }
+        }
+    }
+
+    // 键必须是有效句柄：句柄 0 无处存放，调用方应在驻留失败时先行拒绝
+    V& operator[](Handle key) {
+        assert(key != StringInterner::kInvalidHandle);
+        return *emplace(key, V{}).first;
+    }
+
+    bool erase(Handle key) {
+        size_t index = locate(key);
+        if (index == npos) {
+            return false;
+        }
+
+        // 后移删除：把后续同一探测链上的元素前移填补空位
+        size_t mask = slots_.size() - 1;
+        size_t hole = index;
+        for (size_t next = (hole + 1) & mask; slots_[next].first != StringInterner::kInvalidHandle;
+             next = (next + 1) & mask) {
+            size_t home = hash(slots_[next].first) & mask;
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                slots_[hole] = std::move(slots_[next]);
+                hole = next;
+            }
+        }
+        slots_[hole].first = StringInterner::kInvalidHandle;
+        slots_[hole].second = V{};
+        --size_;
+        return true;
+    }
+
+    // 删除满足条件的元素，返回删除数量（遍历中删除会移动元素，因此先收集键）
+    template <typename Predicate>
+    size_t eraseIf(Predicate predicate) {
+        std::vector<Handle> keys;
+        for (const auto& slot : *this) {
+            if (predicate(slot)) {
+                keys.push_back(slot.first);
+            }
+        }
+        for (Handle key : keys) {
+            erase(key);
+        }
+        return keys.size();
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // 句柄是连续分配的，乘法散列把相邻句柄打散到整个表
+    static size_t hash(Handle key) {
+        return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+
+    size_t locate(Handle key) const {
+        if (slots_.empty() || key == StringInterner::kInvalidHandle) {
+            return npos;
+        }
+        size_t mask = slots_.size() - 1;
+        for (size_t index = hash(key) & mask;; index = (index + 1) & mask) {
+            Handle current = slots_[index].first;
+            if (current == key) {
+                return index;
+            }
+            if (current == StringInterner::kInvalidHandle) {
+                return npos;
+            }
+        }
+    }
+
+    // 负载因子上限 3/4
+    void growIfNeeded() {
+        if (slots_.empty()) {
+            rehash(16);
+        } else if ((size_ + 1) * 4 > slots_.size() * 3) {
+            rehash(slots_.size() * 2);
+        }
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<value_type> old;
+        old.swap(slots_);
+        slots_.resize(capacity);
+        size_ = 0;
+        for (auto& slot : old) {
+            if (slot.first != StringInterner::kInvalidHandle) {
+                emplace(slot.first, std::move(slot.second));
+            }
+        }
+    }
+
+    std::vector<value_type> slots_;
+    size_t size_{0};
+};
+
+// 句柄集合
+class FlatHandleSet {
+public:
+    using Handle = StringInterner::Handle;
+
+    bool insert(Handle key) { return map_.emplace(key, true).second; }
+    bool erase(Handle key) { return map_.erase(key); }
+    bool contains(Handle key) const { return map_.contains(key); }
+    size_t size() const { return map_.size(); }
+    bool empty() const { return map_.empty(); }
+    void clear() { map_.clear(); }
+    void reserve(size_t count) { map_.reserve(count); }
+
+private:
+    FlatHandleMap<bool> map_;
+};
+
+} // namespace openclaw
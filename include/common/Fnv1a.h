@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace openclaw {
+
+// 64 位 FNV-1a。结果与平台和进程无关，可写入文件或用于跨节点分区。
+// 初始值沿用各文件格式一直使用的 1469598103934665603（不是标准偏移基数 14695981039346656037），
+// 修改会使已有的快照、检查点、会话日志与缓存校验失败，并改变集群分区；
+// 传入上一次的结果作为 hash 可以分段累加（字符串字面量须先转为 string_view，
+// 否则 fnv1a("x", hash) 会匹配到 (data, size) 重载）
+constexpr uint64_t kFnv1aOffsetBasis = 1469598103934665603ULL;
+constexpr uint64_t kFnv1aPrime = 1099511628211ULL;
+
+inline uint64_t fnv1a(const char* data, size_t size, uint64_t hash = kFnv1aOffsetBasis) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= kFnv1aPrime;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1a(std::string_view data, uint64_t hash = kFnv1aOffsetBasis) {
+    return fnv1a(data.data(), data.size(), hash);
+}
+
+} // namespace openclaw
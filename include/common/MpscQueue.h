@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace openclaw {
+
+// 无锁多生产者单消费者队列（Vyukov 链表队列）。
+// 生产者入队只有一次原子交换，不加锁、不等待；消费者同一时刻只能有一个，由调用方保证。
+// 生产者在交换与链接之间被抢占时，消费者会暂时看不到其后的元素，pop 返回 false 后重试即可。
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {
+        }
+        if (tail_ != &stub_) {
+            delete tail_;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // 仅消费者调用
+    bool pop(T& out) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        out = std::move(next->value);
+        tail_ = next;
+        if (tail != &stub_) {
+            delete tail;
+        }
+        return true;
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T v) : value(std::move(v)) {}
+
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    // 哨兵节点只在开头使用一次，之后已出队的节点充当哨兵
+    Node stub_;
+    std::atomic<Node*> head_;   // 生产者端
+    Node* tail_;                // 消费者端，next 为队首元素
+};
+
+} // namespace openclaw
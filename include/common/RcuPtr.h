@@ -0,0 +1,37 @@
+#pragma once
+
+#include "EpochManager.h"
+#include <atomic>
+
+namespace openclaw {
+
+// 经 EpochManager 发布的不可变快照指针。
+// 读者在 EpochManager::Guard 内 load() 无锁读取；写者生成新快照后 publish() 整体替换，
+// 旧快照登记给 EpochManager，等读者离开后释放。写者之间的串行化由持有者负责。
+// publish 只登记不回收：回收可能执行任意多个删除器，应在释放写锁之后调用 reclaim()
+template <typename T>
+class RcuPtr {
+public:
+    explicit RcuPtr(const T* initial) : current_(initial) {}
+
+    // 销毁时不应再有读者；已替换下来的旧快照仍由 EpochManager 回收
+    ~RcuPtr() { delete current_.load(std::memory_order_acquire); }
+
+    RcuPtr(const RcuPtr&) = delete;
+    RcuPtr& operator=(const RcuPtr&) = delete;
+
+    // 调用方处于读临界区内，或是持有写锁的写者
+    const T* load() const { return current_.load(std::memory_order_acquire); }
+
+    void publish(const T* next) {
+        const T* old = current_.exchange(next, std::memory_order_seq_cst);
+        EpochManager::getInstance().retire([old] { delete old; });
+    }
+
+    static void reclaim() { EpochManager::getInstance().reclaim(); }
+
+private:
+    std::atomic<const T*> current_;
+};
+
+} // namespace openclaw
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace openclaw {
+
+// 放在共享内存中的单生产者单消费者消息环，可跨进程使用。
+// 消息为长度前缀的字节串，读写位置是单调递增的字节计数，环绕时分段拷贝。
+// 消费者等待时先短暂自旋，再在共享的 futex 字上睡眠；生产者只在消费者登记了等待时才发起系统调用，
+// 因此双方都活跃时收发不进入内核。
+class ShmRing {
+public:
+    // 容量（数据区字节数，2 的幂）对应的共享内存大小
+    static size_t bytesFor(size_t capacity);
+
+    // 在 memory 处初始化一个空环（创建方调用一次），此后双方通过 attach 使用
+    static ShmRing create(void* memory, size_t capacity);
+    static ShmRing attach(void* memory);
+
+    ShmRing() = default;
+
+    bool valid() const { return control_ != nullptr; }
+    size_t capacity() const { return static_cast<size_t>(mask_ + 1); }
+
+    // 单条消息能否放入空环
+    bool fits(size_t size) const { return size + sizeof(uint32_t) <= capacity(); }
+
+    // 生产者：空间不足时返回 false，不阻塞
+    bool push(const std::string& message);
+
+    // 消费者：为空时返回 false
+    bool pop(std::string& message);
+    bool empty() const;
+
+    // 消费者等待数据到达，超时返回 false
+    bool wait(std::chrono::milliseconds timeout);
+
+private:
+    struct Control;
+
+    explicit ShmRing(void* memory);
+
+    void copyIn(uint64_t position, const char* data, size_t size);
+    void copyOut(uint64_t position, char* data, size_t size) const;
+
+    Control* control_{nullptr};
+    char* data_{nullptr};
+    uint64_t mask_{0};
+};
+
+} // namespace openclaw
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace openclaw {
+
+// 进程内的有界单生产者单消费者环。
+// 槽位数为 2 的幂，读写位置是单调递增的计数，各占一个缓存行；双方各自缓存对方的位置，
+// 只有缓存的位置显示满或空时才重新读取对方的原子变量，减少缓存行往返。
+// push 只能由一个生产者线程调用，pop 只能由一个消费者线程调用，由调用方保证。
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t slots = 2;
+        while (slots < capacity) {
+            slots <<= 1;
+        }
+        mask_ = slots - 1;
+        slots_.reset(new T[slots]);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return static_cast<size_t>(mask_ + 1); }
+
+    // 生产者：环满时返回 false，value 保持不变
+    bool push(T& value) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - headCache_ > mask_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail - headCache_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：为空时返回 false
+    bool pop(T& out) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head == tailCache_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[head & mask_]);
+        slots_[head & mask_] = T();   // 及时释放槽位持有的资源
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似值，双方都可调用；先读 head_ 保证结果不为负
+    size_t size() const {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        return static_cast<size_t>(tail_.load(std::memory_order_acquire) - head);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    alignas(64) std::atomic<uint64_t> head_{0};   // 消费者写
+    uint64_t tailCache_{0};                       // 消费者缓存的 tail_
+    alignas(64) std::atomic<uint64_t> tail_{0};   // 生产者写
+    uint64_t headCache_{0};                       // 生产者缓存的 head_
+    alignas(64) std::unique_ptr<T[]> slots_;
+    uint64_t mask_{0};
+};
+
+} // namespace openclaw
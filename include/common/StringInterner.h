@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openclaw {
+
+// 全局字符串驻留表：把任务/智能体/订阅者等外部 ID 映射为 32 位句柄。
+// 内部表以句柄为键，字符串只在 API 与日志边界处还原。
+// intern 得到的句柄常驻（智能体 ID 等数量有限的字符串）；任务、订阅者这类不断产生的 ID
+// 用 acquire/release 按引用计数驻留，最后一个引用释放后槽位回收复用。
+// 句柄低 24 位是槽位，高 8 位是槽位的代数，复用后旧句柄不再能还原或匹配到新字符串。
+// 回收的槽位先进先出，且空闲槽位不少于 kMinFreeBeforeReuse 个时才复用，同一槽位两次复用之间
+// 至少隔这么多次回收，代数要经过约 256 × kMinFreeBeforeReuse 次回收才会回绕。
+// 句柄 0 保留给空字符串/无效值，槽位耗尽时驻留也返回 0
+class StringInterner {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kInvalidHandle = 0;
+    static constexpr uint32_t kIndexBits = 24;
+    static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+
+    // 句柄中的槽位序号（不含代数）。同一时刻每个槽位至多对应一个有效句柄，
+    // 以句柄为下标的表可按槽位索引，再比较完整句柄识别复用
+    static constexpr uint32_t slotOf(Handle handle) { return handle & kIndexMask; }
+
+    static StringInterner& getInstance();
+
+    // 返回字符串对应的常驻句柄，不存在时分配新句柄；已按引用计数驻留的字符串转为常驻
+    Handle intern(std::string_view value);
+
+    // 按引用计数驻留：每次成功的 acquire 对应一次 release。常驻字符串上两者都不改变状态
+    Handle acquire(std::string_view value);
+    void release(Handle handle);
+
+    // 只查找不分配：未驻留的字符串返回 kInvalidHandle
+    Handle find(std::string_view value) const;
+
+    // 还原字符串；无效或已回收的句柄返回空字符串。
+    // 引用在句柄被释放前有效，常驻句柄在进程生命周期内有效
+    const std::string& resolve(Handle handle) const;
+
+    // 当前驻留的字符串数
+    size_t size() const { return live_.load(std::memory_order_relaxed); }
+
+private:
+    StringInterner() = default;
+    ~StringInterner() = default;
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // 槽位按块存放，块一经分配不再移动，resolve 无需加锁
+    static constexpr uint32_t kChunkBits = 12;
+    static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+    static constexpr uint32_t kMaxChunks = 1u << (kIndexBits - kChunkBits);
+    static constexpr uint32_t kPinned = UINT32_MAX;
+    static constexpr size_t kMinFreeBeforeReuse = 1024;
+
+    // refs 由字符串所在分片的锁保护；generation 在回收时递增，resolve 据此识别过期句柄
+    struct Entry {
+        std::string value;
+        uint32_t refs{0};
+        std::atomic<uint8_t> generation{0};
+    };
+
+    // 分片降低并发驻留时的锁竞争。分片内是开放寻址表，槽位只存散列标签和句柄，
+    // 标签相同时才还原字符串比较，查找不经过节点指针
+    static constexpr size_t kShardCount = 16;
+    struct Slot {
+        uint32_t tag;
+        Handle handle;   // 0 表示空槽
+    };
+    struct Shard {
+        mutable std::mutex mutex;
+        std::vector<Slot> slots;
+        size_t count{0};
+    };
+
+    Handle insertOrRef(std::string_view value, bool pin);
+    Handle lookup(const Shard& shard, std::string_view value, uint64_t hash) const;
+    void insert(Shard& shard, uint64_t hash, Handle handle);
+    void erase(Shard& shard, uint64_t hash, Handle handle);
+    Entry* entryFor(Handle handle) const;
+    Handle allocate();
+
+    std::array<Shard, kShardCount> shards_;
+    std::array<std::atomic<Entry*>, kMaxChunks> chunks_{};
+    std::mutex allocMutex_;              // 保护 chunks_ 的分配、freeList_ 与 nextIndex_
+    std::deque<uint32_t> freeList_;      // 回收的槽位，先进先出
+    uint32_t nextIndex_{1};
+    std::atomic<size_t> live_{0};
+    const std::string empty_;
+};
+
+} // namespace openclaw
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <vector>
+#include "../logging/Logger.h"
+
+namespace openclaw {
+
+enum class StreamStatus {
+    CHUNK,      // 取得一个分块
+    TIMEOUT,    // 等待超时，流仍在进行
+    FINISHED    // 流已结束（或被取消）且分块已读完
+};
+
+// 流式输出：单生产者、多消费者的有界分块环。
+// 生产者（模型调用或智能体）每得到一段输出就 write 一个分块；每个读者有自己的读取位置，
+// 都能读到订阅之后的全部分块。最慢的读者落后 capacity 个分块时 write 阻塞（背压），
+// 没有读者时不阻塞，旧分块直接被覆盖。
+//
+// 快速路径不加锁：生产者发布写位置，读者推进自己的位置；只有环满、环空或需要唤醒对方时才进入互斥锁。
+// 生产者缓存所有读者位置的最小值，只有缓存显示已满时才重新计算。须由 shared_ptr 持有（见 create）。
+class TokenStream : public std::enable_shared_from_this<TokenStream> {
+public:
+    explicit TokenStream(size_t capacity = 256);
+
+    TokenStream(const TokenStream&) = delete;
+    TokenStream& operator=(const TokenStream&) = delete;
+
+    class Reader;
+
+    // 订阅：replay 为 true 时从环中仍保留的最早分块开始读，否则只读此后写入的分块
+    Reader subscribe(bool replay = true);
+
+    // 生产者：写入一个分块，必要时等待最慢的读者；流已结束或被取消时返回 false
+    bool write(std::string chunk);
+
+    // 生产者：结束流，读者读完剩余分块后得到 FINISHED
+    void finish(bool success = true, const std::string& error = std::string());
+
+    // 消费者或外部：取消流，此后 write 返回 false，读者立即得到 FINISHED
+    void cancel();
+
+    bool isFinished() const { return finished_.load(std::memory_order_acquire); }
+    bool isCancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    // 结束后有效
+    bool succeeded() const;
+    std::string getError() const;
+
+    size_t getChunkCount() const { return static_cast<size_t>(tail_.load(std::memory_order_acquire)); }
+    size_t getByteCount() const { return bytes_.load(std::memory_order_relaxed); }
+
+    // 从创建到写入第一个分块的时长，尚未写入时为 0
+    std::chrono::microseconds getTimeToFirstChunk() const {
+        return std::chrono::microseconds(firstChunkMicros_.load(std::memory_order_acquire));
+    }
+
+    // 读者：只能由一个线程使用，析构时退订
+    class Reader {
+    public:
+        Reader() = default;
+        Reader(Reader&& other) noexcept = default;
+        Reader& operator=(Reader&& other) noexcept;
+        ~Reader() { close(); }
+
+        explicit operator bool() const { return stream_ != nullptr; }
+
+        // 等待至多 timeout 取得下一个分块
+        StreamStatus next(std::string& chunk, std::chrono::milliseconds timeout);
+
+        // 阻塞直到取得下一个分块（返回 true）或流结束（返回 false）
+        bool next(std::string& chunk);
+
+        // 读到流结束，每个分块调用一次 handler，返回分块数
+        size_t forEach(const std::function<void(const std::string&)>& handler);
+
+        void close();
+
+        const std::shared_ptr<TokenStream>& stream() const { return stream_; }
+
+    private:
+        friend class TokenStream;
+        struct Cursor;
+
+        Reader(std::shared_ptr<TokenStream> stream, std::shared_ptr<Cursor> cursor)
+            : stream_(std::move(stream)), cursor_(std::move(cursor)) {}
+
+        std::shared_ptr<TokenStream> stream_;
+        std::shared_ptr<Cursor> cursor_;
+    };
+
+    static std::shared_ptr<TokenStream> create(size_t capacity = 256) {
+        return std::make_shared<TokenStream>(capacity);
+    }
+
+private:
+    void unsubscribe(const std::shared_ptr<Reader::Cursor>& cursor);
+    uint64_t slowestLocked(uint64_t tail) const;
+    void wakeProducer();
+
+    std::unique_ptr<std::string[]> slots_;
+    uint64_t mask_{0};
+
+    alignas(64) std::atomic<uint64_t> tail_{0};   // 生产者写
+    uint64_t floor_{0};                           // 生产者缓存的最慢读者位置，只在持锁时更新
+
+    mutable std::mutex mutex_;
+    std::condition_variable dataAvailable_;
+    std::condition_variable spaceAvailable_;
+    std::vector<std::shared_ptr<Reader::Cursor>> readers_;
+    std::atomic<bool> producerWaiting_{false};
+    std::atomic<int> readersWaiting_{0};
+
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> cancelled_{false};
+    bool success_{false};
+    std::string error_;
+
+    const std::chrono::steady_clock::time_point created_;
+    std::atomic<int64_t> firstChunkMicros_{0};
+    std::atomic<size_t> bytes_{0};
+};
+
+// 把流按行写入日志，结束时输出不完整的最后一行；返回分块数
+size_t logStream(TokenStream::Reader& reader, const std::string& tag, LogLevel level = LogLevel::INFO);
+
+} // namespace openclaw
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../common/SpscRing.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace openclaw {
+
+// 不可变、引用计数的负载。发送方交出后不能再修改，传递时只复制指针
+using ChannelPayload = std::shared_ptr<const std::string>;
+
+inline ChannelPayload makeChannelPayload(std::string data) {
+    return std::make_shared<const std::string>(std::move(data));
+}
+
+struct ChannelMessage {
+    std::string topic;        // 由双方约定，如 "artifact"、"review-request"
+    ChannelPayload payload;
+};
+
+// 智能体之间的单向直连通道（from -> to），基于 SpscRing，消息只搬运负载指针。
+// 只有 from 智能体的一个线程发送、to 智能体的一个线程接收。
+// 接收方等待时登记后在条件变量上睡眠，发送方只在有人等待时才加锁唤醒。
+class AgentChannel {
+public:
+    AgentChannel(std::string from, std::string to, size_t capacity);
+
+    const std::string& getFrom() const { return from_; }
+    const std::string& getTo() const { return to_; }
+    size_t capacity() const { return ring_.capacity(); }
+    size_t pending() const { return ring_.size(); }
+
+    // 通道已满或已关闭时返回 false，不阻塞；失败时调用方仍持有负载
+    bool send(const std::string& topic, const ChannelPayload& payload);
+
+    // 为空时返回 false
+    bool receive(ChannelMessage& message);
+
+    // 等待消息到达，超时或通道关闭且已取完时返回 false
+    bool receive(ChannelMessage& message, std::chrono::milliseconds timeout);
+
+    // 关闭后不再接受发送，已在环中的消息仍可取出
+    void close();
+    bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    const std::string from_;
+    const std::string to_;
+    SpscRing<ChannelMessage> ring_;
+    std::atomic<bool> closed_{false};
+
+    std::atomic<bool> waiting_{false};
+    std::mutex waitMutex_;
+    std::condition_variable arrived_;
+};
+
+// 直连通道的登记处，对应 tools.agentToAgent：
+//   - 允许列表中的智能体之间才能建立通道，"*" 表示全部；未启用时拒绝所有通道
+//   - 每个有序对 (from, to) 至多一条通道，重复打开返回同一条
+class AgentChannelRegistry {
+public:
+    static AgentChannelRegistry& getInstance();
+
+    AgentChannelRegistry() = default;
+
+    AgentChannelRegistry(const AgentChannelRegistry&) = delete;
+    AgentChannelRegistry& operator=(const AgentChannelRegistry&) = delete;
+
+    void setEnabled(bool enabled);
+    void setAllowList(const std::vector<std::string>& agentIds);
+    bool isAllowed(const std::string& from, const std::string& to) const;
+
+    // 从 ConfigManager 读取 agent_to_agent_enabled 与 agent_to_agent_allow（逗号分隔）
+    void loadConfig();
+
+    // 不允许时返回 nullptr 并记录日志；已存在的通道忽略 capacity
+    std::shared_ptr<AgentChannel> openChannel(const std::string& from, const std::string& to,
+                                              size_t capacity = kDefaultCapacity);
+    std::shared_ptr<AgentChannel> getChannel(const std::string& from, const std::string& to) const;
+
+    // 关闭并移除通道，持有者仍可取出剩余消息
+    bool closeChannel(const std::string& from, const std::string& to);
+
+    // 关闭某个智能体收发的全部通道（如智能体被移除时）
+    size_t closeChannelsOf(const std::string& agentId);
+
+    size_t getChannelCount() const;
+
+    static constexpr size_t kDefaultCapacity = 256;
+
+private:
+    mutable std::mutex mutex_;
+    bool enabled_{false};
+    std::unordered_set<std::string> allowed_;
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<AgentChannel>> channels_;
+};
+
+} // namespace openclaw
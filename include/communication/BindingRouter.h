@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../common/RcuPtr.h"
+#include "../config/ConfigManager.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openclaw {
+
+// 一条绑定，对应 openclaw.json 中 bindings[]：(channel, accountId) -> agentId。
+// channel 或 accountId 为 "*" 时表示通配
+struct Binding {
+    std::string channel;
+    std::string accountId;
+    std::string agentId;
+};
+
+// 渠道 / 账号到智能体的绑定索引。
+// 所有绑定放在一张开放寻址的扁平散列表中，以 (channel, accountId) 为键，装载率不超过 1/2；
+// 查找依次尝试 (channel, accountId)、(channel, *)、(*, accountId)、(*, *)，
+// 不存在的通配层级在构建时记下，查找时直接跳过，因此至多四次探测、与绑定数量无关。
+// 表在写者一侧构建好后经原子指针整体替换，读者经 EpochManager 无锁读取。
+class BindingRouter {
+public:
+    static constexpr const char* kWildcard = "*";
+
+    static BindingRouter& getInstance();
+
+    BindingRouter();
+    ~BindingRouter();
+
+    BindingRouter(const BindingRouter&) = delete;
+    BindingRouter& operator=(const BindingRouter&) = delete;
+
+    // 整体替换绑定；键重复时后出现的覆盖先出现的
+    void setBindings(const std::vector<Binding>& bindings);
+
+    // 从 ConfigManager 读取所有 "binding.<channel>.<accountId> = <agentId>" 键并重建。
+    // channel 取第一个 '.' 之前的部分，accountId 可以包含 '.'
+    void loadConfig();
+
+    // 在 ConfigManager 重新加载后自动调用 loadConfig
+    void watchConfig();
+    void unwatchConfig();
+
+    // 解析消息所属的智能体，没有匹配的绑定时返回 false
+    bool resolve(const std::string& channel, const std::string& accountId, std::string& agentId) const;
+
+    // 同上，没有匹配时返回空串
+    std::string resolve(const std::string& channel, const std::string& accountId) const;
+
+    size_t getBindingCount() const;
+    uint64_t getVersion() const;   // 每次重建加一
+
+private:
+    struct Table;
+
+    RcuPtr<Table> table_;
+    std::mutex writerMutex_;
+    std::atomic<uint64_t> version_{0};
+    ConfigReloadWatch configWatch_{[this] { loadConfig(); }};
+};
+
+} // namespace openclaw
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../common/RcuPtr.h"
+#include "../config/ConfigManager.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace openclaw {
+
+// 群聊提及路由：把所有智能体的提及模式（如 "@coder"、"@project-manager"，对应
+// agents.list[].groupChat.mentionPatterns）编译成一个 Aho-Corasick 自动机，
+// 一条消息扫描一遍即可找出被提及的全部智能体，耗时与消息长度成正比，与模式数量无关。
+//
+// 自动机是完整的 DFA：字节先经折叠表映射到列（ASCII 大小写不敏感，未出现在模式中的字节共用一列），
+// 每个字节只做一次查表。命中要求前后不是标识符字符（字母、数字、'_'、'-'），
+// 因此 "@coder" 不会匹配 "@coders" 或 "a@coder"。
+//
+// 重建在写者一侧完成后整体替换，读者经 EpochManager 无锁读取，重建期间的路由不受影响。
+class MentionRouter {
+public:
+    static MentionRouter& getInstance();
+
+    MentionRouter();
+    ~MentionRouter();
+
+    MentionRouter(const MentionRouter&) = delete;
+    MentionRouter& operator=(const MentionRouter&) = delete;
+
+    // 以智能体 ID -> 模式列表整体重建
+    void setPatterns(const std::unordered_map<std::string, std::vector<std::string>>& patterns);
+
+    // 从 ConfigManager 读取所有 "mention_patterns.<智能体 ID>" 键（逗号分隔的模式列表）并重建
+    void loadConfig();
+
+    // 在 ConfigManager 重新加载后自动调用 loadConfig
+    void watchConfig();
+    void unwatchConfig();
+
+    struct Mention {
+        std::string agentId;
+        std::string pattern;
+        size_t offset;        // 在消息中的起始位置
+    };
+
+    // 按出现顺序返回消息中的全部提及
+    std::vector<Mention> findMentions(const std::string& message) const;
+
+    // 被提及的智能体，按首次提及的顺序去重
+    std::vector<std::string> route(const std::string& message) const;
+
+    size_t getPatternCount() const;
+    size_t getStateCount() const;
+    uint64_t getVersion() const;   // 每次重建加一
+
+private:
+    struct Automaton;
+
+    // 对每个命中调用 onMatch(模式序号, 起始位置)
+    template <typename OnMatch>
+    static void scan(const Automaton& automaton, const std::string& message, OnMatch&& onMatch);
+
+    static Automaton* compile(const std::unordered_map<std::string, std::vector<std::string>>& patterns);
+
+    RcuPtr<Automaton> automaton_;
+    std::mutex writerMutex_;
+    std::atomic<uint64_t> version_{0};
+    ConfigReloadWatch configWatch_{[this] { loadConfig(); }};
+};
+
+} // namespace openclaw
@@ -11,6 +11,8 @@
 #include <thread>
 #include <future>
 #include "../events/Event.h"
+#include "../common/FlatHandleMap.h"
+#include "../common/TokenStream.h"
 
 namespace openclaw {
 
@@ -25,7 +27,9 @@ enum class MessageType {
     COMMAND,          // 命令
     RESPONSE,         // 响应
     BROADCAST,        // 广播
-    DIRECT            // 直接消息
+    DIRECT,           // 直接消息
+    STREAM_CHUNK,     // 流式输出的一个分块，关联 ID 为流 ID
+    STREAM_END        // 流式输出结束，内容为错误信息（成功时为空）
 };
 
 // 消息优先级
@@ -120,6 +124,12 @@ public:
     bool broadcastMessage(const std::string& from, MessageType type, 
                          const std::string& content);
     
+    // 把流的分块逐个作为 STREAM_CHUNK 消息发送，流结束后发送 STREAM_END；关联 ID 均为 streamId。
+    // 在调用线程上读到流结束为止，返回转发的分块数。消息队列积压达到 kStreamQueueLimit 时等待
+    // 处理线程消化，背压经流传回生产者；消息系统停止时关闭读者并返回
+    size_t forwardStream(TokenStream::Reader& reader, const std::string& from, const std::string& to,
+                         const std::string& streamId);
+    
     // 订阅消息
     std::string subscribe(MessageType type, const std::string& name, 
                          MessageHandler handler);
@@ -154,13 +164,20 @@ private:
     
     // 订阅者管理
     mutable std::mutex subscribersMutex_;
-    std::unordered_map<std::string, MessageSubscriber> subscribers_;
-    std::unordered_map<MessageType, std::vector<std::string>> typeSubscribers_;
+    FlatHandleMap<MessageSubscriber> subscribers_;   // 以订阅者 ID 的驻留句柄为键
+    std::unordered_map<MessageType, std::vector<StringInterner::Handle>> typeSubscribers_;
     
     // 消息队列
     mutable std::mutex queueMutex_;
     std::queue<Message> messageQueue_;
     std::condition_variable queueCV_;
+    std::condition_variable queueSpace_;   // 处理线程取出消息后通知，供有界入队等待
+    
+    // 转发流时队列中允许积压的消息数
+    static constexpr size_t kStreamQueueLimit = 1024;
+    
+    // 入队；limit 非 0 时先等待队列低于 limit。消息系统未运行时返回 false
+    bool enqueue(const Message& message, size_t limit);
     
     // 处理线程
     std::thread processorThread_;
@@ -1,12 +1,15 @@
 #ifndef OPENCLAW_CONFIG_MANAGER_H
 #define OPENCLAW_CONFIG_MANAGER_H
 
+#include <condition_variable>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <fstream>
 #include <optional>
+#include <thread>
 
 namespace openclaw {
 
@@ -18,6 +21,14 @@ public:
     bool loadConfigFromDirectory(const std::string& directory);
     bool reloadConfig();
 
+    // 重新加载成功后依次调用的监听器，在调用 reloadConfig 的线程上执行；返回值用于注销
+    using ReloadListener = std::function<void()>;
+    size_t addReloadListener(ReloadListener listener);
+
+    // 注销后该监听器不会再被调用；若其他线程正在调用它，等调用结束后才返回，
+    // 之后可以安全地销毁监听器引用的对象。在监听器内部注销自身不会等待
+    void removeReloadListener(size_t listenerId);
+
     std::string getString(const std::string& key, const std::string& defaultValue = "") const;
     int getInt(const std::string& key, int defaultValue = 0) const;
     bool getBool(const std::string& key, bool defaultValue = false) const;
@@ -64,6 +75,32 @@ private:
     std::string configFile_;
     mutable std::mutex mutex_;
     bool isLoaded_;
+
+    std::mutex listenersMutex_;
+    std::condition_variable listenerFinished_;
+    std::vector<std::pair<size_t, ReloadListener>> reloadListeners_;
+    std::vector<std::pair<size_t, std::thread::id>> runningListeners_;   // 正在调用的监听器及调用线程
+    size_t nextListenerId_{1};
+};
+
+// 可反复开启、关闭的重新加载监听，供随配置重载自行重建的组件持有；销毁时自动注销。
+// 注销会等待进行中的回调，而回调通常要取持有者自己的写锁，因此持有者不得在自己的锁内调用 stop
+class ConfigReloadWatch {
+public:
+    explicit ConfigReloadWatch(ConfigManager::ReloadListener listener);
+    ~ConfigReloadWatch();
+
+    ConfigReloadWatch(const ConfigReloadWatch&) = delete;
+    ConfigReloadWatch& operator=(const ConfigReloadWatch&) = delete;
+
+    void start();   // 已开启时不重复登记
+    void stop();
+    bool isWatching() const;
+
+private:
+    ConfigManager::ReloadListener listener_;
+    mutable std::mutex mutex_;
+    size_t listenerId_{0};   // 由 mutex_ 保护，0 表示未登记
 };
 
 } // namespace openclaw
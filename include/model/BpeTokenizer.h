@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openclaw {
+
+// 字节级 BPE 分词器，用于在每轮调用前统计与裁剪上下文的词元数。
+// 词表为 tiktoken 格式（每行 "base64 编码的字节串 序号"），序号即合并优先级，也是词元 ID；
+// 必须包含全部 256 个单字节词元。
+//
+// 编码分两步：
+//   1. 预分词：按字母（含 UTF-8 多字节字符）、数字（至多 3 位）、标点、空白切成互不影响的片段，
+//      单个前导空格并入后面的片段。游程扫描在 SSE2 下每次比较 16 字节，超长游程按 kMaxChunk 截断
+//   2. 片段整体是词元时直接查表；否则先查每线程的片段缓存（语料词频近似 Zipf 分布，同一片段反复出现），
+//      未命中再从单字节开始，反复合并相邻且拼接后序号最小的一对：词元串为链表，候选对放在最小堆中，
+//      每次合并只重算两侧的候选。相邻词元对在加载时展开成开放寻址的扁平散列表，一次探测即可得到结果
+// 加载后只读，可在多线程中共享。
+class BpeTokenizer {
+public:
+    using TokenId = uint32_t;
+    static constexpr size_t kMaxChunk = 256;
+
+    // 从 tiktoken 格式的词表文件加载，失败时返回 nullptr 并记录日志
+    static std::shared_ptr<BpeTokenizer> loadFromFile(const std::string& path);
+
+    // tokens[i] 为序号 i 的词元字节串；空串表示该序号空缺
+    static std::shared_ptr<BpeTokenizer> fromTokens(const std::vector<std::string>& tokens);
+
+    // 在语料上训练出 vocabSize 个词元（含 256 个单字节词元），供测试与基准使用
+    static std::shared_ptr<BpeTokenizer> train(const std::string& corpus, size_t vocabSize);
+
+    bool saveToFile(const std::string& path) const;
+
+    size_t vocabSize() const { return offsets_.size() - 1; }
+
+    std::vector<TokenId> encode(const std::string& text) const;
+    void encode(const char* data, size_t size, std::vector<TokenId>& out) const;
+    size_t countTokens(const std::string& text) const;
+    std::string decode(const std::vector<TokenId>& tokens) const;
+    std::string tokenBytes(TokenId token) const;
+
+    // 保留文本末尾不超过 maxTokens 个词元的部分（丢弃最早的内容），在片段边界处截断
+    std::string keepLastTokens(const std::string& text, size_t maxTokens) const;
+
+    // 预分词，依次追加每个片段的 [起始, 结束) 位置
+    static void pretokenize(const char* data, size_t size, std::vector<std::pair<size_t, size_t>>& chunks);
+
+    // 从 offset 开始的片段的结束位置
+    static size_t chunkEnd(const char* data, size_t size, size_t offset);
+
+private:
+    // 槽位按散列低位选取，tag 存散列高 32 位，比对字节串前先用它排除大部分冲突
+    struct TokenSlot {
+        uint32_t tag;
+        TokenId id;
+    };
+
+    // 词元对表每项 8 字节：高 42 位为 (左, 右)，低 21 位为拼接后的词元，全 1 表示空槽。
+    // 词表因此至多 kMaxVocab 个词元
+    static constexpr uint32_t kIdBits = 21;
+    static constexpr size_t kMaxVocab = (size_t(1) << kIdBits) - 1;
+
+    BpeTokenizer() = default;
+
+    bool build(const std::vector<std::string>& tokens);
+    TokenId findToken(const char* data, size_t size) const;
+    TokenId findToken(const char* data, size_t size, uint64_t hash) const;
+    TokenId findPair(TokenId left, TokenId right) const;
+    void prefetchPair(TokenId left, TokenId right) const;
+    void encodeChunk(const char* data, size_t size, std::vector<TokenId>& out) const;
+    void mergeChunk(const char* data, size_t size, std::vector<TokenId>& out) const;
+
+    static constexpr TokenId kNoToken = UINT32_MAX;
+
+    std::string bytes_;                  // 全部词元字节串首尾相接
+    std::vector<uint32_t> offsets_;      // 词元 i 的字节为 [offsets_[i], offsets_[i + 1])
+    TokenId byteTokens_[256];
+    std::vector<TokenSlot> tokenTable_;  // 字节串 -> 词元，容量为 2 的幂
+    std::vector<uint64_t> pairTable_;    // (左, 右) -> 拼接后的词元
+    uint64_t tokenMask_{0};
+    uint64_t pairMask_{0};
+    uint32_t cacheId_{0};                // 片段缓存中区分不同分词器的编号，构建时分配
+};
+
+// 增量编码：追加文本时只重新编码最后一个片段（它可能与新文本连成一个片段），
+// 其余词元保持不变，结果与对全文重新编码一致
+class IncrementalTokenizer {
+public:
+    explicit IncrementalTokenizer(std::shared_ptr<const BpeTokenizer> tokenizer);
+
+    void append(const std::string& text);
+    void clear();
+
+    const std::string& text() const { return text_; }
+    const std::vector<BpeTokenizer::TokenId>& tokens() const { return tokens_; }
+    size_t tokenCount() const { return tokens_.size(); }
+
+private:
+    std::shared_ptr<const BpeTokenizer> tokenizer_;
+    std::string text_;
+    std::vector<BpeTokenizer::TokenId> tokens_;
+    size_t lastChunkOffset_{0};   // 最后一个片段在 text_ 中的起点
+    size_t lastChunkToken_{0};    // 最后一个片段的首个词元在 tokens_ 中的下标
+};
+
+} // namespace openclaw
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "ModelProvider.h"
+#include "ResponseCache.h"
+#include "../common/TokenStream.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace openclaw {
+
+// 可嵌套的计数信号量：先占用自身额度再占用父级额度，释放顺序相反。上限为 0 表示不限
+class ConcurrencyLimiter {
+public:
+    explicit ConcurrencyLimiter(size_t limit = 0, ConcurrencyLimiter* parent = nullptr);
+
+    ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+    ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+
+    void acquire();
+    void release();
+
+    // 调整上限，已占用的额度不受影响，调大时唤醒等待者
+    void setLimit(size_t limit);
+    size_t getLimit() const;
+
+    size_t getInFlight() const;
+    size_t getPeakInFlight() const;
+
+private:
+    ConcurrencyLimiter* const parent_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    size_t limit_;
+    size_t inFlight_{0};
+    size_t peak_{0};
+};
+
+// 并发上限，默认值与 openclaw.json 中 agents.defaults.maxConcurrent / subagents.maxConcurrent 一致
+struct ModelGatewayLimits {
+    size_t maxConcurrent{4};           // 主智能体同时进行的模型请求数
+    size_t subagentMaxConcurrent{8};   // 子智能体同时进行的模型请求数
+    size_t totalMaxConcurrent{0};      // 两者合计的上限，0 表示不另设
+    std::chrono::milliseconds batchWindow{2};   // 提供方繁忙时凑批的最长等待
+};
+
+// 模型网关：位于智能体的 executeTask 实现与模型提供方之间。
+//   - 并发分层限制：请求先占用所属通道（主智能体 / 子智能体）的额度，再占用合计额度；
+//     每次提供方调用另外受该提供方自身的上限约束
+//   - 合并：与进行中的请求等价（ResponseCache::makeKey 相同）的请求不再调用提供方，共享同一结果；
+//     temperature 非 0 且不可缓存的请求各自调用
+//   - 微批量：提供方支持批量时，等待提供方额度期间排队的请求合并为一次调用；提供方仍有调用
+//     在进行时，新批次最多再等待 batchWindow 以凑满
+//   - 响应缓存（可选）：先查缓存，命中时不占用额度也不经过提供方
+// 调用在请求线程上同步执行，网关本身不创建线程。
+class ModelGateway {
+public:
+    static ModelGateway& getInstance();
+
+    ModelGateway();
+    ~ModelGateway();
+
+    ModelGateway(const ModelGateway&) = delete;
+    ModelGateway& operator=(const ModelGateway&) = delete;
+
+    // 注册提供方，maxConcurrent 为该提供方同时进行的调用数（0 表示不限）；首个注册的提供方为默认
+    bool registerProvider(const std::shared_ptr<ModelProvider>& provider, size_t maxConcurrent = 0);
+    bool unregisterProvider(const std::string& providerId);
+    bool hasProvider(const std::string& providerId) const;
+    void setDefaultProvider(const std::string& providerId);
+
+    // 设置响应缓存，nullptr 表示不使用缓存
+    void setResponseCache(std::shared_ptr<ResponseCache> cache);
+    std::shared_ptr<ResponseCache> getResponseCache() const;
+
+    void setLimits(const ModelGatewayLimits& limits);
+    ModelGatewayLimits getLimits() const;
+
+    // 从 ConfigManager 读取 model_max_concurrent、model_subagent_max_concurrent、
+    // model_total_max_concurrent 与 model_batch_window（毫秒）；配置了 model_cache_memory（MB）
+    // 或 model_cache_disk_path 时按其与 model_cache_disk_size（MB）创建响应缓存
+    void loadConfig();
+
+    // 同步执行一次请求
+    ModelResponse complete(const ModelRequest& request);
+
+    // 流式执行一次请求：输出分块在到达时写入 out，返回含完整文本的结果，不结束 out（调用方可继续写入）。
+    // 占用与 complete 相同的通道与提供方额度，但不参与合并与批量；命中缓存时整段作为一个分块写入。
+    // 所有读者都取消 out 时提供方调用随之停止
+    ModelResponse stream(const ModelRequest& request, const std::shared_ptr<TokenStream>& out);
+
+    struct Stats {
+        size_t requests{0};
+        size_t coalesced{0};         // 合并到进行中请求的次数
+        size_t cacheHits{0};
+        size_t providerCalls{0};
+        size_t batchedRequests{0};   // 以多于一个请求的批次发出的请求数
+        size_t failed{0};
+        size_t streamed{0};          // 流式请求数
+        size_t peakMainInFlight{0};
+        size_t peakSubagentInFlight{0};
+    };
+    Stats getStats() const;
+
+private:
+    struct Call;
+    struct ProviderSlot;
+
+    std::shared_ptr<ProviderSlot> findProvider(const std::string& model) const;
+    void dispatch(ProviderSlot& slot, const std::shared_ptr<Call>& call);
+    void execute(ProviderSlot& slot, const std::vector<std::shared_ptr<Call>>& batch);
+    void fulfill(Call& call, ModelResponse response);
+    static ModelResponse wait(Call& call);
+
+    mutable std::mutex providersMutex_;
+    std::unordered_map<std::string, std::shared_ptr<ProviderSlot>> providers_;
+    std::string defaultProvider_;
+    std::shared_ptr<ResponseCache> cache_;   // 由 providersMutex_ 保护
+
+    ConcurrencyLimiter total_;
+    ConcurrencyLimiter mainLane_;
+    ConcurrencyLimiter subagentLane_;
+    std::atomic<std::chrono::milliseconds::rep> batchWindow_;
+
+    // 进行中的请求，以请求内容为键
+    std::mutex inflightMutex_;
+    std::unordered_map<std::string, std::shared_ptr<Call>> inflight_;
+
+    std::atomic<size_t> requests_{0};
+    std::atomic<size_t> coalesced_{0};
+    std::atomic<size_t> cacheHits_{0};
+    std::atomic<size_t> providerCalls_{0};
+    std::atomic<size_t> batchedRequests_{0};
+    std::atomic<size_t> failed_{0};
+    std::atomic<size_t> streamed_{0};
+};
+
+} // namespace openclaw
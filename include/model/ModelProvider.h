@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openclaw {
+
+// 一次模型调用
+struct ModelRequest {
+    std::string model;          // "provider/model"，省略 provider 时使用网关的默认提供方
+    std::string system;
+    std::string prompt;
+    int maxTokens{0};           // 0 表示由提供方决定
+    double temperature{0.0};
+    bool subagent{false};       // 由子智能体发起，占用子智能体的并发额度
+    std::string agentId;        // 发起请求的智能体，用于按智能体统计
+    bool cacheable{true};       // 为 false 时不读写响应缓存
+};
+
+struct ModelResponse {
+    bool success{false};
+    std::string text;
+    std::string error;
+    size_t inputTokens{0};
+    size_t outputTokens{0};
+    std::chrono::milliseconds latency{0};
+    bool coalesced{false};      // 与同时进行的相同请求共用了一次调用
+    bool cached{false};         // 由响应缓存直接返回
+};
+
+// 模型计价，与 openclaw.json 中 models.providers.*.models[].cost 对应，单位为每百万词元
+struct ModelCost {
+    double input{0.0};
+    double output{0.0};
+    double cacheRead{0.0};
+    double cacheWrite{0.0};
+};
+
+// 模型提供方接口。complete 同步执行，可能被多个线程并发调用（并发数受网关限制）
+class ModelProvider {
+public:
+    virtual ~ModelProvider() = default;
+
+    virtual std::string getId() const = 0;
+
+    // 一次调用最多可合并的请求数，1 表示接口不支持批量
+    virtual size_t maxBatchSize() const { return 1; }
+
+    // 模型的计价，用于统计缓存节省的费用
+    virtual ModelCost getCost(const std::string& /*model*/) const { return ModelCost(); }
+
+    // 执行一批请求，返回与 requests 一一对应的结果
+    virtual std::vector<ModelResponse> complete(const std::vector<ModelRequest>& requests) = 0;
+
+    // 流式执行单个请求：每收到一段输出调用一次 sink，sink 返回 false 时应尽快停止；返回的结果含完整文本。
+    // 默认不支持流式，调用 complete 后把完整文本作为一个分块
+    using ChunkSink = std::function<bool(const std::string&)>;
+    virtual ModelResponse stream(const ModelRequest& request, const ChunkSink& sink) {
+        std::vector<ModelResponse> responses = complete({request});
+        if (responses.empty()) {
+            return ModelResponse();
+        }
+        if (responses[0].success && !responses[0].text.empty()) {
+            sink(responses[0].text);
+        }
+        return std::move(responses[0]);
+    }
+};
+
+// 本地模拟提供方，用于测试与基准：按配置的延迟休眠后返回 responder 生成的文本
+class MockModelProvider : public ModelProvider {
+public:
+    using Responder = std::function<std::string(const ModelRequest&)>;
+
+    explicit MockModelProvider(std::string id,
+                               std::chrono::milliseconds latency = std::chrono::milliseconds(0),
+                               size_t maxBatch = 1);
+
+    std::string getId() const override { return id_; }
+    size_t maxBatchSize() const override { return maxBatch_; }
+    std::vector<ModelResponse> complete(const std::vector<ModelRequest>& requests) override;
+
+    // 按词切分回复逐段输出：固定延迟后输出第一段，之后每段间隔 chunkDelay
+    ModelResponse stream(const ModelRequest& request, const ChunkSink& sink) override;
+
+    // 每次调用的固定延迟，以及批量中每个请求额外增加的延迟
+    void setLatency(std::chrono::milliseconds latency, std::chrono::milliseconds perRequest = std::chrono::milliseconds(0));
+
+    // 模拟逐词生成：每个词之后的输出间隔。非流式调用也会等满整段的生成时间
+    void setChunkDelay(std::chrono::milliseconds delay) { chunkDelay_ = delay.count(); }
+
+    // 默认回显 "mock:" + prompt
+    void setResponder(Responder responder);
+
+    // 为 true 时所有请求返回失败
+    void setFailing(bool failing) { failing_ = failing; }
+
+    ModelCost getCost(const std::string& model) const override;
+    void setCost(const ModelCost& cost);
+
+    size_t getCallCount() const { return calls_.load(); }
+    size_t getRequestCount() const { return requests_.load(); }
+    size_t getMaxInFlight() const { return maxInFlight_.load(); }
+
+private:
+    const std::string id_;
+    const size_t maxBatch_;
+    std::atomic<std::chrono::milliseconds::rep> latency_;
+    std::atomic<std::chrono::milliseconds::rep> perRequestLatency_{0};
+    std::atomic<std::chrono::milliseconds::rep> chunkDelay_{0};
+    std::atomic<bool> failing_{false};
+
+    mutable std::mutex responderMutex_;   // 同时保护 cost_
+    Responder responder_;
+    ModelCost cost_;
+
+    std::atomic<size_t> calls_{0};
+    std::atomic<size_t> requests_{0};
+    std::atomic<size_t> inFlight_{0};
+    std::atomic<size_t> maxInFlight_{0};
+};
+
+} // namespace openclaw
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "ModelProvider.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace openclaw {
+
+struct ResponseCacheOptions {
+    size_t memoryBytes{64u << 20};   // 内存层总预算，按分片平均分配
+    size_t shards{16};
+    std::string diskPath;            // 为空时不启用磁盘层
+    size_t diskBytes{256u << 20};    // 磁盘层文件大小（数据区）
+};
+
+// 模型响应缓存，以（模型、规范化后的提示词、参数）为内容地址。
+// 两层：分片的内存 LRU，以及映射到内存的磁盘环形日志；内存未命中时查磁盘并提升到内存层。
+// 命中时不经过提供方；按智能体统计命中率、节省的词元与费用（按 ModelCost 计价）。
+class ResponseCache {
+public:
+    explicit ResponseCache(const ResponseCacheOptions& options = ResponseCacheOptions());
+    ~ResponseCache();
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // 缓存键：空白折叠后的系统与用户提示词，加上模型与参数；ModelGateway 也以此合并进行中的请求
+    static std::string makeKey(const ModelRequest& request);
+
+    // 查找并按 request.agentId 记录命中或未命中。
+    // 命中节省的费用 = 输入、输出词元的原价 - 按 cacheRead 计的读取费用
+    bool lookup(const ModelRequest& request, ModelResponse& response, const ModelCost& cost = ModelCost());
+
+    // 写入成功的响应，写入费用按 cacheWrite 计入该智能体
+    void store(const ModelRequest& request, const ModelResponse& response, const ModelCost& cost = ModelCost());
+
+    void clear();
+
+    struct AgentStats {
+        size_t hits{0};
+        size_t misses{0};
+        size_t tokensSaved{0};
+        double costSaved{0.0};       // 命中节省的费用
+        double cacheWriteCost{0.0};  // 写入缓存的费用
+
+        double hitRatio() const {
+            return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+        }
+    };
+    AgentStats getAgentStats(const std::string& agentId) const;
+
+    struct Stats {
+        size_t memoryHits{0};
+        size_t diskHits{0};
+        size_t misses{0};
+        size_t memoryEntries{0};
+        size_t memoryBytes{0};
+        size_t diskEntries{0};
+        size_t evictions{0};         // 内存层因预算淘汰的条目数
+    };
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        uint64_t hash;
+        std::string key;
+        std::string text;
+        size_t inputTokens;
+        size_t outputTokens;
+
+        size_t bytes() const { return key.size() + text.size() + sizeof(Entry); }
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;   // 最近使用的在前
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+        size_t bytes{0};
+        size_t evictions{0};
+    };
+
+    class DiskTier;
+
+    Shard& shardFor(uint64_t hash) const;
+    void insertMemory(Entry entry);
+
+    const size_t shardBudget_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unique_ptr<DiskTier> disk_;
+
+    mutable std::mutex statsMutex_;
+    std::unordered_map<std::string, AgentStats> agentStats_;
+    size_t memoryHits_{0};
+    size_t diskHits_{0};
+    size_t misses_{0};
+};
+
+} // namespace openclaw
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "BpeTokenizer.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace openclaw {
+
+class ModelGateway;
+
+// 上下文压缩参数，与 openclaw.json 中 agents.defaults.compaction 对应
+struct CompactionOptions {
+    std::string mode{"safeguard"};   // "safeguard"：接近上下文窗口时压缩；"off"：不压缩
+    size_t contextWindow{200000};    // 词元
+    double triggerRatio{0.8};        // 超过窗口的该比例时开始压缩
+    double targetRatio{0.6};         // 压缩到窗口的该比例以下为止
+    size_t chunkTokens{2048};        // 末尾块达到该词元数后在消息边界处封存
+    size_t keepRecentTokens{8192};   // 最近的这部分原文不参与压缩
+    size_t summaryTokens{256};       // 每段摘要的词元上限
+
+    // 从 ConfigManager 读取 compaction_mode、compaction_context_window、
+    // compaction_chunk_tokens、compaction_keep_recent_tokens 与 compaction_summary_tokens
+    static CompactionOptions fromConfig();
+};
+
+// 摘要函数：把 text 压缩到不超过 maxTokens 个词元，失败时返回空串
+using Summarizer = std::function<std::string(const std::string& text, size_t maxTokens)>;
+
+// 经模型网关生成摘要的 Summarizer
+Summarizer makeGatewaySummarizer(const std::string& model, const std::string& agentId,
+                                 ModelGateway& gateway);
+
+// 单个会话的对话历史，按块组织的绳索结构：
+//   - 消息追加到末尾的开放块，词元数由 IncrementalTokenizer 增量统计；达到 chunkTokens 后封存
+//   - 每个封存块带一个摘要槽，压缩时用摘要替换原文并释放原文
+//   - 有效词元数（摘要 + 未压缩原文）随追加与压缩增量维护，不需要重新统计全文
+// 超过触发阈值时，从最早的未压缩块开始逐块摘要，直到回到目标以下；每块原文只摘要一次，
+// 因此压缩开销与新增内容成正比。原文都已压缩仍超出时，把最早的两段摘要合并为一段。
+// 摘要在会话锁内同步生成。
+class SessionHistory {
+public:
+    // summarizer 为空时按词元截断（保留末尾）代替摘要
+    SessionHistory(std::shared_ptr<const BpeTokenizer> tokenizer,
+                   const CompactionOptions& options = CompactionOptions(),
+                   Summarizer summarizer = nullptr);
+
+    // 追加一条消息（格式为 "role: text\n"），必要时触发压缩
+    void append(const std::string& role, const std::string& text);
+
+    // 按顺序拼接摘要与原文，作为下一轮调用的上下文
+    std::string render() const;
+
+    size_t tokenCount() const;      // 有效词元数
+    size_t chunkCount() const;
+
+    void setSummarizer(Summarizer summarizer);
+
+    struct Stats {
+        size_t appendedTokens{0};    // 累计追加的原文词元数
+        size_t compactedChunks{0};   // 被摘要替换的原文块数
+        size_t compactedTokens{0};   // 被替换的原文词元数
+        size_t summaryMerges{0};     // 合并摘要的次数
+        size_t summarizedBytes{0};   // 交给摘要函数的累计字节数
+        size_t failures{0};
+    };
+    Stats getStats() const;
+
+private:
+    struct Chunk {
+        std::string text;            // 压缩后为空
+        size_t tokens{0};            // 原文词元数
+        std::string summary;
+        size_t summaryTokens{0};
+        bool summarized{false};
+        unsigned level{0};           // 摘要被合并的层数
+
+        size_t effectiveTokens() const { return summarized ? summaryTokens : tokens; }
+    };
+
+    void sealTail();
+    void compactIfNeeded();
+    std::string summarize(const std::string& text);
+
+    const std::shared_ptr<const BpeTokenizer> tokenizer_;
+    const CompactionOptions options_;
+
+    mutable std::mutex mutex_;
+    Summarizer summarizer_;
+    std::deque<Chunk> chunks_;       // 已封存的块
+    IncrementalTokenizer tail_;      // 开放块
+    size_t firstRaw_{0};             // 首个未压缩块的下标，之前的块都已压缩
+    size_t sealedTokens_{0};         // 封存块的有效词元数之和
+    size_t rawSealedTokens_{0};      // 未压缩封存块的原文词元数之和
+    Stats stats_;
+};
+
+} // namespace openclaw
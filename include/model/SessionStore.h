@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace openclaw {
+
+// 会话中的一轮对话
+struct SessionTurn {
+    uint64_t index{0};        // 会话内从 0 开始的轮次序号
+    int64_t timestamp{0};     // 毫秒，Unix 时间
+    std::string role;
+    std::string text;
+};
+
+struct SessionStoreOptions {
+    size_t segmentBytes{16u << 20};                  // 段文件达到该大小后滚动到新段
+    std::chrono::milliseconds commitInterval{5};     // 后台组提交的间隔
+    size_t indexStride{64};                          // 稀疏索引每隔多少轮记录一次偏移
+    size_t maxOpenSessions{256};                     // 保持打开（描述符与映射）的会话数上限
+};
+
+// 会话记录存储：每个会话一个目录，目录下是只追加的分段日志 "<首轮序号>.seg"。
+//
+// 段文件格式（小端）：u32 magic | u32 version | 记录...
+// 记录：u32 负载长度 | 负载 | u64 负载校验和（FNV-1a）
+// 负载：varint 轮次序号 | varint 时间戳 | string 角色 | string 内容
+//
+// 追加只写入内存缓冲；有未提交的追加时，后台线程等待 commitInterval 后把所有会话的缓冲
+// 写入文件并 fdatasync，同一间隔内的追加共用一次同步（组提交），空闲时不唤醒。
+// sync 追加会立即唤醒后台线程并等待所在批次落盘。
+// 打开的会话超过 maxOpenSessions 时，按最近使用顺序关闭已落盘且无人使用的会话，下次访问时重新打开。
+//
+// 读取经 mmap 进行。每段在内存中保留稀疏索引（每 indexStride 轮一个偏移），
+// 段内轮数由相邻段的首轮序号得出，因此读取最后 N 轮只需定位到所在段，
+// 从最近的索引点开始解码，不需要解析整个会话。
+// 打开会话时只校验最后一段，截掉写了一半的尾部记录；较早的段在首次读到时才建立索引。
+class SessionStore {
+public:
+    explicit SessionStore(std::string directory, const SessionStoreOptions& options = SessionStoreOptions());
+    ~SessionStore();
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    // 追加一轮，返回轮次序号；失败时返回 UINT64_MAX 并记录日志。
+    // sync 为 true 时等到这一轮落盘后返回
+    uint64_t append(const std::string& sessionId, const std::string& role, const std::string& text,
+                    bool sync = false);
+
+    // 立即写入并同步所有会话的缓冲
+    void flush();
+
+    // 从 from 开始最多 count 轮；包含尚未落盘的追加
+    std::vector<SessionTurn> read(const std::string& sessionId, uint64_t from, size_t count);
+
+    // 最后 count 轮，按序号升序
+    std::vector<SessionTurn> readLast(const std::string& sessionId, size_t count);
+
+    uint64_t getTurnCount(const std::string& sessionId);
+    std::vector<std::string> listSessions() const;
+
+    struct Stats {
+        size_t commits{0};          // 组提交（fdatasync）次数
+        size_t appendedTurns{0};
+        size_t truncatedBytes{0};   // 打开会话时截掉的不完整尾部
+        size_t openSessions{0};     // 当前打开的会话数
+        size_t evictedSessions{0};  // 因超过 maxOpenSessions 而关闭的次数
+    };
+    Stats getStats() const;
+
+private:
+    struct Segment;
+    struct Session;
+
+    std::shared_ptr<Session> openSession(const std::string& sessionId, bool create);
+    bool loadSession(Session& session);
+    bool startSegment(Session& session, uint64_t firstTurn);
+    bool writePending(Session& session);
+    void indexSegment(Session& session, Segment& segment, bool verify);
+    void decodeRange(Session& session, uint64_t from, uint64_t end, std::vector<SessionTurn>& out);
+    void commitLoop();
+    void commit(Session& session);
+    void requestCommit(bool immediate);
+    void evictIdleSessions();   // 调用方持有 sessionsMutex_
+
+    std::string pathFor(const std::string& sessionId) const;
+
+    const std::string directory_;
+    const SessionStoreOptions options_;
+
+    mutable std::mutex sessionsMutex_;
+    std::unordered_map<std::string, std::shared_ptr<Session>> sessions_;
+    uint64_t useClock_{0};      // 最近使用顺序，由 sessionsMutex_ 保护
+
+    std::mutex commitMutex_;
+    std::condition_variable commitWakeup_;
+    bool commitRequested_{false};
+    bool stopping_{false};
+    std::atomic<bool> dirty_{false};   // 有尚未提交的追加
+    std::thread committer_;
+
+    std::atomic<size_t> commits_{0};
+    std::atomic<size_t> appendedTurns_{0};
+    std::atomic<size_t> truncatedBytes_{0};
+    std::atomic<size_t> evictedSessions_{0};
+};
+
+} // namespace openclaw
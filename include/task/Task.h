@@ -5,9 +5,15 @@
 #include <unordered_map>
 #include <vector>
 #include <chrono>
+#include <mutex>
+#include "../common/StringInterner.h"
 
 namespace openclaw {
 
+class BinaryWriter;
+class BinaryReader;
+class TokenStream;
+
 // 任务优先级
 enum class TaskPriority {
     LOW = 0,
@@ -37,6 +43,8 @@ enum class TaskType {
     CUSTOM
 };
 
+constexpr size_t kTaskTypeCount = static_cast<size_t>(TaskType::CUSTOM) + 1;
+
 // 资源需求
 struct ResourceRequirements {
     size_t memoryMB{0};
@@ -59,6 +67,10 @@ struct TaskConfig {
     size_t maxRetries{3};
     
     bool validate() const;
+    
+    // 二进制序列化（节点间转发任务使用）
+    void serialize(BinaryWriter& writer) const;
+    static bool deserialize(BinaryReader& reader, TaskConfig& config);
 };
 
 // 任务结果
@@ -90,10 +102,14 @@ struct TaskExecutionInfo {
 class Task {
 public:
     Task(const TaskConfig& config);
-    ~Task() = default;
+    Task(TaskConfig&& config);
+    // 接管调用方已为 config.id acquire 的句柄引用（快照恢复时直接从映射内存驻留 ID）
+    Task(TaskConfig&& config, StringInterner::Handle handle);
+    ~Task();
     
     // 获取任务信息
-    std::string getId() const { return config_.id; }
+    const std::string& getId() const { return config_.id; }
+    StringInterner::Handle getHandle() const { return handle_; }
     std::string getName() const { return config_.name; }
     TaskType getType() const { return config_.type; }
     TaskPriority getPriority() const { return config_.priority; }
@@ -106,6 +122,8 @@ public:
     void setAssignedAgent(const std::string& agentId);
     void setProgress(double progress);
     void setPhase(const std::string& phase);
+    void setExecutionInfo(const TaskExecutionInfo& info);   // 快照恢复使用，同时恢复状态
+    void setExecutionInfo(TaskExecutionInfo&& info);
     
     // 执行控制
     void markStarted();
@@ -120,11 +138,27 @@ public:
     
     // 资源检查
     bool canResourceRequirementsBeMet(const ResourceRequirements& available) const;
+    
+    // 流式输出：订阅方打开后，智能体执行时把输出分块写入（见 Agent::submitTask）。
+    // 已有未结束的流时返回它；任务已结束时返回 nullptr。一次执行失败会以失败结束当前流，
+    // 重试期间再次打开得到新的流
+    std::shared_ptr<TokenStream> openOutputStream();
+    
+    // 已打开且未结束的输出流，没有时为 nullptr
+    std::shared_ptr<TokenStream> getOutputStream() const;
 
 private:
+    // 结束输出流；智能体没有逐块写入时把 text 作为一个分块补上
+    void finishOutputStream(bool success, const std::string& text, const std::string& error);
+    
+
     TaskConfig config_;
+    StringInterner::Handle handle_{StringInterner::kInvalidHandle};   // 任务 ID 的驻留句柄，析构时释放
     TaskStatus status_{TaskStatus::PENDING};
     TaskExecutionInfo executionInfo_;
+    
+    mutable std::mutex outputMutex_;
+    std::shared_ptr<TokenStream> outputStream_;   // 由 outputMutex_ 保护
 };
 
 // 任务比较器（用于优先级队列）
@@ -3,6 +3,8 @@
 #include "Task.h"
 #include "../agent/Agent.h"
 #include "../agent/AgentManager.h"
+#include "../common/FlatHandleMap.h"
+#include "../common/TokenStream.h"
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
@@ -10,6 +12,8 @@
 #include <thread>
 #include <atomic>
 #include <condition_variable>
+#include <mutex>
+#include <cstdint>
 
 namespace openclaw {
 
@@ -32,6 +36,7 @@ public:
     bool push(TaskPtr task);
     TaskPtr pop();
     bool remove(const std::string& taskId);
+    bool remove(StringInterner::Handle taskHandle);
     bool contains(const std::string& taskId) const;
     
     // 查询
@@ -43,16 +48,41 @@ public:
     // 按优先级获取任务
     TaskPtr getHighestPriorityPendingTask() const;
     
+    // 按优先级顺序获取前 limit 个任务（同优先级先入先出），不修改队列
+    std::vector<TaskPtr> getTopTasks(size_t limit) const;
+    
     // 清理
     size_t cleanupCompletedTasks();
+    
+    // 按出队顺序批量装入任务并替换现有内容（快照恢复使用），不检查容量上限
+    void assign(const std::vector<TaskPtr>& ordered);
 
 private:
+    // 堆条目：序号用于同优先级下的先入先出，以及识别已被移除的旧条目
+    struct Entry {
+        TaskPtr task;
+        uint64_t seq{0};
+    };
+    struct EntryComparator {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.task->getPriority() != b.task->getPriority()) {
+                return static_cast<int>(a.task->getPriority()) < static_cast<int>(b.task->getPriority());
+            }
+            return a.seq > b.seq;
+        }
+    };
+    
+    bool isLive(const Entry& entry) const;
+    void compactIfNeeded();
+    void rebuildHeap();
+    
     mutable std::mutex mutex_;
     size_t maxSize_;
+    uint64_t nextSeq_{0};
     
-    // 使用优先级比较器的队列
-    std::priority_queue<TaskPtr, std::vector<TaskPtr>, TaskPriorityComparator> queue_;
-    std::unordered_map<std::string, TaskPtr> taskMap_;
+    // 二叉堆（std::push_heap/pop_heap 维护），移除采用惰性删除
+    std::vector<Entry> heap_;
+    FlatHandleMap<Entry> taskMap_;
 };
 
 // 任务调度策略
@@ -91,11 +121,23 @@ public:
         const std::vector<Agent::Ptr>& availableAgents) override;
 };
 
+// 最短队列优先：选择邮箱积压（Agent::getQueueDepth）最少的可用智能体，积压相同时轮询
+class ShortestQueueExecutionStrategy : public DefaultExecutionStrategy {
+public:
+    Agent::Ptr selectAgentForTask(
+        const std::shared_ptr<Task>& task,
+        const std::vector<Agent::Ptr>& availableAgents) override;
+
+private:
+    size_t nextStart_{0};
+};
+
 // 任务调度器
 class TaskScheduler {
 public:
     using TaskPtr = std::shared_ptr<Task>;
     using TaskCallback = std::function<void(const TaskPtr&)>;
+    using Clock = std::function<std::chrono::system_clock::time_point()>;
     
     TaskScheduler(AgentManager& agentManager);
     ~TaskScheduler();
@@ -109,17 +151,31 @@ public:
     void setTaskQueueMaxSize(size_t maxSize);
     void setExecutionStrategy(std::unique_ptr<ExecutionStrategy> strategy);
     
-    // 任务调度
-    void scheduleTask(const TaskConfig& config);
+    // 时钟（默认 system_clock::now，仿真器可替换为虚拟时钟），用于回填调度的完成时间估计
+    void setClock(Clock clock);
+    
+    // 任务调度（依赖未满足的任务先挂起，依赖全部完成后才进入队列）。
+    // 依赖必须是已调度且尚未清理的其他任务；依赖不存在或已失败、取消、超时时拒绝并返回 false
+    bool scheduleTask(const TaskConfig& config);
     bool cancelTask(const std::string& taskId);
     TaskPtr getTask(const std::string& taskId);
     TaskStatus getTaskStatus(const std::string& taskId);
     
+    // 订阅任务的流式输出：执行该任务的智能体改为 executeTaskStreaming，分块到达即可读到；
+    // 不支持流式的智能体在任务结束时整体写入。任务不存在或已结束时返回空读者
+    TokenStream::Reader subscribeOutput(const std::string& taskId);
+    
     // 任务查询
     std::vector<TaskPtr> getAllTasks() const;
     std::vector<TaskPtr> getTasksByStatus(TaskStatus status) const;
     std::vector<TaskPtr> getTasksByAgent(const std::string& agentId) const;
     
+    // 获取运行中任务预留的全部智能体（首个为执行者，其余为协作者）
+    std::vector<std::string> getReservedAgents(const std::string& taskId) const;
+    
+    // 组任务需要同时预留的智能体数（resourceRequirements.cpuCores，至少为 1）
+    static size_t gangWidth(const TaskPtr& task);
+    
     // 调度控制
     void start();
     void stop();
@@ -127,6 +183,24 @@ public:
     void resume();
     bool isRunning() const;
     
+    // 手动执行一轮调度（调度线程未启动时由仿真器/测试驱动）
+    void runSchedulingRound();
+    
+    // 从任务表中移除已结束的任务，返回移除数量
+    size_t cleanupFinishedTasks();
+    
+    // 工作窃取：从队列尾部（最低优先级）取出至多 maxTasks 个可迁移的就绪任务，
+    // 并将其从本调度器中移除。被其他任务依赖、带 partitionKey 或组调度的任务不会被取出
+    std::vector<TaskConfig> releaseReadyTasks(size_t maxTasks);
+    
+    // 当前可用（运行中且未被预留）的智能体数量
+    size_t getAvailableAgentCount() const;
+    
+    // 状态快照：任务、队列顺序、依赖关系、智能体分配与统计写入带版本的二进制文件。
+    // 恢复只能在调度器停止且没有任何任务时进行；快照时正在运行的任务恢复为待执行并重新排队
+    bool snapshot(const std::string& path) const;
+    bool restore(const std::string& path);
+    
     // 统计监控
     struct SchedulerStats {
         size_t totalTasksScheduled;
@@ -157,11 +231,25 @@ private:
     std::atomic<bool> paused_{false};
     std::thread schedulerThread_;
     
-    // 任务状态管理
+    // 任务状态管理（均以驻留句柄为键，字符串 ID 只在接口边界处转换）
+    using Handle = StringInterner::Handle;
     mutable std::mutex tasksMutex_;
-    std::unordered_map<std::string, TaskPtr> allTasks_;
-    std::unordered_set<std::string> runningTasks_;
-    std::unordered_map<std::string, std::string> taskAgentMap_; // taskId -> agentId
+    FlatHandleMap<TaskPtr> allTasks_;
+    FlatHandleSet runningTasks_;
+    FlatHandleMap<Handle> taskAgentMap_;   // 任务 -> 智能体
+    FlatHandleMap<size_t> agentLoad_;      // 智能体 -> 执行中的任务数，不超过 Agent::getConcurrency
+    
+    // 组调度：需要 N 个槽位（resourceRequirements.cpuCores）的任务一次性预留 N 个智能体
+    struct Reservation {
+        std::vector<Handle> agents;
+        std::chrono::system_clock::time_point expectedEnd;   // 以 timeoutSeconds 作为运行时间上界
+    };
+    FlatHandleMap<Reservation> reservations_;   // 任务 -> 预留
+    Clock clock_;
+    
+    // 依赖管理
+    FlatHandleMap<size_t> blockedTasks_;                // 任务 -> 未完成依赖数
+    FlatHandleMap<std::vector<Handle>> dependents_;     // 依赖 -> 等待它的任务
     
     // 统计
     mutable std::mutex statsMutex_;
@@ -181,9 +269,16 @@ private:
     // 私有方法
     void schedulerLoop();
     void processSchedulingRound();
-    void executeTask(TaskPtr task, Agent::Ptr agent);
+    void executeTask(TaskPtr task, const std::vector<Agent::Ptr>& agents);
+    void onTaskFinished(const TaskPtr& task, const std::shared_ptr<TaskResult>& result);
+    bool computeShadowTime(size_t width, size_t freeAgents,
+                           std::chrono::system_clock::time_point& shadowTime,
+                           size_t& extraAgents) const;
+    void releaseDependents(Handle taskHandle);
+    void cancelDependents(Handle taskHandle);
+    static bool isTerminal(TaskStatus status);
     bool canScheduleMoreTasks() const;
-    std::vector<Agent::Ptr> getAvailableAgents() const;
+    std::vector<Agent::Ptr> getAvailableAgents(FlatHandleMap<size_t>& freeSlots) const;
     void updateStats(const TaskPtr& task, bool completed);
 };
 
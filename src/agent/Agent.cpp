@@ -1,5 +1,15 @@
 #include "agent/Agent.h"
+#include "task/Task.h"
+#include "common/EpochManager.h"
+#include "common/MpscQueue.h"
+#include "common/TokenStream.h"
+#include "logging/Logger.h"
+#include <algorithm>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 namespace openclaw {
 
@@ -31,21 +41,350 @@ AgentConfig AgentConfig::fromJson(const std::string& json) {
     return config;
 }
 
+// 智能体邮箱：生产者无锁入队；执行线程之间用 consumerMutex 串行化出队，
+// 只有存在空闲执行线程时生产者才需要短暂加锁唤醒
+struct Agent::Mailbox {
+    explicit Mailbox(size_t threads) : threadCount(threads) {}
+    
+    // 取出一条消息；队列为空时返回 false
+    bool take(Message& message) {
+        if (queued.load() == 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(consumerMutex);
+        while (!queue.pop(message)) {
+            // 计数已增加但生产者尚未完成链接，稍等即可看到
+            if (queued.load() == 0) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        queued.fetch_sub(1);
+        return true;
+    }
+    
+    void run() {
+        while (true) {
+            Message message;
+            if (take(message)) {
+                message();
+                pending.fetch_sub(1);
+                continue;
+            }
+            if (closed.load()) {
+                return;
+            }
+            
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            idle.fetch_add(1);
+            wake.wait(lock, [this] { return queued.load() > 0 || closed.load(); });
+            idle.fetch_sub(1);
+        }
+    }
+    
+    MpscQueue<Message> queue;
+    std::atomic<size_t> queued{0};    // 已入队尚未取出
+    std::atomic<size_t> pending{0};   // 已投递尚未处理完
+    std::atomic<size_t> idle{0};      // 等待唤醒的执行线程数
+    std::atomic<size_t> posting{0};   // 正在投递的生产者数，关闭时等待其归零
+    std::atomic<bool> closed{false};
+    
+    std::mutex consumerMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    
+    // 执行线程在首次投递时才创建
+    size_t threadCount;
+    std::once_flag started;
+    std::vector<std::thread> workers;
+};
+
 // Agent 实现
-Agent::Agent(const AgentConfig& config) : config_(config) {
+Agent::Agent(const AgentConfig& config)
+    : id_(config.id), handle_(StringInterner::getInstance().intern(config.id)),
+      config_(std::make_shared<const AgentConfig>(config)), capabilityMask_(capabilityMaskOf(config)) {
     status_ = AgentStatus::STOPPED;
+    if (config.useMailbox) {
+        mailbox_ = std::make_shared<Mailbox>(std::max<size_t>(1, config.resourceLimits.maxThreads));
+    }
+}
+
+Agent::~Agent() {
+    shutdownMailbox();
+}
+
+bool Agent::post(Message message) {
+    if (!mailbox_) {
+        return false;
+    }
+    
+    Mailbox& mailbox = *mailbox_;
+    mailbox.posting.fetch_add(1);
+    if (mailbox.closed.load()) {
+        mailbox.posting.fetch_sub(1);
+        return false;
+    }
+    
+    mailbox.pending.fetch_add(1);
+    mailbox.queue.push(std::move(message));
+    mailbox.queued.fetch_add(1);
+    mailbox.posting.fetch_sub(1);
+    
+    // 执行线程共同持有邮箱：智能体可能在执行线程上析构，此时该线程分离后仍要访问邮箱
+    std::call_once(mailbox.started, [this] {
+        for (size_t i = 0; i < mailbox_->threadCount; ++i) {
+            mailbox_->workers.emplace_back([mailbox = mailbox_] { mailbox->run(); });
+        }
+    });
+    
+    // 与执行线程登记空闲、检查队列的顺序配对，不会丢失唤醒
+    if (mailbox.idle.load() > 0) {
+        std::lock_guard<std::mutex> lock(mailbox.wakeMutex);
+        mailbox.wake.notify_one();
+    }
+    return true;
+}
+
+size_t Agent::getQueueDepth() const {
+    return mailbox_ ? mailbox_->pending.load() : 0;
+}
+
+size_t Agent::getConcurrency() const {
+    return mailbox_ ? mailbox_->threadCount : 1;
+}
+
+void Agent::shutdownMailbox() {
+    if (!mailbox_ || mailbox_->closed.exchange(true)) {
+        return;
+    }
+    
+    Mailbox& mailbox = *mailbox_;
+    while (mailbox.posting.load() > 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mailbox.wakeMutex);
+        mailbox.wake.notify_all();
+    }
+    
+    // 首次投递可能与关闭并发，先确保不会再创建执行线程。
+    // 最后一个引用在执行线程上释放时在该线程上关闭，不能等待自己，改为分离
+    std::call_once(mailbox.started, [] {});
+    for (auto& worker : mailbox.workers) {
+        if (worker.get_id() == std::this_thread::get_id()) {
+            worker.detach();
+        } else if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    
+    // 执行线程退出前后入队的消息在此处理完，保证每个任务都有回调
+    Message message;
+    while (mailbox.take(message)) {
+        message();
+        mailbox.pending.fetch_sub(1);
+    }
 }
 
 bool Agent::updateConfig(const AgentConfig& config) {
-    if (!config.validate()) {
+    // 智能体 ID 是管理器和调度器中的键，不允许通过更新配置修改
+    if (!config.validate() || config.id != id_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(configMutex_);
+    std::atomic_store(&config_, std::shared_ptr<const AgentConfig>(std::make_shared<const AgentConfig>(config)));
+    capabilityMask_ = capabilityMaskOf(config);
+    return true;
+}
+
+bool Agent::checkpoint(std::ostream& out) const {
+    std::string state = serializeState();
+    return static_cast<bool>(out.write(state.data(), static_cast<std::streamsize>(state.size())));
+}
+
+bool Agent::restore(std::istream& in) {
+    std::string state((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return restoreState(state);
+}
+
+uint32_t Agent::capabilityMaskOf(const AgentConfig& config) {
+    if (config.capabilities.empty()) {
+        return (1u << kTaskTypeCount) - 1;
+    }
+    uint32_t mask = 1u << static_cast<size_t>(TaskType::UNKNOWN);
+    for (TaskType type : config.capabilities) {
+        if (static_cast<size_t>(type) < kTaskTypeCount) {
+            mask |= 1u << static_cast<size_t>(type);
+        }
+    }
+    return mask;
+}
+
+void Agent::start() {
+    setStatus(AgentStatus::RUNNING);
+}
+
+void Agent::stop() {
+    setStatus(AgentStatus::STOPPED);
+}
+
+void Agent::pause() {
+    setStatus(AgentStatus::PAUSED);
+}
+
+void Agent::resume() {
+    setStatus(AgentStatus::RUNNING);
+}
+
+bool Agent::setStatus(AgentStatus status) {
+    AgentStatus old = status_.exchange(status);
+    if (old == status) {
         return false;
     }
-    config_ = config;
+    // 通知处于读临界区内，管理器析构时据此等待进行中的通知结束
+    EpochManager::Guard guard;
+    if (AgentStatusObserver* observer = observer_.load()) {
+        observer->onAgentStatusChanged(*this, old, status);
+    }
     return true;
 }
 
+void Agent::heartbeat() {
+    // 先写时间戳再读登记标记（均为顺序一致），与 checkHeartbeat 的解除登记配对
+    lastHeartbeat_.store(std::chrono::steady_clock::now().time_since_epoch().count());
+    
+    // 常规路径到此为止；只有未登记时才走慢路径通知
+    if (heartbeatArmed_.load() || heartbeatArmed_.exchange(true)) {
+        return;
+    }
+    healthy_ = true;
+    EpochManager::Guard guard;
+    if (AgentStatusObserver* observer = observer_.load()) {
+        observer->onAgentHeartbeatStarted(*this);
+    } else {
+        // 无人监听时保持未登记，加入管理器后的首次心跳仍能通知
+        heartbeatArmed_ = false;
+    }
+}
+
+Agent::HeartbeatCheck Agent::checkHeartbeat(std::chrono::steady_clock::time_point observed) {
+    auto stamp = observed.time_since_epoch().count();
+    if (lastHeartbeat_.load() != stamp) {
+        return HeartbeatCheck::BEATING;
+    }
+    bool idle = activeTasks_.load() == 0;
+    
+    // 解除登记后再看一次时间戳：并发心跳若仍看到已登记而走了快路径，这里必然能看到它写入的时间戳
+    heartbeatArmed_ = false;
+    if (lastHeartbeat_.load() != stamp) {
+        heartbeatArmed_ = true;
+        return HeartbeatCheck::BEATING;
+    }
+    if (idle) {
+        return HeartbeatCheck::IDLE;
+    }
+    healthy_ = false;
+    return HeartbeatCheck::MISSED;
+}
+
+void Agent::beginTask() {
+    activeTasks_.fetch_add(1);
+    heartbeat();
+}
+
+void Agent::endTask() {
+    heartbeat();
+    activeTasks_.fetch_sub(1);
+}
+
+void Agent::submitTask(const std::shared_ptr<Task>& task, TaskCompletion done) {
+    beginTask();
+    if (mailbox_) {
+        // 排队的任务持有智能体的引用，智能体不会在任务执行前析构；
+        // 不由 shared_ptr 管理的智能体由持有者保证先关闭邮箱
+        bool posted = post([this, self = weak_from_this().lock(), task, done] {
+            std::shared_ptr<TaskResult> result;
+            {
+                ResourceAccounting::Scope scope(handle_);
+                heartbeat();   // 执行线程取到任务，排队期间不算停顿
+                result = runTask(*task);
+            }
+            endTask();
+            if (done) {
+                done(result);
+            }
+        });
+        if (!posted) {
+            endTask();
+            if (done) {
+                auto result = std::make_shared<TaskResult>(false);
+                result->errorMessage = "Agent mailbox is closed: " + getId();
+                done(result);
+            }
+        }
+        return;
+    }
+    
+    std::shared_ptr<TaskResult> result;
+    {
+        ResourceAccounting::Scope scope(handle_);
+        result = runTask(*task);
+    }
+    endTask();
+    if (done) {
+        done(result);
+    }
+}
+
+std::shared_ptr<TaskResult> Agent::runTask(const Task& task) {
+    // 有订阅方打开了输出流时流式执行，否则照常执行，完整输出在任务结束时补写
+    auto stream = task.getOutputStream();
+    return stream ? executeTaskStreaming(task, stream) : executeTask(task);
+}
+
+std::shared_ptr<TaskResult> Agent::executeTaskStreaming(const Task& task, const std::shared_ptr<TokenStream>& stream) {
+    auto result = executeTask(task);
+    if (!result) {
+        stream->finish(false, "Agent returned no result: " + getId());
+        return result;
+    }
+    auto it = result->output.find("text");
+    if (it != result->output.end() && !it->second.empty()) {
+        stream->write(it->second);
+    }
+    stream->finish(result->success, result->errorMessage);
+    return result;
+}
+
 bool Agent::isHealthy() const {
-    return healthy_.load() && status_ == AgentStatus::RUNNING;
+    AgentStatus status = status_.load();
+    return healthy_.load() && (status == AgentStatus::RUNNING || status == AgentStatus::HIBERNATED);
+}
+
+ResourceUsage Agent::getResourceUsage() const {
+    return ResourceAccounting::getInstance().getUsage(handle_);
+}
+
+bool Agent::exceedsResourceLimits() const {
+    ResourceUsage usage = getResourceUsage();
+    auto config = configSnapshot();
+    const auto& limits = config->resourceLimits;
+    // 未设上限时按允许的线程数计：单线程持续占满一个核是正常负载，不应被暂停派发
+    double cpuLimit = limits.maxCpuUsage > 0.0 ? limits.maxCpuUsage
+                                               : 100.0 * static_cast<double>(std::max<size_t>(1, limits.maxThreads));
+    bool cpuExceeded = usage.cpuPercent > cpuLimit;
+    bool memoryExceeded = usage.memoryMB() > static_cast<double>(limits.maxMemoryMB);
+    bool over = cpuExceeded || memoryExceeded;
+    
+    if (ResourceAccounting::getInstance().setOverLimit(handle_, over)) {
+        if (over) {
+            Logger::getInstance().warning("Agent", "Agent " + getId() + " exceeds resource limits: cpu " +
+                std::to_string(usage.cpuPercent) + "%, memory " + std::to_string(usage.memoryMB()) + "MB");
+        } else {
+            Logger::getInstance().info("Agent", "Agent " + getId() + " is back within resource limits");
+        }
+    }
+    return over;
 }
 
 std::string Agent::statusToString(AgentStatus status) {
@@ -57,6 +396,7 @@ std::string Agent::statusToString(AgentStatus status) {
         case AgentStatus::PAUSED: return "PAUSED";
         case AgentStatus::STOPPING: return "STOPPING";
         case AgentStatus::ERROR: return "ERROR";
+        case AgentStatus::HIBERNATED: return "HIBERNATED";
         default: return "UNKNOWN";
     }
 }
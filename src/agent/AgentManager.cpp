@@ -1,11 +1,67 @@
 #include "agent/AgentManager.h"
+#include "agent/LazyAgent.h"
+#include "agent/RemoteAgent.h"
+#include "agent/WorkspaceCache.h"
 #include "logging/Logger.h"
 #include "events/EventDispatcher.h"
+#include <algorithm>
+#include <sstream>
 #include <thread>
 
 namespace openclaw {
 
-AgentManager::AgentManager() {}
+AgentManager::Registry* AgentManager::Registry::inserted(const AgentPtr& agent) const {
+    auto* next = new Registry(*this);
+    next->added.emplace(agent->getHandle(), agent);
+    next->addedOrder.push_back(agent);
+    next->count++;
+    next->compactIfNeeded();
+    return next;
+}
+
+AgentManager::Registry* AgentManager::Registry::erased(StringInterner::Handle handle) const {
+    auto* next = new Registry(*this);
+    if (next->added.erase(handle)) {
+        auto& order = next->addedOrder;
+        order.erase(std::find_if(order.begin(), order.end(),
+                                 [handle](const AgentPtr& agent) { return agent->getHandle() == handle; }));
+    } else {
+        next->removed.insert(handle);
+    }
+    next->count--;
+    next->compactIfNeeded();
+    return next;
+}
+
+void AgentManager::Registry::compactIfNeeded() {
+    static constexpr size_t kMinOverlay = 32;
+    size_t limit = kMinOverlay;
+    while (limit * limit < base->agents.size()) {
+        limit *= 2;
+    }
+    if (added.size() + removed.size() <= limit) {
+        return;
+    }
+    Registry* merged = filtered([](const AgentPtr&) { return true; });
+    *this = std::move(*merged);
+    delete merged;
+}
+
+AgentManager::AgentIndex::AgentIndex() {
+    auto empty = std::make_shared<const List>();
+    byStatus.fill(empty);
+    byTaskType.fill(empty);
+}
+
+AgentManager::AgentManager() : registry_(new Registry()), index_(new AgentIndex()) {}
+
+AgentManager::~AgentManager() {
+    // 智能体可能比管理器活得久（如超时后分离的启停线程），先解除观察者，
+    // 再等已经读到本管理器的通知离开读临界区
+    registry_.load()->forEach([this](const AgentPtr& agent) { untrack(*agent); });
+    EpochManager::getInstance().retire([] {});
+    EpochManager::getInstance().synchronize();
+}
 
 Agent::Ptr AgentManager::createAgent(const AgentConfig& config) {
     if (!config.validate()) {
@@ -13,25 +69,50 @@ Agent::Ptr AgentManager::createAgent(const AgentConfig& config) {
         return nullptr;
     }
     
-    std::lock_guard<std::mutex> lock(agentsMutex_);
+    auto handle = StringInterner::getInstance().intern(config.id);
+    if (handle == StringInterner::kInvalidHandle) {
+        Logger::getInstance().error("AgentManager", "Cannot intern agent id: " + config.id);
+        return nullptr;
+    }
+    std::unique_lock<std::mutex> lock(agentsMutex_);
     
     // 检查ID是否已存在
-    if (agents_.find(config.id) != agents_.end()) {
+    const Registry* current = registry_.load();
+    if (current->find(handle)) {
         Logger::getInstance().error("AgentManager", 
             "Agent with ID " + config.id + " already exists");
         return nullptr;
     }
     
-    // 使用工厂创建智能体
-    auto agent = AgentFactory::getInstance().createAgent(config);
+    // 使用工厂创建智能体；延迟智能体与进程外智能体先登记代理，真实智能体由代理通过工厂构造
+    AgentPtr agent;
+    ResourceAccounting::Scope scope(handle);
+    if (config.outOfProcess) {
+        if (AgentFactory::getInstance().isRegistered(config.type)) {
+            agent = std::make_shared<RemoteAgent>(config);
+        }
+    } else if (config.lazy) {
+        if (AgentFactory::getInstance().isRegistered(config.type)) {
+            agent = std::make_shared<LazyAgent>(config);
+        }
+    } else {
+        agent = AgentFactory::getInstance().createAgent(config);
+    }
     if (!agent) {
         Logger::getInstance().error("AgentManager", 
             "Failed to create agent of type " + Agent::typeToString(config.type));
         return nullptr;
     }
     
-    // 添加到管理器
-    agents_[config.id] = agent;
+    // 发布加入新智能体后的快照，旧快照在释放写锁后回收
+    registry_.publish(current->inserted(agent));
+    track(*agent);
+    lock.unlock();
+    RcuPtr<Registry>::reclaim();
+    
+    if (!config.workspace.empty()) {
+        WorkspaceCache::getInstance().addWorkspace(config.workspace);
+    }
     
     // 发布创建事件
     // 简化的事件发送
@@ -44,27 +125,32 @@ Agent::Ptr AgentManager::createAgent(const AgentConfig& config) {
 }
 
 bool AgentManager::deleteAgent(const std::string& agentId) {
-    std::lock_guard<std::mutex> lock(agentsMutex_);
+    auto handle = StringInterner::getInstance().find(agentId);
+    std::unique_lock<std::mutex> lock(agentsMutex_);
     
-    auto it = agents_.find(agentId);
-    if (it == agents_.end()) {
+    const Registry* current = registry_.load();
+    const AgentPtr* found = current->find(handle);
+    if (!found) {
         Logger::getInstance().warning("AgentManager", 
             "Agent not found: " + agentId);
         return false;
     }
     
-    // 停止智能体
-    auto agent = it->second;
+    // 先从管理中移除再解锁；停止智能体和回收邮箱线程（需处理完已有消息）可能很慢，放在锁外
+    auto agent = *found;
+    untrack(*agent);
+    registry_.publish(current->erased(handle));
+    lock.unlock();
+    RcuPtr<Registry>::reclaim();
+    
     if (agent->getStatus() == AgentStatus::RUNNING) {
         agent->stop();
     }
+    agent->shutdownMailbox();
     
     // 发布停止事件
     EventDispatcher::getInstance().dispatchEvent(EventType::AGENT_STOPPED);
     
-    // 从管理中移除
-    agents_.erase(it);
-    
     Logger::getInstance().info("AgentManager", 
         "Deleted agent: " + agentId);
     
@@ -72,45 +158,41 @@ bool AgentManager::deleteAgent(const std::string& agentId) {
 }
 
 Agent::Ptr AgentManager::getAgent(const std::string& agentId) {
-    std::lock_guard<std::mutex> lock(agentsMutex_);
-    
-    auto it = agents_.find(agentId);
-    if (it != agents_.end()) {
-        return it->second;
-    }
-    return nullptr;
+    AgentPtr result;
+    withAgent(agentId, [&result](const AgentPtr& agent) { result = agent; });
+    return result;
 }
 
 std::vector<Agent::Ptr> AgentManager::listAgents() const {
-    std::lock_guard<std::mutex> lock(agentsMutex_);
-    
     std::vector<Agent::Ptr> result;
-    for (const auto& pair : agents_) {
-        result.push_back(pair.second);
-    }
+    EpochManager::Guard guard;
+    const Registry* current = registry_.load();
+    result.reserve(current->count);
+    current->forEach([&result](const AgentPtr& agent) { result.push_back(agent); });
     return result;
 }
 
 std::vector<Agent::Ptr> AgentManager::listAgentsByType(AgentType type) const {
-    std::lock_guard<std::mutex> lock(agentsMutex_);
-    
     std::vector<Agent::Ptr> result;
-    for (const auto& pair : agents_) {
-        if (pair.second->getType() == type) {
-            result.push_back(pair.second);
+    forEachAgent([&](const AgentPtr& agent) {
+        if (agent->getType() == type) {
+            result.push_back(agent);
         }
-    }
+    });
     return result;
 }
 
 std::vector<Agent::Ptr> AgentManager::listAgentsByStatus(AgentStatus status) const {
-    std::lock_guard<std::mutex> lock(agentsMutex_);
-    
     std::vector<Agent::Ptr> result;
-    for (const auto& pair : agents_) {
-        if (pair.second->getStatus() == status) {
-            result.push_back(pair.second);
-        }
+    if (static_cast<size_t>(status) >= kStatusCount) {
+        return result;
+    }
+    
+    EpochManager::Guard guard;
+    const auto& agents = *index_.load()->byStatus[static_cast<size_t>(status)];
+    result.reserve(agents.size());
+    for (Agent* agent : agents) {
+        result.push_back(agent->shared_from_this());
     }
     return result;
 }
@@ -130,61 +212,244 @@ bool AgentManager::updateAgentConfig(const std::string& agentId, const AgentConf
             "Cannot update config, agent not found: " + agentId);
         return false;
     }
-    return agent->updateConfig(config);
-}
-
-void AgentManager::startAllAgents() {
-    auto agents = listAgents();
-    for (auto& agent : agents) {
-        if (agent->getStatus() == AgentStatus::STOPPED) {
-            agent->start();
+    if (!agent->updateConfig(config)) {
+        return false;
+    }
+    
+    // 能力可能变化，按新配置重新登记能力索引
+    {
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        if (agent->statusBucket_ >= 0) {
+            reindex(*agent, true);
         }
     }
+    RcuPtr<AgentIndex>::reclaim();
+    return true;
 }
 
-void AgentManager::stopAllAgents() {
-    auto agents = listAgents();
-    for (auto& agent : agents) {
-        if (agent->getStatus() == AgentStatus::RUNNING ||
-            agent->getStatus() == AgentStatus::PAUSED) {
-            agent->stop();
-        }
-    }
+LifecycleReport AgentManager::startAllAgents(std::chrono::milliseconds deadline, size_t parallelism) {
+    return runLifecycle("start",
+                        [](AgentStatus status) { return status == AgentStatus::STOPPED; },
+                        [](Agent& agent) { agent.start(); },
+                        AgentStatus::RUNNING, deadline, parallelism);
 }
 
-void AgentManager::pauseAllAgents() {
-    auto agents = listAgents();
-    for (auto& agent : agents) {
-        if (agent->getStatus() == AgentStatus::RUNNING) {
-            agent->pause();
+LifecycleReport AgentManager::stopAllAgents(std::chrono::milliseconds deadline, size_t parallelism) {
+    return runLifecycle("stop",
+                        [](AgentStatus status) {
+                            return status == AgentStatus::RUNNING || status == AgentStatus::PAUSED ||
+                                   status == AgentStatus::HIBERNATED;
+                        },
+                        [](Agent& agent) { agent.stop(); },
+                        AgentStatus::STOPPED, deadline, parallelism);
+}
+
+LifecycleReport AgentManager::pauseAllAgents(std::chrono::milliseconds deadline, size_t parallelism) {
+    return runLifecycle("pause",
+                        [](AgentStatus status) {
+                            return status == AgentStatus::RUNNING || status == AgentStatus::HIBERNATED;
+                        },
+                        [](Agent& agent) { agent.pause(); },
+                        AgentStatus::PAUSED, deadline, parallelism);
+}
+
+LifecycleReport AgentManager::resumeAllAgents(std::chrono::milliseconds deadline, size_t parallelism) {
+    return runLifecycle("resume",
+                        [](AgentStatus status) { return status == AgentStatus::PAUSED; },
+                        [](Agent& agent) { agent.resume(); },
+                        AgentStatus::RUNNING, deadline, parallelism);
+}
+
+namespace {
+
+// 一次批量操作的共享状态。超时的工作线程会被分离，因此状态由各线程共同持有
+struct LifecycleRun {
+    enum class Outcome { WAITING, RUNNING, SUCCEEDED, FAILED, TIMED_OUT };
+    
+    struct Item {
+        Agent::Ptr agent;
+        Outcome outcome{Outcome::WAITING};
+        std::chrono::steady_clock::time_point started;
+    };
+    
+    std::vector<Item> items;
+    std::atomic<size_t> next{0};
+    std::function<void(Agent&)> action;
+    AgentStatus target{AgentStatus::UNKNOWN};
+    std::chrono::milliseconds deadline{0};
+    
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t finished{0};
+    
+    // 操作返回后等待异步的过渡状态（STARTING/STOPPING）结束
+    Outcome awaitTarget(const Agent& agent, std::chrono::steady_clock::time_point due) const {
+        while (true) {
+            AgentStatus status = agent.getStatus();
+            // 休眠的智能体同样可接收任务，视为已运行
+            if (status == target || (target == AgentStatus::RUNNING && status == AgentStatus::HIBERNATED)) {
+                return Outcome::SUCCEEDED;
+            }
+            if (status != AgentStatus::STARTING && status != AgentStatus::STOPPING) {
+                return Outcome::FAILED;
+            }
+            if (std::chrono::steady_clock::now() >= due) {
+                return Outcome::TIMED_OUT;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
         }
     }
-}
+    
+    static void work(std::shared_ptr<LifecycleRun> run, std::shared_ptr<std::atomic<bool>> exited) {
+        while (true) {
+            size_t index = run->next.fetch_add(1);
+            if (index >= run->items.size()) {
+                break;
+            }
+            
+            auto started = std::chrono::steady_clock::now();
+            Agent::Ptr agent;
+            {
+                std::lock_guard<std::mutex> lock(run->mutex);
+                run->items[index].outcome = Outcome::RUNNING;
+                run->items[index].started = started;
+                agent = run->items[index].agent;
+            }
+            
+            run->action(*agent);
+            Outcome outcome = run->awaitTarget(*agent, started + run->deadline);
+            
+            {
+                // 已被协调线程判为超时的不再改写
+                std::lock_guard<std::mutex> lock(run->mutex);
+                if (run->items[index].outcome == Outcome::RUNNING) {
+                    run->items[index].outcome = outcome;
+                    run->finished++;
+                }
+            }
+            run->changed.notify_all();
+        }
+        exited->store(true);
+    }
+};
 
-void AgentManager::resumeAllAgents() {
-    auto agents = listAgents();
-    for (auto& agent : agents) {
-        if (agent->getStatus() == AgentStatus::PAUSED) {
-            agent->resume();
+} // namespace
+
+LifecycleReport AgentManager::runLifecycle(const std::string& operation,
+                                           const std::function<bool(AgentStatus)>& eligible,
+                                           const std::function<void(Agent&)>& action,
+                                           AgentStatus target,
+                                           std::chrono::milliseconds deadline,
+                                           size_t parallelism) {
+    using Outcome = LifecycleRun::Outcome;
+    auto begin = std::chrono::steady_clock::now();
+    
+    LifecycleReport report;
+    auto run = std::make_shared<LifecycleRun>();
+    run->action = action;
+    run->target = target;
+    run->deadline = deadline;
+    for (auto& agent : listAgents()) {
+        if (eligible(agent->getStatus())) {
+            run->items.push_back({agent, LifecycleRun::Outcome::WAITING, {}});
+        } else {
+            report.skipped.push_back(agent->getId());
+        }
+    }
+    
+    // 有界工作线程池；某个线程卡在超时的智能体上时补充一个线程，保证其余智能体照常推进
+    std::vector<std::pair<std::thread, std::shared_ptr<std::atomic<bool>>>> workers;
+    auto spawn = [&workers, &run] {
+        auto exited = std::make_shared<std::atomic<bool>>(false);
+        workers.emplace_back(std::thread(&LifecycleRun::work, run, exited), exited);
+    };
+    size_t poolSize = std::min(run->items.size(),
+                               parallelism > 0 ? parallelism : kDefaultLifecycleParallelism);
+    for (size_t i = 0; i < poolSize; ++i) {
+        spawn();
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(run->mutex);
+        while (run->finished < run->items.size()) {
+            auto now = std::chrono::steady_clock::now();
+            auto earliest = std::chrono::steady_clock::time_point::max();
+            for (auto& item : run->items) {
+                if (item.outcome != Outcome::RUNNING) {
+                    continue;
+                }
+                auto due = item.started + deadline;
+                if (due <= now) {
+                    item.outcome = Outcome::TIMED_OUT;
+                    run->finished++;
+                    if (run->next.load() < run->items.size()) {
+                        spawn();
+                    }
+                } else {
+                    earliest = std::min(earliest, due);
+                }
+            }
+            if (run->finished >= run->items.size()) {
+                break;
+            }
+            
+            if (earliest == std::chrono::steady_clock::time_point::max()) {
+                run->changed.wait(lock);
+            } else {
+                run->changed.wait_until(lock, earliest);
+            }
+        }
+        
+        for (const auto& item : run->items) {
+            switch (item.outcome) {
+                case Outcome::SUCCEEDED: report.succeeded.push_back(item.agent->getId()); break;
+                case Outcome::TIMED_OUT: report.timedOut.push_back(item.agent->getId()); break;
+                default: report.failed.push_back(item.agent->getId()); break;
+            }
         }
     }
+    
+    // 卡住的线程分离，返回后自行退出
+    for (auto& worker : workers) {
+        if (worker.second->load()) {
+            worker.first.join();
+        } else {
+            worker.first.detach();
+        }
+    }
+    
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    Logger::getInstance().info("AgentManager",
+        "Bulk " + operation + ": " + std::to_string(report.succeeded.size()) + " succeeded, " +
+        std::to_string(report.failed.size()) + " failed, " +
+        std::to_string(report.timedOut.size()) + " timed out in " +
+        std::to_string(report.elapsed.count()) + "ms");
+    for (const auto& id : report.timedOut) {
+        Logger::getInstance().warning("AgentManager", "Agent " + operation + " timed out: " + id);
+    }
+    return report;
 }
 
 size_t AgentManager::getAgentCount() const {
-    std::lock_guard<std::mutex> lock(agentsMutex_);
-    return agents_.size();
+    EpochManager::Guard guard;
+    return registry_.load()->count;
 }
 
 size_t AgentManager::getAgentCountByStatus(AgentStatus status) const {
-    return listAgentsByStatus(status).size();
+    if (static_cast<size_t>(status) >= kStatusCount) {
+        return 0;
+    }
+    EpochManager::Guard guard;
+    return index_.load()->byStatus[static_cast<size_t>(status)]->size();
 }
 
 std::unordered_map<AgentStatus, size_t> AgentManager::getAgentStatusDistribution() const {
     std::unordered_map<AgentStatus, size_t> distribution;
     
-    for (int i = 0; i <= static_cast<int>(AgentStatus::ERROR); ++i) {
-        AgentStatus status = static_cast<AgentStatus>(i);
-        distribution[status] = getAgentCountByStatus(status);
+    EpochManager::Guard guard;
+    const AgentIndex* index = index_.load();
+    for (size_t i = 0; i < kStatusCount; ++i) {
+        distribution[static_cast<AgentStatus>(i)] = index->byStatus[i]->size();
     }
     
     return distribution;
@@ -192,42 +457,203 @@ std::unordered_map<AgentStatus, size_t> AgentManager::getAgentStatusDistribution
 
 std::vector<std::string> AgentManager::getUnhealthyAgents() const {
     std::vector<std::string> result;
-    auto agents = listAgents();
     
-    for (const auto& agent : agents) {
+    forEachAgent([&](const AgentPtr& agent) {
         if (!agent->isHealthy()) {
             result.push_back(agent->getId());
         }
-    }
+    });
     
     return result;
 }
 
 void AgentManager::setStatusCallback(AgentStatusCallback callback) {
+    std::lock_guard<std::mutex> lock(statusMutex_);
     statusCallback_ = callback;
 }
 
 void AgentManager::notifyStatusChange(const std::string& agentId, 
                                       AgentStatus oldStatus, 
                                       AgentStatus newStatus) {
-    if (statusCallback_) {
-        statusCallback_(agentId, newStatus);
+    AgentStatusCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        callback = statusCallback_;
+    }
+    if (callback) {
+        callback(agentId, newStatus);
     }
     
     EventDispatcher::getInstance().dispatchEvent(EventType::AGENT_STATUS_CHANGED);
 }
 
-size_t AgentManager::cleanupStoppedAgents() {
-    std::lock_guard<std::mutex> lock(agentsMutex_);
+void AgentManager::onAgentStatusChanged(Agent& agent, AgentStatus oldStatus, AgentStatus newStatus) {
+    {
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        // 已被移出管理器（或尚未登记）的智能体不再计入
+        if (agent.statusBucket_ < 0) {
+            return;
+        }
+        // 并发变更时按最新状态归桶，多次变更最终收敛到实际状态；已在该桶中时无需重建
+        if (agent.statusBucket_ != static_cast<int>(agent.status_.load())) {
+            reindex(agent, true);
+        }
+    }
+    RcuPtr<AgentIndex>::reclaim();
     
+    notifyStatusChange(agent.getId(), oldStatus, newStatus);
+}
+
+void AgentManager::setHeartbeatListener(HeartbeatListener listener) {
+    std::lock_guard<std::mutex> lock(statusMutex_);
+    heartbeatListener_ = std::move(listener);
+}
+
+void AgentManager::onAgentHeartbeatStarted(Agent& agent) {
+    std::lock_guard<std::mutex> lock(statusMutex_);
+    if (agent.statusBucket_ >= 0 && heartbeatListener_) {
+        heartbeatListener_(agent.shared_from_this());
+    }
+}
+
+void AgentManager::track(Agent& agent) {
+    // 先挂观察者再入桶：两者之间发生的变更由入桶时读取的最新状态覆盖
+    agent.setStatusObserver(this);
+    std::lock_guard<std::mutex> lock(statusMutex_);
+    reindex(agent, true);
+}
+
+void AgentManager::untrack(Agent& agent) {
+    agent.setStatusObserver(nullptr);
+    std::lock_guard<std::mutex> lock(statusMutex_);
+    if (agent.statusBucket_ >= 0) {
+        reindex(agent, false);
+    }
+}
+
+namespace {
+
+using AgentList = std::vector<Agent*>;
+
+std::shared_ptr<const AgentList> listWith(const AgentList& list, Agent* agent) {
+    auto next = std::make_shared<AgentList>();
+    next->reserve(list.size() + 1);
+    next->assign(list.begin(), list.end());
+    next->push_back(agent);
+    return next;
+}
+
+std::shared_ptr<const AgentList> listWithout(const AgentList& list, Agent* agent) {
+    auto next = std::make_shared<AgentList>();
+    next->reserve(list.size());
+    for (Agent* other : list) {
+        if (other != agent) {
+            next->push_back(other);
+        }
+    }
+    return next;
+}
+
+} // namespace
+
+void AgentManager::reindex(Agent& agent, bool keep) {
+    auto* next = new AgentIndex(*index_.load());
+    
+    if (agent.statusBucket_ >= 0) {
+        auto& list = next->byStatus[static_cast<size_t>(agent.statusBucket_)];
+        list = listWithout(*list, &agent);
+        for (size_t type = 0; type < kTaskTypeCount; ++type) {
+            if ((agent.indexedMask_ >> type) & 1u) {
+                auto& typed = next->byTaskType[type];
+                typed = listWithout(*typed, &agent);
+            }
+        }
+        agent.statusBucket_ = -1;
+        agent.indexedMask_ = 0;
+    }
+    
+    if (keep) {
+        size_t bucket = static_cast<size_t>(agent.status_.load());
+        if (bucket >= kStatusCount) {
+            bucket = static_cast<size_t>(AgentStatus::UNKNOWN);
+        }
+        auto& list = next->byStatus[bucket];
+        list = listWith(*list, &agent);
+        agent.statusBucket_ = static_cast<int>(bucket);
+        
+        // 可接收任务的智能体按能力加入索引
+        AgentStatus status = static_cast<AgentStatus>(bucket);
+        if (status == AgentStatus::RUNNING || status == AgentStatus::HIBERNATED) {
+            for (size_t type = 0; type < kTaskTypeCount; ++type) {
+                if (agent.canExecute(static_cast<TaskType>(type))) {
+                    auto& typed = next->byTaskType[type];
+                    typed = listWith(*typed, &agent);
+                    agent.indexedMask_ |= 1u << type;
+                }
+            }
+        }
+    }
+    
+    index_.publish(next);
+}
+
+size_t AgentManager::getAgentCountForTaskType(TaskType type) const {
+    size_t index = static_cast<size_t>(type);
+    if (index >= kTaskTypeCount) {
+        return 0;
+    }
+    EpochManager::Guard guard;
+    return index_.load()->byTaskType[index]->size();
+}
+
+size_t AgentManager::getRegisteredAgentCountForTaskType(TaskType type) const {
     size_t count = 0;
-    for (auto it = agents_.begin(); it != agents_.end();) {
-        if (it->second->getStatus() == AgentStatus::STOPPED) {
-            it = agents_.erase(it);
+    forEachAgent([&count, type](const AgentPtr& agent) {
+        if (agent->canExecute(type)) {
             count++;
-        } else {
-            ++it;
         }
+    });
+    return count;
+}
+
+bool AgentManager::allReadyAgentsCanExecute(TaskType type) const {
+    size_t index = static_cast<size_t>(type);
+    if (index >= kTaskTypeCount) {
+        return false;
+    }
+    // UNKNOWN 列表包含全部可接收任务的智能体
+    EpochManager::Guard guard;
+    const AgentIndex* current = index_.load();
+    return current->byTaskType[index]->size() ==
+           current->byTaskType[static_cast<size_t>(TaskType::UNKNOWN)]->size();
+}
+
+size_t AgentManager::cleanupStoppedAgents() {
+    std::unique_lock<std::mutex> lock(agentsMutex_);
+    
+    const Registry* current = registry_.load();
+    std::vector<AgentPtr> removed;
+    Registry* next = current->filtered([this, &removed](const AgentPtr& agent) {
+        if (agent->getStatus() != AgentStatus::STOPPED) {
+            return true;
+        }
+        untrack(*agent);
+        removed.push_back(agent);
+        return false;
+    });
+    size_t count = removed.size();
+    if (count > 0) {
+        registry_.publish(next);
+        lock.unlock();
+        RcuPtr<Registry>::reclaim();
+    } else {
+        delete next;
+        lock.unlock();
+    }
+    
+    // 邮箱线程要处理完已有消息才退出，在锁外回收
+    for (const auto& agent : removed) {
+        agent->shutdownMailbox();
     }
     
     Logger::getInstance().info("AgentManager", 
@@ -236,6 +662,40 @@ size_t AgentManager::cleanupStoppedAgents() {
     return count;
 }
 
+void AgentManager::setHibernateAfter(std::chrono::milliseconds idle) {
+    hibernateAfter_.store(idle.count());
+}
+
+std::chrono::milliseconds AgentManager::getHibernateAfter() const {
+    return std::chrono::milliseconds(hibernateAfter_.load());
+}
+
+size_t AgentManager::hibernateIdleAgents(std::chrono::milliseconds idle) {
+    // 先在读临界区内收集候选，休眠（停止真实智能体、改变状态）在临界区外进行
+    std::vector<std::shared_ptr<LazyAgent>> candidates;
+    forEachAgent([&candidates, idle](const AgentPtr& agent) {
+        if (agent->getStatus() != AgentStatus::RUNNING) {
+            return;
+        }
+        auto lazy = std::dynamic_pointer_cast<LazyAgent>(agent);
+        if (lazy && lazy->idleTime() >= idle) {
+            candidates.push_back(std::move(lazy));
+        }
+    });
+    
+    size_t count = 0;
+    for (const auto& agent : candidates) {
+        if (agent->hibernate(idle)) {
+            count++;
+        }
+    }
+    if (count > 0) {
+        Logger::getInstance().info("AgentManager", 
+            "Hibernated " + std::to_string(count) + " idle agents");
+    }
+    return count;
+}
+
 // AgentMonitor 实现
 AgentMonitor::AgentMonitor(AgentManager& manager) 
     : manager_(manager) {}
@@ -251,20 +711,60 @@ AgentMonitor::MonitorStats AgentMonitor::getStats() const {
     stats.stoppedAgents = manager_.getAgentCountByStatus(AgentStatus::STOPPED);
     stats.errorAgents = manager_.getAgentCountByStatus(AgentStatus::ERROR);
     stats.unhealthyAgents = manager_.getUnhealthyAgents().size();
+    stats.overLimitAgents = 0;
+    manager_.forEachAgent([&stats](const Agent::Ptr& agent) {
+        if (agent->exceedsResourceLimits()) {
+            stats.overLimitAgents++;
+        }
+    });
+    stats.missedHeartbeats = missedHeartbeats_.load();
     
     return stats;
 }
 
+void AgentMonitor::setHeartbeatTimeout(std::chrono::milliseconds timeout) {
+    if (monitoring_) {
+        Logger::getInstance().warning("AgentMonitor", "Heartbeat timeout can only be changed while not monitoring");
+        return;
+    }
+    heartbeatTimeout_ = timeout;
+}
+
+std::chrono::milliseconds AgentMonitor::getHeartbeatTimeout() const {
+    return heartbeatTimeout_;
+}
+
 void AgentMonitor::startMonitoring(size_t intervalSeconds) {
     if (monitoring_.exchange(true)) {
         return; // 已经在监控
     }
     
-    intervalSeconds_ = intervalSeconds;
+    scanInterval_ = std::chrono::seconds(std::max<size_t>(1, intervalSeconds));
+    
+    // 先挂监听再登记已在发心跳的智能体，两者重叠的部分由 armed_ 去重
+    manager_.setHeartbeatListener([this](const Agent::Ptr& agent) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        arm(agent);
+        wakeup_.notify_one();
+    });
+    std::vector<Agent::Ptr> beating;
+    manager_.forEachAgent([&beating](const Agent::Ptr& agent) {
+        if (agent->getLastHeartbeat().time_since_epoch().count() != 0) {
+            beating.push_back(agent);
+        }
+    });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& agent : beating) {
+            arm(agent);
+        }
+    }
+    
     monitorThread_ = std::thread(&AgentMonitor::monitorLoop, this);
     
     Logger::getInstance().info("AgentMonitor", 
-        "Started monitoring with interval " + std::to_string(intervalSeconds) + "s");
+        "Started monitoring with interval " + std::to_string(scanInterval_.count()) +
+        "s, heartbeat timeout " + std::to_string(heartbeatTimeout_.count()) + "ms");
 }
 
 void AgentMonitor::stopMonitoring() {
@@ -272,10 +772,21 @@ void AgentMonitor::stopMonitoring() {
         return; // 已经停止
     }
     
+    manager_.setHeartbeatListener(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeup_.notify_all();
+    }
+    
     if (monitorThread_.joinable()) {
         monitorThread_.join();
     }
     
+    // 重新开始监控时按当时的心跳状态重新登记
+    std::lock_guard<std::mutex> lock(mutex_);
+    deadlines_ = {};
+    armed_.clear();
+    
     Logger::getInstance().info("AgentMonitor", "Stopped monitoring");
 }
 
@@ -283,20 +794,172 @@ bool AgentMonitor::isMonitoring() const {
     return monitoring_.load();
 }
 
+void AgentMonitor::arm(const Agent::Ptr& agent) {
+    if (!armed_.insert(agent->getHandle())) {
+        return;
+    }
+    auto observed = agent->getLastHeartbeat();
+    deadlines_.push({observed + heartbeatTimeout_, observed, agent, agent->getHandle()});
+}
+
+std::chrono::steady_clock::time_point AgentMonitor::sweepIdleAgents(
+    std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point nextSweep) {
+    auto idle = manager_.getHibernateAfter();
+    if (idle.count() <= 0) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (nextSweep == std::chrono::steady_clock::time_point::max()) {
+        return now + idle;   // 刚启用：一个周期后首次扫描
+    }
+    if (now < nextSweep) {
+        return nextSweep;
+    }
+    
+    lock.unlock();
+    manager_.hibernateIdleAgents(idle);
+    lock.lock();
+    return std::chrono::steady_clock::now() + idle;
+}
+
+void AgentMonitor::scanUnhealthyAgents() {
+    auto unhealthy = manager_.getUnhealthyAgents();
+    if (!unhealthy.empty()) {
+        Logger::getInstance().warning("AgentMonitor",
+            "Unhealthy agents detected: " + std::to_string(unhealthy.size()));
+    }
+}
+
 void AgentMonitor::monitorLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto nextSweep = std::chrono::steady_clock::time_point::max();
+    auto nextScan = std::chrono::steady_clock::now() + scanInterval_;
     while (monitoring_) {
-        // 获取统计
-        auto stats = getStats();
+        nextSweep = sweepIdleAgents(lock, nextSweep);
+        if (!monitoring_) {
+            break;
+        }
         
-        // 检查不健康智能体
-        auto unhealthy = manager_.getUnhealthyAgents();
-        if (!unhealthy.empty()) {
-            Logger::getInstance().warning("AgentMonitor", "Unhealthy agents detected");
+        // 状态扫描覆盖不发心跳的智能体（停止、出错等）
+        if (std::chrono::steady_clock::now() >= nextScan) {
+            lock.unlock();
+            scanUnhealthyAgents();
+            lock.lock();
+            nextScan = std::chrono::steady_clock::now() + scanInterval_;
+            continue;
         }
         
-        // 休眠指定的时间间隔
-        std::this_thread::sleep_for(std::chrono::seconds(intervalSeconds_));
+        // 只睡到最早的截止时间（或下一次扫描）；新登记或停止监控会提前唤醒
+        auto due = deadlines_.empty() ? std::chrono::steady_clock::time_point::max() : deadlines_.top().due;
+        auto wake = std::min({due, nextSweep, nextScan});
+        if (std::chrono::steady_clock::now() < wake) {
+            wakeup_.wait_until(lock, wake);
+            continue;
+        }
+        if (deadlines_.empty()) {
+            continue;
+        }
+        
+        Deadline entry = deadlines_.top();
+        deadlines_.pop();
+        
+        auto agent = entry.agent.lock();
+        if (!agent) {
+            armed_.erase(entry.handle);
+            continue;
+        }
+        
+        Agent::HeartbeatCheck check = agent->checkHeartbeat(entry.observed);
+        if (check == Agent::HeartbeatCheck::BEATING) {
+            // 期间有过心跳：按最新心跳顺延
+            auto last = agent->getLastHeartbeat();
+            deadlines_.push({last + heartbeatTimeout_, last, std::move(agent), entry.handle});
+            continue;
+        }
+        
+        // 空闲或错过心跳：移出截止时间表，智能体下次心跳时重新登记
+        armed_.erase(entry.handle);
+        if (check == Agent::HeartbeatCheck::IDLE || agent->getStatus() != AgentStatus::RUNNING) {
+            continue;
+        }
+        missedHeartbeats_++;
+        
+        lock.unlock();
+        Logger::getInstance().warning("AgentMonitor", "Agent missed heartbeat: " + agent->getId());
+        EventDispatcher::getInstance().dispatchEvent(EventType::AGENT_ERROR);
+        lock.lock();
     }
 }
 
-} // namespace openclaw
\ No newline at end of file
+void AgentManager::setCheckpointDirectory(const std::string& directory) {
+    auto store = directory.empty() ? nullptr : std::make_shared<CheckpointStore>(directory);
+    std::lock_guard<std::mutex> lock(checkpointMutex_);
+    checkpointStore_ = std::move(store);
+}
+
+std::string AgentManager::getCheckpointDirectory() const {
+    auto store = getCheckpointStore();
+    return store ? store->getDirectory() : std::string();
+}
+
+std::shared_ptr<CheckpointStore> AgentManager::getCheckpointStore() const {
+    std::lock_guard<std::mutex> lock(checkpointMutex_);
+    return checkpointStore_;
+}
+
+bool AgentManager::checkpointAgent(const std::string& agentId) {
+    auto store = getCheckpointStore();
+    auto agent = getAgent(agentId);
+    if (!store || !agent) {
+        return false;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    std::ostringstream out(std::ios::binary);
+    if (!agent->checkpoint(out)) {
+        Logger::getInstance().error("AgentManager", "Failed to export state of agent: " + agentId);
+        return false;
+    }
+    auto paused = std::chrono::steady_clock::now() - start;
+    if (paused > kCheckpointPauseBudget) {
+        Logger::getInstance().warning("AgentManager", "Exporting state of agent " + agentId + " took " +
+            std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(paused).count()) + "ms");
+    }
+    return store->save(agentId, out.str());
+}
+
+size_t AgentManager::checkpointAllAgents() {
+    if (!getCheckpointStore()) {
+        return 0;
+    }
+    // 先复制 ID，逐个导出时不停留在读临界区内
+    std::vector<std::string> ids;
+    forEachAgent([&ids](const AgentPtr& agent) { ids.push_back(agent->getId()); });
+    
+    size_t count = 0;
+    for (const auto& id : ids) {
+        if (checkpointAgent(id)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool AgentManager::restoreAgent(const std::string& agentId) {
+    auto store = getCheckpointStore();
+    auto agent = getAgent(agentId);
+    std::string state;
+    if (!store || !agent || !store->load(agentId, state)) {
+        return false;
+    }
+    
+    std::istringstream in(std::move(state), std::ios::binary);
+    if (!agent->restore(in)) {
+        Logger::getInstance().error("AgentManager", "Failed to restore agent from checkpoint: " + agentId);
+        return false;
+    }
+    Logger::getInstance().info("AgentManager", "Restored agent from checkpoint: " + agentId);
+    return true;
+}
+
+} // namespace openclaw
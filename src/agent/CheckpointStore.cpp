@@ -0,0 +1,283 @@
+#include "agent/CheckpointStore.h"
+#include "common/BinaryCodec.h"
+#include "common/DurableFile.h"
+#include "common/FileNameEscape.h"
+#include "common/Fnv1a.h"
+#include "logging/Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace openclaw {
+
+// 检查点文件格式（小端）：
+//   u32 magic | u32 version | 帧...
+// 帧：u32 负载长度 | 负载 | u64 负载校验和
+// 负载：u8 类型 | varint 序号 | varint 状态长度 | 完整帧为全部状态字节；
+//       增量帧为 varint 块数，随后每块 varint 块号 + 块内容（长度由块号和状态长度决定）
+namespace {
+
+constexpr uint32_t kCheckpointMagic = 0x4B43434F;   // "OCCK"
+constexpr uint32_t kCheckpointVersion = 1;
+constexpr uint8_t kFullFrame = 1;
+constexpr uint8_t kDeltaFrame = 2;
+
+std::vector<uint64_t> blockHashes(const std::string& state) {
+    std::vector<uint64_t> blocks;
+    blocks.reserve((state.size() + CheckpointStore::kBlockSize - 1) / CheckpointStore::kBlockSize);
+    for (size_t offset = 0; offset < state.size(); offset += CheckpointStore::kBlockSize) {
+        blocks.push_back(fnv1a(state.data() + offset, std::min(CheckpointStore::kBlockSize, state.size() - offset)));
+    }
+    return blocks;
+}
+
+void appendFrame(std::string& out, const std::string& payload) {
+    BinaryWriter writer(out);
+    writer.writeU32(static_cast<uint32_t>(payload.size()));
+    writer.writeBytes(payload.data(), payload.size());
+    writer.writeU64(fnv1a(payload.data(), payload.size()));
+}
+
+std::string fullPayload(uint64_t sequence, const std::string& state) {
+    std::string payload;
+    payload.reserve(state.size() + 24);
+    BinaryWriter writer(payload);
+    writer.writeU8(kFullFrame);
+    writer.writeVarint(sequence);
+    writer.writeVarint(state.size());
+    writer.writeBytes(state.data(), state.size());
+    return payload;
+}
+
+// 按块散列比较新旧状态，变化的块超过状态的一半时返回 false（改写完整帧更划算）
+bool deltaPayload(uint64_t sequence, const std::vector<uint64_t>& previous, size_t previousSize,
+                  const std::string& state, const std::vector<uint64_t>& current, std::string& payload) {
+    std::string blocks;
+    BinaryWriter blockWriter(blocks);
+    size_t changed = 0;
+    for (size_t offset = 0; offset < state.size(); offset += CheckpointStore::kBlockSize) {
+        size_t index = offset / CheckpointStore::kBlockSize;
+        size_t length = std::min(CheckpointStore::kBlockSize, state.size() - offset);
+        size_t previousLength = offset < previousSize
+            ? std::min(CheckpointStore::kBlockSize, previousSize - offset) : 0;
+        if (length == previousLength && previous[index] == current[index]) {
+            continue;
+        }
+        blockWriter.writeVarint(index);
+        blockWriter.writeBytes(state.data() + offset, length);
+        changed++;
+        if (blocks.size() > state.size() / 2) {
+            return false;
+        }
+    }
+
+    BinaryWriter writer(payload);
+    writer.writeU8(kDeltaFrame);
+    writer.writeVarint(sequence);
+    writer.writeVarint(state.size());
+    writer.writeVarint(changed);
+    payload.append(blocks);
+    return true;
+}
+
+// 把一帧应用到 state 上，增量帧要求之前已有完整帧
+bool applyFrame(const char* data, size_t size, std::string& state, bool& haveFull, uint64_t& sequence) {
+    BinaryReader reader(data, size);
+    uint8_t kind = 0;
+    uint64_t stateSize = 0;
+    if (!reader.readU8(kind) || !reader.readVarint(sequence) || !reader.readVarint(stateSize)) {
+        return false;
+    }
+
+    if (kind == kFullFrame) {
+        if (reader.remaining() != stateSize) {
+            return false;
+        }
+        state.assign(reader.current(), stateSize);
+        haveFull = true;
+        return true;
+    }
+
+    uint64_t count = 0;
+    if (kind != kDeltaFrame || !haveFull || !reader.readVarint(count)) {
+        return false;
+    }
+    state.resize(stateSize);
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t block = 0;
+        if (!reader.readVarint(block) || block >= (stateSize + CheckpointStore::kBlockSize - 1) / CheckpointStore::kBlockSize) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(block) * CheckpointStore::kBlockSize;
+        size_t length = std::min(CheckpointStore::kBlockSize, state.size() - offset);
+        const char* bytes = reader.current();
+        if (!reader.skip(length)) {
+            return false;
+        }
+        state.replace(offset, length, bytes, length);
+    }
+    return reader.remaining() == 0;
+}
+
+} // namespace
+
+CheckpointStore::CheckpointStore(std::string directory) : directory_(std::move(directory)) {}
+
+bool CheckpointStore::save(const std::string& agentId, const std::string& state) {
+    auto entry = entryFor(agentId);
+    std::vector<uint64_t> blocks = blockHashes(state);
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (entry->known && entry->size == state.size() && entry->blocks == blocks) {
+        return true;   // 状态未变化，无需写入
+    }
+
+    std::string path = pathFor(agentId);
+    if (entry->known && entry->chain < kMaxDeltaChain) {
+        std::string payload;
+        if (deltaPayload(entry->sequence + 1, entry->blocks, entry->size, state, blocks, payload)) {
+            std::string frame;
+            appendFrame(frame, payload);
+            return appendDelta(path, *entry, frame, state.size(), blocks);
+        }
+    }
+    return writeFull(path, *entry, state, blocks);
+}
+
+bool CheckpointStore::load(const std::string& agentId, std::string& state) {
+    auto entry = entryFor(agentId);
+    std::lock_guard<std::mutex> lock(entry->mutex);
+
+    std::string path = pathFor(agentId);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    BinaryReader reader(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!reader.readU32(magic) || !reader.readU32(version) ||
+        magic != kCheckpointMagic || version != kCheckpointVersion) {
+        Logger::getInstance().error("CheckpointStore", "Invalid checkpoint file: " + path);
+        return false;
+    }
+
+    std::string current;
+    bool haveFull = false;
+    bool clean = true;
+    uint64_t sequence = 0;
+    size_t frames = 0;
+    while (reader.remaining() > 0) {
+        uint32_t length = 0;
+        uint64_t sum = 0;
+        const char* payload = nullptr;
+        if (reader.readU32(length)) {
+            payload = reader.current();
+        }
+        if (!payload || !reader.skip(length) || !reader.readU64(sum) || sum != fnv1a(payload, length) ||
+            !applyFrame(payload, length, current, haveFull, sequence)) {
+            clean = false;
+            break;
+        }
+        frames++;
+    }
+    if (!haveFull) {
+        Logger::getInstance().error("CheckpointStore", "No complete checkpoint in: " + path);
+        return false;
+    }
+    if (!clean) {
+        // 通常是写入中途崩溃留下的尾帧，此前的帧仍然有效；下次保存时重写整个文件
+        Logger::getInstance().warning("CheckpointStore", "Ignoring truncated checkpoint frame in: " + path);
+    }
+
+    entry->blocks = blockHashes(current);
+    entry->size = current.size();
+    entry->sequence = sequence;
+    entry->chain = frames - 1;
+    entry->known = clean;
+    state = std::move(current);
+    return true;
+}
+
+bool CheckpointStore::remove(const std::string& agentId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(agentId);
+    }
+    return std::remove(pathFor(agentId).c_str()) == 0;
+}
+
+CheckpointStore::Stats CheckpointStore::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::shared_ptr<CheckpointStore::Entry> CheckpointStore::entryFor(const std::string& agentId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[agentId];
+    if (!entry) {
+        entry = std::make_shared<Entry>();
+    }
+    return entry;
+}
+
+std::string CheckpointStore::pathFor(const std::string& agentId) const {
+    return directory_ + "/" + escapeFileName(agentId) + ".ckpt";
+}
+
+bool CheckpointStore::writeFull(const std::string& path, Entry& entry, const std::string& state,
+                                std::vector<uint64_t>& blocks) {
+    std::string image;
+    image.reserve(state.size() + 48);
+    BinaryWriter header(image);
+    header.writeU32(kCheckpointMagic);
+    header.writeU32(kCheckpointVersion);
+    appendFrame(image, fullPayload(entry.sequence + 1, state));
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+
+    // 崩溃时保留上一份完整的检查点
+    if (!writeFileDurably(path, image.data(), image.size())) {
+        Logger::getInstance().error("CheckpointStore", "Failed to write checkpoint: " + path);
+        entry.known = false;
+        return false;
+    }
+
+    entry.blocks.swap(blocks);
+    entry.size = state.size();
+    entry.sequence++;
+    entry.chain = 0;
+    entry.known = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.fullCheckpoints++;
+    stats_.bytesWritten += image.size();
+    return true;
+}
+
+bool CheckpointStore::appendDelta(const std::string& path, Entry& entry, const std::string& frame, size_t size,
+                                  std::vector<uint64_t>& blocks) {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    if (!out || !out.write(frame.data(), static_cast<std::streamsize>(frame.size())) || !out.flush()) {
+        // 文件末尾可能留下半帧，下次保存时改写完整帧
+        Logger::getInstance().error("CheckpointStore", "Failed to append checkpoint: " + path);
+        entry.known = false;
+        return false;
+    }
+
+    entry.blocks.swap(blocks);
+    entry.size = size;
+    entry.sequence++;
+    entry.chain++;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.deltaCheckpoints++;
+    stats_.bytesWritten += frame.size();
+    return true;
+}
+
+} // namespace openclaw
@@ -0,0 +1,303 @@
+#include "agent/LazyAgent.h"
+#include "task/Task.h"
+#include "common/TokenStream.h"
+#include "logging/Logger.h"
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <ostream>
+
+namespace openclaw {
+
+namespace {
+
+// 代理本身不需要邮箱，邮箱属于真实智能体
+AgentConfig proxyConfig(AgentConfig config) {
+    config.useMailbox = false;
+    return config;
+}
+
+int64_t steadyNow() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+} // namespace
+
+LazyAgent::LazyAgent(const AgentConfig& config)
+    : Agent(proxyConfig(config)), useMailbox_(config.useMailbox) {
+    touch();
+}
+
+LazyAgent::~LazyAgent() = default;
+
+void LazyAgent::start() {
+    Agent::Ptr inner;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMaterialize(lock);
+        inner = inner_;
+    }
+    if (inner) {
+        inner->start();
+    }
+    touch();
+    syncStatus(true);
+}
+
+void LazyAgent::stop() {
+    Agent::Ptr released;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMaterialize(lock);
+        if (inner_) {
+            state_ = inner_->serializeState();
+            released = std::move(inner_);
+        }
+    }
+    // 在锁外停止并释放：真实智能体析构时可能要等邮箱中的任务回调本对象
+    if (released) {
+        released->stop();
+        released.reset();
+    }
+    setStatus(AgentStatus::STOPPED);
+}
+
+void LazyAgent::pause() {
+    Agent::Ptr inner;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMaterialize(lock);
+        inner = inner_;
+    }
+    if (inner) {
+        inner->pause();
+    }
+    setStatus(AgentStatus::PAUSED);
+}
+
+void LazyAgent::resume() {
+    Agent::Ptr inner;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMaterialize(lock);
+        inner = inner_;
+    }
+    if (inner) {
+        inner->resume();
+    }
+    syncStatus(true);
+}
+
+std::shared_ptr<TaskResult> LazyAgent::executeTask(const Task& task) {
+    return runOnInner([&task](Agent& inner) { return inner.executeTask(task); });
+}
+
+std::shared_ptr<TaskResult> LazyAgent::executeTaskStreaming(const Task& task, const std::shared_ptr<TokenStream>& stream) {
+    auto result = runOnInner([&task, &stream](Agent& inner) { return inner.executeTaskStreaming(task, stream); });
+    // 构造失败时真实智能体没有机会结束流
+    if (!stream->isFinished()) {
+        stream->finish(result && result->success, result ? result->errorMessage : std::string());
+    }
+    return result;
+}
+
+std::shared_ptr<TaskResult> LazyAgent::runOnInner(const std::function<std::shared_ptr<TaskResult>(Agent&)>& run) {
+    Agent::Ptr inner = acquireInner();
+    if (!inner) {
+        auto result = std::make_shared<TaskResult>(false);
+        result->errorMessage = "Failed to materialize agent: " + getId();
+        return result;
+    }
+    syncStatus(false);
+
+    std::shared_ptr<TaskResult> result;
+    {
+        ResourceAccounting::Scope scope(handle_);
+        result = run(*inner);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inFlight_--;
+    }
+    touch();
+    return result;
+}
+
+void LazyAgent::submitTask(const std::shared_ptr<Task>& task, TaskCompletion done) {
+    Agent::Ptr inner = acquireInner();
+    if (!inner) {
+        if (done) {
+            auto result = std::make_shared<TaskResult>(false);
+            result->errorMessage = "Failed to materialize agent: " + getId();
+            done(result);
+        }
+        return;
+    }
+    syncStatus(false);
+    beginTask();   // 监控器跟踪的是代理，心跳记在代理名下
+
+    // 回调持有代理本身，保证任务完成前代理不被释放；不持有真实智能体，以免在其执行线程上析构它
+    auto self = std::static_pointer_cast<LazyAgent>(shared_from_this());
+    inner->submitTask(task, [self, done](std::shared_ptr<TaskResult> result) {
+        {
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            self->inFlight_--;
+        }
+        self->touch();
+        self->endTask();
+        if (done) {
+            done(result);
+        }
+    });
+}
+
+size_t LazyAgent::getQueueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inner_ ? inner_->getQueueDepth() : 0;
+}
+
+size_t LazyAgent::getConcurrency() const {
+    // 按真实智能体的配置计算，休眠时也不必构造它
+    return useMailbox_ ? std::max<size_t>(1, configSnapshot()->resourceLimits.maxThreads) : 1;
+}
+
+bool LazyAgent::checkpoint(std::ostream& out) const {
+    Agent::Ptr inner;
+    std::string state;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMaterialize(lock);
+        inner = inner_;
+        if (!inner) {
+            state = state_;
+        }
+    }
+    if (inner) {
+        return inner->checkpoint(out);
+    }
+    return static_cast<bool>(out.write(state.data(), static_cast<std::streamsize>(state.size())));
+}
+
+bool LazyAgent::restore(std::istream& in) {
+    Agent::Ptr inner;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waitForMaterialize(lock);
+        inner = inner_;
+    }
+    if (inner) {
+        return inner->restore(in);
+    }
+    std::string state((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitForMaterialize(lock);
+    if (inner_) {
+        // 读取期间已被构造，转交真实智能体
+        return inner_->restoreState(state);
+    }
+    state_ = std::move(state);
+    return true;
+}
+
+bool LazyAgent::isMaterialized() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inner_ != nullptr;
+}
+
+bool LazyAgent::hibernate(std::chrono::milliseconds idleFor) {
+    Agent::Ptr released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!inner_ || inFlight_ > 0 || getStatus() != AgentStatus::RUNNING || idleTime() < idleFor ||
+            !inner_->supportsHibernation()) {
+            return false;
+        }
+        state_ = inner_->serializeState();
+        released = std::move(inner_);
+    }
+    released->stop();
+    released.reset();
+    syncStatus(false);
+
+    Logger::getInstance().debug("LazyAgent", "Hibernated agent: " + getId());
+    return true;
+}
+
+std::chrono::milliseconds LazyAgent::idleTime() const {
+    auto elapsed = std::chrono::steady_clock::duration(steadyNow() - lastActive_.load());
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+}
+
+Agent::Ptr LazyAgent::acquireInner() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitForMaterialize(lock);
+    if (!inner_) {
+        // 工厂与 start() 可能耗时或回调本对象，在锁外执行；其他线程等待同一次构造
+        materializing_ = true;
+        std::string state = std::move(state_);
+        state_.clear();
+        lock.unlock();
+        Agent::Ptr agent = materialize(state);
+        lock.lock();
+        materializing_ = false;
+        if (agent) {
+            inner_ = std::move(agent);
+        } else {
+            state_ = std::move(state);   // 构造失败，保留状态供下次重试
+        }
+        materialized_.notify_all();
+    }
+    if (inner_) {
+        inFlight_++;
+    }
+    return inner_;
+}
+
+void LazyAgent::waitForMaterialize(std::unique_lock<std::mutex>& lock) const {
+    materialized_.wait(lock, [this] { return !materializing_; });
+}
+
+Agent::Ptr LazyAgent::materialize(const std::string& state) {
+    // 真实智能体及其恢复的状态计入本智能体名下，休眠释放后随之扣除
+    ResourceAccounting::Scope scope(handle_);
+    AgentConfig config = getConfig();
+    config.lazy = false;
+    config.useMailbox = useMailbox_;
+    auto agent = AgentFactory::getInstance().createAgent(config);
+    if (!agent) {
+        Logger::getInstance().error("LazyAgent",
+            "Failed to create agent of type " + Agent::typeToString(config.type) + ": " + config.id);
+        return nullptr;
+    }
+    if (!state.empty() && !agent->restoreState(state)) {
+        Logger::getInstance().warning("LazyAgent", "Failed to restore hibernated state: " + config.id);
+    }
+
+    agent->start();
+    Logger::getInstance().debug("LazyAgent", "Materialized agent: " + config.id);
+    return agent;
+}
+
+void LazyAgent::syncStatus(bool fromStopped) {
+    // 只在“可接收任务”的两种状态之间切换；暂停、停止等由对应操作显式设置
+    while (true) {
+        AgentStatus current = getStatus();
+        bool ready = current == AgentStatus::RUNNING || current == AgentStatus::HIBERNATED;
+        if (!ready && !fromStopped) {
+            return;
+        }
+        bool materialized = isMaterialized();
+        setStatus(materialized ? AgentStatus::RUNNING : AgentStatus::HIBERNATED);
+        // 期间被其他线程构造或休眠时再对齐一次
+        if (isMaterialized() == materialized) {
+            return;
+        }
+        fromStopped = false;
+    }
+}
+
+void LazyAgent::touch() {
+    lastActive_.store(steadyNow());
+}
+
+} // namespace openclaw
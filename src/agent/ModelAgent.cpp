@@ -0,0 +1,48 @@
+#include "agent/ModelAgent.h"
+#include "task/Task.h"
+#include "common/TokenStream.h"
+
+namespace openclaw {
+
+ModelAgent::ModelAgent(const AgentConfig& config, ModelGateway& gateway) : Agent(config), gateway_(gateway) {}
+
+ModelRequest ModelAgent::buildRequest(const Task& task) const {
+    AgentConfig config = getConfig();
+    auto property = [&config](const std::string& key) {
+        auto it = config.properties.find(key);
+        return it != config.properties.end() ? it->second : std::string();
+    };
+
+    ModelRequest request;
+    request.model = property("model");
+    request.system = property("system");
+    request.subagent = property("subagent") == "true";
+    request.agentId = config.id;
+
+    const auto& parameters = task.getConfig().parameters;
+    auto prompt = parameters.find("prompt");
+    request.prompt = prompt != parameters.end() ? prompt->second : task.getConfig().description;
+    return request;
+}
+
+std::shared_ptr<TaskResult> ModelAgent::toResult(const ModelResponse& response) {
+    auto result = std::make_shared<TaskResult>(response.success);
+    result->errorMessage = response.error;
+    result->executionTime = response.latency;
+    result->output["text"] = response.text;
+    result->output["input_tokens"] = std::to_string(response.inputTokens);
+    result->output["output_tokens"] = std::to_string(response.outputTokens);
+    return result;
+}
+
+std::shared_ptr<TaskResult> ModelAgent::executeTask(const Task& task) {
+    return toResult(gateway_.complete(buildRequest(task)));
+}
+
+std::shared_ptr<TaskResult> ModelAgent::executeTaskStreaming(const Task& task, const std::shared_ptr<TokenStream>& stream) {
+    ModelResponse response = gateway_.stream(buildRequest(task), stream);
+    stream->finish(response.success, response.error);
+    return toResult(response);
+}
+
+} // namespace openclaw
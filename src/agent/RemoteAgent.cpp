@@ -0,0 +1,757 @@
+#include "agent/RemoteAgent.h"
+#include "common/BinaryCodec.h"
+#include "task/Task.h"
+#include "logging/Logger.h"
+#include <condition_variable>
+#include <csignal>
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char** environ;
+
+namespace openclaw {
+
+namespace {
+
+enum class RequestKind : uint8_t {
+    EXECUTE = 1,
+    SHUTDOWN = 2
+};
+
+// 子进程据此环境变量找到继承的共享内存，值为文件描述符
+constexpr const char* kHostEnv = "OPENCLAW_AGENT_HOST_FD";
+constexpr int kHostFd = 3;
+constexpr uint32_t kHostMagic = 0x4f434148;   // "OCAH"
+
+std::mutex hostExecutableMutex;
+std::string hostExecutable = "/proc/self/exe";
+
+void encodeConfig(BinaryWriter& writer, const AgentConfig& config) {
+    writer.writeString(config.id);
+    writer.writeU8(static_cast<uint8_t>(config.type));
+    writer.writeString(config.name);
+    writer.writeString(config.description);
+    writer.writeVarint(config.properties.size());
+    for (const auto& property : config.properties) {
+        writer.writeString(property.first);
+        writer.writeString(property.second);
+    }
+    writer.writeVarint(config.resourceLimits.maxMemoryMB);
+    writer.writeVarint(config.resourceLimits.maxThreads);
+    writer.writeDouble(config.resourceLimits.maxCpuUsage);
+    writer.writeVarint(config.capabilities.size());
+    for (TaskType type : config.capabilities) {
+        writer.writeU8(static_cast<uint8_t>(type));
+    }
+    writer.writeString(config.workspace);
+}
+
+bool decodeConfig(BinaryReader& reader, AgentConfig& config) {
+    uint8_t type = 0;
+    uint64_t count = 0;
+    reader.readString(config.id);
+    reader.readU8(type);
+    config.type = static_cast<AgentType>(type);
+    reader.readString(config.name);
+    reader.readString(config.description);
+    reader.readVarint(count);
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        std::string key;
+        std::string value;
+        reader.readString(key);
+        reader.readString(value);
+        config.properties[key] = value;
+    }
+    uint64_t value = 0;
+    reader.readVarint(value);
+    config.resourceLimits.maxMemoryMB = value;
+    reader.readVarint(value);
+    config.resourceLimits.maxThreads = value;
+    reader.readDouble(config.resourceLimits.maxCpuUsage);
+    reader.readVarint(count);
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        uint8_t capability = 0;
+        reader.readU8(capability);
+        config.capabilities.push_back(static_cast<TaskType>(capability));
+    }
+    reader.readString(config.workspace);
+    return reader.ok();
+}
+
+void encodeTask(BinaryWriter& writer, const TaskConfig& config) {
+    writer.writeString(config.id);
+    writer.writeString(config.name);
+    writer.writeString(config.description);
+    writer.writeU8(static_cast<uint8_t>(config.type));
+    writer.writeU8(static_cast<uint8_t>(config.priority));
+    writer.writeVarint(config.parameters.size());
+    for (const auto& parameter : config.parameters) {
+        writer.writeString(parameter.first);
+        writer.writeString(parameter.second);
+    }
+    writer.writeVarint(config.dependencies.size());
+    for (const auto& dependency : config.dependencies) {
+        writer.writeString(dependency);
+    }
+    writer.writeVarint(config.resourceRequirements.memoryMB);
+    writer.writeVarint(config.resourceRequirements.cpuCores);
+    writer.writeDouble(config.resourceRequirements.cpuUsage);
+    writer.writeString(config.assignedAgentId);
+    writer.writeVarint(config.timeoutSeconds);
+    writer.writeVarint(config.maxRetries);
+}
+
+bool decodeTask(BinaryReader& reader, TaskConfig& config) {
+    uint8_t type = 0;
+    uint8_t priority = 0;
+    uint64_t count = 0;
+    reader.readString(config.id);
+    reader.readString(config.name);
+    reader.readString(config.description);
+    reader.readU8(type);
+    reader.readU8(priority);
+    config.type = static_cast<TaskType>(type);
+    config.priority = static_cast<TaskPriority>(priority);
+    reader.readVarint(count);
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        std::string key;
+        std::string value;
+        reader.readString(key);
+        reader.readString(value);
+        config.parameters[key] = value;
+    }
+    reader.readVarint(count);
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        std::string dependency;
+        reader.readString(dependency);
+        config.dependencies.push_back(dependency);
+    }
+    uint64_t value = 0;
+    reader.readVarint(value);
+    config.resourceRequirements.memoryMB = value;
+    reader.readVarint(value);
+    config.resourceRequirements.cpuCores = value;
+    reader.readDouble(config.resourceRequirements.cpuUsage);
+    reader.readString(config.assignedAgentId);
+    reader.readVarint(value);
+    config.timeoutSeconds = value;
+    reader.readVarint(value);
+    config.maxRetries = value;
+    return reader.ok();
+}
+
+void encodeResult(BinaryWriter& writer, const TaskResult& result) {
+    writer.writeU8(result.success ? 1 : 0);
+    writer.writeString(result.errorMessage);
+    writer.writeVarint(result.output.size());
+    for (const auto& entry : result.output) {
+        writer.writeString(entry.first);
+        writer.writeString(entry.second);
+    }
+    writer.writeVarint(static_cast<uint64_t>(result.executionTime.count()));
+    writer.writeString(result.logPath);
+}
+
+bool decodeResult(BinaryReader& reader, TaskResult& result) {
+    uint8_t success = 0;
+    uint64_t count = 0;
+    reader.readU8(success);
+    result.success = success != 0;
+    reader.readString(result.errorMessage);
+    reader.readVarint(count);
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        std::string key;
+        std::string value;
+        reader.readString(key);
+        reader.readString(value);
+        result.output[key] = value;
+    }
+    uint64_t elapsed = 0;
+    reader.readVarint(elapsed);
+    result.executionTime = std::chrono::milliseconds(elapsed);
+    reader.readString(result.logPath);
+    return reader.ok();
+}
+
+std::shared_ptr<TaskResult> failure(const std::string& message) {
+    auto result = std::make_shared<TaskResult>(false);
+    result->errorMessage = message;
+    return result;
+}
+
+int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// 共享内存头部，后接智能体配置，再后是请求环与结果环（均按缓存行对齐）
+struct HostHeader {
+    uint32_t magic;
+    uint32_t configSize;
+    int32_t parent;
+    uint32_t ringOffset;
+    std::atomic<uint32_t> ready;        // 子进程构造好智能体后置 1
+    std::atomic<int64_t> heartbeat;     // 子进程心跳线程写入的 steady_clock 时间（纳秒，系统内单调）
+};
+
+} // namespace
+
+// 一次子进程生命周期的共享内存：memfd 映射，派生时作为固定描述符传给子进程
+struct RemoteAgent::Channel {
+    ~Channel() {
+        if (memory != MAP_FAILED) {
+            munmap(memory, size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    static std::shared_ptr<Channel> create(const AgentConfig& config) {
+        std::string encoded;
+        BinaryWriter writer(encoded);
+        encodeConfig(writer, config);
+
+        auto channel = std::make_shared<Channel>();
+        size_t ringBytes = ShmRing::bytesFor(kRingCapacity);
+        size_t ringOffset = alignUp(sizeof(HostHeader) + encoded.size(), 64);
+        channel->size = ringOffset + ringBytes * 2;
+        channel->fd = memfd_create("openclaw-agent", MFD_CLOEXEC);
+        if (channel->fd < 0 || ftruncate(channel->fd, static_cast<off_t>(channel->size)) != 0) {
+            return nullptr;
+        }
+        channel->memory = mmap(nullptr, channel->size, PROT_READ | PROT_WRITE, MAP_SHARED, channel->fd, 0);
+        if (channel->memory == MAP_FAILED) {
+            return nullptr;
+        }
+
+        auto* header = new (channel->memory) HostHeader();
+        header->magic = kHostMagic;
+        header->configSize = static_cast<uint32_t>(encoded.size());
+        header->parent = getpid();
+        header->ringOffset = static_cast<uint32_t>(ringOffset);
+        header->ready.store(0);
+        header->heartbeat.store(steadyNanos());
+        std::memcpy(reinterpret_cast<char*>(header + 1), encoded.data(), encoded.size());
+
+        char* rings = static_cast<char*>(channel->memory) + ringOffset;
+        channel->header = header;
+        channel->requests = ShmRing::create(rings, kRingCapacity);
+        channel->responses = ShmRing::create(rings + ringBytes, kRingCapacity);
+        return channel;
+    }
+
+    int fd{-1};
+    void* memory{MAP_FAILED};
+    size_t size{0};
+    HostHeader* header{nullptr};
+    ShmRing requests;    // 父进程 -> 子进程
+    ShmRing responses;   // 子进程 -> 父进程
+};
+
+namespace {
+
+// 子进程主循环：以 _exit 结束，不运行宿主程序的析构与 atexit
+[[noreturn]] void runChild(const AgentConfig& config, HostHeader* header, ShmRing requests, ShmRing responses) {
+    auto agent = AgentFactory::getInstance().createAgent(config);
+    if (!agent) {
+        _exit(2);
+    }
+    agent->start();
+
+    // 心跳在独立线程上发出：任务执行期间同样可见，只有整个进程卡住或停止时才会中断
+    std::thread([header] {
+        while (true) {
+            header->heartbeat.store(steadyNanos(), std::memory_order_release);
+            std::this_thread::sleep_for(RemoteAgent::kHeartbeatInterval);
+        }
+    }).detach();
+    header->ready.store(1, std::memory_order_release);
+
+    const pid_t parent = header->parent;
+    std::string message;
+    std::string reply;
+    while (true) {
+        if (!requests.pop(message)) {
+            // 父进程退出后自行结束
+            if (!requests.wait(std::chrono::milliseconds(200)) && getppid() != parent) {
+                _exit(0);
+            }
+            continue;
+        }
+
+        BinaryReader reader(message);
+        uint8_t kind = 0;
+        uint64_t id = 0;
+        reader.readU8(kind);
+        if (static_cast<RequestKind>(kind) == RequestKind::SHUTDOWN) {
+            agent->stop();
+            _exit(0);
+        }
+        reader.readU64(id);
+
+        TaskConfig taskConfig;
+        std::shared_ptr<TaskResult> result;
+        if (decodeTask(reader, taskConfig)) {
+            result = agent->executeTask(Task(taskConfig));
+        }
+        if (!result) {
+            result = failure("Agent returned no result");
+        }
+
+        reply.clear();
+        BinaryWriter writer(reply);
+        writer.writeU64(id);
+        encodeResult(writer, *result);
+        if (!responses.fits(reply.size())) {
+            reply.clear();
+            writer.writeU64(id);
+            encodeResult(writer, *failure("Task result exceeds the IPC ring capacity"));
+        }
+        while (!responses.push(reply)) {
+            if (getppid() != parent) {
+                _exit(0);
+            }
+            sched_yield();
+        }
+    }
+}
+
+} // namespace
+
+bool RemoteAgent::isHostProcess() {
+    return std::getenv(kHostEnv) != nullptr;
+}
+
+bool RemoteAgent::serveIfHost() {
+    const char* value = std::getenv(kHostEnv);
+    if (!value) {
+        return false;
+    }
+    int fd = std::atoi(value);
+    unsetenv(kHostEnv);
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(HostHeader)) {
+        _exit(2);
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        _exit(2);
+    }
+
+    auto* header = static_cast<HostHeader*>(memory);
+    AgentConfig config;
+    if (header->magic != kHostMagic || sizeof(HostHeader) + header->configSize > size) {
+        _exit(2);
+    }
+    BinaryReader reader(reinterpret_cast<const char*>(header + 1), header->configSize);
+    if (!decodeConfig(reader, config)) {
+        _exit(2);
+    }
+    char* rings = static_cast<char*>(memory) + header->ringOffset;
+    runChild(config, header, ShmRing::attach(rings), ShmRing::attach(rings + ShmRing::bytesFor(kRingCapacity)));
+}
+
+void RemoteAgent::setHostExecutable(const std::string& path) {
+    std::lock_guard<std::mutex> lock(hostExecutableMutex);
+    hostExecutable = path;
+}
+
+RemoteAgent::RemoteAgent(const AgentConfig& config) : Agent(config) {}
+
+RemoteAgent::~RemoteAgent() {
+    running_ = false;
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        terminate();
+    }
+    failPending("Agent process stopped: " + getId());
+}
+
+void RemoteAgent::start() {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+    if (running_) {
+        return;
+    }
+    // 上一次因连续崩溃自行退出的读取线程
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+
+    setStatus(AgentStatus::STARTING);
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        if (!spawn()) {
+            setStatus(AgentStatus::ERROR);
+            return;
+        }
+    }
+    consecutiveCrashes_ = 0;
+    running_ = true;
+    reader_ = std::thread(&RemoteAgent::readerLoop, this);
+    setStatus(AgentStatus::RUNNING);
+}
+
+void RemoteAgent::stop() {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+    running_ = false;
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        terminate();
+    }
+    failPending("Agent process stopped: " + getId());
+    setStatus(AgentStatus::STOPPED);
+}
+
+void RemoteAgent::pause() {
+    // 子进程保持运行，只是不再被调度
+    setStatus(AgentStatus::PAUSED);
+}
+
+void RemoteAgent::resume() {
+    setStatus(running_ ? AgentStatus::RUNNING : AgentStatus::ERROR);
+}
+
+std::shared_ptr<TaskResult> RemoteAgent::executeTask(const Task& task) {
+    // 回调可能在本函数超时返回后才到达，等待状态由双方共同持有
+    struct Waiter {
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::shared_ptr<TaskResult> result;
+    };
+    auto waiter = std::make_shared<Waiter>();
+    auto complete = [waiter](std::shared_ptr<TaskResult> reply) {
+        std::lock_guard<std::mutex> lock(waiter->mutex);
+        waiter->result = std::move(reply);
+        waiter->finished.notify_one();
+    };
+    if (!running_ || !send(nextRequest_++, task, complete)) {
+        return failure("Failed to send task to agent process: " + getId());
+    }
+
+    // 读取线程在任务期限到达时结束子进程并回调；这里再留出余量，读取线程本身出问题时也不会无限等待
+    std::unique_lock<std::mutex> lock(waiter->mutex);
+    size_t timeoutSeconds = task.getConfig().timeoutSeconds;
+    if (timeoutSeconds == 0) {
+        waiter->finished.wait(lock, [&waiter] { return waiter->result != nullptr; });
+    } else if (!waiter->finished.wait_for(lock, std::chrono::seconds(timeoutSeconds) + 2 * kHangTimeout,
+                                          [&waiter] { return waiter->result != nullptr; })) {
+        return failure("Timed out waiting for agent process: " + getId());
+    }
+    return waiter->result;
+}
+
+void RemoteAgent::submitTask(const std::shared_ptr<Task>& task, TaskCompletion done) {
+    beginTask();
+    auto self = std::static_pointer_cast<RemoteAgent>(shared_from_this());
+    auto finish = [self, done](std::shared_ptr<TaskResult> result) {
+        self->endTask();
+        if (done) {
+            done(result);
+        }
+    };
+    if (!running_ || !send(nextRequest_++, *task, finish)) {
+        finish(failure("Failed to send task to agent process: " + getId()));
+    }
+}
+
+size_t RemoteAgent::getQueueDepth() const {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    return pending_.size();
+}
+
+bool RemoteAgent::spawn() {
+    AgentConfig config = getConfig();
+    config.outOfProcess = false;
+    config.lazy = false;
+    config.useMailbox = false;
+    auto channel = Channel::create(config);
+    if (!channel) {
+        Logger::getInstance().error("RemoteAgent", "Failed to map IPC rings for agent: " + getId());
+        return false;
+    }
+
+    // 共享内存以固定描述符传给子进程；恰好已是该描述符时先挪开，否则 dup2 不会清除 CLOEXEC
+    int fd = channel->fd;
+    if (fd == kHostFd) {
+        fd = fcntl(channel->fd, F_DUPFD_CLOEXEC, kHostFd + 1);
+        close(channel->fd);
+        channel->fd = fd;
+    }
+
+    std::vector<std::string> environment;
+    for (char** entry = environ; *entry; ++entry) {
+        if (std::strncmp(*entry, kHostEnv, std::strlen(kHostEnv)) != 0) {
+            environment.emplace_back(*entry);
+        }
+    }
+    environment.push_back(std::string(kHostEnv) + "=" + std::to_string(kHostFd));
+    std::vector<char*> envp;
+    for (auto& entry : environment) {
+        envp.push_back(&entry[0]);
+    }
+    envp.push_back(nullptr);
+
+    std::string executable;
+    {
+        std::lock_guard<std::mutex> lock(hostExecutableMutex);
+        executable = hostExecutable;
+    }
+    std::string label = "openclaw-agent-host";
+    char* argv[] = {&executable[0], &label[0], nullptr};
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fd, kHostFd);
+    pid_t pid = -1;
+    int error = posix_spawn(&pid, executable.c_str(), &actions, nullptr, argv, envp.data());
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0) {
+        Logger::getInstance().error("RemoteAgent",
+            "Failed to spawn agent process " + executable + ": " + std::strerror(error) + " (" + getId() + ")");
+        return false;
+    }
+
+    // 等待子进程构造好智能体；宿主程序没有调用 serveIfHost 时不会就绪，结束它以免运行宿主程序本身
+    auto deadline = std::chrono::steady_clock::now() + kStartupTimeout;
+    while (!channel->header->ready.load(std::memory_order_acquire)) {
+        if (waitpid(pid, nullptr, WNOHANG) != 0 || std::chrono::steady_clock::now() >= deadline) {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+            Logger::getInstance().error("RemoteAgent", "Agent process did not become ready (host " + executable +
+                " must call RemoteAgent::serveIfHost and register the agent type): " + getId());
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    channel_ = std::move(channel);
+    pid_ = pid;
+    Logger::getInstance().info("RemoteAgent",
+        "Spawned agent process " + std::to_string(pid) + " for agent: " + getId());
+    return true;
+}
+
+void RemoteAgent::terminate() {
+    if (!channel_) {
+        return;
+    }
+    pid_t pid = pid_.load();
+
+    // 请求子进程自行退出，限时等待后强制结束
+    std::string message;
+    BinaryWriter writer(message);
+    writer.writeU8(static_cast<uint8_t>(RequestKind::SHUTDOWN));
+    bool exited = false;
+    if (channel_->requests.push(message)) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (waitpid(pid, nullptr, WNOHANG) != 0) {
+                exited = true;
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (!exited) {
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+    }
+
+    channel_.reset();
+    pid_ = -1;
+}
+
+bool RemoteAgent::send(uint64_t id, const Task& task, TaskCompletion done) {
+    std::string message;
+    BinaryWriter writer(message);
+    writer.writeU8(static_cast<uint8_t>(RequestKind::EXECUTE));
+    writer.writeU64(id);
+    encodeTask(writer, task.getConfig());
+
+    Pending pending;
+    pending.done = std::move(done);
+    pending.deadline = std::chrono::steady_clock::time_point::max();
+    if (task.getConfig().timeoutSeconds > 0) {
+        pending.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(task.getConfig().timeoutSeconds);
+    }
+
+    std::unique_lock<std::mutex> lock(sendMutex_);
+    std::shared_ptr<Channel> channel = channel_;
+    if (!channel || !channel->requests.fits(message.size())) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        pending_.emplace(id, std::move(pending));
+    }
+
+    // 请求环已满时等待子进程消费；期间子进程被替换则请求已随崩溃处理失败回调。
+    // 持有旧通道的引用，新通道不可能复用它的地址
+    while (!channel->requests.push(message)) {
+        lock.unlock();
+        sched_yield();
+        lock.lock();
+        if (channel_ != channel) {
+            return true;
+        }
+    }
+    return true;
+}
+
+void RemoteAgent::readerLoop() {
+    std::string message;
+    while (running_) {
+        // 读取线程之外只有 start/stop 会替换通道，而它们总是先等本线程退出
+        ShmRing& responses = channel_->responses;
+        if (!responses.pop(message)) {
+            std::vector<TaskCompletion> expired;
+            if (!responses.wait(std::chrono::milliseconds(50)) &&
+                (waitpid(pid_.load(), nullptr, WNOHANG) != 0 || checkLiveness(expired))) {
+                handleCrash(std::move(expired));
+            }
+            continue;
+        }
+        consecutiveCrashes_ = 0;
+
+        BinaryReader reader(message);
+        uint64_t id = 0;
+        auto result = std::make_shared<TaskResult>();
+        if (!reader.readU64(id) || !decodeResult(reader, *result)) {
+            Logger::getInstance().error("RemoteAgent", "Malformed result from agent process: " + getId());
+            continue;
+        }
+
+        TaskCompletion done;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex_);
+            auto it = pending_.find(id);
+            if (it == pending_.end()) {
+                continue;
+            }
+            done = std::move(it->second.done);
+            pending_.erase(it);
+        }
+        if (done) {
+            done(result);
+        }
+    }
+}
+
+bool RemoteAgent::checkLiveness(std::vector<TaskCompletion>& expired) {
+    pid_t pid = pid_.load();
+    auto silentFor = std::chrono::nanoseconds(steadyNanos() -
+                                              channel_->header->heartbeat.load(std::memory_order_acquire));
+    if (silentFor > kHangTimeout) {
+        Logger::getInstance().warning("RemoteAgent", "Agent process " + std::to_string(pid) +
+            " stopped sending heartbeats for " +
+            std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(silentFor).count()) + "ms: " + getId());
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        return true;
+    }
+
+    // 子进程按顺序执行请求，超时的任务仍占着它，只能结束进程
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if (it->second.deadline <= now) {
+                expired.push_back(std::move(it->second.done));
+                it = pending_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (expired.empty()) {
+        return false;
+    }
+    Logger::getInstance().warning("RemoteAgent", "Agent process " + std::to_string(pid) + " exceeded the deadline of " +
+        std::to_string(expired.size()) + " task(s), restarting: " + getId());
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    return true;
+}
+
+void RemoteAgent::handleCrash(std::vector<TaskCompletion> expired) {
+    Logger::getInstance().warning("RemoteAgent",
+        "Agent process " + std::to_string(pid_.load()) + " exited unexpectedly: " + getId());
+
+    // 替换通道期间持有 sendMutex_：新任务等待新的子进程，而不是投递到已结束的进程或直接失败。
+    // 未完成的任务在替换之后才回调，回调中立即重新提交的任务会进入新的子进程
+    std::unordered_map<uint64_t, Pending> pending;
+    bool respawned = false;
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        channel_.reset();
+        pid_ = -1;
+        {
+            std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+            pending.swap(pending_);
+        }
+
+        if (++consecutiveCrashes_ > kMaxConsecutiveCrashes) {
+            Logger::getInstance().error("RemoteAgent",
+                "Agent process keeps crashing, giving up: " + getId());
+        } else {
+            // 连续崩溃时逐步退避，避免紧密的派生循环
+            std::this_thread::sleep_for(std::chrono::milliseconds(10) * (consecutiveCrashes_ - 1));
+            respawned = spawn();
+        }
+    }
+    if (respawned) {
+        restarts_++;
+    } else {
+        running_ = false;
+        setStatus(AgentStatus::ERROR);
+    }
+
+    for (auto& done : expired) {
+        if (done) {
+            done(failure("Task timed out in agent process: " + getId()));
+        }
+    }
+    for (auto& entry : pending) {
+        if (entry.second.done) {
+            entry.second.done(failure("Agent process exited unexpectedly: " + getId()));
+        }
+    }
+}
+
+void RemoteAgent::failPending(const std::string& reason) {
+    std::unordered_map<uint64_t, Pending> pending;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending.swap(pending_);
+    }
+    for (auto& entry : pending) {
+        if (entry.second.done) {
+            entry.second.done(failure(reason));
+        }
+    }
+}
+
+} // namespace openclaw
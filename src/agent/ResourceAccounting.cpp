@@ -0,0 +1,217 @@
+#include "agent/ResourceAccounting.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+namespace openclaw {
+
+namespace {
+
+// 每个驻留槽位一份计数，owner 记录当前使用该槽位的完整句柄；槽位被其他句柄复用时计数清零。
+// 表按块惰性分配，已分配的块不再释放，读取方无需加锁
+struct Account {
+    std::atomic<StringInterner::Handle> owner{StringInterner::kInvalidHandle};
+    std::atomic<int64_t> cpuNanos{0};
+    std::atomic<int64_t> memoryBytes{0};
+    std::atomic<int64_t> peakMemoryBytes{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<bool> overLimit{false};
+
+    // 指数衰减的 CPU 时间及其更新时刻，由 decayLock 保护（每个任务更新一次）
+    std::atomic_flag decayLock = ATOMIC_FLAG_INIT;
+    double decayedCpuNanos{0.0};
+    int64_t decayedAt{0};
+};
+
+constexpr size_t kChunkBits = 12;
+constexpr size_t kChunkSize = size_t(1) << kChunkBits;
+constexpr size_t kMaxChunks = size_t(1) << (StringInterner::kIndexBits - kChunkBits);
+
+std::atomic<Account*> accountChunks[kMaxChunks];
+
+// 当前线程所在 Scope 的句柄，以及嵌套 Scope 已计量的 CPU 时间
+thread_local StringInterner::Handle currentHandle = StringInterner::kInvalidHandle;
+thread_local int64_t nestedCpuNanos = 0;
+
+void lockDecay(Account& account) {
+    while (account.decayLock.test_and_set(std::memory_order_acquire)) {
+    }
+}
+
+void unlockDecay(Account& account) {
+    account.decayLock.clear(std::memory_order_release);
+}
+
+// 句柄所在槽位的计数，不属于该句柄（尚未登记或已被复用）时返回 nullptr
+Account* findAccount(StringInterner::Handle handle) {
+    uint32_t slot = StringInterner::slotOf(handle);
+    if (slot == 0) {
+        return nullptr;
+    }
+    Account* accounts = accountChunks[slot >> kChunkBits].load(std::memory_order_acquire);
+    Account* account = accounts ? &accounts[slot & (kChunkSize - 1)] : nullptr;
+    return account && account->owner.load(std::memory_order_acquire) == handle ? account : nullptr;
+}
+
+Account* ensureAccount(StringInterner::Handle handle) {
+    if (Account* account = findAccount(handle)) {
+        return account;
+    }
+    uint32_t slot = StringInterner::slotOf(handle);
+    if (slot == 0) {
+        return nullptr;
+    }
+
+    std::atomic<Account*>& chunk = accountChunks[slot >> kChunkBits];
+    Account* accounts = chunk.load(std::memory_order_acquire);
+    if (!accounts) {
+        accounts = new Account[kChunkSize];
+        Account* expected = nullptr;
+        if (!chunk.compare_exchange_strong(expected, accounts, std::memory_order_acq_rel)) {
+            delete[] accounts;   // 其他线程已安装
+            accounts = expected;
+        }
+    }
+
+    // 槽位上一个句柄的计数不属于新句柄，清零后再转交；在 decayLock 下进行，避免并发转交重复清零
+    Account& account = accounts[slot & (kChunkSize - 1)];
+    lockDecay(account);
+    if (account.owner.load(std::memory_order_relaxed) != handle) {
+        account.cpuNanos.store(0, std::memory_order_relaxed);
+        account.memoryBytes.store(0, std::memory_order_relaxed);
+        account.peakMemoryBytes.store(0, std::memory_order_relaxed);
+        account.allocations.store(0, std::memory_order_relaxed);
+        account.overLimit.store(false, std::memory_order_relaxed);
+        account.decayedCpuNanos = 0.0;
+        account.decayedAt = 0;
+        account.owner.store(handle, std::memory_order_release);
+    }
+    unlockDecay(account);
+    return &account;
+}
+
+int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 把衰减量推进到 now，调用方持有 decayLock
+void decayTo(Account& account, int64_t now, int64_t windowNanos) {
+    if (account.decayedAt != 0 && now > account.decayedAt) {
+        account.decayedCpuNanos *= std::exp(-static_cast<double>(now - account.decayedAt) / windowNanos);
+    }
+    account.decayedAt = now;
+}
+
+} // namespace
+
+ResourceAccounting& ResourceAccounting::getInstance() {
+    static ResourceAccounting instance;
+    return instance;
+}
+
+ResourceAccounting::Scope::Scope(StringInterner::Handle handle)
+    : handle_(handle), previous_(currentHandle) {
+    if (handle == previous_ || !ensureAccount(handle)) {
+        return;
+    }
+    active_ = true;
+    previousNested_ = nestedCpuNanos;
+    nestedCpuNanos = 0;
+    currentHandle = handle;
+    cpuStart_ = threadCpuNanos();
+}
+
+ResourceAccounting::Scope::~Scope() {
+    if (!active_) {
+        return;
+    }
+    int64_t elapsed = threadCpuNanos() - cpuStart_;
+    ResourceAccounting::getInstance().chargeCpu(handle_, elapsed - nestedCpuNanos);
+    nestedCpuNanos = previousNested_ + elapsed;
+    currentHandle = previous_;
+}
+
+ResourceUsage ResourceAccounting::getUsage(StringInterner::Handle handle) const {
+    ResourceUsage usage;
+    Account* account = findAccount(handle);
+    if (!account) {
+        return usage;
+    }
+
+    usage.cpuTime = std::chrono::nanoseconds(account->cpuNanos.load(std::memory_order_relaxed));
+    usage.memoryBytes = account->memoryBytes.load(std::memory_order_relaxed);
+    usage.peakMemoryBytes = account->peakMemoryBytes.load(std::memory_order_relaxed);
+    usage.allocations = account->allocations.load(std::memory_order_relaxed);
+
+    int64_t window = windowNanos_.load(std::memory_order_relaxed);
+    lockDecay(*account);
+    decayTo(*account, steadyNanos(), window);
+    double decayed = account->decayedCpuNanos;
+    unlockDecay(*account);
+    usage.cpuPercent = decayed / static_cast<double>(window) * 100.0;
+    return usage;
+}
+
+void ResourceAccounting::chargeMemory(StringInterner::Handle handle, size_t bytes) {
+    Account* account = ensureAccount(handle);
+    if (!account) {
+        return;
+    }
+    int64_t current = account->memoryBytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) +
+                      static_cast<int64_t>(bytes);
+    int64_t peak = account->peakMemoryBytes.load(std::memory_order_relaxed);
+    while (current > peak &&
+           !account->peakMemoryBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+    account->allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ResourceAccounting::releaseMemory(StringInterner::Handle handle, size_t bytes) {
+    if (Account* account = findAccount(handle)) {
+        account->memoryBytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    }
+}
+
+bool ResourceAccounting::setOverLimit(StringInterner::Handle handle, bool over) {
+    Account* account = findAccount(handle);
+    return account && account->overLimit.exchange(over, std::memory_order_relaxed) != over;
+}
+
+void ResourceAccounting::setUtilizationWindow(std::chrono::milliseconds window) {
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(window).count();
+    windowNanos_.store(std::max<int64_t>(1, nanos), std::memory_order_relaxed);
+}
+
+std::chrono::milliseconds ResourceAccounting::getUtilizationWindow() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::nanoseconds(windowNanos_.load(std::memory_order_relaxed)));
+}
+
+int64_t ResourceAccounting::threadCpuNanos() {
+    timespec ts{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+StringInterner::Handle ResourceAccounting::currentAccount() {
+    return currentHandle;
+}
+
+void ResourceAccounting::chargeCpu(StringInterner::Handle handle, int64_t nanos) {
+    Account* account = findAccount(handle);
+    if (!account || nanos <= 0) {
+        return;
+    }
+    account->cpuNanos.fetch_add(nanos, std::memory_order_relaxed);
+
+    int64_t window = windowNanos_.load(std::memory_order_relaxed);
+    lockDecay(*account);
+    decayTo(*account, steadyNanos(), window);
+    account->decayedCpuNanos += static_cast<double>(nanos);
+    unlockDecay(*account);
+}
+
+} // namespace openclaw
@@ -0,0 +1,375 @@
+#include "agent/WorkspaceCache.h"
+#include "common/Fnv1a.h"
+#include "logging/Logger.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <filesystem>
+
+namespace openclaw {
+
+namespace {
+
+constexpr uint32_t kWatchMask = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE |
+                                IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+
+bool underDirectory(const std::string& path, const std::string& dir) {
+    return path.size() > dir.size() && path.compare(0, dir.size(), dir) == 0 && path[dir.size()] == '/';
+}
+
+} // namespace
+
+// 一个文件的只读映射，最后一个 View 释放时解除映射
+class WorkspaceCache::Mapping {
+public:
+    static std::shared_ptr<const Mapping> open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return nullptr;
+        }
+        std::shared_ptr<Mapping> mapping(new Mapping(path));
+        if (st.st_size > 0) {
+            void* data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                return nullptr;
+            }
+            mapping->data_ = static_cast<const char*>(data);
+            mapping->size_ = static_cast<size_t>(st.st_size);
+        }
+        ::close(fd);
+        mapping->hash_ = fnv1a(mapping->data_, mapping->size_);
+        return mapping;
+    }
+
+    ~Mapping() {
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    std::string_view data() const { return std::string_view(data_, size_); }
+    size_t size() const { return size_; }
+    uint64_t hash() const { return hash_; }
+    const std::string& path() const { return path_; }
+
+private:
+    explicit Mapping(std::string path) : path_(std::move(path)) {}
+
+    std::string path_;
+    const char* data_{nullptr};
+    size_t size_{0};
+    uint64_t hash_{0};
+};
+
+std::string_view WorkspaceCache::View::data() const {
+    return mapping_ ? mapping_->data() : std::string_view();
+}
+
+uint64_t WorkspaceCache::View::hash() const {
+    return mapping_ ? mapping_->hash() : 0;
+}
+
+const std::string& WorkspaceCache::View::path() const {
+    static const std::string empty;
+    return mapping_ ? mapping_->path() : empty;
+}
+
+WorkspaceCache& WorkspaceCache::getInstance() {
+    static WorkspaceCache instance;
+    return instance;
+}
+
+WorkspaceCache::WorkspaceCache(const WorkspaceCacheOptions& options) : options_(options) {}
+
+WorkspaceCache::~WorkspaceCache() {
+    if (watcher_.joinable()) {
+        char byte = 0;
+        if (::write(wakeupPipe_[1], &byte, 1) < 0) {
+            Logger::getInstance().warning("WorkspaceCache", "Failed to wake watcher thread");
+        }
+        watcher_.join();
+    }
+    for (int fd : {inotifyFd_, wakeupPipe_[0], wakeupPipe_[1]}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+std::string WorkspaceCache::normalizePath(const std::string& path) {
+    std::error_code ec;
+    std::string normalized = std::filesystem::absolute(path, ec).lexically_normal().string();
+    if (ec) {
+        normalized = std::filesystem::path(path).lexically_normal().string();
+    }
+    while (normalized.size() > 1 && normalized.back() == '/') {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+bool WorkspaceCache::addWorkspace(const std::string& root) {
+    std::string dir = normalizePath(root);
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec)) {
+        Logger::getInstance().error("WorkspaceCache", "Workspace is not a directory: " + dir);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!roots_.insert(dir).second) {
+        return true;
+    }
+    if (options_.watch && inotifyFd_ < 0) {
+        inotifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd_ < 0 || ::pipe2(wakeupPipe_, O_CLOEXEC) != 0) {
+            Logger::getInstance().error("WorkspaceCache", "Failed to initialize inotify, cache will not be invalidated");
+            roots_.erase(dir);
+            return false;
+        }
+        watcher_ = std::thread(&WorkspaceCache::watchLoop, this);
+    }
+    indexDirectory(dir);
+    Logger::getInstance().info("WorkspaceCache", "Indexed workspace " + dir + ": " +
+                               std::to_string(files_.size()) + " files");
+    return true;
+}
+
+void WorkspaceCache::removeWorkspace(const std::string& root) {
+    std::string dir = normalizePath(root);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (roots_.erase(dir) == 0) {
+        return;
+    }
+    for (auto it = watches_.begin(); it != watches_.end();) {
+        if (it->second == dir || underDirectory(it->second, dir)) {
+            ::inotify_rm_watch(inotifyFd_, it->first);
+            it = watches_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = files_.lower_bound(dir + "/"); it != files_.end() && underDirectory(*it, dir);) {
+        dropLocked(*it);
+        it = files_.erase(it);
+    }
+}
+
+void WorkspaceCache::indexDirectory(const std::string& dir) {
+    // 调用方持有 mutex_
+    auto watch = [this](const std::string& path) {
+        if (inotifyFd_ < 0) {
+            return;
+        }
+        int wd = ::inotify_add_watch(inotifyFd_, path.c_str(), kWatchMask);
+        if (wd >= 0) {
+            watches_[wd] = path;
+        } else {
+            Logger::getInstance().warning("WorkspaceCache", "Failed to watch directory: " + path);
+        }
+    };
+
+    // 先监视再遍历，遍历期间新建的文件要么被遍历到，要么产生事件
+    watch(dir);
+    std::error_code ec;
+    std::filesystem::recursive_directory_iterator it(
+        dir, std::filesystem::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        std::error_code statError;
+        if (it->is_symlink(statError)) {
+            continue;
+        }
+        if (it->is_directory(statError)) {
+            watch(it->path().string());
+        } else if (it->is_regular_file(statError)) {
+            files_.insert(it->path().string());
+        }
+    }
+}
+
+WorkspaceCache::View WorkspaceCache::read(const std::string& path) {
+    std::string key = normalizePath(path);
+    uint64_t generation = 0;
+    bool cacheable = !options_.watch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            hits_++;
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            return View(it->second.mapping);
+        }
+        misses_++;
+        generation = generation_;
+        // 启用监视时只缓存工作区内的文件，否则无法得知它何时变化
+        for (const auto& root : roots_) {
+            cacheable = cacheable || underDirectory(key, root);
+        }
+    }
+
+    auto mapping = Mapping::open(key);
+    if (!mapping) {
+        return View();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 映射期间文件可能已失效，此时本次结果不进入缓存
+    if (!cacheable || generation != generation_ || mapping->size() > options_.maxBytes) {
+        return View(mapping);
+    }
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        return View(it->second.mapping);
+    }
+    lru_.push_front(key);
+    entries_.emplace(key, Entry{mapping, lru_.begin()});
+    cachedBytes_ += mapping->size();
+    while (cachedBytes_ > options_.maxBytes && lru_.size() > 1) {
+        auto victim = entries_.find(lru_.back());
+        cachedBytes_ -= victim->second.mapping->size();
+        entries_.erase(victim);
+        lru_.pop_back();
+        evictions_++;
+    }
+    return View(mapping);
+}
+
+std::vector<std::string> WorkspaceCache::listFiles(const std::string& dir) const {
+    std::string prefix = normalizePath(dir);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> files;
+    for (auto it = files_.lower_bound(prefix + "/"); it != files_.end() && underDirectory(*it, prefix); ++it) {
+        files.push_back(*it);
+    }
+    return files;
+}
+
+void WorkspaceCache::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropLocked(normalizePath(path));
+}
+
+void WorkspaceCache::dropLocked(const std::string& path) {
+    // 即使未缓存也推进代数，让正在映射该文件的读取放弃写入缓存
+    generation_++;
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+        return;
+    }
+    invalidations_++;
+    cachedBytes_ -= it->second.mapping->size();
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+}
+
+void WorkspaceCache::watchLoop() {
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    struct pollfd fds[2] = {{inotifyFd_, POLLIN, 0}, {wakeupPipe_[0], POLLIN, 0}};
+    while (true) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::getInstance().error("WorkspaceCache", "poll failed, stopping watcher");
+            return;
+        }
+        if (fds[1].revents) {
+            return;
+        }
+        ssize_t length;
+        while ((length = ::read(inotifyFd_, buffer, sizeof(buffer))) > 0) {
+            handleEvents(buffer, static_cast<size_t>(length));
+        }
+        eventGeneration_++;
+    }
+}
+
+void WorkspaceCache::handleEvents(const char* buffer, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t offset = 0; offset < length;) {
+        const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            // 丢失了事件，整个缓存作废
+            Logger::getInstance().warning("WorkspaceCache", "inotify queue overflow, dropping all cached files");
+            generation_++;
+            invalidations_ += entries_.size();
+            entries_.clear();
+            lru_.clear();
+            cachedBytes_ = 0;
+            continue;
+        }
+        auto watch = watches_.find(event->wd);
+        if (watch == watches_.end()) {
+            continue;
+        }
+        if (event->mask & IN_IGNORED) {
+            watches_.erase(watch);
+            continue;
+        }
+        if (event->len == 0) {
+            continue;   // 目录自身的事件（IN_DELETE_SELF 之后会收到 IN_IGNORED）
+        }
+        std::string path = watch->second + "/" + event->name;
+
+        if (event->mask & IN_ISDIR) {
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                indexDirectory(path);
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                for (auto it = files_.lower_bound(path + "/"); it != files_.end() && underDirectory(*it, path);) {
+                    dropLocked(*it);
+                    it = files_.erase(it);
+                }
+                // 移出工作区的目录仍被监视，但路径已失效
+                for (auto it = watches_.begin(); it != watches_.end();) {
+                    if (it->second == path || underDirectory(it->second, path)) {
+                        ::inotify_rm_watch(inotifyFd_, it->first);
+                        it = watches_.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+            continue;
+        }
+
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+            files_.insert(path);
+        } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+            files_.erase(path);
+        }
+        dropLocked(path);
+    }
+}
+
+WorkspaceCache::Stats WorkspaceCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.invalidations = invalidations_;
+    stats.evictions = evictions_;
+    stats.cachedFiles = entries_.size();
+    stats.cachedBytes = cachedBytes_;
+    stats.indexedFiles = files_.size();
+    stats.watchedDirectories = watches_.size();
+    return stats;
+}
+
+} // namespace openclaw
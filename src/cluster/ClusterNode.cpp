@@ -0,0 +1,876 @@
+#include "cluster/ClusterNode.h"
+#include "common/BinaryCodec.h"
+#include "common/Fnv1a.h"
+#include "config/ConfigManager.h"
+#include "logging/Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace openclaw {
+
+namespace {
+
+// 单帧上限，防止损坏的长度字段导致超大分配
+constexpr uint32_t kMaxFrameSize = 16 * 1024 * 1024;
+
+bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recvAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::recv(fd, data, size, 0);
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 帧格式：u32 长度（类型 + 负载）| u8 类型 | 负载
+std::string encodeFrame(uint8_t type, const std::string& payload) {
+    std::string frame;
+    BinaryWriter writer(frame);
+    writer.writeU32(static_cast<uint32_t>(payload.size() + 1));
+    writer.writeU8(type);
+    frame.append(payload);
+    return frame;
+}
+
+bool sendFrame(int fd, uint8_t type, const std::string& payload) {
+    std::string frame = encodeFrame(type, payload);
+    return sendAll(fd, frame.data(), frame.size());
+}
+
+bool recvFrame(int fd, uint8_t& type, std::string& payload) {
+    char header[4];
+    if (!recvAll(fd, header, sizeof(header))) return false;
+
+    uint32_t length = 0;
+    BinaryReader reader(header, sizeof(header));
+    reader.readU32(length);
+    if (length == 0 || length > kMaxFrameSize) return false;
+
+    std::string body(length, '\0');
+    if (!recvAll(fd, &body[0], length)) return false;
+    type = static_cast<uint8_t>(body[0]);
+    payload.assign(body, 1, std::string::npos);
+    return true;
+}
+
+void setIoTimeout(int fd, std::chrono::milliseconds timeout) {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+// 发起非阻塞连接，返回套接字并通过 connected 告知是否已立即连上；失败返回 -1
+int connectNonBlocking(const std::string& host, uint16_t port, bool& connected) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        return -1;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    int rc = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    if (rc < 0 && errno != EINPROGRESS) {
+        ::close(fd);
+        return -1;
+    }
+    connected = rc == 0;
+    return fd;
+}
+
+// 一次请求-响应在非阻塞套接字上的进度，由 gossip 线程的 poll 循环推进
+struct Exchange {
+    enum class Phase { CONNECTING, SENDING, RECEIVING, DONE };
+
+    int fd{-1};
+    Phase phase{Phase::DONE};
+    size_t sent{0};
+    std::string received;
+    bool ok{false};
+
+    void finish(bool success) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        ok = success;
+        phase = Phase::DONE;
+    }
+
+    // 发送到阻塞为止，全部发完后转入接收
+    void pump(const std::string& frame) {
+        while (sent < frame.size()) {
+            ssize_t n = ::send(fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) finish(false);
+                return;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        phase = Phase::RECEIVING;
+    }
+
+    // 接收到阻塞为止，收齐一帧后结束
+    void drain() {
+        char buffer[4096];
+        while (true) {
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) finish(false);
+                return;
+            }
+            if (n == 0) {
+                finish(false);
+                return;
+            }
+            received.append(buffer, static_cast<size_t>(n));
+            if (received.size() >= sizeof(uint32_t)) {
+                uint32_t length = 0;
+                BinaryReader reader(received.data(), sizeof(uint32_t));
+                reader.readU32(length);
+                if (length == 0 || length > kMaxFrameSize) {
+                    finish(false);
+                    return;
+                }
+                if (received.size() >= sizeof(uint32_t) + length) {
+                    finish(true);
+                    return;
+                }
+            }
+        }
+    }
+};
+
+// 带超时的连接，避免对已宕机节点的连接阻塞 gossip 线程
+int connectWithTimeout(const std::string& host, uint16_t port, std::chrono::milliseconds timeout) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        return -1;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    int rc = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    if (rc < 0 && errno == EINPROGRESS) {
+        pollfd pfd{fd, POLLOUT, 0};
+        rc = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (rc <= 0 || ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0) {
+            ::close(fd);
+            return -1;
+        }
+    } else if (rc < 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    ::fcntl(fd, F_SETFL, flags);
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setIoTimeout(fd, timeout);
+    return fd;
+}
+
+} // namespace
+
+ClusterConfig ClusterConfig::fromConfig() {
+    ClusterConfig defaults;
+    auto& config = ConfigManager::getInstance();
+    ClusterConfig result;
+    result.host = config.getString("cluster_host", defaults.host);
+    result.port = static_cast<uint16_t>(std::min(65535, std::max(0, config.getInt("cluster_port", defaults.port))));
+    result.seeds = config.getStringList("cluster_seeds");
+    result.heartbeatInterval = std::chrono::milliseconds(std::max(1, config.getInt("cluster_heartbeat_interval",
+        static_cast<int>(defaults.heartbeatInterval.count()))));
+    result.failureTimeout = std::chrono::milliseconds(std::max(1, config.getInt("cluster_failure_timeout",
+        static_cast<int>(defaults.failureTimeout.count()))));
+    result.stealBatchSize = static_cast<size_t>(std::max(1, config.getInt("cluster_steal_batch",
+        static_cast<int>(defaults.stealBatchSize))));
+    result.stealThreshold = static_cast<size_t>(std::max(1, config.getInt("cluster_steal_threshold",
+        static_cast<int>(defaults.stealThreshold))));
+    return result;
+}
+
+ClusterNode::ClusterNode(TaskScheduler& scheduler, const ClusterConfig& config)
+    : scheduler_(scheduler), config_(config) {
+}
+
+ClusterNode::~ClusterNode() {
+    stop();
+}
+
+bool ClusterNode::start() {
+    if (running_) {
+        return true;
+    }
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        Logger::getInstance().error("ClusterNode", "Failed to create socket: " + std::string(std::strerror(errno)));
+        return false;
+    }
+
+    int one = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config_.port);
+    if (::inet_pton(AF_INET, config_.host.c_str(), &addr.sin_addr) != 1 ||
+        ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listenFd_, 64) < 0) {
+        Logger::getInstance().error("ClusterNode", "Failed to listen on " + config_.host + ":" +
+                                    std::to_string(config_.port) + ": " + std::strerror(errno));
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    nodeId_ = config_.host + ":" + std::to_string(port_);
+
+    {
+        std::lock_guard<std::mutex> lock(membersMutex_);
+        for (const auto& seed : config_.seeds) {
+            if (seed != nodeId_) {
+                candidates_.insert(seed);
+            }
+        }
+    }
+
+    running_ = true;
+    acceptThread_ = std::thread(&ClusterNode::acceptLoop, this);
+    gossipThread_ = std::thread(&ClusterNode::gossipLoop, this);
+
+    Logger::getInstance().info("ClusterNode", "Cluster node started: " + nodeId_);
+    return true;
+}
+
+void ClusterNode::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    stopCv_.notify_all();
+
+    if (acceptThread_.joinable()) {
+        acceptThread_.join();
+    }
+    if (gossipThread_.joinable()) {
+        gossipThread_.join();
+    }
+    {
+        // 连接处理线程都带 I/O 超时，等待它们结束后调度器才可安全销毁
+        std::unique_lock<std::mutex> lock(stopMutex_);
+        stopCv_.wait(lock, [this] { return activeHandlers_ == 0; });
+    }
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+    }
+
+    Logger::getInstance().info("ClusterNode", "Cluster node stopped: " + nodeId_);
+}
+
+bool ClusterNode::submitTask(const TaskConfig& config) {
+    std::string owner = ownerOf(config);
+    if (owner.empty() || owner == nodeId_) {
+        return scheduler_.scheduleTask(config);
+    }
+
+    std::string host;
+    uint16_t port = 0;
+    std::string payload;
+    std::string response;
+    BinaryWriter writer(payload);
+    config.serialize(writer);
+
+    if (parseAddress(owner, host, port) &&
+        request(host, port, MessageType::SUBMIT, payload, MessageType::ACK, response)) {
+        if (response.empty() || response[0] == 0) {
+            Logger::getInstance().error("ClusterNode", "Task rejected by " + owner + ": " + config.id);
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.forwardedTasks++;
+        return true;
+    }
+
+    // 归属节点不可达时退回本地调度，该节点会在失效超时后被移出成员视图
+    Logger::getInstance().warning("ClusterNode", "Owner unreachable, scheduling locally: " + config.id);
+    return scheduler_.scheduleTask(config);
+}
+
+std::string ClusterNode::ownerOf(const TaskConfig& config) const {
+    auto it = config.parameters.find("partitionKey");
+    const std::string& key = (it != config.parameters.end()) ? it->second : config.id;
+    // FNV-1a 与进程无关，各节点对同一键算出相同的分区
+    uint64_t keyHash = fnv1a(key);
+
+    // 最高随机权重哈希：成员变化时只有落在增删节点上的键会迁移
+    std::string owner;
+    uint64_t bestWeight = 0;
+    for (const auto& member : liveMembers()) {
+        uint64_t weight = fnv1a(member.nodeId, keyHash);
+        if (owner.empty() || weight > bestWeight || (weight == bestWeight && member.nodeId < owner)) {
+            owner = member.nodeId;
+            bestWeight = weight;
+        }
+    }
+    return owner;
+}
+
+std::vector<ClusterNode::Member> ClusterNode::getMembers() const {
+    return liveMembers();
+}
+
+ClusterNode::ClusterStats ClusterNode::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
+
+void ClusterNode::acceptLoop() {
+    while (running_) {
+        pollfd pfd{listenFd_, POLLIN, 0};
+        int rc = ::poll(&pfd, 1, 100);
+        if (rc <= 0 || !(pfd.revents & POLLIN)) {
+            continue;
+        }
+
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        setIoTimeout(fd, config_.failureTimeout / 2);
+        {
+            std::lock_guard<std::mutex> lock(stopMutex_);
+            activeHandlers_++;
+        }
+        std::thread([this, fd] {
+            handleConnection(fd);
+            ::close(fd);
+            std::lock_guard<std::mutex> lock(stopMutex_);
+            if (--activeHandlers_ == 0) {
+                stopCv_.notify_all();
+            }
+        }).detach();
+    }
+}
+
+void ClusterNode::gossipLoop() {
+    while (running_) {
+        gossipRound();
+        trySteal();
+
+        std::unique_lock<std::mutex> lock(stopMutex_);
+        stopCv_.wait_for(lock, config_.heartbeatInterval, [this] { return !running_; });
+    }
+}
+
+void ClusterNode::handleConnection(int fd) {
+    uint8_t type = 0;
+    std::string payload;
+    if (!recvFrame(fd, type, payload)) {
+        return;
+    }
+
+    std::string response;
+    BinaryWriter writer(response);
+
+    switch (static_cast<MessageType>(type)) {
+        case MessageType::HEARTBEAT: {
+            mergeHeartbeat(payload);
+            encodeHeartbeat(response);
+            sendFrame(fd, static_cast<uint8_t>(MessageType::MEMBERS), response);
+            break;
+        }
+        case MessageType::SUBMIT: {
+            TaskConfig config;
+            BinaryReader reader(payload);
+            bool ok = TaskConfig::deserialize(reader, config) && scheduler_.scheduleTask(config);
+            if (ok) {
+                std::lock_guard<std::mutex> lock(statsMutex_);
+                stats_.receivedTasks++;
+            }
+            writer.writeU8(ok ? 1 : 0);
+            sendFrame(fd, static_cast<uint8_t>(MessageType::ACK), response);
+            break;
+        }
+        case MessageType::STEAL:
+            handleSteal(fd, payload);
+            break;
+        default:
+            Logger::getInstance().warning("ClusterNode", "Unknown message type: " + std::to_string(type));
+            break;
+    }
+}
+
+// 窃取：发出 TASKS 后等待窃取方的 ACK（已接收的任务 ID 列表），未确认的任务重新放回本地调度
+void ClusterNode::handleSteal(int fd, const std::string& payload) {
+    uint32_t maxTasks = 0;
+    BinaryReader reader(payload);
+    if (!reader.readU32(maxTasks)) {
+        return;
+    }
+
+    auto released = scheduler_.releaseReadyTasks(std::min<size_t>(maxTasks, config_.stealBatchSize));
+    std::string response;
+    BinaryWriter writer(response);
+    writer.writeVarint(released.size());
+    for (const auto& config : released) {
+        config.serialize(writer);
+    }
+    if (released.empty()) {
+        sendFrame(fd, static_cast<uint8_t>(MessageType::TASKS), response);
+        return;
+    }
+
+    std::unordered_set<std::string> accepted;
+    uint8_t ackType = 0;
+    std::string ack;
+    if (sendFrame(fd, static_cast<uint8_t>(MessageType::TASKS), response) &&
+        recvFrame(fd, ackType, ack) && ackType == static_cast<uint8_t>(MessageType::ACK)) {
+        BinaryReader ackReader(ack);
+        uint64_t count = 0;
+        ackReader.readVarint(count);
+        for (uint64_t i = 0; i < count && ackReader.ok(); ++i) {
+            std::string id;
+            if (ackReader.readString(id)) {
+                accepted.insert(id);
+            }
+        }
+    }
+
+    size_t given = 0;
+    for (const auto& config : released) {
+        if (accepted.count(config.id)) {
+            given++;
+        } else if (!scheduler_.scheduleTask(config)) {
+            Logger::getInstance().error("ClusterNode", "Failed to requeue unacknowledged task: " + config.id);
+        }
+    }
+    if (given < released.size()) {
+        Logger::getInstance().warning("ClusterNode", "Requeued " + std::to_string(released.size() - given) +
+                                      " tasks not acknowledged by thief");
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_.givenTasks += given;
+}
+
+// 心跳负载：发送者 ID | 积压任务数 | 可用智能体数 | 已知成员 ID 列表
+void ClusterNode::encodeHeartbeat(std::string& payload) const {
+    BinaryWriter writer(payload);
+    writer.writeString(nodeId_);
+    writer.writeVarint(scheduler_.getStats().currentPendingCount);
+    writer.writeVarint(scheduler_.getAvailableAgentCount());
+
+    auto members = liveMembers();
+    writer.writeVarint(members.size());
+    for (const auto& member : members) {
+        writer.writeString(member.nodeId);
+    }
+}
+
+void ClusterNode::mergeHeartbeat(const std::string& payload) {
+    BinaryReader reader(payload);
+    std::string sender;
+    uint64_t pending = 0;
+    uint64_t available = 0;
+    uint64_t count = 0;
+
+    if (!reader.readString(sender) || !reader.readVarint(pending) ||
+        !reader.readVarint(available) || !reader.readVarint(count)) {
+        return;
+    }
+
+    std::vector<std::string> known;
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        std::string id;
+        if (reader.readString(id)) {
+            known.push_back(id);
+        }
+    }
+
+    touchMember(sender, pending, available);
+
+    std::lock_guard<std::mutex> lock(membersMutex_);
+    for (const auto& id : known) {
+        if (id != nodeId_ && members_.find(id) == members_.end()) {
+            candidates_.insert(id);
+        }
+    }
+}
+
+bool ClusterNode::request(const std::string& host, uint16_t port, MessageType type,
+                          const std::string& payload, MessageType expected, std::string& response) const {
+    int fd = connectWithTimeout(host, port, config_.failureTimeout / 2);
+    if (fd < 0) {
+        return false;
+    }
+
+    uint8_t responseType = 0;
+    bool ok = sendFrame(fd, static_cast<uint8_t>(type), payload) &&
+              recvFrame(fd, responseType, response) &&
+              responseType == static_cast<uint8_t>(expected);
+    ::close(fd);
+    return ok;
+}
+
+void ClusterNode::exchangeAll(const std::vector<std::string>& targets, MessageType type,
+                              const std::string& payload, MessageType expected,
+                              std::vector<std::string>& responses, std::vector<char>& reached) const {
+    const std::string frame = encodeFrame(static_cast<uint8_t>(type), payload);
+    std::vector<Exchange> exchanges(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) {
+        std::string host;
+        uint16_t port = 0;
+        bool connected = false;
+        if (!parseAddress(targets[i], host, port)) {
+            continue;
+        }
+        exchanges[i].fd = connectNonBlocking(host, port, connected);
+        if (exchanges[i].fd >= 0) {
+            exchanges[i].phase = connected ? Exchange::Phase::SENDING : Exchange::Phase::CONNECTING;
+        }
+    }
+
+    // 所有连接共用一个期限，到期仍未完成的按联系失败处理
+    auto deadline = std::chrono::steady_clock::now() + config_.failureTimeout / 2;
+    std::vector<pollfd> pfds;
+    std::vector<size_t> owners;
+    while (true) {
+        pfds.clear();
+        owners.clear();
+        for (size_t i = 0; i < exchanges.size(); ++i) {
+            const Exchange& exchange = exchanges[i];
+            if (exchange.phase == Exchange::Phase::DONE) {
+                continue;
+            }
+            short events = exchange.phase == Exchange::Phase::RECEIVING ? POLLIN : POLLOUT;
+            pfds.push_back(pollfd{exchange.fd, events, 0});
+            owners.push_back(i);
+        }
+        if (pfds.empty()) {
+            break;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            break;
+        }
+        int rc = ::poll(pfds.data(), pfds.size(), static_cast<int>(remaining.count()));
+        if (rc < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (size_t k = 0; rc > 0 && k < pfds.size(); ++k) {
+            if (pfds[k].revents == 0) {
+                continue;
+            }
+            Exchange& exchange = exchanges[owners[k]];
+            if (exchange.phase == Exchange::Phase::CONNECTING) {
+                int error = 0;
+                socklen_t len = sizeof(error);
+                if (::getsockopt(exchange.fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0) {
+                    exchange.finish(false);
+                    continue;
+                }
+                exchange.phase = Exchange::Phase::SENDING;
+            }
+            if (exchange.phase == Exchange::Phase::SENDING) {
+                exchange.pump(frame);
+            } else if (exchange.phase == Exchange::Phase::RECEIVING) {
+                exchange.drain();
+            }
+        }
+    }
+
+    responses.assign(targets.size(), std::string());
+    reached.assign(targets.size(), 0);
+    for (size_t i = 0; i < exchanges.size(); ++i) {
+        Exchange& exchange = exchanges[i];
+        exchange.finish(exchange.ok);
+        if (!exchange.ok) {
+            continue;
+        }
+        // drain 只在收齐一帧后成功：长度字段之后依次是类型与负载
+        uint32_t length = 0;
+        BinaryReader reader(exchange.received.data(), sizeof(uint32_t));
+        reader.readU32(length);
+        if (static_cast<uint8_t>(exchange.received[sizeof(uint32_t)]) == static_cast<uint8_t>(expected)) {
+            responses[i].assign(exchange.received, sizeof(uint32_t) + 1, length - 1);
+            reached[i] = 1;
+        }
+    }
+}
+
+void ClusterNode::gossipRound() {
+    // 成员每轮都联系；候选与种子地址联系不上时按退避时间跳过
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::string> targets;
+    {
+        std::lock_guard<std::mutex> lock(membersMutex_);
+        for (const auto& pair : members_) {
+            targets.push_back(pair.first);
+        }
+        auto due = [&](const std::string& id) {
+            auto it = unreachable_.find(id);
+            return it == unreachable_.end() || it->second.nextAttempt <= now;
+        };
+        for (const auto& id : candidates_) {
+            if (due(id)) {
+                targets.push_back(id);
+            }
+        }
+        for (const auto& seed : config_.seeds) {
+            if (seed != nodeId_ && members_.find(seed) == members_.end() && candidates_.count(seed) == 0 &&
+                due(seed)) {
+                targets.push_back(seed);
+            }
+        }
+    }
+
+    std::string heartbeat;
+    encodeHeartbeat(heartbeat);
+
+    // 并发联系：一轮的耗时不超过单次请求的超时，失效地址不会拖慢对健康成员的心跳
+    std::vector<std::string> responses;
+    std::vector<char> reached;
+    exchangeAll(targets, MessageType::HEARTBEAT, heartbeat, MessageType::MEMBERS, responses, reached);
+
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (reached[i]) {
+            mergeHeartbeat(responses[i]);
+        }
+    }
+
+    // 只有本轮联系失败、且超过失效时间没有任何往来（包括对方发来的心跳）的成员才移出视图，
+    // 其分区由剩余成员接管
+    now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(membersMutex_);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const std::string& target = targets[i];
+        auto member = members_.find(target);
+        if (reached[i]) {
+            unreachable_.erase(target);
+        } else if (member != members_.end()) {
+            if (now - member->second.lastSeen > config_.failureTimeout) {
+                Logger::getInstance().warning("ClusterNode", "Member timed out: " + target);
+                members_.erase(member);
+            }
+        } else {
+            Backoff& backoff = unreachable_[target];
+            backoff.delay = std::min(std::max(backoff.delay * 2, config_.heartbeatInterval),
+                                     std::chrono::duration_cast<std::chrono::milliseconds>(config_.failureTimeout * 8));
+            backoff.nextAttempt = now + backoff.delay;
+        }
+        candidates_.erase(target);
+    }
+}
+
+void ClusterNode::trySteal() {
+    // 只有本地无积压且有空闲智能体时才窃取
+    if (scheduler_.getStats().currentPendingCount > 0) {
+        return;
+    }
+    size_t available = scheduler_.getAvailableAgentCount();
+    if (available == 0) {
+        return;
+    }
+
+    Member victim;
+    {
+        std::lock_guard<std::mutex> lock(membersMutex_);
+        for (const auto& pair : members_) {
+            if (pair.second.pendingTasks >= config_.stealThreshold &&
+                pair.second.pendingTasks > victim.pendingTasks) {
+                victim = pair.second;
+            }
+        }
+    }
+    if (victim.nodeId.empty()) {
+        return;
+    }
+
+    int fd = connectWithTimeout(victim.host, victim.port, config_.failureTimeout / 2);
+    if (fd < 0) {
+        return;
+    }
+
+    std::string payload;
+    BinaryWriter writer(payload);
+    writer.writeU32(static_cast<uint32_t>(std::min(available, config_.stealBatchSize)));
+    uint8_t responseType = 0;
+    std::string response;
+    if (!sendFrame(fd, static_cast<uint8_t>(MessageType::STEAL), payload) ||
+        !recvFrame(fd, responseType, response) || responseType != static_cast<uint8_t>(MessageType::TASKS)) {
+        ::close(fd);
+        return;
+    }
+
+    // 逐个调度后回复已接收的任务 ID；本地拒绝的任务（例如 ID 冲突）由对端放回
+    BinaryReader reader(response);
+    uint64_t count = 0;
+    reader.readVarint(count);
+    std::vector<std::string> accepted;
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        TaskConfig config;
+        if (!TaskConfig::deserialize(reader, config)) {
+            break;
+        }
+        if (scheduler_.scheduleTask(config)) {
+            accepted.push_back(config.id);
+        }
+    }
+    if (count > 0) {
+        std::string ack;
+        BinaryWriter ackWriter(ack);
+        ackWriter.writeVarint(accepted.size());
+        for (const auto& id : accepted) {
+            ackWriter.writeString(id);
+        }
+        if (!sendFrame(fd, static_cast<uint8_t>(MessageType::ACK), ack)) {
+            // 对端收不到确认会放回这些任务，撤销本地副本以免重复执行
+            for (const auto& id : accepted) {
+                scheduler_.cancelTask(id);
+            }
+            accepted.clear();
+        }
+    }
+    ::close(fd);
+
+    {
+        // 对端积压以下次心跳为准，这里先扣减，避免在同一轮心跳周期内重复窃取
+        std::lock_guard<std::mutex> lock(membersMutex_);
+        auto it = members_.find(victim.nodeId);
+        if (it != members_.end()) {
+            it->second.pendingTasks -= std::min<size_t>(it->second.pendingTasks, count);
+        }
+    }
+
+    if (!accepted.empty()) {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.stolenTasks += accepted.size();
+        Logger::getInstance().debug("ClusterNode", "Stole " + std::to_string(accepted.size()) +
+                                    " tasks from " + victim.nodeId);
+    }
+}
+
+void ClusterNode::touchMember(const std::string& nodeId, size_t pendingTasks, size_t availableAgents) {
+    if (nodeId.empty() || nodeId == nodeId_) {
+        return;
+    }
+
+    Member member;
+    if (!parseAddress(nodeId, member.host, member.port)) {
+        return;
+    }
+    member.nodeId = nodeId;
+    member.pendingTasks = pendingTasks;
+    member.availableAgents = availableAgents;
+    member.lastSeen = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(membersMutex_);
+    if (members_.find(nodeId) == members_.end()) {
+        Logger::getInstance().info("ClusterNode", "Member joined: " + nodeId);
+    }
+    members_[nodeId] = member;
+    candidates_.erase(nodeId);
+}
+
+std::vector<ClusterNode::Member> ClusterNode::liveMembers() const {
+    std::vector<Member> result;
+
+    Member self;
+    self.nodeId = nodeId_;
+    self.host = config_.host;
+    self.port = port_;
+    self.lastSeen = std::chrono::steady_clock::now();
+    if (!nodeId_.empty()) {
+        result.push_back(self);
+    }
+
+    {
+        // 成员的移除只在 gossipRound 中按联系结果判定，这里不再按 lastSeen 过滤，避免视图抖动
+        std::lock_guard<std::mutex> lock(membersMutex_);
+        for (const auto& pair : members_) {
+            result.push_back(pair.second);
+        }
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const Member& a, const Member& b) { return a.nodeId < b.nodeId; });
+    return result;
+}
+
+bool ClusterNode::parseAddress(const std::string& address, std::string& host, uint16_t& port) {
+    auto pos = address.rfind(':');
+    if (pos == std::string::npos || pos == 0 || pos + 1 >= address.size()) {
+        return false;
+    }
+
+    unsigned long value = 0;
+    for (size_t i = pos + 1; i < address.size(); ++i) {
+        if (address[i] < '0' || address[i] > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<unsigned long>(address[i] - '0');
+        if (value > 65535) {
+            return false;
+        }
+    }
+
+    host = address.substr(0, pos);
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+
+} // namespace openclaw
@@ -0,0 +1,149 @@
+#include "common/EpochManager.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+namespace openclaw {
+
+// 线程私有的读者状态：槽位在线程首次进入临界区时分配，线程退出时归还
+struct EpochManager::ThreadState {
+    ReaderSlot* slot{nullptr};
+    bool overflow{false};
+    unsigned depth{0};
+
+    ~ThreadState() {
+        if (slot) {
+            EpochManager::getInstance().releaseSlot(slot);
+        }
+    }
+};
+
+EpochManager& EpochManager::getInstance() {
+    // 有意不析构：线程退出时仍会归还槽位
+    static EpochManager* instance = new EpochManager();
+    return *instance;
+}
+
+EpochManager::ThreadState& EpochManager::threadState() {
+    thread_local ThreadState state;
+    return state;
+}
+
+EpochManager::Guard::Guard() {
+    EpochManager::getInstance().enter();
+}
+
+EpochManager::Guard::~Guard() {
+    EpochManager::getInstance().leave();
+}
+
+void EpochManager::enter() {
+    ThreadState& state = threadState();
+    if (state.depth++ > 0) {
+        return;
+    }
+
+    if (!state.slot) {
+        state.slot = acquireSlot();
+    }
+    if (state.slot) {
+        state.slot->epoch.store(globalEpoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    } else {
+        state.overflow = true;
+        overflowReaders_.fetch_add(1, std::memory_order_seq_cst);
+    }
+    // 与 retire/reclaim 中的栅栏配对：要么写者看到本读者的纪元，要么本读者读到新指针
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochManager::leave() {
+    ThreadState& state = threadState();
+    if (--state.depth > 0) {
+        return;
+    }
+
+    if (state.overflow) {
+        state.overflow = false;
+        overflowReaders_.fetch_sub(1, std::memory_order_release);
+    } else {
+        state.slot->epoch.store(0, std::memory_order_release);
+    }
+}
+
+EpochManager::ReaderSlot* EpochManager::acquireSlot() {
+    for (auto& slot : slots_) {
+        bool expected = false;
+        if (!slot.owned.load(std::memory_order_relaxed) &&
+            slot.owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void EpochManager::releaseSlot(ReaderSlot* slot) {
+    slot->epoch.store(0, std::memory_order_release);
+    slot->owned.store(false, std::memory_order_release);
+}
+
+void EpochManager::retire(std::function<void()> deleter) {
+    // 调用方已经发布了新指针；推进纪元后，之后进入的读者只能看到新指针
+    uint64_t epoch = globalEpoch_.fetch_add(1, std::memory_order_seq_cst);
+
+    std::lock_guard<std::mutex> lock(retiredMutex_);
+    retired_.push_back({epoch, std::move(deleter)});
+}
+
+uint64_t EpochManager::minActiveEpoch() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (overflowReaders_.load(std::memory_order_seq_cst) > 0) {
+        return 0;
+    }
+
+    uint64_t minimum = std::numeric_limits<uint64_t>::max();
+    for (const auto& slot : slots_) {
+        uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch < minimum) {
+            minimum = epoch;
+        }
+    }
+    return minimum;
+}
+
+size_t EpochManager::reclaim() {
+    uint64_t minimum = minActiveEpoch();
+
+    // 纪元小于所有活跃读者纪元的对象已不可能被引用；回收在锁外执行
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> lock(retiredMutex_);
+        auto split = std::partition(retired_.begin(), retired_.end(),
+                                    [minimum](const Retired& item) { return item.epoch >= minimum; });
+        ready.assign(std::make_move_iterator(split), std::make_move_iterator(retired_.end()));
+        retired_.erase(split, retired_.end());
+    }
+
+    for (auto& item : ready) {
+        item.deleter();
+    }
+    return ready.size();
+}
+
+void EpochManager::synchronize() {
+    // 在读临界区内调用会永远等待自己
+    while (true) {
+        reclaim();
+        if (pendingCount() == 0) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+size_t EpochManager::pendingCount() const {
+    std::lock_guard<std::mutex> lock(retiredMutex_);
+    return retired_.size();
+}
+
+} // namespace openclaw
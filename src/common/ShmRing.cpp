@@ -0,0 +1,147 @@
+#include "common/ShmRing.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <ctime>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace openclaw {
+
+namespace {
+
+// 自旋阶段：先忙等，再让出处理器（单核时让对端进程有机会运行），最后才睡眠
+constexpr int kBusySpins = 256;
+constexpr int kYieldSpins = 64;
+
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::milliseconds timeout) {
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    ts.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+    // 跨进程共享，不能使用 FUTEX_PRIVATE_FLAG
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+} // namespace
+
+// 生产者与消费者的位置分处不同缓存行
+struct ShmRing::Control {
+    alignas(64) std::atomic<uint64_t> head;        // 消费者已读到的位置
+    alignas(64) std::atomic<uint64_t> tail;        // 生产者已写到的位置
+    alignas(64) std::atomic<uint32_t> signal;      // futex 字，每次唤醒加一
+    std::atomic<uint32_t> consumerWaiting;         // 消费者是否准备睡眠
+    uint64_t capacity;
+};
+
+size_t ShmRing::bytesFor(size_t capacity) {
+    return sizeof(Control) + capacity;
+}
+
+ShmRing ShmRing::create(void* memory, size_t capacity) {
+    auto* control = new (memory) Control();
+    control->head.store(0);
+    control->tail.store(0);
+    control->signal.store(0);
+    control->consumerWaiting.store(0);
+    control->capacity = capacity;
+    return ShmRing(memory);
+}
+
+ShmRing ShmRing::attach(void* memory) {
+    return ShmRing(memory);
+}
+
+ShmRing::ShmRing(void* memory)
+    : control_(static_cast<Control*>(memory)),
+      data_(static_cast<char*>(memory) + sizeof(Control)),
+      mask_(control_->capacity - 1) {}
+
+bool ShmRing::push(const std::string& message) {
+    uint32_t size = static_cast<uint32_t>(message.size());
+    uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    uint64_t head = control_->head.load(std::memory_order_acquire);
+    if (!fits(message.size()) || tail + sizeof(size) + size - head > capacity()) {
+        return false;
+    }
+
+    copyIn(tail, reinterpret_cast<const char*>(&size), sizeof(size));
+    copyIn(tail + sizeof(size), message.data(), size);
+    control_->tail.store(tail + sizeof(size) + size, std::memory_order_release);
+
+    // 与消费者“登记等待后再检查是否为空”配对，不会丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (control_->consumerWaiting.load(std::memory_order_relaxed)) {
+        control_->signal.fetch_add(1, std::memory_order_release);
+        futexWake(&control_->signal);
+    }
+    return true;
+}
+
+bool ShmRing::pop(std::string& message) {
+    uint64_t head = control_->head.load(std::memory_order_relaxed);
+    uint64_t tail = control_->tail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+
+    uint32_t size = 0;
+    copyOut(head, reinterpret_cast<char*>(&size), sizeof(size));
+    message.resize(size);
+    copyOut(head + sizeof(size), &message[0], size);
+    control_->head.store(head + sizeof(size) + size, std::memory_order_release);
+    return true;
+}
+
+bool ShmRing::empty() const {
+    return control_->head.load(std::memory_order_relaxed) == control_->tail.load(std::memory_order_acquire);
+}
+
+bool ShmRing::wait(std::chrono::milliseconds timeout) {
+    for (int i = 0; i < kBusySpins + kYieldSpins; ++i) {
+        if (!empty()) {
+            return true;
+        }
+        if (i < kBusySpins) {
+            cpuRelax();
+        } else {
+            sched_yield();
+        }
+    }
+
+    uint32_t expected = control_->signal.load(std::memory_order_acquire);
+    control_->consumerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (empty()) {
+        futexWait(&control_->signal, expected, timeout);
+    }
+    control_->consumerWaiting.store(0, std::memory_order_relaxed);
+    return !empty();
+}
+
+void ShmRing::copyIn(uint64_t position, const char* data, size_t size) {
+    size_t offset = static_cast<size_t>(position & mask_);
+    size_t first = std::min(size, capacity() - offset);
+    std::memcpy(data_ + offset, data, first);
+    std::memcpy(data_, data + first, size - first);
+}
+
+void ShmRing::copyOut(uint64_t position, char* data, size_t size) const {
+    size_t offset = static_cast<size_t>(position & mask_);
+    size_t first = std::min(size, capacity() - offset);
+    std::memcpy(data, data_ + offset, first);
+    std::memcpy(data + first, data_, size - first);
+}
+
+} // namespace openclaw
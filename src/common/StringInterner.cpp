@@ -0,0 +1,208 @@
+#include "common/StringInterner.h"
+#include "logging/Logger.h"
+#include <algorithm>
+
+namespace openclaw {
+
+StringInterner& StringInterner::getInstance() {
+    // 有意不析构：退出阶段其他静态对象仍可能还原句柄
+    static StringInterner* instance = new StringInterner();
+    return *instance;
+}
+
+namespace {
+
+// 高 4 位选分片，低 32 位作为分片内的散列标签
+size_t shardOf(uint64_t hash) {
+    return static_cast<size_t>(hash >> 60);
+}
+
+} // namespace
+
+StringInterner::Handle StringInterner::intern(std::string_view value) {
+    return insertOrRef(value, true);
+}
+
+StringInterner::Handle StringInterner::acquire(std::string_view value) {
+    return insertOrRef(value, false);
+}
+
+StringInterner::Handle StringInterner::insertOrRef(std::string_view value, bool pin) {
+    if (value.empty()) {
+        return kInvalidHandle;
+    }
+
+    uint64_t hash = std::hash<std::string_view>()(value);
+    Shard& shard = shards_[shardOf(hash)];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Handle existing = lookup(shard, value, hash);
+    if (existing != kInvalidHandle) {
+        Entry* entry = entryFor(existing);
+        if (pin) {
+            entry->refs = kPinned;
+        } else if (entry->refs != kPinned) {
+            entry->refs++;
+        }
+        return existing;
+    }
+
+    Handle handle = allocate();
+    if (handle == kInvalidHandle) {
+        Logger::getInstance().error("StringInterner", "Handle space exhausted, cannot intern: " + std::string(value));
+        return kInvalidHandle;
+    }
+
+    // 先写入字符串再发布句柄，持有句柄的线程都能看到完整的字符串
+    Entry* entry = entryFor(handle);
+    entry->value = value;
+    entry->refs = pin ? kPinned : 1;
+    insert(shard, hash, handle);
+    live_.fetch_add(1, std::memory_order_relaxed);
+    return handle;
+}
+
+void StringInterner::release(Handle handle) {
+    Entry* entry = entryFor(handle);
+    if (!entry) {
+        return;
+    }
+
+    // 调用方持有引用，字符串在加锁前不会被改写
+    uint64_t hash = std::hash<std::string_view>()(entry->value);
+    Shard& shard = shards_[shardOf(hash)];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (entry->refs == kPinned || entry->refs == 0 || --entry->refs > 0) {
+            return;
+        }
+        erase(shard, hash, handle);
+        entry->generation.fetch_add(1, std::memory_order_release);
+        std::string().swap(entry->value);
+    }
+    live_.fetch_sub(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    freeList_.push_back(handle & kIndexMask);
+}
+
+StringInterner::Handle StringInterner::find(std::string_view value) const {
+    if (value.empty()) {
+        return kInvalidHandle;
+    }
+
+    uint64_t hash = std::hash<std::string_view>()(value);
+    const Shard& shard = shards_[shardOf(hash)];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return lookup(shard, value, hash);
+}
+
+StringInterner::Handle StringInterner::lookup(const Shard& shard, std::string_view value, uint64_t hash) const {
+    if (shard.slots.empty()) {
+        return kInvalidHandle;
+    }
+    uint32_t tag = static_cast<uint32_t>(hash);
+    size_t mask = shard.slots.size() - 1;
+    for (size_t index = tag & mask;; index = (index + 1) & mask) {
+        const Slot& slot = shard.slots[index];
+        if (slot.handle == kInvalidHandle) {
+            return kInvalidHandle;
+        }
+        if (slot.tag == tag && resolve(slot.handle) == value) {
+            return slot.handle;
+        }
+    }
+}
+
+void StringInterner::insert(Shard& shard, uint64_t hash, Handle handle) {
+    // 负载因子上限 1/2；扩容时按标签重新分布，不需要还原字符串
+    if ((shard.count + 1) * 2 > shard.slots.size()) {
+        std::vector<Slot> old(std::max<size_t>(64, shard.slots.size() * 2), Slot{0, kInvalidHandle});
+        old.swap(shard.slots);
+        size_t mask = shard.slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.handle == kInvalidHandle) {
+                continue;
+            }
+            size_t index = slot.tag & mask;
+            while (shard.slots[index].handle != kInvalidHandle) {
+                index = (index + 1) & mask;
+            }
+            shard.slots[index] = slot;
+        }
+    }
+
+    uint32_t tag = static_cast<uint32_t>(hash);
+    size_t mask = shard.slots.size() - 1;
+    size_t index = tag & mask;
+    while (shard.slots[index].handle != kInvalidHandle) {
+        index = (index + 1) & mask;
+    }
+    shard.slots[index] = Slot{tag, handle};
+    ++shard.count;
+}
+
+void StringInterner::erase(Shard& shard, uint64_t hash, Handle handle) {
+    size_t mask = shard.slots.size() - 1;
+    size_t hole = static_cast<uint32_t>(hash) & mask;
+    while (shard.slots[hole].handle != handle) {
+        hole = (hole + 1) & mask;
+    }
+
+    // 后移删除：把后续同一探测链上的槽位前移填补空位，查找遇到空槽即可停止
+    for (size_t next = (hole + 1) & mask; shard.slots[next].handle != kInvalidHandle;
+         next = (next + 1) & mask) {
+        size_t home = shard.slots[next].tag & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            shard.slots[hole] = shard.slots[next];
+            hole = next;
+        }
+    }
+    shard.slots[hole] = Slot{0, kInvalidHandle};
+    --shard.count;
+}
+
+const std::string& StringInterner::resolve(Handle handle) const {
+    const Entry* entry = entryFor(handle);
+    return entry ? entry->value : empty_;
+}
+
+StringInterner::Entry* StringInterner::entryFor(Handle handle) const {
+    uint32_t index = handle & kIndexMask;
+    if (index == 0) {
+        return nullptr;
+    }
+    Entry* chunk = chunks_[index >> kChunkBits].load(std::memory_order_acquire);
+    if (!chunk) {
+        return nullptr;
+    }
+    Entry* entry = &chunk[index & (kChunkSize - 1)];
+    if (entry->generation.load(std::memory_order_acquire) != static_cast<uint8_t>(handle >> kIndexBits)) {
+        return nullptr;
+    }
+    return entry;
+}
+
+StringInterner::Handle StringInterner::allocate() {
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    uint32_t index;
+    // 空闲槽位不多时先用新槽位，让刚回收的槽位多闲置一段时间，延缓代数回绕
+    if (freeList_.size() >= kMinFreeBeforeReuse || (nextIndex_ > kIndexMask && !freeList_.empty())) {
+        index = freeList_.front();
+        freeList_.pop_front();
+    } else if (nextIndex_ <= kIndexMask) {
+        index = nextIndex_++;
+    } else {
+        return kInvalidHandle;
+    }
+
+    std::atomic<Entry*>& chunk = chunks_[index >> kChunkBits];
+    if (!chunk.load(std::memory_order_relaxed)) {
+        chunk.store(new Entry[kChunkSize], std::memory_order_release);
+    }
+    Entry& entry = chunk.load(std::memory_order_relaxed)[index & (kChunkSize - 1)];
+    return index | (static_cast<Handle>(entry.generation.load(std::memory_order_relaxed)) << kIndexBits);
+}
+
+} // namespace openclaw
@@ -0,0 +1,215 @@
+#include "common/TokenStream.h"
+
+#include <algorithm>
+
+namespace openclaw {
+
+// 读者的读取位置，单独占一个缓存行，避免与其他读者互相干扰
+struct TokenStream::Reader::Cursor {
+    alignas(64) std::atomic<uint64_t> position{0};
+};
+
+TokenStream::TokenStream(size_t capacity) : created_(std::chrono::steady_clock::now()) {
+    size_t slots = 2;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+    mask_ = slots - 1;
+    slots_.reset(new std::string[slots]);
+}
+
+TokenStream::Reader TokenStream::subscribe(bool replay) {
+    auto cursor = std::make_shared<Reader::Cursor>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // floor_ 之后的槽位在所有读者越过之前不会被覆盖，从这里开始读是安全的
+    cursor->position.store(replay ? floor_ : tail_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    readers_.push_back(cursor);
+    return Reader(shared_from_this(), std::move(cursor));
+}
+
+void TokenStream::unsubscribe(const std::shared_ptr<Reader::Cursor>& cursor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    readers_.erase(std::remove(readers_.begin(), readers_.end(), cursor), readers_.end());
+    spaceAvailable_.notify_one();
+}
+
+uint64_t TokenStream::slowestLocked(uint64_t tail) const {
+    uint64_t slowest = tail;
+    for (const auto& cursor : readers_) {
+        slowest = std::min(slowest, cursor->position.load(std::memory_order_acquire));
+    }
+    return slowest;
+}
+
+bool TokenStream::write(std::string chunk) {
+    if (finished_.load(std::memory_order_relaxed) || cancelled_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - floor_ > mask_) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            floor_ = slowestLocked(tail);
+            if (tail - floor_ <= mask_ || cancelled_.load(std::memory_order_relaxed)) {
+                break;
+            }
+            // 与读者推进位置配对：要么这里重新计算时看到新位置，要么读者看到 producerWaiting_
+            producerWaiting_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tail - slowestLocked(tail) > mask_ && !cancelled_.load(std::memory_order_relaxed)) {
+                spaceAvailable_.wait(lock);
+            }
+            producerWaiting_.store(false, std::memory_order_relaxed);
+        }
+        if (cancelled_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+    }
+
+    bytes_.fetch_add(chunk.size(), std::memory_order_relaxed);
+    slots_[tail & mask_] = std::move(chunk);
+    tail_.store(tail + 1, std::memory_order_release);
+    if (tail == 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - created_);
+        firstChunkMicros_.store(std::max<int64_t>(1, elapsed.count()), std::memory_order_release);
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (readersWaiting_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dataAvailable_.notify_all();
+    }
+    return true;
+}
+
+void TokenStream::finish(bool success, const std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (finished_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    success_ = success && !cancelled_.load(std::memory_order_relaxed);
+    error_ = error;
+    finished_.store(true, std::memory_order_release);
+    dataAvailable_.notify_all();
+}
+
+void TokenStream::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_.store(true, std::memory_order_release);
+    if (!finished_.load(std::memory_order_relaxed)) {
+        success_ = false;
+        error_ = "Stream cancelled";
+        finished_.store(true, std::memory_order_release);
+    }
+    dataAvailable_.notify_all();
+    spaceAvailable_.notify_all();
+}
+
+bool TokenStream::succeeded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return success_;
+}
+
+std::string TokenStream::getError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+void TokenStream::wakeProducer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producerWaiting_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        spaceAvailable_.notify_one();
+    }
+}
+
+TokenStream::Reader& TokenStream::Reader::operator=(Reader&& other) noexcept {
+    if (this != &other) {
+        close();
+        stream_ = std::move(other.stream_);
+        cursor_ = std::move(other.cursor_);
+    }
+    return *this;
+}
+
+StreamStatus TokenStream::Reader::next(std::string& chunk, std::chrono::milliseconds timeout) {
+    if (!stream_) {
+        return StreamStatus::FINISHED;
+    }
+    TokenStream& stream = *stream_;
+    uint64_t position = cursor_->position.load(std::memory_order_relaxed);
+
+    auto readable = [&stream, position] {
+        return position < stream.tail_.load(std::memory_order_acquire) ||
+               stream.finished_.load(std::memory_order_acquire);
+    };
+    if (!readable()) {
+        std::unique_lock<std::mutex> lock(stream.mutex_);
+        stream.readersWaiting_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        stream.dataAvailable_.wait_for(lock, timeout, readable);
+        stream.readersWaiting_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    if (stream.cancelled_.load(std::memory_order_acquire)) {
+        return StreamStatus::FINISHED;
+    }
+    // 先看结束标志再读写位置：finish 之前写入的分块都能读到
+    bool finished = stream.finished_.load(std::memory_order_acquire);
+    if (position == stream.tail_.load(std::memory_order_acquire)) {
+        return finished ? StreamStatus::FINISHED : StreamStatus::TIMEOUT;
+    }
+
+    chunk = stream.slots_[position & stream.mask_];
+    cursor_->position.store(position + 1, std::memory_order_release);
+    stream.wakeProducer();
+    return StreamStatus::CHUNK;
+}
+
+bool TokenStream::Reader::next(std::string& chunk) {
+    while (true) {
+        StreamStatus status = next(chunk, std::chrono::milliseconds(1000));
+        if (status != StreamStatus::TIMEOUT) {
+            return status == StreamStatus::CHUNK;
+        }
+    }
+}
+
+size_t TokenStream::Reader::forEach(const std::function<void(const std::string&)>& handler) {
+    size_t count = 0;
+    std::string chunk;
+    while (next(chunk)) {
+        handler(chunk);
+        count++;
+    }
+    return count;
+}
+
+void TokenStream::Reader::close() {
+    if (stream_) {
+        stream_->unsubscribe(cursor_);
+        stream_.reset();
+        cursor_.reset();
+    }
+}
+
+size_t logStream(TokenStream::Reader& reader, const std::string& tag, LogLevel level) {
+    std::string line;
+    size_t count = reader.forEach([&line, &tag, level](const std::string& chunk) {
+        size_t start = 0;
+        for (size_t newline = chunk.find('\n'); newline != std::string::npos; newline = chunk.find('\n', start)) {
+            line.append(chunk, start, newline - start);
+            Logger::getInstance().log(level, tag, line);
+            line.clear();
+            start = newline + 1;
+        }
+        line.append(chunk, start, std::string::npos);
+    });
+    if (!line.empty()) {
+        Logger::getInstance().log(level, tag, line);
+    }
+    return count;
+}
+
+} // namespace openclaw
@@ -0,0 +1,144 @@
+#include "communication/AgentChannel.h"
+#include "config/ConfigManager.h"
+#include "logging/Logger.h"
+
+namespace openclaw {
+
+AgentChannel::AgentChannel(std::string from, std::string to, size_t capacity)
+    : from_(std::move(from)), to_(std::move(to)), ring_(capacity) {}
+
+bool AgentChannel::send(const std::string& topic, const ChannelPayload& payload) {
+    if (closed_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    ChannelMessage message{topic, payload};
+    if (!ring_.push(message)) {
+        return false;
+    }
+    // 与接收方登记等待配对：要么接收方看到新消息，要么这里看到 waiting_
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        arrived_.notify_one();
+    }
+    return true;
+}
+
+bool AgentChannel::receive(ChannelMessage& message) {
+    return ring_.pop(message);
+}
+
+bool AgentChannel::receive(ChannelMessage& message, std::chrono::milliseconds timeout) {
+    if (ring_.pop(message)) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    arrived_.wait_for(lock, timeout, [this] { return !ring_.empty() || isClosed(); });
+    waiting_.store(false, std::memory_order_relaxed);
+    lock.unlock();
+    return ring_.pop(message);
+}
+
+void AgentChannel::close() {
+    closed_.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(waitMutex_);
+    arrived_.notify_all();
+}
+
+AgentChannelRegistry& AgentChannelRegistry::getInstance() {
+    static AgentChannelRegistry instance;
+    return instance;
+}
+
+void AgentChannelRegistry::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = enabled;
+}
+
+void AgentChannelRegistry::setAllowList(const std::vector<std::string>& agentIds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    allowed_ = std::unordered_set<std::string>(agentIds.begin(), agentIds.end());
+}
+
+bool AgentChannelRegistry::isAllowed(const std::string& from, const std::string& to) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!enabled_ || from == to) {
+        return false;
+    }
+    if (allowed_.count("*")) {
+        return true;
+    }
+    return allowed_.count(from) && allowed_.count(to);
+}
+
+void AgentChannelRegistry::loadConfig() {
+    auto& config = ConfigManager::getInstance();
+    setEnabled(config.getBool("agent_to_agent_enabled", false));
+    setAllowList(config.getStringList("agent_to_agent_allow"));
+}
+
+std::shared_ptr<AgentChannel> AgentChannelRegistry::openChannel(const std::string& from, const std::string& to,
+                                                                size_t capacity) {
+    if (!isAllowed(from, to)) {
+        Logger::getInstance().error("AgentChannelRegistry", "Agent-to-agent channel not allowed: " + from +
+                                    " -> " + to);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& channel = channels_[{from, to}];
+    if (!channel) {
+        channel = std::make_shared<AgentChannel>(from, to, capacity);
+        Logger::getInstance().info("AgentChannelRegistry", "Opened channel " + from + " -> " + to);
+    }
+    return channel;
+}
+
+std::shared_ptr<AgentChannel> AgentChannelRegistry::getChannel(const std::string& from, const std::string& to) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = channels_.find({from, to});
+    return it != channels_.end() ? it->second : nullptr;
+}
+
+bool AgentChannelRegistry::closeChannel(const std::string& from, const std::string& to) {
+    std::shared_ptr<AgentChannel> channel;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = channels_.find({from, to});
+        if (it == channels_.end()) {
+            return false;
+        }
+        channel = std::move(it->second);
+        channels_.erase(it);
+    }
+    channel->close();
+    return true;
+}
+
+size_t AgentChannelRegistry::closeChannelsOf(const std::string& agentId) {
+    std::vector<std::shared_ptr<AgentChannel>> closing;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = channels_.begin(); it != channels_.end();) {
+            if (it->first.first == agentId || it->first.second == agentId) {
+                closing.push_back(std::move(it->second));
+                it = channels_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (const auto& channel : closing) {
+        channel->close();
+    }
+    return closing.size();
+}
+
+size_t AgentChannelRegistry::getChannelCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return channels_.size();
+}
+
+} // namespace openclaw
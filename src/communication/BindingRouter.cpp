@@ -0,0 +1,187 @@
+#include "communication/BindingRouter.h"
+#include "common/EpochManager.h"
+#include "common/Fnv1a.h"
+#include "config/ConfigManager.h"
+#include "logging/Logger.h"
+#include <utility>
+
+namespace openclaw {
+
+namespace {
+
+constexpr uint32_t kEmptySlot = UINT32_MAX;
+const std::string kConfigPrefix = "binding.";
+
+// FNV-1a，渠道与账号之间插入一个分隔字节，避免 ("ab", "c") 与 ("a", "bc") 相同
+uint64_t hashKey(const std::string& channel, const std::string& accountId) {
+    uint64_t hash = fnv1a(accountId, fnv1a(std::string_view("\xFF", 1), fnv1a(channel)));
+    return hash ^ (hash >> 29);
+}
+
+} // namespace
+
+struct BindingRouter::Table {
+    struct Slot {
+        uint64_t hash;
+        uint32_t index;   // bindings 中的下标，kEmptySlot 表示空槽
+    };
+
+    std::vector<Binding> bindings;
+    std::vector<Slot> slots;      // 容量为 2 的幂
+    uint64_t mask{0};
+    bool channelWildcards{false};   // 存在 (channel, *)
+    bool accountWildcards{false};   // 存在 (*, accountId)
+    bool catchAll{false};           // 存在 (*, *)
+
+    explicit Table(const std::vector<Binding>& input) {
+        size_t capacity = 16;
+        while (capacity < input.size() * 2) {
+            capacity <<= 1;
+        }
+        slots.assign(capacity, Slot{0, kEmptySlot});
+        mask = capacity - 1;
+
+        bindings.reserve(input.size());
+        for (const auto& binding : input) {
+            if (binding.channel.empty() || binding.accountId.empty() || binding.agentId.empty()) {
+                Logger::getInstance().warning("BindingRouter", "Ignoring incomplete binding for agent: " +
+                                              binding.agentId);
+                continue;
+            }
+            uint64_t hash = hashKey(binding.channel, binding.accountId);
+            Slot* slot = probe(hash, binding.channel, binding.accountId);
+            if (slot->index != kEmptySlot) {
+                Logger::getInstance().warning("BindingRouter", "Duplicate binding " + binding.channel + "/" +
+                                              binding.accountId + ", using agent " + binding.agentId);
+                bindings[slot->index].agentId = binding.agentId;
+                continue;
+            }
+            *slot = Slot{hash, static_cast<uint32_t>(bindings.size())};
+            bindings.push_back(binding);
+
+            bool anyChannel = binding.channel == kWildcard;
+            bool anyAccount = binding.accountId == kWildcard;
+            catchAll |= anyChannel && anyAccount;
+            channelWildcards |= !anyChannel && anyAccount;
+            accountWildcards |= anyChannel && !anyAccount;
+        }
+    }
+
+    // 键所在的槽，或探测序列上的第一个空槽
+    Slot* probe(uint64_t hash, const std::string& channel, const std::string& accountId) {
+        return const_cast<Slot*>(static_cast<const Table*>(this)->probe(hash, channel, accountId));
+    }
+
+    const Slot* probe(uint64_t hash, const std::string& channel, const std::string& accountId) const {
+        for (uint64_t i = hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (slot.index == kEmptySlot) {
+                return &slot;
+            }
+            if (slot.hash == hash) {
+                const Binding& binding = bindings[slot.index];
+                if (binding.channel == channel && binding.accountId == accountId) {
+                    return &slot;
+                }
+            }
+        }
+    }
+
+    const Binding* find(const std::string& channel, const std::string& accountId) const {
+        const Slot* slot = probe(hashKey(channel, accountId), channel, accountId);
+        return slot->index == kEmptySlot ? nullptr : &bindings[slot->index];
+    }
+};
+
+BindingRouter& BindingRouter::getInstance() {
+    static BindingRouter instance;
+    return instance;
+}
+
+BindingRouter::BindingRouter() : table_(new Table({})) {}
+
+BindingRouter::~BindingRouter() {
+    unwatchConfig();
+}
+
+void BindingRouter::setBindings(const std::vector<Binding>& bindings) {
+    const Table* next = new Table(bindings);
+    size_t count = next->bindings.size();
+
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        table_.publish(next);
+        version_++;
+    }
+    RcuPtr<Table>::reclaim();
+
+    Logger::getInstance().info("BindingRouter", "Indexed " + std::to_string(count) + " bindings");
+}
+
+void BindingRouter::loadConfig() {
+    auto& config = ConfigManager::getInstance();
+    std::vector<Binding> bindings;
+    for (const auto& key : config.getKeys()) {
+        if (key.compare(0, kConfigPrefix.size(), kConfigPrefix) != 0) {
+            continue;
+        }
+        size_t dot = key.find('.', kConfigPrefix.size());
+        if (dot == std::string::npos || dot == kConfigPrefix.size() || dot + 1 == key.size()) {
+            Logger::getInstance().warning("BindingRouter", "Malformed binding key: " + key);
+            continue;
+        }
+        Binding binding;
+        binding.channel = key.substr(kConfigPrefix.size(), dot - kConfigPrefix.size());
+        binding.accountId = key.substr(dot + 1);
+        binding.agentId = config.getString(key);
+        bindings.push_back(std::move(binding));
+    }
+    setBindings(bindings);
+}
+
+void BindingRouter::watchConfig() {
+    configWatch_.start();
+}
+
+void BindingRouter::unwatchConfig() {
+    configWatch_.stop();
+}
+
+bool BindingRouter::resolve(const std::string& channel, const std::string& accountId, std::string& agentId) const {
+    static const std::string wildcard = kWildcard;
+    EpochManager::Guard guard;
+    const Table* table = table_.load();
+
+    const Binding* binding = table->find(channel, accountId);
+    if (!binding && table->channelWildcards) {
+        binding = table->find(channel, wildcard);
+    }
+    if (!binding && table->accountWildcards) {
+        binding = table->find(wildcard, accountId);
+    }
+    if (!binding && table->catchAll) {
+        binding = table->find(wildcard, wildcard);
+    }
+    if (!binding) {
+        return false;
+    }
+    agentId = binding->agentId;
+    return true;
+}
+
+std::string BindingRouter::resolve(const std::string& channel, const std::string& accountId) const {
+    std::string agentId;
+    resolve(channel, accountId, agentId);
+    return agentId;
+}
+
+size_t BindingRouter::getBindingCount() const {
+    EpochManager::Guard guard;
+    return table_.load()->bindings.size();
+}
+
+uint64_t BindingRouter::getVersion() const {
+    return version_.load();
+}
+
+} // namespace openclaw
@@ -0,0 +1,244 @@
+#include "communication/MentionRouter.h"
+#include "common/EpochManager.h"
+#include "config/ConfigManager.h"
+#include "logging/Logger.h"
+#include <algorithm>
+#include <deque>
+#include <unordered_set>
+
+namespace openclaw {
+
+namespace {
+
+constexpr uint32_t kNoState = UINT32_MAX;
+const std::string kConfigPrefix = "mention_patterns.";
+
+inline unsigned char fold(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+}
+
+inline bool isIdentifierChar(char ch) {
+    unsigned char c = static_cast<unsigned char>(ch);
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+} // namespace
+
+struct MentionRouter::Automaton {
+    uint8_t columns[256];                // 字节 -> 列，0 列为未出现在模式中的字节
+    size_t columnCount{1};
+    std::vector<uint32_t> next;          // next[state * columnCount + column]
+    std::vector<uint32_t> outputStart;   // 状态 s 命中的模式为 outputs[outputStart[s], outputStart[s + 1])
+    std::vector<uint32_t> outputs;
+    std::vector<std::string> patterns;
+    std::vector<std::string> agents;     // 与 patterns 一一对应
+
+    size_t stateCount() const { return outputStart.size() - 1; }
+};
+
+MentionRouter& MentionRouter::getInstance() {
+    static MentionRouter instance;
+    return instance;
+}
+
+MentionRouter::MentionRouter() : automaton_(compile({})) {}
+
+MentionRouter::~MentionRouter() {
+    unwatchConfig();
+}
+
+MentionRouter::Automaton* MentionRouter::compile(
+    const std::unordered_map<std::string, std::vector<std::string>>& patterns) {
+    auto* automaton = new Automaton();
+
+    // 按智能体 ID 排序，使命中顺序与模式序号确定
+    std::vector<std::string> agentIds;
+    for (const auto& entry : patterns) {
+        agentIds.push_back(entry.first);
+    }
+    std::sort(agentIds.begin(), agentIds.end());
+    for (const auto& agentId : agentIds) {
+        for (const auto& pattern : patterns.at(agentId)) {
+            if (!pattern.empty()) {
+                automaton->patterns.push_back(pattern);
+                automaton->agents.push_back(agentId);
+            }
+        }
+    }
+
+    // 字母表压缩：只为模式中出现的（折叠后的）字节分配列
+    std::fill(std::begin(automaton->columns), std::end(automaton->columns), 0);
+    uint8_t folded[256] = {0};
+    for (const auto& pattern : automaton->patterns) {
+        for (char ch : pattern) {
+            unsigned char c = fold(static_cast<unsigned char>(ch));
+            if (folded[c] == 0) {
+                folded[c] = static_cast<uint8_t>(automaton->columnCount++);
+            }
+        }
+    }
+    for (int b = 0; b < 256; ++b) {
+        automaton->columns[b] = folded[fold(static_cast<unsigned char>(b))];
+    }
+    const size_t columns = automaton->columnCount;
+
+    // 构建字典树
+    std::vector<uint32_t>& next = automaton->next;
+    std::vector<std::vector<uint32_t>> outputs(1);
+    next.assign(columns, kNoState);
+    for (uint32_t id = 0; id < automaton->patterns.size(); ++id) {
+        uint32_t state = 0;
+        for (char ch : automaton->patterns[id]) {
+            size_t cell = state * columns + automaton->columns[static_cast<unsigned char>(ch)];
+            if (next[cell] == kNoState) {
+                next[cell] = static_cast<uint32_t>(outputs.size());
+                outputs.emplace_back();
+                next.resize(next.size() + columns, kNoState);
+            }
+            state = next[cell];
+        }
+        outputs[state].push_back(id);
+    }
+
+    // 按广度优先补全失败转移，得到完整的 DFA；失败状态更浅，它的行已补全
+    std::vector<uint32_t> fail(outputs.size(), 0);
+    std::deque<uint32_t> queue;
+    for (size_t column = 0; column < columns; ++column) {
+        uint32_t& child = next[column];
+        if (child == kNoState) {
+            child = 0;
+        } else {
+            queue.push_back(child);
+        }
+    }
+    while (!queue.empty()) {
+        uint32_t state = queue.front();
+        queue.pop_front();
+        for (size_t column = 0; column < columns; ++column) {
+            uint32_t& child = next[state * columns + column];
+            uint32_t fallback = next[fail[state] * columns + column];
+            if (child == kNoState) {
+                child = fallback;
+                continue;
+            }
+            fail[child] = fallback;
+            const auto& inherited = outputs[fallback];
+            outputs[child].insert(outputs[child].end(), inherited.begin(), inherited.end());
+            queue.push_back(child);
+        }
+    }
+
+    automaton->outputStart.reserve(outputs.size() + 1);
+    automaton->outputStart.push_back(0);
+    for (const auto& list : outputs) {
+        automaton->outputs.insert(automaton->outputs.end(), list.begin(), list.end());
+        automaton->outputStart.push_back(static_cast<uint32_t>(automaton->outputs.size()));
+    }
+    return automaton;
+}
+
+void MentionRouter::setPatterns(const std::unordered_map<std::string, std::vector<std::string>>& patterns) {
+    Automaton* next = compile(patterns);
+    size_t patternCount = next->patterns.size();
+    size_t stateCount = next->stateCount();
+
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        automaton_.publish(next);
+        version_++;
+    }
+    RcuPtr<Automaton>::reclaim();
+
+    Logger::getInstance().info("MentionRouter", "Compiled " + std::to_string(patternCount) +
+                               " mention patterns into " + std::to_string(stateCount) + " states");
+}
+
+void MentionRouter::loadConfig() {
+    auto& config = ConfigManager::getInstance();
+    std::unordered_map<std::string, std::vector<std::string>> patterns;
+    for (const auto& key : config.getKeys()) {
+        if (key.size() > kConfigPrefix.size() && key.compare(0, kConfigPrefix.size(), kConfigPrefix) == 0) {
+            patterns[key.substr(kConfigPrefix.size())] = config.getStringList(key);
+        }
+    }
+    setPatterns(patterns);
+}
+
+void MentionRouter::watchConfig() {
+    configWatch_.start();
+}
+
+void MentionRouter::unwatchConfig() {
+    configWatch_.stop();
+}
+
+template <typename OnMatch>
+void MentionRouter::scan(const Automaton& automaton, const std::string& message, OnMatch&& onMatch) {
+    const uint32_t* next = automaton.next.data();
+    const uint32_t* outputStart = automaton.outputStart.data();
+    const size_t columns = automaton.columnCount;
+    const size_t size = message.size();
+
+    uint32_t state = 0;
+    for (size_t i = 0; i < size; ++i) {
+        state = next[state * columns + automaton.columns[static_cast<unsigned char>(message[i])]];
+        for (uint32_t k = outputStart[state]; k < outputStart[state + 1]; ++k) {
+            uint32_t id = automaton.outputs[k];
+            size_t start = i + 1 - automaton.patterns[id].size();
+            // 前后不能紧接标识符字符
+            if ((start > 0 && isIdentifierChar(message[start - 1])) ||
+                (i + 1 < size && isIdentifierChar(message[i + 1]))) {
+                continue;
+            }
+            onMatch(id, start);
+        }
+    }
+}
+
+std::vector<MentionRouter::Mention> MentionRouter::findMentions(const std::string& message) const {
+    EpochManager::Guard guard;
+    const Automaton* automaton = automaton_.load();
+    std::vector<Mention> mentions;
+    scan(*automaton, message, [&](uint32_t id, size_t offset) {
+        mentions.push_back(Mention{automaton->agents[id], automaton->patterns[id], offset});
+    });
+    // 命中按结束位置产生，改为按起始位置排列
+    std::stable_sort(mentions.begin(), mentions.end(),
+        [](const Mention& a, const Mention& b) { return a.offset < b.offset; });
+    return mentions;
+}
+
+std::vector<std::string> MentionRouter::route(const std::string& message) const {
+    EpochManager::Guard guard;
+    const Automaton* automaton = automaton_.load();
+    std::vector<std::pair<size_t, uint32_t>> hits;
+    scan(*automaton, message, [&hits](uint32_t id, size_t offset) { hits.emplace_back(offset, id); });
+    std::stable_sort(hits.begin(), hits.end(),
+        [](const std::pair<size_t, uint32_t>& a, const std::pair<size_t, uint32_t>& b) { return a.first < b.first; });
+
+    std::vector<std::string> agents;
+    std::unordered_set<std::string> seen;
+    for (const auto& hit : hits) {
+        const std::string& agentId = automaton->agents[hit.second];
+        if (seen.insert(agentId).second) {
+            agents.push_back(agentId);
+        }
+    }
+    return agents;
+}
+
+size_t MentionRouter::getPatternCount() const {
+    EpochManager::Guard guard;
+    return automaton_.load()->patterns.size();
+}
+
+size_t MentionRouter::getStateCount() const {
+    EpochManager::Guard guard;
+    return automaton_.load()->stateCount();
+}
+
+uint64_t MentionRouter::getVersion() const {
+    return version_.load();
+}
+
+} // namespace openclaw
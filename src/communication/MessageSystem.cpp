@@ -122,7 +122,12 @@ void MessageSystem::shutdown() {
         return;
     }
     
-    queueCV_.notify_all();
+    {
+        // 持锁通知，避免等待方在检查 running_ 之后、进入等待之前错过唤醒
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queueCV_.notify_all();
+        queueSpace_.notify_all();
+    }
     
     if (processorThread_.joinable()) {
         processorThread_.join();
@@ -136,13 +141,26 @@ bool MessageSystem::isRunning() const {
 }
 
 bool MessageSystem::sendMessage(const Message& message) {
-    if (!running_) {
+    if (!enqueue(message, 0)) {
         Logger::getInstance().error("MessageSystem", "Cannot send message, system not running");
         return false;
     }
     
+    Logger::getInstance().debug("MessageSystem", 
+        "Queued message: " + message.getId() + " from " + message.getFrom() + " to " + message.getTo());
+    
+    return true;
+}
+
+bool MessageSystem::enqueue(const Message& message, size_t limit) {
     {
-        std::lock_guard<std::mutex> lock(queueMutex_);
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        if (limit > 0) {
+            queueSpace_.wait(lock, [this, limit] { return messageQueue_.size() < limit || !running_; });
+        }
+        if (!running_) {
+            return false;
+        }
         messageQueue_.push(message);
     }
     
@@ -152,10 +170,6 @@ bool MessageSystem::sendMessage(const Message& message) {
         std::lock_guard<std::mutex> lock(statsMutex_);
         stats_.totalSent++;
     }
-    
-    Logger::getInstance().debug("MessageSystem", 
-        "Queued message: " + message.getId() + " from " + message.getFrom() + " to " + message.getTo());
-    
     return true;
 }
 
@@ -175,10 +189,10 @@ bool MessageSystem::broadcastMessage(const std::string& from, MessageType type,
     }
     
     bool allSuccess = true;
-    for (const auto& subId : it->second) {
-        auto subIt = subscribers_.find(subId);
-        if (subIt != subscribers_.end()) {
-            auto message = Message::create(from, subIt->second.name, type, content);
+    for (auto subHandle : it->second) {
+        const MessageSubscriber* sub = subscribers_.find(subHandle);
+        if (sub) {
+            auto message = Message::create(from, sub->name, type, content);
             sendMessage(message);
         }
     }
@@ -186,6 +200,38 @@ bool MessageSystem::broadcastMessage(const std::string& from, MessageType type,
     return allSuccess;
 }
 
+size_t MessageSystem::forwardStream(TokenStream::Reader& reader, const std::string& from, const std::string& to,
+                                    const std::string& streamId) {
+    // 不经 sendMessage：每个分块一条调试日志的开销与分块本身相当
+    size_t count = 0;
+    std::string chunk;
+    while (reader.next(chunk)) {
+        auto message = Message::create(from, to, MessageType::STREAM_CHUNK, chunk);
+        message.setCorrelationId(streamId);
+        if (!enqueue(message, kStreamQueueLimit)) {
+            Logger::getInstance().error("MessageSystem",
+                "Stopped forwarding stream " + streamId + " after " + std::to_string(count) + " chunks, system not running");
+            reader.close();
+            return count;
+        }
+        count++;
+    }
+    
+    std::string error;
+    if (reader.stream() && !reader.stream()->succeeded()) {
+        error = reader.stream()->getError();
+        if (error.empty()) {
+            error = "Stream failed";
+        }
+    }
+    auto end = Message::create(from, to, MessageType::STREAM_END, error);
+    end.setCorrelationId(streamId);
+    if (!enqueue(end, kStreamQueueLimit)) {
+        Logger::getInstance().error("MessageSystem", "Cannot end stream " + streamId + ", system not running");
+    }
+    return count;
+}
+
 std::string MessageSystem::subscribe(MessageType type, const std::string& name, 
                                     MessageHandler handler) {
     std::lock_guard<std::mutex> lock(subscribersMutex_);
@@ -196,8 +242,14 @@ std::string MessageSystem::subscribe(MessageType type, const std::string& name,
     sub.messageType = type;
     sub.handler = handler;
     
-    subscribers_[sub.id] = sub;
-    typeSubscribers_[type].push_back(sub.id);
+    // 订阅者 ID 按引用计数驻留，取消订阅时释放
+    auto handle = StringInterner::getInstance().acquire(sub.id);
+    if (handle == StringInterner::kInvalidHandle) {
+        Logger::getInstance().error("MessageSystem", "Cannot add subscriber: " + name);
+        return std::string();
+    }
+    subscribers_.emplace(handle, sub);
+    typeSubscribers_[type].push_back(handle);
     
     Logger::getInstance().info("MessageSystem", 
         "Subscriber added: " + name + " (ID: " + sub.id + ")");
@@ -206,18 +258,20 @@ std::string MessageSystem::subscribe(MessageType type, const std::string& name,
 }
 
 bool MessageSystem::unsubscribe(const std::string& subscriberId) {
+    auto handle = StringInterner::getInstance().find(subscriberId);
     std::lock_guard<std::mutex> lock(subscribersMutex_);
     
-    auto it = subscribers_.find(subscriberId);
-    if (it == subscribers_.end()) {
+    const MessageSubscriber* sub = subscribers_.find(handle);
+    if (!sub) {
         return false;
     }
     
-    auto type = it->second.messageType;
-    subscribers_.erase(it);
+    auto type = sub->messageType;
+    subscribers_.erase(handle);
     
     auto& subs = typeSubscribers_[type];
-    subs.erase(std::remove(subs.begin(), subs.end(), subscriberId), subs.end());
+    subs.erase(std::remove(subs.begin(), subs.end(), handle), subs.end());
+    StringInterner::getInstance().release(handle);
     
     Logger::getInstance().info("MessageSystem", "Subscriber removed: " + subscriberId);
     
@@ -271,6 +325,7 @@ void MessageSystem::processLoop() {
         while (!messageQueue_.empty()) {
             auto message = messageQueue_.front();
             messageQueue_.pop();
+            queueSpace_.notify_one();
             lock.unlock();
             
             routeMessage(message);
@@ -293,7 +348,7 @@ void MessageSystem::routeMessage(const Message& message) {
     }
     
     // 找到匹配的订阅者
-    std::vector<std::string> subscribersToNotify;
+    std::vector<StringInterner::Handle> subscribersToNotify;
     {
         std::lock_guard<std::mutex> lock(subscribersMutex_);
         auto it = typeSubscribers_.find(message.getType());
@@ -303,15 +358,15 @@ void MessageSystem::routeMessage(const Message& message) {
     }
     
     // 通知每个订阅者
-    for (const auto& subscriberId : subscribersToNotify) {
+    for (auto subHandle : subscribersToNotify) {
         std::lock_guard<std::mutex> lock(subscribersMutex_);
-        auto subIt = subscribers_.find(subscriberId);
-        if (subIt != subscribers_.end()) {
+        const MessageSubscriber* sub = subscribers_.find(subHandle);
+        if (sub) {
             try {
-                subIt->second.handler(message);
+                sub->handler(message);
             } catch (const std::exception& e) {
                 Logger::getInstance().error("MessageSystem", 
-                    "Error calling handler for subscriber " + subscriberId + ": " + e.what());
+                    "Error calling handler for subscriber " + sub->id + ": " + e.what());
                 {
                     std::lock_guard<std::mutex> lock(statsMutex_);
                     stats_.totalFailed++;
@@ -5,6 +5,7 @@
 #include <locale>
 #include <fstream>
 #include <sstream>
+#include <utility>
 
 namespace openclaw {
 
@@ -67,7 +68,93 @@ bool ConfigManager::reloadConfig() {
         return false;
     }
     
-    return loadConfig(configFile_);
+    // loadConfig 会先清空 configFile_，不能直接传入成员的引用
+    std::string filename = configFile_;
+    if (!loadConfig(filename)) {
+        return false;
+    }
+
+    // 复制后在锁外调用，监听器可以读取配置或注销自身；调用前确认仍已登记并记入 runningListeners_，
+    // 注销方据此等待调用结束
+    std::vector<std::pair<size_t, ReloadListener>> listeners;
+    {
+        std::lock_guard<std::mutex> lock(listenersMutex_);
+        listeners = reloadListeners_;
+    }
+    auto self = std::this_thread::get_id();
+    for (const auto& entry : listeners) {
+        {
+            std::lock_guard<std::mutex> lock(listenersMutex_);
+            bool registered = std::any_of(reloadListeners_.begin(), reloadListeners_.end(),
+                [&entry](const std::pair<size_t, ReloadListener>& current) { return current.first == entry.first; });
+            if (!registered) {
+                continue;
+            }
+            runningListeners_.emplace_back(entry.first, self);
+        }
+        entry.second();
+        {
+            std::lock_guard<std::mutex> lock(listenersMutex_);
+            auto running = std::find(runningListeners_.begin(), runningListeners_.end(), std::make_pair(entry.first, self));
+            runningListeners_.erase(running);
+        }
+        listenerFinished_.notify_all();
+    }
+    return true;
+}
+
+size_t ConfigManager::addReloadListener(ReloadListener listener) {
+    std::lock_guard<std::mutex> lock(listenersMutex_);
+    size_t listenerId = nextListenerId_++;
+    reloadListeners_.emplace_back(listenerId, std::move(listener));
+    return listenerId;
+}
+
+void ConfigManager::removeReloadListener(size_t listenerId) {
+    std::unique_lock<std::mutex> lock(listenersMutex_);
+    reloadListeners_.erase(std::remove_if(reloadListeners_.begin(), reloadListeners_.end(),
+        [listenerId](const std::pair<size_t, ReloadListener>& entry) { return entry.first == listenerId; }),
+        reloadListeners_.end());
+
+    // 等待其他线程上进行中的调用；本线程上的调用（监听器注销自身）不等待
+    auto self = std::this_thread::get_id();
+    listenerFinished_.wait(lock, [this, listenerId, self] {
+        return std::none_of(runningListeners_.begin(), runningListeners_.end(),
+            [listenerId, self](const std::pair<size_t, std::thread::id>& running) {
+                return running.first == listenerId && running.second != self;
+            });
+    });
+}
+
+ConfigReloadWatch::ConfigReloadWatch(ConfigManager::ReloadListener listener)
+    : listener_(std::move(listener)) {}
+
+ConfigReloadWatch::~ConfigReloadWatch() {
+    stop();
+}
+
+void ConfigReloadWatch::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (listenerId_ == 0) {
+        listenerId_ = ConfigManager::getInstance().addReloadListener(listener_);
+    }
+}
+
+void ConfigReloadWatch::stop() {
+    size_t listenerId = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(listenerId, listenerId_);
+    }
+    // 在锁外注销：等待进行中的回调时不阻塞并发的 start / isWatching
+    if (listenerId != 0) {
+        ConfigManager::getInstance().removeReloadListener(listenerId);
+    }
+}
+
+bool ConfigReloadWatch::isWatching() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return listenerId_ != 0;
 }
 
 std::string ConfigManager::getString(const std::string& key, const std::string& defaultValue) const {
@@ -284,6 +371,11 @@ bool ConfigManager::parseJsonFile(const std::string& filename) {
             continue;
         }
         
+        // 去掉成员之间的逗号
+        if (line.back() == ',') {
+            line.pop_back();
+        }
+        
         // 查找键值对
         size_t colonPos = line.find(':');
         if (colonPos == std::string::npos) {
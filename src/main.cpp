@@ -1,11 +1,18 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <memory>
 
+#include "agent/RemoteAgent.h"
+#include "cluster/ClusterNode.h"
 #include "events/EventDispatcher.h"
 #include "config/ConfigManager.h"
 #include "logging/Logger.h"
+#include "communication/AgentChannel.h"
+#include "communication/BindingRouter.h"
 #include "communication/Communicator.h"
+#include "communication/MentionRouter.h"
+#include "model/ModelGateway.h"
 
 using namespace openclaw;
 
@@ -27,7 +34,7 @@ void initializeComponents() {
 void registerEventHandlers() {
     // 系统启动事件处理
     EventDispatcher::getInstance().registerEventHandler(
-        EventType::SYSTEM_STARTUP,
+        openclaw::EventType::SYSTEM_STARTUP,
         [](const Event& event) {
             Logger::getInstance().info("System startup event received");
             Logger::getInstance().info("Source: " + event.getSource());
@@ -36,7 +43,7 @@ void registerEventHandlers() {
     
     // 任务完成事件处理
     EventDispatcher::getInstance().registerEventHandler(
-        EventType::TASK_COMPLETED,
+        openclaw::EventType::TASK_COMPLETED,
         [](const Event& event) {
             Logger::getInstance().info("Task completed: ");
         }
@@ -44,7 +51,7 @@ void registerEventHandlers() {
     
     // 任务失败事件处理
     EventDispatcher::getInstance().registerEventHandler(
-        EventType::TASK_FAILED,
+        openclaw::EventType::TASK_FAILED,
         [](const Event& event) {
             Logger::getInstance().error("Task failed: ");
         }
@@ -52,7 +59,7 @@ void registerEventHandlers() {
     
     // 测试通过事件处理
     EventDispatcher::getInstance().registerEventHandler(
-        EventType::TEST_PASSED,
+        openclaw::EventType::TEST_PASSED,
         [](const Event& event) {
             Logger::getInstance().info("Test passed: ");
         }
@@ -60,7 +67,7 @@ void registerEventHandlers() {
     
     // 测试失败事件处理
     EventDispatcher::getInstance().registerEventHandler(
-        EventType::TEST_FAILED,
+        openclaw::EventType::TEST_FAILED,
         [](const Event& event) {
             Logger::getInstance().warning("Test failed: ");
         }
@@ -96,28 +103,28 @@ void testEventDispatcher() {
     
     // 发送系统启动事件
     EventDispatcher::getInstance().dispatchEvent(
-        EventType::SYSTEM_STARTUP,
+        openclaw::EventType::SYSTEM_STARTUP,
         "main",
         "System initialization completed"
     );
     
     // 发送任务完成事件
     EventDispatcher::getInstance().dispatchEvent(
-        EventType::TASK_COMPLETED,
+        openclaw::EventType::TASK_COMPLETED,
         "coder",
         "EventDispatcher implementation completed"
     );
     
     // 发送测试通过事件
     EventDispatcher::getInstance().dispatchEvent(
-        EventType::TEST_PASSED,
+        openclaw::EventType::TEST_PASSED,
         "tester",
         "EventDispatcher functional test"
     );
     
     // 发送警告事件
     EventDispatcher::getInstance().dispatchEvent(
-        EventType::WARNING_OCCURRED,
+        openclaw::EventType::WARNING_OCCURRED,
         "system",
         "Low memory warning"
     );
@@ -183,6 +190,9 @@ void runTests() {
 }
 
 int main() {
+    // 作为 outOfProcess 智能体的子进程宿主被重新执行时，直接进入服务循环
+    RemoteAgent::serveIfHost();
+    
     std::cout << "=== OpenClaw-CPP System ===" << std::endl;
     
     try {
@@ -202,6 +212,36 @@ int main() {
         std::cout << "   - 事件驱动系统..." << std::endl;
         EventDispatcher::getInstance().setEventDispatchEnabled(true);
         
+        std::cout << "   - 模型网关..." << std::endl;
+        ModelGateway::getInstance().loadConfig();
+        
+        std::cout << "   - 提及与绑定路由..." << std::endl;
+        MentionRouter::getInstance().loadConfig();
+        MentionRouter::getInstance().watchConfig();
+        BindingRouter::getInstance().loadConfig();
+        BindingRouter::getInstance().watchConfig();
+        AgentChannelRegistry::getInstance().loadConfig();
+        
+        // 集群模式：本地调度器加入由 cluster_seeds 指定的集群，参与分区转发与工作窃取
+        std::unique_ptr<AgentManager> agentManager;
+        std::unique_ptr<TaskScheduler> scheduler;
+        std::unique_ptr<ClusterNode> clusterNode;
+        if (ConfigManager::getInstance().getBool("cluster_enabled", false)) {
+            std::cout << "   - 集群节点..." << std::endl;
+            agentManager = std::make_unique<AgentManager>();
+            scheduler = std::make_unique<TaskScheduler>(*agentManager);
+            if (ConfigManager::getInstance().getString("scheduler_execution_strategy", "default") == "shortest_queue") {
+                scheduler->setExecutionStrategy(std::make_unique<ShortestQueueExecutionStrategy>());
+            }
+            scheduler->start();
+            clusterNode = std::make_unique<ClusterNode>(*scheduler, ClusterConfig::fromConfig());
+            if (!clusterNode->start()) {
+                std::cerr << "❌ 集群节点启动失败" << std::endl;
+                return 1;
+            }
+            std::cout << "     节点 " << clusterNode->getNodeId() << std::endl;
+        }
+        
         std::cout << "✅ 组件初始化完成!" << std::endl;
         
         std::cout << "2. 注册事件和消息处理程序..." << std::endl;
@@ -222,8 +262,12 @@ int main() {
         
         // 系统关闭
         std::cout << "5. 系统关闭..." << std::endl;
+        if (clusterNode) {
+            clusterNode->stop();
+            scheduler->stop();
+        }
         EventDispatcher::getInstance().dispatchEvent(
-            EventType::SYSTEM_SHUTDOWN,
+            openclaw::EventType::SYSTEM_SHUTDOWN,
             "main",
             "System shutting down"
         );
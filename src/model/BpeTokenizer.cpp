@@ -0,0 +1,665 @@
+#include "model/BpeTokenizer.h"
+#include "logging/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace openclaw {
+
+namespace {
+
+enum CharClass : uint8_t {
+    kLetter = 0,   // ASCII 字母与所有 >= 0x80 的字节（UTF-8 多字节字符）
+    kDigit,
+    kSpace,
+    kPunct
+};
+
+struct ClassTable {
+    uint8_t classes[256];
+
+    ClassTable() {
+        for (int c = 0; c < 256; ++c) {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80) {
+                classes[c] = kLetter;
+            } else if (c >= '0' && c <= '9') {
+                classes[c] = kDigit;
+            } else if (c == ' ' || (c >= '\t' && c <= '\r')) {
+                classes[c] = kSpace;
+            } else {
+                classes[c] = kPunct;
+            }
+        }
+    }
+};
+
+const ClassTable kClasses;
+
+inline uint8_t classOf(char c) {
+    return kClasses.classes[static_cast<unsigned char>(c)];
+}
+
+#if defined(__SSE2__)
+// 16 个字节中属于 cls 的位掩码
+inline unsigned classMask(__m128i v, uint8_t cls) {
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    auto below = [&bias](__m128i x, char limit) {
+        // 无符号 x < limit：翻转符号位后做有符号比较
+        return _mm_cmplt_epi8(_mm_xor_si128(x, bias), _mm_xor_si128(_mm_set1_epi8(limit), bias));
+    };
+    __m128i letters = _mm_or_si128(
+        below(_mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')), 26),
+        _mm_cmplt_epi8(v, _mm_setzero_si128()));
+    if (cls == kLetter) {
+        return static_cast<unsigned>(_mm_movemask_epi8(letters));
+    }
+    __m128i digits = below(_mm_sub_epi8(v, _mm_set1_epi8('0')), 10);
+    if (cls == kDigit) {
+        return static_cast<unsigned>(_mm_movemask_epi8(digits));
+    }
+    __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                  below(_mm_sub_epi8(v, _mm_set1_epi8('\t')), 5));
+    if (cls == kSpace) {
+        return static_cast<unsigned>(_mm_movemask_epi8(spaces));
+    }
+    return ~static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), spaces))) & 0xFFFF;
+}
+#endif
+
+// 从 offset 起属于 cls 的字节数，至多 limit
+size_t spanClass(const char* data, size_t offset, size_t limit, uint8_t cls) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    while (i + 16 <= limit) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + i));
+        unsigned mask = classMask(v, cls);
+        if (mask != 0xFFFF) {
+            return i + static_cast<size_t>(__builtin_ctz(~mask));
+        }
+        i += 16;
+    }
+#endif
+    while (i < limit && classOf(data[offset + i]) == cls) {
+        ++i;
+    }
+    return i;
+}
+
+// 混合 8 字节块的散列，短串只需少量乘法
+inline uint64_t hashBytes(const char* data, size_t size) {
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ (size * 0xFF51AFD7ED558CCDULL);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t block;
+        std::memcpy(&block, data + i, 8);
+        hash = (hash ^ block) * 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 29;
+    }
+    if (i < size) {
+        uint64_t block = 0;
+        std::memcpy(&block, data + i, size - i);
+        hash = (hash ^ block) * 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 29;
+    }
+    return hash ^ (hash >> 32);
+}
+
+inline uint64_t mixPair(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return key;
+}
+
+// 每线程的片段编码缓存，直接映射，按片段散列取槽位，每项占一个缓存行（整表 2MB）。
+// 只缓存需要合并的短片段：整体即词元的片段查一次词元表即可，合并则要多次探测词元对表
+constexpr size_t kCacheEntries = 32768;
+constexpr size_t kCacheBytes = 24;
+constexpr size_t kCacheTokens = 6;
+
+struct alignas(64) CachedChunk {
+    uint64_t hash;
+    uint32_t owner;      // 分词器的 cacheId_，0 表示空槽
+    uint8_t size;
+    uint8_t count;
+    char bytes[kCacheBytes];
+    uint32_t tokens[kCacheTokens];
+};
+
+std::atomic<uint32_t> nextCacheId{0};
+
+// 首次使用时分配，避免每个线程的静态 TLS 都带上整张表
+CachedChunk* chunkCache() {
+    thread_local std::unique_ptr<CachedChunk[]> cache;
+    if (!cache) {
+        cache.reset(new CachedChunk[kCacheEntries]());
+    }
+    return cache.get();
+}
+
+size_t tableCapacity(size_t entries) {
+    size_t capacity = 16;
+    while (capacity < entries * 2) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+const char kBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string base64Encode(const std::string& input) {
+    std::string out;
+    out.reserve((input.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 3 <= input.size(); i += 3) {
+        uint32_t v = (static_cast<unsigned char>(input[i]) << 16) |
+                     (static_cast<unsigned char>(input[i + 1]) << 8) |
+                     static_cast<unsigned char>(input[i + 2]);
+        out.push_back(kBase64[(v >> 18) & 63]);
+        out.push_back(kBase64[(v >> 12) & 63]);
+        out.push_back(kBase64[(v >> 6) & 63]);
+        out.push_back(kBase64[v & 63]);
+    }
+    if (i < input.size()) {
+        uint32_t v = static_cast<unsigned char>(input[i]) << 16;
+        if (i + 1 < input.size()) {
+            v |= static_cast<unsigned char>(input[i + 1]) << 8;
+        }
+        out.push_back(kBase64[(v >> 18) & 63]);
+        out.push_back(kBase64[(v >> 12) & 63]);
+        out.push_back(i + 1 < input.size() ? kBase64[(v >> 6) & 63] : '=');
+        out.push_back('=');
+    }
+    return out;
+}
+
+bool base64Decode(const std::string& input, std::string& out) {
+    out.clear();
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : input) {
+        if (c == '=') {
+            break;
+        }
+        const char* pos = std::strchr(kBase64, c);
+        if (!pos || c == '\0') {
+            return false;
+        }
+        buffer = (buffer << 6) | static_cast<uint32_t>(pos - kBase64);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((buffer >> bits) & 0xFF));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+size_t BpeTokenizer::chunkEnd(const char* data, size_t size, size_t offset) {
+    size_t limit = std::min(size - offset, kMaxChunk);
+    uint8_t cls = classOf(data[offset]);
+    size_t start = 0;
+
+    if (cls == kSpace) {
+        size_t run = spanClass(data, offset, limit, kSpace);
+        if (offset + run == size || run == limit) {
+            return offset + run;
+        }
+        if (data[offset + run - 1] != ' ') {
+            return offset + run;   // 以换行等结尾的空白自成片段
+        }
+        if (run > 1) {
+            return offset + run - 1;   // 最后一个空格留给后面的片段
+        }
+        // 单个空格并入后面的片段
+        start = 1;
+        cls = classOf(data[offset + 1]);
+    }
+
+    size_t run = spanClass(data, offset + start, limit - start, cls);
+    if (cls == kDigit) {
+        run = std::min<size_t>(run, 3);
+    }
+    return offset + start + run;
+}
+
+void BpeTokenizer::pretokenize(const char* data, size_t size, std::vector<std::pair<size_t, size_t>>& chunks) {
+    size_t offset = 0;
+    while (offset < size) {
+        size_t end = chunkEnd(data, size, offset);
+        chunks.emplace_back(offset, end);
+        offset = end;
+    }
+}
+
+std::shared_ptr<BpeTokenizer> BpeTokenizer::loadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        Logger::getInstance().error("BpeTokenizer", "Failed to open vocabulary: " + path);
+        return nullptr;
+    }
+
+    std::vector<std::string> tokens;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        size_t space = line.find(' ');
+        std::string bytes;
+        char* end = nullptr;
+        unsigned long long rank = space == std::string::npos ? 0 : std::strtoull(line.c_str() + space + 1, &end, 10);
+        if (space == std::string::npos || end == line.c_str() + space + 1 || rank >= UINT32_MAX ||
+            !base64Decode(line.substr(0, space), bytes) || bytes.empty()) {
+            Logger::getInstance().error("BpeTokenizer", "Malformed vocabulary line " +
+                                        std::to_string(lineNumber) + " in " + path);
+            return nullptr;
+        }
+        if (rank >= tokens.size()) {
+            tokens.resize(rank + 1);
+        }
+        tokens[rank] = std::move(bytes);
+    }
+    return fromTokens(tokens);
+}
+
+std::shared_ptr<BpeTokenizer> BpeTokenizer::fromTokens(const std::vector<std::string>& tokens) {
+    std::shared_ptr<BpeTokenizer> tokenizer(new BpeTokenizer());
+    if (!tokenizer->build(tokens)) {
+        return nullptr;
+    }
+    return tokenizer;
+}
+
+bool BpeTokenizer::build(const std::vector<std::string>& tokens) {
+    if (tokens.size() > kMaxVocab) {
+        Logger::getInstance().error("BpeTokenizer", "Vocabulary too large: " + std::to_string(tokens.size()));
+        return false;
+    }
+    cacheId_ = nextCacheId.fetch_add(1, std::memory_order_relaxed) + 1;
+    offsets_.assign(1, 0);
+    offsets_.reserve(tokens.size() + 1);
+    size_t present = 0;
+    for (const auto& token : tokens) {
+        bytes_.append(token);
+        offsets_.push_back(static_cast<uint32_t>(bytes_.size()));
+        present += token.empty() ? 0 : 1;
+    }
+
+    tokenTable_.assign(tableCapacity(present), TokenSlot{0, kNoToken});
+    tokenMask_ = tokenTable_.size() - 1;
+    for (TokenId id = 0; id < tokens.size(); ++id) {
+        const std::string& token = tokens[id];
+        if (token.empty()) {
+            continue;
+        }
+        if (findToken(token.data(), token.size()) != kNoToken) {
+            Logger::getInstance().error("BpeTokenizer", "Duplicate token in vocabulary: rank " + std::to_string(id));
+            return false;
+        }
+        uint64_t hash = hashBytes(token.data(), token.size());
+        for (uint64_t slot = hash & tokenMask_;; slot = (slot + 1) & tokenMask_) {
+            if (tokenTable_[slot].id == kNoToken) {
+                tokenTable_[slot] = TokenSlot{static_cast<uint32_t>(hash >> 32), id};
+                break;
+            }
+        }
+    }
+
+    for (int b = 0; b < 256; ++b) {
+        char c = static_cast<char>(b);
+        byteTokens_[b] = findToken(&c, 1);
+        if (byteTokens_[b] == kNoToken) {
+            Logger::getInstance().error("BpeTokenizer", "Vocabulary lacks single-byte token " + std::to_string(b));
+            return false;
+        }
+    }
+
+    // 展开所有可由两个词元拼成的词元，拼接后的序号即这一对的合并优先级
+    std::vector<uint64_t> pairs;
+    for (TokenId id = 0; id < tokens.size(); ++id) {
+        const std::string& token = tokens[id];
+        for (size_t split = 1; split < token.size(); ++split) {
+            TokenId left = findToken(token.data(), split);
+            TokenId right = findToken(token.data() + split, token.size() - split);
+            if (left != kNoToken && right != kNoToken) {
+                pairs.push_back((((static_cast<uint64_t>(left) << kIdBits) | right) << kIdBits) | id);
+            }
+        }
+    }
+    pairTable_.assign(tableCapacity(pairs.size()), UINT64_MAX);
+    pairMask_ = pairTable_.size() - 1;
+    for (uint64_t pair : pairs) {
+        for (uint64_t slot = mixPair(pair >> kIdBits) & pairMask_;; slot = (slot + 1) & pairMask_) {
+            if (pairTable_[slot] == UINT64_MAX) {
+                pairTable_[slot] = pair;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<BpeTokenizer> BpeTokenizer::train(const std::string& corpus, size_t vocabSize) {
+    // 统计去重后的片段，每个片段以词元序列表示
+    std::unordered_map<std::string, size_t> counts;
+    std::vector<std::pair<size_t, size_t>> chunks;
+    pretokenize(corpus.data(), corpus.size(), chunks);
+    for (const auto& chunk : chunks) {
+        counts[corpus.substr(chunk.first, chunk.second - chunk.first)]++;
+    }
+
+    std::vector<std::string> tokens;
+    for (int b = 0; b < 256; ++b) {
+        tokens.emplace_back(1, static_cast<char>(b));
+    }
+    std::vector<std::pair<std::vector<TokenId>, size_t>> words;
+    words.reserve(counts.size());
+    for (const auto& pair : counts) {
+        std::vector<TokenId> symbols;
+        for (char c : pair.first) {
+            symbols.push_back(static_cast<unsigned char>(c));
+        }
+        words.emplace_back(std::move(symbols), pair.second);
+    }
+
+    while (tokens.size() < vocabSize) {
+        // 频次最高的相邻对，相同频次取 ID 较小的一对以保证结果确定
+        std::map<std::pair<TokenId, TokenId>, size_t> pairCounts;
+        for (const auto& word : words) {
+            for (size_t i = 0; i + 1 < word.first.size(); ++i) {
+                pairCounts[{word.first[i], word.first[i + 1]}] += word.second;
+            }
+        }
+        auto best = pairCounts.end();
+        for (auto it = pairCounts.begin(); it != pairCounts.end(); ++it) {
+            if (best == pairCounts.end() || it->second > best->second) {
+                best = it;
+            }
+        }
+        if (best == pairCounts.end()) {
+            break;
+        }
+
+        TokenId merged = static_cast<TokenId>(tokens.size());
+        TokenId left = best->first.first;
+        TokenId right = best->first.second;
+        tokens.push_back(tokens[left] + tokens[right]);
+        for (auto& word : words) {
+            auto& symbols = word.first;
+            size_t out = 0;
+            for (size_t i = 0; i < symbols.size(); ++i) {
+                if (i + 1 < symbols.size() && symbols[i] == left && symbols[i + 1] == right) {
+                    symbols[out++] = merged;
+                    ++i;
+                } else {
+                    symbols[out++] = symbols[i];
+                }
+            }
+            symbols.resize(out);
+        }
+    }
+    return fromTokens(tokens);
+}
+
+bool BpeTokenizer::saveToFile(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        Logger::getInstance().error("BpeTokenizer", "Failed to write vocabulary: " + path);
+        return false;
+    }
+    for (TokenId id = 0; id < vocabSize(); ++id) {
+        if (offsets_[id + 1] > offsets_[id]) {
+            file << base64Encode(tokenBytes(id)) << ' ' << id << '\n';
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+std::vector<BpeTokenizer::TokenId> BpeTokenizer::encode(const std::string& text) const {
+    std::vector<TokenId> tokens;
+    tokens.reserve(text.size() / 4 + 1);
+    encode(text.data(), text.size(), tokens);
+    return tokens;
+}
+
+void BpeTokenizer::encode(const char* data, size_t size, std::vector<TokenId>& out) const {
+    size_t offset = 0;
+    while (offset < size) {
+        size_t end = chunkEnd(data, size, offset);
+        encodeChunk(data + offset, end - offset, out);
+        offset = end;
+    }
+}
+
+size_t BpeTokenizer::countTokens(const std::string& text) const {
+    thread_local std::vector<TokenId> buffer;
+    buffer.clear();
+    encode(text.data(), text.size(), buffer);
+    return buffer.size();
+}
+
+std::string BpeTokenizer::decode(const std::vector<TokenId>& tokens) const {
+    std::string text;
+    for (TokenId token : tokens) {
+        if (token < vocabSize()) {
+            text.append(bytes_, offsets_[token], offsets_[token + 1] - offsets_[token]);
+        }
+    }
+    return text;
+}
+
+std::string BpeTokenizer::tokenBytes(TokenId token) const {
+    if (token >= vocabSize()) {
+        return std::string();
+    }
+    return bytes_.substr(offsets_[token], offsets_[token + 1] - offsets_[token]);
+}
+
+std::string BpeTokenizer::keepLastTokens(const std::string& text, size_t maxTokens) const {
+    std::vector<std::pair<size_t, size_t>> chunks;
+    pretokenize(text.data(), text.size(), chunks);
+
+    std::vector<TokenId> buffer;
+    size_t total = 0;
+    size_t keepFrom = text.size();
+    for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+        buffer.clear();
+        encodeChunk(text.data() + it->first, it->second - it->first, buffer);
+        if (total + buffer.size() > maxTokens) {
+            break;
+        }
+        total += buffer.size();
+        keepFrom = it->first;
+    }
+    return text.substr(keepFrom);
+}
+
+BpeTokenizer::TokenId BpeTokenizer::findToken(const char* data, size_t size) const {
+    return findToken(data, size, hashBytes(data, size));
+}
+
+BpeTokenizer::TokenId BpeTokenizer::findToken(const char* data, size_t size, uint64_t hash) const {
+    for (uint64_t slot = hash & tokenMask_;; slot = (slot + 1) & tokenMask_) {
+        const TokenSlot& entry = tokenTable_[slot];
+        if (entry.id == kNoToken) {
+            return kNoToken;
+        }
+        if (entry.tag == static_cast<uint32_t>(hash >> 32) && offsets_[entry.id + 1] - offsets_[entry.id] == size &&
+            std::memcmp(bytes_.data() + offsets_[entry.id], data, size) == 0) {
+            return entry.id;
+        }
+    }
+}
+
+BpeTokenizer::TokenId BpeTokenizer::findPair(TokenId left, TokenId right) const {
+    uint64_t key = (static_cast<uint64_t>(left) << kIdBits) | right;
+    for (uint64_t slot = mixPair(key) & pairMask_;; slot = (slot + 1) & pairMask_) {
+        uint64_t entry = pairTable_[slot];
+        if ((entry >> kIdBits) == key) {
+            return static_cast<TokenId>(entry & kMaxVocab);
+        }
+        if (entry == UINT64_MAX) {
+            return kNoToken;
+        }
+    }
+}
+
+void BpeTokenizer::prefetchPair(TokenId left, TokenId right) const {
+#if defined(__GNUC__)
+    uint64_t key = (static_cast<uint64_t>(left) << kIdBits) | right;
+    __builtin_prefetch(&pairTable_[mixPair(key) & pairMask_]);
+#else
+    (void)left;
+    (void)right;
+#endif
+}
+
+void BpeTokenizer::encodeChunk(const char* data, size_t size, std::vector<TokenId>& out) const {
+    // 常见词整体就是一个词元
+    uint64_t hash = hashBytes(data, size);
+    TokenId whole = findToken(data, size, hash);
+    if (whole != kNoToken) {
+        out.push_back(whole);
+        return;
+    }
+    if (size > kCacheBytes) {
+        mergeChunk(data, size, out);
+        return;
+    }
+
+    // 需要合并的片段先查本线程缓存，未命中时合并并记下结果
+    CachedChunk& cached = chunkCache()[(hash ^ (hash >> 17)) & (kCacheEntries - 1)];
+    if (cached.owner == cacheId_ && cached.hash == hash && cached.size == size &&
+        std::memcmp(cached.bytes, data, size) == 0) {
+        out.insert(out.end(), cached.tokens, cached.tokens + cached.count);
+        return;
+    }
+
+    size_t begin = out.size();
+    mergeChunk(data, size, out);
+    size_t count = out.size() - begin;
+    if (count <= kCacheTokens) {
+        cached.hash = hash;
+        cached.owner = cacheId_;
+        cached.size = static_cast<uint8_t>(size);
+        cached.count = static_cast<uint8_t>(count);
+        std::memcpy(cached.bytes, data, size);
+        std::copy(out.begin() + begin, out.end(), cached.tokens);
+    }
+}
+
+void BpeTokenizer::mergeChunk(const char* data, size_t size, std::vector<TokenId>& out) const {
+    // 词元串以下标链表表示：parts[i] 之后是 parts[next[i]]，size 表示末尾。
+    // parts[i] 与其后继合并后的词元记在 ranks[i]，kNoToken 表示不可合并或 i 已被并入前驱
+    TokenId parts[kMaxChunk];
+    TokenId ranks[kMaxChunk];
+    uint16_t next[kMaxChunk];
+    uint16_t prev[kMaxChunk];
+
+    // 候选对的最小堆，键为 (序号, 位置)：序号相同时先合并靠左的一对。
+    // 过期的候选留在堆中，弹出时与 ranks 比对后丢弃；每次合并至多新增两个候选
+    uint64_t heap[3 * kMaxChunk];
+    size_t heapSize = 0;
+    auto push = [&](size_t i) {
+        if (ranks[i] != kNoToken) {
+            heap[heapSize++] = (static_cast<uint64_t>(ranks[i]) << 32) | i;
+            std::push_heap(heap, heap + heapSize, std::greater<uint64_t>());
+        }
+    };
+
+    for (size_t i = 0; i < size; ++i) {
+        parts[i] = byteTokens_[static_cast<unsigned char>(data[i])];
+        next[i] = static_cast<uint16_t>(i + 1);
+        prev[i] = static_cast<uint16_t>(i - 1);
+    }
+    // 词元对表通常远大于缓存，先对所有相邻对发出预取，使这些探测的缺失并行而不是依次等待
+    for (size_t i = 0; i + 1 < size; ++i) {
+        prefetchPair(parts[i], parts[i + 1]);
+    }
+    for (size_t i = 0; i < size; ++i) {
+        ranks[i] = i + 1 < size ? findPair(parts[i], parts[i + 1]) : kNoToken;
+        push(i);
+    }
+
+    while (heapSize > 0) {
+        std::pop_heap(heap, heap + heapSize, std::greater<uint64_t>());
+        uint64_t top = heap[--heapSize];
+        size_t at = static_cast<size_t>(top & UINT32_MAX);
+        TokenId rank = static_cast<TokenId>(top >> 32);
+        if (ranks[at] != rank) {
+            continue;
+        }
+
+        // 把后继并入 at，再重算 at 与前驱的候选
+        size_t removed = next[at];
+        parts[at] = rank;
+        ranks[removed] = kNoToken;
+        next[at] = next[removed];
+        if (next[at] < size) {
+            prefetchPair(parts[at], parts[next[at]]);
+        }
+        if (at > 0) {
+            prefetchPair(parts[prev[at]], parts[at]);
+        }
+        if (next[at] < size) {
+            prev[next[at]] = static_cast<uint16_t>(at);
+            ranks[at] = findPair(parts[at], parts[next[at]]);
+        } else {
+            ranks[at] = kNoToken;
+        }
+        push(at);
+        if (at > 0) {
+            size_t before = prev[at];
+            ranks[before] = findPair(parts[before], parts[at]);
+            push(before);
+        }
+    }
+    for (size_t i = 0; i < size; i = next[i]) {
+        out.push_back(parts[i]);
+    }
+}
+
+IncrementalTokenizer::IncrementalTokenizer(std::shared_ptr<const BpeTokenizer> tokenizer)
+    : tokenizer_(std::move(tokenizer)) {}
+
+void IncrementalTokenizer::append(const std::string& text) {
+    if (text.empty()) {
+        return;
+    }
+    text_.append(text);
+    tokens_.resize(lastChunkToken_);
+
+    size_t offset = lastChunkOffset_;
+    while (offset < text_.size()) {
+        size_t end = BpeTokenizer::chunkEnd(text_.data(), text_.size(), offset);
+        lastChunkOffset_ = offset;
+        lastChunkToken_ = tokens_.size();
+        tokenizer_->encode(text_.data() + offset, end - offset, tokens_);
+        offset = end;
+    }
+}
+
+void IncrementalTokenizer::clear() {
+    text_.clear();
+    tokens_.clear();
+    lastChunkOffset_ = 0;
+    lastChunkToken_ = 0;
+}
+
+} // namespace openclaw
@@ -0,0 +1,152 @@
+#include "model/ModelProvider.h"
+#include <algorithm>
+#include <thread>
+
+namespace openclaw {
+
+namespace {
+
+// 按空白切分粗略估算词元数
+size_t countWords(const std::string& text) {
+    size_t count = 0;
+    bool inWord = false;
+    for (char c : text) {
+        bool space = c == ' ' || c == '\n' || c == '\t' || c == '\r';
+        if (!space && !inWord) {
+            count++;
+        }
+        inWord = !space;
+    }
+    return count;
+}
+
+} // namespace
+
+MockModelProvider::MockModelProvider(std::string id, std::chrono::milliseconds latency, size_t maxBatch)
+    : id_(std::move(id)), maxBatch_(maxBatch == 0 ? 1 : maxBatch), latency_(latency.count()) {}
+
+void MockModelProvider::setLatency(std::chrono::milliseconds latency, std::chrono::milliseconds perRequest) {
+    latency_ = latency.count();
+    perRequestLatency_ = perRequest.count();
+}
+
+void MockModelProvider::setResponder(Responder responder) {
+    std::lock_guard<std::mutex> lock(responderMutex_);
+    responder_ = std::move(responder);
+}
+
+ModelCost MockModelProvider::getCost(const std::string& /*model*/) const {
+    std::lock_guard<std::mutex> lock(responderMutex_);
+    return cost_;
+}
+
+void MockModelProvider::setCost(const ModelCost& cost) {
+    std::lock_guard<std::mutex> lock(responderMutex_);
+    cost_ = cost;
+}
+
+std::vector<ModelResponse> MockModelProvider::complete(const std::vector<ModelRequest>& requests) {
+    size_t inFlight = inFlight_.fetch_add(1) + 1;
+    size_t peak = maxInFlight_.load();
+    while (inFlight > peak && !maxInFlight_.compare_exchange_weak(peak, inFlight)) {
+    }
+    calls_++;
+    requests_ += requests.size();
+
+    auto latency = std::chrono::milliseconds(latency_.load() + perRequestLatency_.load() *
+                                             static_cast<std::chrono::milliseconds::rep>(requests.size()));
+    if (latency.count() > 0) {
+        std::this_thread::sleep_for(latency);
+    }
+
+    Responder responder;
+    {
+        std::lock_guard<std::mutex> lock(responderMutex_);
+        responder = responder_;
+    }
+
+    std::vector<ModelResponse> responses(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        ModelResponse& response = responses[i];
+        response.latency = latency;
+        if (failing_) {
+            response.error = "Mock provider failure";
+            continue;
+        }
+        response.success = true;
+        response.text = responder ? responder(requests[i]) : "mock:" + requests[i].prompt;
+        response.inputTokens = countWords(requests[i].system) + countWords(requests[i].prompt);
+        response.outputTokens = countWords(response.text);
+    }
+
+    // 按最长的回复补足逐词生成的时间
+    auto chunkDelay = std::chrono::milliseconds(chunkDelay_.load());
+    if (chunkDelay.count() > 0) {
+        size_t words = 0;
+        for (const auto& response : responses) {
+            words = std::max(words, response.outputTokens);
+        }
+        if (words > 1) {
+            std::this_thread::sleep_for(chunkDelay * static_cast<std::chrono::milliseconds::rep>(words - 1));
+        }
+    }
+
+    inFlight_--;
+    return responses;
+}
+
+ModelResponse MockModelProvider::stream(const ModelRequest& request, const ChunkSink& sink) {
+    size_t inFlight = inFlight_.fetch_add(1) + 1;
+    size_t peak = maxInFlight_.load();
+    while (inFlight > peak && !maxInFlight_.compare_exchange_weak(peak, inFlight)) {
+    }
+    calls_++;
+    requests_++;
+
+    auto start = std::chrono::steady_clock::now();
+    auto latency = std::chrono::milliseconds(latency_.load() + perRequestLatency_.load());
+    if (latency.count() > 0) {
+        std::this_thread::sleep_for(latency);
+    }
+
+    ModelResponse response;
+    if (failing_) {
+        response.error = "Mock provider failure";
+        inFlight_--;
+        return response;
+    }
+    Responder responder;
+    {
+        std::lock_guard<std::mutex> lock(responderMutex_);
+        responder = responder_;
+    }
+    response.text = responder ? responder(request) : "mock:" + request.prompt;
+    response.inputTokens = countWords(request.system) + countWords(request.prompt);
+    response.outputTokens = countWords(response.text);
+    response.success = true;
+
+    // 每段是一个词及其后的空白
+    auto chunkDelay = std::chrono::milliseconds(chunkDelay_.load());
+    const std::string& text = response.text;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find_first_of(" \n\t\r", pos);
+        end = end == std::string::npos ? text.size() : text.find_first_not_of(" \n\t\r", end);
+        end = end == std::string::npos ? text.size() : end;
+        if (pos > 0 && chunkDelay.count() > 0) {
+            std::this_thread::sleep_for(chunkDelay);
+        }
+        if (!sink(text.substr(pos, end - pos))) {
+            response.success = false;
+            response.error = "Stream cancelled";
+            break;
+        }
+        pos = end;
+    }
+
+    response.latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    inFlight_--;
+    return response;
+}
+
+} // namespace openclaw
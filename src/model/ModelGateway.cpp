@@ -0,0 +1,428 @@
+#include "model/ModelGateway.h"
+#include "config/ConfigManager.h"
+#include "logging/Logger.h"
+#include <algorithm>
+
+namespace openclaw {
+
+namespace {
+
+ModelResponse failure(const std::string& error) {
+    ModelResponse response;
+    response.error = error;
+    return response;
+}
+
+} // namespace
+
+ConcurrencyLimiter::ConcurrencyLimiter(size_t limit, ConcurrencyLimiter* parent)
+    : parent_(parent), limit_(limit) {}
+
+void ConcurrencyLimiter::acquire() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        available_.wait(lock, [this] { return limit_ == 0 || inFlight_ < limit_; });
+        inFlight_++;
+        peak_ = std::max(peak_, inFlight_);
+    }
+    if (parent_) {
+        parent_->acquire();
+    }
+}
+
+void ConcurrencyLimiter::release() {
+    if (parent_) {
+        parent_->release();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    inFlight_--;
+    available_.notify_one();
+}
+
+void ConcurrencyLimiter::setLimit(size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = limit;
+    available_.notify_all();
+}
+
+size_t ConcurrencyLimiter::getLimit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limit_;
+}
+
+size_t ConcurrencyLimiter::getInFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inFlight_;
+}
+
+size_t ConcurrencyLimiter::getPeakInFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+}
+
+// 一次进行中的请求，合并进来的请求在 cv 上等待同一结果
+struct ModelGateway::Call {
+    ModelRequest request;
+    std::string key;   // 未参与合并时为空
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done{false};
+    ModelResponse response;
+
+    bool taken{false};   // 已被某个批次取走，由所属 ProviderSlot::mutex 保护
+};
+
+// 每个提供方的排队与调用额度
+struct ModelGateway::ProviderSlot {
+    std::shared_ptr<ModelProvider> provider;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::shared_ptr<Call>> queue;
+    size_t limit{0};
+    size_t inFlight{0};
+    bool forming{false};   // 已有线程在组织下一个批次
+};
+
+ModelGateway& ModelGateway::getInstance() {
+    static ModelGateway instance;
+    return instance;
+}
+
+ModelGateway::ModelGateway()
+    : mainLane_(0, &total_), subagentLane_(0, &total_) {
+    setLimits(ModelGatewayLimits());
+}
+
+ModelGateway::~ModelGateway() = default;
+
+bool ModelGateway::registerProvider(const std::shared_ptr<ModelProvider>& provider, size_t maxConcurrent) {
+    if (!provider || provider->getId().empty()) {
+        Logger::getInstance().error("ModelGateway", "Cannot register provider without id");
+        return false;
+    }
+
+    auto slot = std::make_shared<ProviderSlot>();
+    slot->provider = provider;
+    slot->limit = maxConcurrent;
+
+    std::lock_guard<std::mutex> lock(providersMutex_);
+    if (!providers_.emplace(provider->getId(), slot).second) {
+        Logger::getInstance().warning("ModelGateway", "Provider already registered: " + provider->getId());
+        return false;
+    }
+    if (defaultProvider_.empty()) {
+        defaultProvider_ = provider->getId();
+    }
+    Logger::getInstance().info("ModelGateway", "Registered model provider: " + provider->getId());
+    return true;
+}
+
+bool ModelGateway::unregisterProvider(const std::string& providerId) {
+    // 进行中的调用持有 ProviderSlot 的引用，可以正常完成
+    std::lock_guard<std::mutex> lock(providersMutex_);
+    if (providers_.erase(providerId) == 0) {
+        return false;
+    }
+    if (defaultProvider_ == providerId) {
+        defaultProvider_ = providers_.empty() ? std::string() : providers_.begin()->first;
+    }
+    return true;
+}
+
+bool ModelGateway::hasProvider(const std::string& providerId) const {
+    std::lock_guard<std::mutex> lock(providersMutex_);
+    return providers_.count(providerId) > 0;
+}
+
+void ModelGateway::setDefaultProvider(const std::string& providerId) {
+    std::lock_guard<std::mutex> lock(providersMutex_);
+    defaultProvider_ = providerId;
+}
+
+void ModelGateway::setLimits(const ModelGatewayLimits& limits) {
+    total_.setLimit(limits.totalMaxConcurrent);
+    mainLane_.setLimit(limits.maxConcurrent);
+    subagentLane_.setLimit(limits.subagentMaxConcurrent);
+    batchWindow_ = limits.batchWindow.count();
+}
+
+void ModelGateway::setResponseCache(std::shared_ptr<ResponseCache> cache) {
+    std::lock_guard<std::mutex> lock(providersMutex_);
+    cache_ = std::move(cache);
+}
+
+std::shared_ptr<ResponseCache> ModelGateway::getResponseCache() const {
+    std::lock_guard<std::mutex> lock(providersMutex_);
+    return cache_;
+}
+
+ModelGatewayLimits ModelGateway::getLimits() const {
+    ModelGatewayLimits limits;
+    limits.maxConcurrent = mainLane_.getLimit();
+    limits.subagentMaxConcurrent = subagentLane_.getLimit();
+    limits.totalMaxConcurrent = total_.getLimit();
+    limits.batchWindow = std::chrono::milliseconds(batchWindow_.load());
+    return limits;
+}
+
+void ModelGateway::loadConfig() {
+    ModelGatewayLimits defaults;
+    auto& config = ConfigManager::getInstance();
+    ModelGatewayLimits limits;
+    limits.maxConcurrent = static_cast<size_t>(std::max(0, config.getInt("model_max_concurrent",
+        static_cast<int>(defaults.maxConcurrent))));
+    limits.subagentMaxConcurrent = static_cast<size_t>(std::max(0, config.getInt("model_subagent_max_concurrent",
+        static_cast<int>(defaults.subagentMaxConcurrent))));
+    limits.totalMaxConcurrent = static_cast<size_t>(std::max(0, config.getInt("model_total_max_concurrent",
+        static_cast<int>(defaults.totalMaxConcurrent))));
+    limits.batchWindow = std::chrono::milliseconds(std::max(0, config.getInt("model_batch_window",
+        static_cast<int>(defaults.batchWindow.count()))));
+    setLimits(limits);
+
+    // 响应缓存：内存预算与磁盘文件均未配置时不启用
+    ResponseCacheOptions cacheOptions;
+    cacheOptions.memoryBytes = static_cast<size_t>(std::max(0, config.getInt("model_cache_memory", 0))) << 20;
+    cacheOptions.diskPath = config.getString("model_cache_disk_path");
+    cacheOptions.diskBytes = static_cast<size_t>(std::max(1, config.getInt("model_cache_disk_size", 256))) << 20;
+    if (cacheOptions.memoryBytes > 0 || !cacheOptions.diskPath.empty()) {
+        setResponseCache(std::make_shared<ResponseCache>(cacheOptions));
+    }
+}
+
+ModelResponse ModelGateway::complete(const ModelRequest& request) {
+    requests_++;
+    auto slot = findProvider(request.model);
+    if (!slot) {
+        failed_++;
+        Logger::getInstance().error("ModelGateway", "No provider for model: " + request.model);
+        return failure("No provider for model: " + request.model);
+    }
+
+    auto cache = request.cacheable ? getResponseCache() : nullptr;
+    ModelCost cost;
+    if (cache) {
+        cost = slot->provider->getCost(request.model);
+        ModelResponse cached;
+        if (cache->lookup(request, cached, cost)) {
+            cacheHits_++;
+            return cached;
+        }
+    }
+
+    // 只合并确定性（temperature 为 0）或调用方允许复用结果（cacheable）的请求，
+    // 合并键与响应缓存相同：缓存视为等价的请求，进行中时同样可以共享结果
+    std::shared_ptr<Call> call;
+    bool joined = false;
+    if (request.temperature == 0.0 || request.cacheable) {
+        std::string key = ResponseCache::makeKey(request);
+        std::lock_guard<std::mutex> lock(inflightMutex_);
+        auto it = inflight_.find(key);
+        if (it != inflight_.end()) {
+            call = it->second;
+            joined = true;
+        } else {
+            call = std::make_shared<Call>();
+            call->request = request;
+            call->key = key;
+            inflight_.emplace(std::move(key), call);
+        }
+    } else {
+        call = std::make_shared<Call>();
+        call->request = request;
+    }
+    if (joined) {
+        // 合并到进行中的请求，不占用并发额度
+        coalesced_++;
+        ModelResponse response = wait(*call);
+        response.coalesced = true;
+        return response;
+    }
+
+    ConcurrencyLimiter& lane = request.subagent ? subagentLane_ : mainLane_;
+    lane.acquire();
+    dispatch(*slot, call);
+    lane.release();
+
+    ModelResponse response = wait(*call);
+    if (cache) {
+        cache->store(request, response, cost);
+    }
+    return response;
+}
+
+ModelResponse ModelGateway::stream(const ModelRequest& request, const std::shared_ptr<TokenStream>& out) {
+    requests_++;
+    streamed_++;
+    auto slot = findProvider(request.model);
+    if (!slot) {
+        failed_++;
+        Logger::getInstance().error("ModelGateway", "No provider for model: " + request.model);
+        return failure("No provider for model: " + request.model);
+    }
+
+    auto cache = request.cacheable ? getResponseCache() : nullptr;
+    ModelCost cost;
+    if (cache) {
+        cost = slot->provider->getCost(request.model);
+        ModelResponse cached;
+        if (cache->lookup(request, cached, cost)) {
+            cacheHits_++;
+            out->write(cached.text);
+            return cached;
+        }
+    }
+
+    ConcurrencyLimiter& lane = request.subagent ? subagentLane_ : mainLane_;
+    lane.acquire();
+    {
+        // 与批次轮流占用提供方额度，不打断正在组织的批次
+        std::unique_lock<std::mutex> lock(slot->mutex);
+        slot->cv.wait(lock, [&slot] { return !slot->forming && (slot->limit == 0 || slot->inFlight < slot->limit); });
+        slot->inFlight++;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ModelResponse response = slot->provider->stream(request, [&out](const std::string& chunk) {
+        return out->write(chunk);
+    });
+    if (response.latency.count() == 0) {
+        response.latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+    providerCalls_++;
+
+    {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->inFlight--;
+        slot->cv.notify_all();
+    }
+    lane.release();
+
+    if (!response.success) {
+        failed_++;
+    } else if (cache) {
+        cache->store(request, response, cost);
+    }
+    return response;
+}
+
+ModelGateway::Stats ModelGateway::getStats() const {
+    Stats stats;
+    stats.requests = requests_.load();
+    stats.coalesced = coalesced_.load();
+    stats.cacheHits = cacheHits_.load();
+    stats.providerCalls = providerCalls_.load();
+    stats.batchedRequests = batchedRequests_.load();
+    stats.failed = failed_.load();
+    stats.streamed = streamed_.load();
+    stats.peakMainInFlight = mainLane_.getPeakInFlight();
+    stats.peakSubagentInFlight = subagentLane_.getPeakInFlight();
+    return stats;
+}
+
+std::shared_ptr<ModelGateway::ProviderSlot> ModelGateway::findProvider(const std::string& model) const {
+    auto slash = model.find('/');
+    std::lock_guard<std::mutex> lock(providersMutex_);
+    auto it = providers_.find(slash == std::string::npos ? defaultProvider_ : model.substr(0, slash));
+    return it == providers_.end() ? nullptr : it->second;
+}
+
+void ModelGateway::dispatch(ProviderSlot& slot, const std::shared_ptr<Call>& call) {
+    std::unique_lock<std::mutex> lock(slot.mutex);
+    slot.queue.push_back(call);
+    slot.cv.notify_all();   // 正在凑批的线程可能在等队列攒满
+
+    // 排队的请求轮流组织批次：同一时刻只有一个线程在组织，且提供方须有空闲额度。
+    // 组织者取走的批次不一定包含自己的请求，此时继续等待
+    while (!call->taken) {
+        if (slot.forming || (slot.limit > 0 && slot.inFlight >= slot.limit)) {
+            slot.cv.wait(lock);
+            continue;
+        }
+
+        slot.forming = true;
+        size_t maxBatch = std::max<size_t>(1, slot.provider->maxBatchSize());
+        auto window = std::chrono::milliseconds(batchWindow_.load());
+        if (maxBatch > 1 && slot.inFlight > 0 && window.count() > 0) {
+            // 提供方空闲时立即发出；繁忙时稍等片刻，让后续请求并入同一批
+            slot.cv.wait_for(lock, window, [&slot, maxBatch] { return slot.queue.size() >= maxBatch; });
+        }
+
+        std::vector<std::shared_ptr<Call>> batch;
+        while (!slot.queue.empty() && batch.size() < maxBatch) {
+            slot.queue.front()->taken = true;
+            batch.push_back(std::move(slot.queue.front()));
+            slot.queue.pop_front();
+        }
+        slot.forming = false;
+        slot.inFlight++;
+        slot.cv.notify_all();
+
+        lock.unlock();
+        execute(slot, batch);
+        lock.lock();
+
+        slot.inFlight--;
+        slot.cv.notify_all();
+    }
+}
+
+void ModelGateway::execute(ProviderSlot& slot, const std::vector<std::shared_ptr<Call>>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+
+    std::vector<ModelRequest> requests;
+    requests.reserve(batch.size());
+    for (const auto& call : batch) {
+        requests.push_back(call->request);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ModelResponse> responses = slot.provider->complete(requests);
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    providerCalls_++;
+    if (batch.size() > 1) {
+        batchedRequests_ += batch.size();
+    }
+    if (responses.size() != batch.size()) {
+        Logger::getInstance().error("ModelGateway", "Provider " + slot.provider->getId() + " returned " +
+            std::to_string(responses.size()) + " responses for " + std::to_string(batch.size()) + " requests");
+        responses.resize(batch.size(), failure("Missing response from provider " + slot.provider->getId()));
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!responses[i].success) {
+            failed_++;
+        }
+        if (responses[i].latency.count() == 0) {
+            responses[i].latency = latency;
+        }
+        fulfill(*batch[i], std::move(responses[i]));
+    }
+}
+
+void ModelGateway::fulfill(Call& call, ModelResponse response) {
+    {
+        // 先移出进行中的表：此后到达的相同请求会重新调用，而不是拿到这次的结果
+        std::lock_guard<std::mutex> lock(inflightMutex_);
+        auto it = inflight_.find(call.key);
+        if (it != inflight_.end() && it->second.get() == &call) {
+            inflight_.erase(it);
+        }
+    }
+    std::lock_guard<std::mutex> lock(call.mutex);
+    call.response = std::move(response);
+    call.done = true;
+    call.cv.notify_all();
+}
+
+ModelResponse ModelGateway::wait(Call& call) {
+    std::unique_lock<std::mutex> lock(call.mutex);
+    call.cv.wait(lock, [&call] { return call.done; });
+    return call.response;
+}
+
+} // namespace openclaw
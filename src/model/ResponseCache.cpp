@@ -0,0 +1,467 @@
+#include "model/ResponseCache.h"
+#include "common/BinaryCodec.h"
+#include "common/Fnv1a.h"
+#include "logging/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace openclaw {
+
+namespace {
+
+// 折叠连续空白为单个空格并去掉首尾空白
+void appendNormalized(std::string& out, const std::string& text) {
+    bool pendingSpace = false;
+    bool any = false;
+    for (char c : text) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            pendingSpace = any;
+            continue;
+        }
+        if (pendingSpace) {
+            out.push_back(' ');
+            pendingSpace = false;
+        }
+        out.push_back(c);
+        any = true;
+    }
+}
+
+std::string encodeValue(const std::string& text, size_t inputTokens, size_t outputTokens) {
+    std::string value;
+    value.reserve(text.size() + 12);
+    BinaryWriter writer(value);
+    writer.writeString(text);
+    writer.writeVarint(inputTokens);
+    writer.writeVarint(outputTokens);
+    return value;
+}
+
+bool decodeValue(const std::string& value, std::string& text, size_t& inputTokens, size_t& outputTokens) {
+    BinaryReader reader(value);
+    uint64_t input = 0;
+    uint64_t output = 0;
+    if (!reader.readString(text) || !reader.readVarint(input) || !reader.readVarint(output)) {
+        return false;
+    }
+    inputTokens = static_cast<size_t>(input);
+    outputTokens = static_cast<size_t>(output);
+    return true;
+}
+
+} // namespace
+
+// 磁盘层：一个定长文件整体映射到内存，作为环形日志顺序写入记录，写满后从头覆盖最旧的记录。
+// 文件格式（小端）：
+//   64 字节文件头：u32 magic | u32 version | u64 数据区容量 | u64 写入位置 | u64 下一个序号 | u64 代号
+//   数据区中的记录按 64 字节对齐：
+//   u32 magic | u32 长度 | u64 代号 | u64 序号 | u64 键散列 | u32 键长 | u32 值长 | 键 | 值 | u64 校验和
+// 打开已有文件时扫描全部记录重建索引，只接受代号与文件头一致的记录，同一键保留序号最大的。
+// 清空时只需更换代号，旧记录随即失效。
+class ResponseCache::DiskTier {
+public:
+    DiskTier(const std::string& path, size_t capacity)
+        : path_(path), capacity_(capacity / kAlign * kAlign) {
+        if (capacity_ < kAlign * 16) {
+            Logger::getInstance().error("ResponseCache", "Disk cache too small: " + path);
+            return;
+        }
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0 || ::ftruncate(fd_, static_cast<off_t>(kHeaderSize + capacity_)) != 0) {
+            Logger::getInstance().error("ResponseCache", "Failed to open disk cache: " + path);
+            return;
+        }
+        void* base = ::mmap(nullptr, kHeaderSize + capacity_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            Logger::getInstance().error("ResponseCache", "Failed to map disk cache: " + path);
+            return;
+        }
+        base_ = static_cast<char*>(base);
+        data_ = base_ + kHeaderSize;
+
+        if (readU32(base_) == kFileMagic && readU32(base_ + 4) == kFileVersion &&
+            readU64(base_ + 8) == capacity_ && readU64(base_ + 16) <= capacity_) {
+            scan();
+        } else {
+            reset(static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+        }
+    }
+
+    ~DiskTier() {
+        if (base_) {
+            ::munmap(base_, kHeaderSize + capacity_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    bool valid() const { return base_ != nullptr; }
+
+    bool get(uint64_t hash, const std::string& key, std::string& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(hash);
+        if (it == index_.end()) {
+            return false;
+        }
+        Record record;
+        if (!readRecord(it->second, record) || record.hash != hash) {
+            // 记录已损坏，丢弃索引
+            byOffset_.erase(it->second);
+            index_.erase(it);
+            return false;
+        }
+        if (record.keyLength != key.size() || std::memcmp(record.key, key.data(), key.size()) != 0) {
+            return false;   // 散列冲突
+        }
+        value.assign(record.value, record.valueLength);
+        return true;
+    }
+
+    void put(uint64_t hash, const std::string& key, const std::string& value) {
+        size_t length = kRecordHeader + key.size() + value.size() + sizeof(uint64_t);
+        size_t aligned = (length + kAlign - 1) / kAlign * kAlign;
+        if (aligned > capacity_ / 4) {
+            return;   // 过大的记录不写入，避免一次冲掉大半缓存
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t head = readU64(base_ + 16);
+        if (head + aligned > capacity_) {
+            evictRange(head, capacity_);
+            head = 0;
+        }
+        evictRange(head, head + aligned);
+
+        uint64_t sequence = readU64(base_ + 24);
+        std::string record;
+        record.reserve(length);
+        BinaryWriter writer(record);
+        writer.writeU32(kRecordMagic);
+        writer.writeU32(static_cast<uint32_t>(length));
+        writer.writeU64(readU64(base_ + 32));
+        writer.writeU64(sequence);
+        writer.writeU64(hash);
+        writer.writeU32(static_cast<uint32_t>(key.size()));
+        writer.writeU32(static_cast<uint32_t>(value.size()));
+        writer.writeBytes(key.data(), key.size());
+        writer.writeBytes(value.data(), value.size());
+        writer.writeU64(fnv1a(record.data(), record.size()));
+        std::memcpy(data_ + head, record.data(), record.size());
+
+        auto existing = index_.find(hash);
+        if (existing != index_.end()) {
+            byOffset_.erase(existing->second);
+        }
+        index_[hash] = head;
+        byOffset_[head] = hash;
+        writeU64(base_ + 16, head + aligned);
+        writeU64(base_ + 24, sequence + 1);
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reset(readU64(base_ + 32) + 1);
+    }
+
+    size_t entries() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return index_.size();
+    }
+
+private:
+    static constexpr size_t kAlign = 64;
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr size_t kRecordHeader = 40;
+    static constexpr uint32_t kFileMagic = 0x43524F43;     // "OCRC"
+    static constexpr uint32_t kFileVersion = 1;
+    static constexpr uint32_t kRecordMagic = 0x52524F43;   // "OCRR"
+
+    struct Record {
+        uint64_t generation;
+        uint64_t sequence;
+        uint64_t hash;
+        uint32_t length;
+        uint32_t keyLength;
+        uint32_t valueLength;
+        const char* key;
+        const char* value;
+    };
+
+    static uint32_t readU32(const char* p) {
+        uint32_t value;
+        BinaryReader(p, sizeof(value)).readU32(value);
+        return value;
+    }
+
+    static uint64_t readU64(const char* p) {
+        uint64_t value;
+        BinaryReader(p, sizeof(value)).readU64(value);
+        return value;
+    }
+
+    static void writeU64(char* p, uint64_t value) {
+        std::string bytes;
+        BinaryWriter(bytes).writeU64(value);
+        std::memcpy(p, bytes.data(), bytes.size());
+    }
+
+    // 校验 offset 处的记录，调用方持有 mutex_（或在构造期间）
+    bool readRecord(uint64_t offset, Record& record) const {
+        if (offset + kRecordHeader + sizeof(uint64_t) > capacity_) {
+            return false;
+        }
+        BinaryReader reader(data_ + offset, capacity_ - offset);
+        uint32_t magic = 0;
+        if (!reader.readU32(magic) || magic != kRecordMagic || !reader.readU32(record.length) ||
+            record.length < kRecordHeader + sizeof(uint64_t) || record.length > capacity_ - offset ||
+            !reader.readU64(record.generation) || record.generation != readU64(base_ + 32) ||
+            !reader.readU64(record.sequence) || !reader.readU64(record.hash) ||
+            !reader.readU32(record.keyLength) || !reader.readU32(record.valueLength) ||
+            static_cast<uint64_t>(record.keyLength) + record.valueLength + kRecordHeader + sizeof(uint64_t) != record.length) {
+            return false;
+        }
+        const char* start = data_ + offset;
+        if (readU64(start + record.length - sizeof(uint64_t)) != fnv1a(start, record.length - sizeof(uint64_t))) {
+            return false;
+        }
+        record.key = start + kRecordHeader;
+        record.value = record.key + record.keyLength;
+        return true;
+    }
+
+    // 移除起始位置落在 [begin, end) 中的记录，它们即将被覆盖
+    void evictRange(uint64_t begin, uint64_t end) {
+        auto it = byOffset_.lower_bound(begin);
+        while (it != byOffset_.end() && it->first < end) {
+            auto indexed = index_.find(it->second);
+            if (indexed != index_.end() && indexed->second == it->first) {
+                index_.erase(indexed);
+            }
+            it = byOffset_.erase(it);
+        }
+    }
+
+    // 以新代号重新开始，数据区中的旧记录不再被接受
+    void reset(uint64_t generation) {
+        std::memset(base_, 0, kHeaderSize);
+        std::string header;
+        BinaryWriter writer(header);
+        writer.writeU32(kFileMagic);
+        writer.writeU32(kFileVersion);
+        writer.writeU64(capacity_);
+        writer.writeU64(0);
+        writer.writeU64(0);
+        writer.writeU64(generation);
+        std::memcpy(base_, header.data(), header.size());
+        index_.clear();
+        byOffset_.clear();
+    }
+
+    void scan() {
+        std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> latest;   // 散列 -> (序号, 位置)
+        uint64_t offset = 0;
+        while (offset + kAlign <= capacity_) {
+            Record record;
+            if (!readRecord(offset, record)) {
+                offset += kAlign;
+                continue;
+            }
+            auto it = latest.find(record.hash);
+            if (it == latest.end() || record.sequence > it->second.first) {
+                latest[record.hash] = {record.sequence, offset};
+            }
+            offset += (record.length + kAlign - 1) / kAlign * kAlign;
+        }
+        for (const auto& pair : latest) {
+            index_[pair.first] = pair.second.second;
+            byOffset_[pair.second.second] = pair.first;
+        }
+        Logger::getInstance().info("ResponseCache", "Loaded " + std::to_string(index_.size()) +
+                                   " cached responses from " + path_);
+    }
+
+    const std::string path_;
+    const size_t capacity_;
+    int fd_{-1};
+    char* base_{nullptr};
+    char* data_{nullptr};
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, uint64_t> index_;   // 键散列 -> 记录位置
+    std::map<uint64_t, uint64_t> byOffset_;          // 记录位置 -> 键散列，用于覆盖时按区间淘汰
+};
+
+ResponseCache::ResponseCache(const ResponseCacheOptions& options)
+    : shardBudget_(options.memoryBytes / std::max<size_t>(1, options.shards)) {
+    size_t shards = std::max<size_t>(1, options.shards);
+    shards_.reserve(shards);
+    for (size_t i = 0; i < shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    if (!options.diskPath.empty()) {
+        disk_ = std::make_unique<DiskTier>(options.diskPath, options.diskBytes);
+        if (!disk_->valid()) {
+            disk_.reset();
+        }
+    }
+}
+
+ResponseCache::~ResponseCache() = default;
+
+std::string ResponseCache::makeKey(const ModelRequest& request) {
+    std::string key;
+    key.reserve(request.model.size() + request.system.size() + request.prompt.size() + 32);
+    key.append(request.model).push_back('\0');
+    key.append(std::to_string(request.maxTokens)).push_back('\0');
+    // 按位编码 temperature，不同的取值不会因格式化精度而得到相同的键
+    uint64_t temperatureBits = 0;
+    std::memcpy(&temperatureBits, &request.temperature, sizeof(temperatureBits));
+    BinaryWriter(key).writeU64(temperatureBits);
+    appendNormalized(key, request.system);
+    key.push_back('\0');
+    appendNormalized(key, request.prompt);
+    return key;
+}
+
+bool ResponseCache::lookup(const ModelRequest& request, ModelResponse& response, const ModelCost& cost) {
+    std::string key = makeKey(request);
+    uint64_t hash = fnv1a(key.data(), key.size());
+
+    bool found = false;
+    bool fromDisk = false;
+    std::string text;
+    size_t inputTokens = 0;
+    size_t outputTokens = 0;
+    {
+        Shard& shard = shardFor(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(hash);
+        if (it != shard.index.end() && it->second->key == key) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            text = it->second->text;
+            inputTokens = it->second->inputTokens;
+            outputTokens = it->second->outputTokens;
+            found = true;
+        }
+    }
+
+    std::string value;
+    if (!found && disk_ && disk_->get(hash, key, value) && decodeValue(value, text, inputTokens, outputTokens)) {
+        found = true;
+        fromDisk = true;
+        insertMemory(Entry{hash, std::move(key), text, inputTokens, outputTokens});
+    }
+
+    double saved = 0.0;
+    if (found) {
+        response = ModelResponse();
+        response.success = true;
+        response.text = std::move(text);
+        response.inputTokens = inputTokens;
+        response.outputTokens = outputTokens;
+        response.cached = true;
+        saved = (cost.input * inputTokens + cost.output * outputTokens - cost.cacheRead * inputTokens) / 1e6;
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    AgentStats& stats = agentStats_[request.agentId];
+    if (found) {
+        stats.hits++;
+        stats.tokensSaved += inputTokens + outputTokens;
+        stats.costSaved += saved;
+        (fromDisk ? diskHits_ : memoryHits_)++;
+    } else {
+        stats.misses++;
+        misses_++;
+    }
+    return found;
+}
+
+void ResponseCache::store(const ModelRequest& request, const ModelResponse& response, const ModelCost& cost) {
+    if (!response.success) {
+        return;
+    }
+    std::string key = makeKey(request);
+    uint64_t hash = fnv1a(key.data(), key.size());
+    if (disk_) {
+        disk_->put(hash, key, encodeValue(response.text, response.inputTokens, response.outputTokens));
+    }
+    insertMemory(Entry{hash, std::move(key), response.text, response.inputTokens, response.outputTokens});
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    agentStats_[request.agentId].cacheWriteCost += cost.cacheWrite * response.inputTokens / 1e6;
+}
+
+void ResponseCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+        shard->bytes = 0;
+    }
+    if (disk_) {
+        disk_->clear();
+    }
+}
+
+ResponseCache::AgentStats ResponseCache::getAgentStats(const std::string& agentId) const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    auto it = agentStats_.find(agentId);
+    return it == agentStats_.end() ? AgentStats() : it->second;
+}
+
+ResponseCache::Stats ResponseCache::getStats() const {
+    Stats stats;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.memoryEntries += shard->lru.size();
+        stats.memoryBytes += shard->bytes;
+        stats.evictions += shard->evictions;
+    }
+    stats.diskEntries = disk_ ? disk_->entries() : 0;
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats.memoryHits = memoryHits_;
+    stats.diskHits = diskHits_;
+    stats.misses = misses_;
+    return stats;
+}
+
+ResponseCache::Shard& ResponseCache::shardFor(uint64_t hash) const {
+    return *shards_[hash % shards_.size()];
+}
+
+void ResponseCache::insertMemory(Entry entry) {
+    size_t bytes = entry.bytes();
+    if (bytes > shardBudget_) {
+        return;
+    }
+
+    Shard& shard = shardFor(entry.hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(entry.hash);
+    if (it != shard.index.end()) {
+        shard.bytes -= it->second->bytes();
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+    shard.lru.push_front(std::move(entry));
+    shard.index[shard.lru.front().hash] = shard.lru.begin();
+    shard.bytes += bytes;
+
+    while (shard.bytes > shardBudget_) {
+        const Entry& victim = shard.lru.back();
+        shard.bytes -= victim.bytes();
+        shard.index.erase(victim.hash);
+        shard.lru.pop_back();
+        shard.evictions++;
+    }
+}
+
+} // namespace openclaw
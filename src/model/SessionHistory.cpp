@@ -0,0 +1,177 @@
+#include "model/SessionHistory.h"
+#include "model/ModelGateway.h"
+#include "config/ConfigManager.h"
+#include "logging/Logger.h"
+#include <algorithm>
+
+namespace openclaw {
+
+namespace {
+
+const char kSummaryPrefix[] = "[summary] ";
+
+std::string renderSummary(const std::string& summary) {
+    return kSummaryPrefix + summary + "\n";
+}
+
+} // namespace
+
+CompactionOptions CompactionOptions::fromConfig() {
+    CompactionOptions defaults;
+    auto& config = ConfigManager::getInstance();
+    CompactionOptions options;
+    options.mode = config.getString("compaction_mode", defaults.mode);
+    options.contextWindow = static_cast<size_t>(std::max(1, config.getInt("compaction_context_window",
+        static_cast<int>(defaults.contextWindow))));
+    options.chunkTokens = static_cast<size_t>(std::max(1, config.getInt("compaction_chunk_tokens",
+        static_cast<int>(defaults.chunkTokens))));
+    options.keepRecentTokens = static_cast<size_t>(std::max(0, config.getInt("compaction_keep_recent_tokens",
+        static_cast<int>(defaults.keepRecentTokens))));
+    options.summaryTokens = static_cast<size_t>(std::max(1, config.getInt("compaction_summary_tokens",
+        static_cast<int>(defaults.summaryTokens))));
+    return options;
+}
+
+Summarizer makeGatewaySummarizer(const std::string& model, const std::string& agentId, ModelGateway& gateway) {
+    return [model, agentId, &gateway](const std::string& text, size_t maxTokens) {
+        ModelRequest request;
+        request.model = model;
+        request.system = "Summarize the following conversation excerpt. Keep decisions, open tasks, "
+                         "file names and identifiers; drop pleasantries.";
+        request.prompt = text;
+        request.maxTokens = static_cast<int>(maxTokens);
+        request.agentId = agentId;
+        ModelResponse response = gateway.complete(request);
+        return response.success ? response.text : std::string();
+    };
+}
+
+SessionHistory::SessionHistory(std::shared_ptr<const BpeTokenizer> tokenizer, const CompactionOptions& options,
+                               Summarizer summarizer)
+    : tokenizer_(std::move(tokenizer)), options_(options), summarizer_(std::move(summarizer)), tail_(tokenizer_) {}
+
+void SessionHistory::append(const std::string& role, const std::string& text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t before = tail_.tokenCount();
+    tail_.append(role + ": " + text + "\n");
+    stats_.appendedTokens += tail_.tokenCount() - before;
+
+    // 消息以换行结尾，换行自成预分词片段，因此在这里封存不会改变任何词元
+    if (tail_.tokenCount() >= options_.chunkTokens) {
+        sealTail();
+    }
+    if (options_.mode != "off") {
+        compactIfNeeded();
+    }
+}
+
+void SessionHistory::sealTail() {
+    Chunk chunk;
+    chunk.text = tail_.text();
+    chunk.tokens = tail_.tokenCount();
+    sealedTokens_ += chunk.tokens;
+    rawSealedTokens_ += chunk.tokens;
+    chunks_.push_back(std::move(chunk));
+    tail_.clear();
+}
+
+void SessionHistory::compactIfNeeded() {
+    size_t trigger = static_cast<size_t>(static_cast<double>(options_.contextWindow) * options_.triggerRatio);
+    if (sealedTokens_ + tail_.tokenCount() <= trigger) {
+        return;
+    }
+    size_t target = static_cast<size_t>(static_cast<double>(options_.contextWindow) * options_.targetRatio);
+
+    while (sealedTokens_ + tail_.tokenCount() > target) {
+        // 最早的未压缩块，前提是它之后仍保留足够的最近原文
+        if (firstRaw_ < chunks_.size() &&
+            rawSealedTokens_ - chunks_[firstRaw_].tokens + tail_.tokenCount() >= options_.keepRecentTokens) {
+            Chunk& chunk = chunks_[firstRaw_];
+            std::string summary = summarize(chunk.text);
+            chunk.summaryTokens = tokenizer_->countTokens(renderSummary(summary));
+            chunk.summary = std::move(summary);
+            chunk.summarized = true;
+            sealedTokens_ = sealedTokens_ - chunk.tokens + chunk.summaryTokens;
+            rawSealedTokens_ -= chunk.tokens;
+            stats_.compactedChunks++;
+            stats_.compactedTokens += chunk.tokens;
+            std::string().swap(chunk.text);
+            firstRaw_++;
+            continue;
+        }
+
+        // 原文已无可压缩的部分：合并最早的两段摘要
+        if (firstRaw_ < 2) {
+            break;
+        }
+        Chunk& first = chunks_[0];
+        Chunk& second = chunks_[1];
+        std::string summary = summarize(first.summary + "\n" + second.summary);
+        size_t tokens = tokenizer_->countTokens(renderSummary(summary));
+        if (tokens >= first.summaryTokens + second.summaryTokens) {
+            break;
+        }
+        sealedTokens_ = sealedTokens_ - first.summaryTokens - second.summaryTokens + tokens;
+        second.tokens += first.tokens;
+        second.summary = std::move(summary);
+        second.summaryTokens = tokens;
+        second.level = std::max(first.level, second.level) + 1;
+        chunks_.pop_front();
+        firstRaw_--;
+        stats_.summaryMerges++;
+    }
+
+    if (sealedTokens_ + tail_.tokenCount() > trigger) {
+        Logger::getInstance().warning("SessionHistory", "Context still above compaction threshold: " +
+                                      std::to_string(sealedTokens_ + tail_.tokenCount()) + " tokens");
+    }
+}
+
+std::string SessionHistory::summarize(const std::string& text) {
+    stats_.summarizedBytes += text.size();
+    if (summarizer_) {
+        std::string summary = summarizer_(text, options_.summaryTokens);
+        if (!summary.empty() && tokenizer_->countTokens(summary) <= options_.summaryTokens) {
+            return summary;
+        }
+        stats_.failures++;
+        Logger::getInstance().warning("SessionHistory", "Summarizer failed or exceeded budget, truncating instead");
+    }
+    return tokenizer_->keepLastTokens(text, options_.summaryTokens);
+}
+
+std::string SessionHistory::render() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string context;
+    for (const auto& chunk : chunks_) {
+        if (chunk.summarized) {
+            context += renderSummary(chunk.summary);
+        } else {
+            context += chunk.text;
+        }
+    }
+    context += tail_.text();
+    return context;
+}
+
+size_t SessionHistory::tokenCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sealedTokens_ + tail_.tokenCount();
+}
+
+size_t SessionHistory::chunkCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunks_.size() + (tail_.text().empty() ? 0 : 1);
+}
+
+void SessionHistory::setSummarizer(Summarizer summarizer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    summarizer_ = std::move(summarizer);
+}
+
+SessionHistory::Stats SessionHistory::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace openclaw
@@ -0,0 +1,566 @@
+#include "model/SessionStore.h"
+#include "common/BinaryCodec.h"
+#include "common/FileNameEscape.h"
+#include "common/Fnv1a.h"
+#include "logging/Logger.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+
+namespace openclaw {
+
+namespace {
+
+constexpr uint32_t kSegmentMagic = 0x5353434F;   // "OCSS"
+constexpr uint32_t kSegmentVersion = 1;
+constexpr size_t kHeaderBytes = 8;
+constexpr size_t kRecordOverhead = sizeof(uint32_t) + sizeof(uint64_t);
+const char kSegmentSuffix[] = ".seg";
+
+uint32_t loadU32(const char* data) {
+    BinaryReader reader(data, sizeof(uint32_t));
+    uint32_t value = 0;
+    reader.readU32(value);
+    return value;
+}
+
+uint64_t loadU64(const char* data) {
+    BinaryReader reader(data, sizeof(uint64_t));
+    uint64_t value = 0;
+    reader.readU64(value);
+    return value;
+}
+
+int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+// 一个段文件。size 为已写入文件的有效字节数，末尾的段还会随追加增长
+struct SessionStore::Segment {
+    uint64_t firstTurn{0};
+    std::string path;
+    size_t size{0};
+    bool indexed{false};
+    uint64_t turnCount{0};                              // 已索引时有效，含尚未写入文件的追加
+    std::vector<std::pair<uint64_t, uint64_t>> sparse;  // (轮次序号, 记录偏移)
+    const char* map{nullptr};
+    size_t mapLength{0};
+
+    ~Segment() { unmap(); }
+
+    void unmap() {
+        if (map) {
+            ::munmap(const_cast<char*>(map), mapLength);
+            map = nullptr;
+            mapLength = 0;
+        }
+    }
+
+    // 映射长度至少为 minimum；末尾段按段大小预留，追加后无需每次重新映射
+    bool ensureMapped(size_t minimum) {
+        if (map && mapLength >= size) {
+            return true;
+        }
+        unmap();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        size_t length = std::max(size, minimum);
+        void* data = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        map = static_cast<const char*>(data);
+        mapLength = length;
+        return true;
+    }
+};
+
+struct SessionStore::Session {
+    std::mutex mutex;
+    std::condition_variable durableChanged;
+    std::string id;
+    std::string directory;
+    std::vector<std::unique_ptr<Segment>> segments;   // 按首轮序号升序
+    int fd{-1};                 // 末尾段，只追加
+    uint64_t nextTurn{0};
+    std::string pending;        // 已编码、尚未写入文件的记录
+    uint64_t durableTurns{0};   // 之前的轮次都已落盘
+    bool failed{false};
+    uint64_t lastUsed{0};       // 由 SessionStore::sessionsMutex_ 保护
+
+    ~Session() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+SessionStore::SessionStore(std::string directory, const SessionStoreOptions& options)
+    : directory_(std::move(directory)), options_(options) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        Logger::getInstance().error("SessionStore", "Failed to create directory: " + directory_);
+    }
+    committer_ = std::thread(&SessionStore::commitLoop, this);
+}
+
+SessionStore::~SessionStore() {
+    {
+        std::lock_guard<std::mutex> lock(commitMutex_);
+        stopping_ = true;
+    }
+    commitWakeup_.notify_one();
+    committer_.join();
+}
+
+std::string SessionStore::pathFor(const std::string& sessionId) const {
+    return directory_ + "/" + escapeFileName(sessionId);
+}
+
+std::shared_ptr<SessionStore::Session> SessionStore::openSession(const std::string& sessionId, bool create) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    auto it = sessions_.find(sessionId);
+    if (it != sessions_.end()) {
+        it->second->lastUsed = ++useClock_;
+        return it->second;
+    }
+
+    auto session = std::make_shared<Session>();
+    session->id = sessionId;
+    session->directory = pathFor(sessionId);
+    std::error_code ec;
+    if (!std::filesystem::is_directory(session->directory, ec)) {
+        if (!create || sessionId.empty()) {
+            return nullptr;
+        }
+        std::filesystem::create_directories(session->directory, ec);
+        if (ec) {
+            Logger::getInstance().error("SessionStore", "Failed to create session directory: " + session->directory);
+            return nullptr;
+        }
+    }
+    if (!loadSession(*session)) {
+        return nullptr;
+    }
+    session->lastUsed = ++useClock_;
+    sessions_.emplace(sessionId, session);
+    if (sessions_.size() > options_.maxOpenSessions) {
+        evictIdleSessions();
+    }
+    return session;
+}
+
+void SessionStore::evictIdleSessions() {
+    // 只关闭除表项外无人持有、且追加都已落盘（或已失败）的会话：新的引用只能在 sessionsMutex_ 下取得，
+    // 关闭后再次打开时从文件恢复，不会与仍在使用的旧对象同时写同一个段
+    std::vector<std::pair<uint64_t, std::string>> idle;
+    for (const auto& entry : sessions_) {
+        Session& session = *entry.second;
+        if (entry.second.use_count() != 1) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(session.mutex);
+        if (session.failed || (session.pending.empty() && session.durableTurns == session.nextTurn)) {
+            idle.emplace_back(session.lastUsed, entry.first);
+        }
+    }
+
+    size_t excess = std::min(idle.size(), sessions_.size() - std::min(sessions_.size(), options_.maxOpenSessions));
+    std::nth_element(idle.begin(), idle.begin() + static_cast<std::ptrdiff_t>(excess), idle.end());
+    for (size_t i = 0; i < excess; ++i) {
+        sessions_.erase(idle[i].second);
+    }
+    evictedSessions_ += excess;
+}
+
+bool SessionStore::loadSession(Session& session) {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(session.directory, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= sizeof(kSegmentSuffix) - 1 ||
+            name.compare(name.size() - (sizeof(kSegmentSuffix) - 1), std::string::npos, kSegmentSuffix) != 0) {
+            continue;
+        }
+        auto segment = std::make_unique<Segment>();
+        segment->firstTurn = std::strtoull(name.c_str(), nullptr, 10);
+        segment->path = entry.path().string();
+        segment->size = static_cast<size_t>(entry.file_size(ec));
+        session.segments.push_back(std::move(segment));
+    }
+    std::sort(session.segments.begin(), session.segments.end(),
+        [](const std::unique_ptr<Segment>& a, const std::unique_ptr<Segment>& b) { return a->firstTurn < b->firstTurn; });
+
+    if (session.segments.empty()) {
+        return startSegment(session, 0);
+    }
+
+    // 只有末尾段可能有写了一半的记录
+    Segment& last = *session.segments.back();
+    indexSegment(session, last, true);
+    session.fd = ::open(last.path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (session.fd < 0) {
+        Logger::getInstance().error("SessionStore", "Failed to open segment: " + last.path);
+        return false;
+    }
+    session.nextTurn = last.firstTurn + last.turnCount;
+    session.durableTurns = session.nextTurn;
+    return true;
+}
+
+bool SessionStore::startSegment(Session& session, uint64_t firstTurn) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%020" PRIu64 "%s", firstTurn, kSegmentSuffix);
+    auto segment = std::make_unique<Segment>();
+    segment->firstTurn = firstTurn;
+    segment->path = session.directory + "/" + name;
+    segment->indexed = true;
+
+    int fd = ::open(segment->path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    std::string header;
+    BinaryWriter writer(header);
+    writer.writeU32(kSegmentMagic);
+    writer.writeU32(kSegmentVersion);
+    if (fd < 0 || !writeAll(fd, header.data(), header.size())) {
+        Logger::getInstance().error("SessionStore", "Failed to create segment: " + segment->path);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        session.failed = true;
+        return false;
+    }
+    segment->size = header.size();
+
+    if (session.fd >= 0) {
+        ::close(session.fd);
+    }
+    session.fd = fd;
+    session.segments.push_back(std::move(segment));
+    return true;
+}
+
+void SessionStore::indexSegment(Session& session, Segment& segment, bool verify) {
+    // 校验时以文件实际大小为准，否则以已知的有效大小为准
+    segment.indexed = true;
+    segment.turnCount = 0;
+    segment.sparse.clear();
+    if (!segment.ensureMapped(segment.size) || segment.size < kHeaderBytes ||
+        loadU32(segment.map) != kSegmentMagic) {
+        Logger::getInstance().error("SessionStore", "Unreadable segment: " + segment.path);
+        segment.size = std::min(segment.size, kHeaderBytes);
+        return;
+    }
+
+    size_t pos = kHeaderBytes;
+    while (pos + kRecordOverhead <= segment.size) {
+        uint32_t length = loadU32(segment.map + pos);
+        if (pos + kRecordOverhead + length > segment.size) {
+            break;
+        }
+        const char* payload = segment.map + pos + sizeof(uint32_t);
+        if (verify && loadU64(payload + length) != fnv1a(payload, length)) {
+            break;
+        }
+        BinaryReader reader(payload, length);
+        uint64_t turn = 0;
+        if (!reader.readVarint(turn) || turn != segment.firstTurn + segment.turnCount) {
+            break;
+        }
+        if (segment.turnCount % options_.indexStride == 0) {
+            segment.sparse.emplace_back(turn, pos);
+        }
+        segment.turnCount++;
+        pos += kRecordOverhead + length;
+    }
+
+    if (pos < segment.size) {
+        Logger::getInstance().warning("SessionStore", "Truncating " + std::to_string(segment.size - pos) +
+                                      " bytes of incomplete records in session " + session.id);
+        truncatedBytes_ += segment.size - pos;
+        if (::truncate(segment.path.c_str(), static_cast<off_t>(pos)) != 0) {
+            Logger::getInstance().error("SessionStore", "Failed to truncate segment: " + segment.path);
+        }
+        segment.size = pos;
+    }
+}
+
+uint64_t SessionStore::append(const std::string& sessionId, const std::string& role, const std::string& text,
+                              bool sync) {
+    auto session = openSession(sessionId, true);
+    if (!session) {
+        Logger::getInstance().error("SessionStore", "Cannot open session: " + sessionId);
+        return UINT64_MAX;
+    }
+
+    std::unique_lock<std::mutex> lock(session->mutex);
+    if (session->failed) {
+        return UINT64_MAX;
+    }
+
+    // 段写满时先把它落盘再滚动，新记录写入新段
+    Segment* active = session->segments.back().get();
+    if (active->turnCount > 0 && active->size + session->pending.size() >= options_.segmentBytes) {
+        if (!writePending(*session) || ::fdatasync(session->fd) != 0 || !startSegment(*session, session->nextTurn)) {
+            session->failed = true;
+            Logger::getInstance().error("SessionStore", "Failed to roll segment for session " + sessionId);
+            return UINT64_MAX;
+        }
+        session->durableTurns = session->nextTurn;
+        active = session->segments.back().get();
+    }
+
+    uint64_t turn = session->nextTurn++;
+    std::string payload;
+    payload.reserve(role.size() + text.size() + 24);
+    BinaryWriter payloadWriter(payload);
+    payloadWriter.writeVarint(turn);
+    payloadWriter.writeVarint(static_cast<uint64_t>(nowMillis()));
+    payloadWriter.writeString(role);
+    payloadWriter.writeString(text);
+
+    if (active->turnCount % options_.indexStride == 0) {
+        active->sparse.emplace_back(turn, active->size + session->pending.size());
+    }
+    active->turnCount++;
+    BinaryWriter writer(session->pending);
+    writer.writeU32(static_cast<uint32_t>(payload.size()));
+    writer.writeBytes(payload.data(), payload.size());
+    writer.writeU64(fnv1a(payload.data(), payload.size()));
+    appendedTurns_++;
+
+    requestCommit(sync);
+    if (sync) {
+        session->durableChanged.wait(lock, [&session, turn] { return session->durableTurns > turn || session->failed; });
+        if (session->failed) {
+            return UINT64_MAX;
+        }
+    }
+    return turn;
+}
+
+bool SessionStore::writePending(Session& session) {
+    // 调用方持有 session.mutex
+    if (session.pending.empty()) {
+        return true;
+    }
+    if (!writeAll(session.fd, session.pending.data(), session.pending.size())) {
+        Logger::getInstance().error("SessionStore", "Failed to write session " + session.id);
+        session.failed = true;
+        session.durableChanged.notify_all();
+        return false;
+    }
+    session.segments.back()->size += session.pending.size();
+    session.pending.clear();
+    return true;
+}
+
+void SessionStore::commit(Session& session) {
+    int fd = -1;
+    uint64_t target = 0;
+    {
+        std::lock_guard<std::mutex> lock(session.mutex);
+        if (session.failed || session.durableTurns == session.nextTurn || !writePending(session)) {
+            return;
+        }
+        target = session.nextTurn;
+        // 复制描述符后在锁外同步，期间追加不受阻塞；段滚动关闭原描述符也不影响这里
+        fd = ::dup(session.fd);
+    }
+    bool synced = fd >= 0 && ::fdatasync(fd) == 0;
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    commits_++;
+
+    std::lock_guard<std::mutex> lock(session.mutex);
+    if (!synced) {
+        Logger::getInstance().error("SessionStore", "Failed to sync session " + session.id);
+        session.failed = true;
+    } else {
+        session.durableTurns = std::max(session.durableTurns, target);
+    }
+    session.durableChanged.notify_all();
+}
+
+void SessionStore::requestCommit(bool immediate) {
+    // 只有从空闲变为有追加时才唤醒后台线程，同一批次内的后续追加不必加锁
+    if (!immediate && dirty_.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(commitMutex_);
+        dirty_ = true;
+        commitRequested_ = commitRequested_ || immediate;
+    }
+    commitWakeup_.notify_one();
+}
+
+void SessionStore::commitLoop() {
+    std::unique_lock<std::mutex> lock(commitMutex_);
+    while (true) {
+        // 空闲时一直等待；有追加后再等一个提交间隔，让同一间隔内的追加合并为一次同步
+        commitWakeup_.wait(lock, [this] { return dirty_ || stopping_; });
+        commitWakeup_.wait_for(lock, options_.commitInterval, [this] { return commitRequested_ || stopping_; });
+        bool stopping = stopping_;
+        commitRequested_ = false;
+        dirty_ = false;
+        lock.unlock();
+        flush();
+        {
+            std::lock_guard<std::mutex> sessionsLock(sessionsMutex_);
+            if (sessions_.size() > options_.maxOpenSessions) {
+                evictIdleSessions();
+            }
+        }
+        lock.lock();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void SessionStore::flush() {
+    std::vector<std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        for (const auto& entry : sessions_) {
+            sessions.push_back(entry.second);
+        }
+    }
+    for (const auto& session : sessions) {
+        commit(*session);
+    }
+}
+
+void SessionStore::decodeRange(Session& session, uint64_t from, uint64_t end, std::vector<SessionTurn>& out) {
+    // 调用方持有 session.mutex，且缓冲已写入文件
+    auto& segments = session.segments;
+    auto it = std::upper_bound(segments.begin(), segments.end(), from,
+        [](uint64_t turn, const std::unique_ptr<Segment>& segment) { return turn < segment->firstTurn; });
+    if (it == segments.begin()) {
+        return;
+    }
+    for (--it; it != segments.end() && from < end; ++it) {
+        Segment& segment = **it;
+        if (!segment.indexed) {
+            indexSegment(session, segment, false);
+        }
+        if (!segment.ensureMapped(options_.segmentBytes) || segment.sparse.empty()) {
+            continue;
+        }
+
+        // 从不超过 from 的最近索引点开始顺序解码
+        auto point = std::upper_bound(segment.sparse.begin(), segment.sparse.end(), from,
+            [](uint64_t turn, const std::pair<uint64_t, uint64_t>& entry) { return turn < entry.first; });
+        if (point != segment.sparse.begin()) {
+            --point;
+        }
+        uint64_t turn = point->first;
+        size_t pos = static_cast<size_t>(point->second);
+        while (from < end && pos + kRecordOverhead <= segment.size) {
+            uint32_t length = loadU32(segment.map + pos);
+            const char* payload = segment.map + pos + sizeof(uint32_t);
+            pos += kRecordOverhead + length;
+            if (turn++ < from) {
+                continue;
+            }
+            SessionTurn record;
+            uint64_t timestamp = 0;
+            BinaryReader reader(payload, length);
+            if (loadU64(payload + length) != fnv1a(payload, length) || !reader.readVarint(record.index) ||
+                !reader.readVarint(timestamp) || !reader.readString(record.role) || !reader.readString(record.text)) {
+                Logger::getInstance().error("SessionStore", "Corrupt record " + std::to_string(turn - 1) +
+                                            " in session " + session.id);
+                return;
+            }
+            record.timestamp = static_cast<int64_t>(timestamp);
+            out.push_back(std::move(record));
+            from++;
+        }
+    }
+}
+
+std::vector<SessionTurn> SessionStore::read(const std::string& sessionId, uint64_t from, size_t count) {
+    std::vector<SessionTurn> turns;
+    auto session = openSession(sessionId, false);
+    if (!session) {
+        return turns;
+    }
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (!writePending(*session)) {
+        return turns;
+    }
+    uint64_t end = std::min<uint64_t>(session->nextTurn, from + std::min<uint64_t>(count, session->nextTurn));
+    if (from < end) {
+        turns.reserve(static_cast<size_t>(end - from));
+        decodeRange(*session, from, end, turns);
+    }
+    return turns;
+}
+
+std::vector<SessionTurn> SessionStore::readLast(const std::string& sessionId, size_t count) {
+    uint64_t total = getTurnCount(sessionId);
+    return read(sessionId, total > count ? total - count : 0, count);
+}
+
+uint64_t SessionStore::getTurnCount(const std::string& sessionId) {
+    auto session = openSession(sessionId, false);
+    if (!session) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(session->mutex);
+    return session->nextTurn;
+}
+
+std::vector<std::string> SessionStore::listSessions() const {
+    std::vector<std::string> ids;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+        if (entry.is_directory(ec)) {
+            ids.push_back(unescapeFileName(entry.path().filename().string()));
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+SessionStore::Stats SessionStore::getStats() const {
+    Stats stats;
+    stats.commits = commits_.load();
+    stats.appendedTurns = appendedTurns_.load();
+    stats.truncatedBytes = truncatedBytes_.load();
+    stats.evictedSessions = evictedSessions_.load();
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    stats.openSessions = sessions_.size();
+    return stats;
+}
+
+} // namespace openclaw
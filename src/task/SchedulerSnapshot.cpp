@@ -0,0 +1,628 @@
+#include "task/TaskScheduler.h"
+#include "common/BinaryCodec.h"
+#include "common/DurableFile.h"
+#include "common/FlatHandleMap.h"
+#include "common/Fnv1a.h"
+#include "logging/Logger.h"
+#include <cstdio>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace openclaw {
+
+// 快照文件格式（小端）：
+//   u32 magic | u32 version | 配置 | 字符串表 | 任务 | 队列顺序 | 挂起任务 | 依赖边 | 智能体分配 | 统计 | u64 校验和
+// 所有字符串只在字符串表中出现一次，其余位置以变长整数索引引用
+namespace {
+
+constexpr uint32_t kSnapshotMagic = 0x4E53434F;   // "OCSN"
+constexpr uint32_t kSnapshotVersion = 1;
+
+int64_t toMillis(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromMillis(int64_t millis) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(millis)));
+}
+
+// 写入时的字符串去重表。字符串拷贝一份首尾相接存放（任务字段可能被执行线程修改），
+// 去重索引为开放寻址表，槽位只存散列标签与下标，不为每个字符串单独分配内存
+class StringTableBuilder {
+public:
+    // 下标 0 固定为空字符串（描述、阶段等字段大多为空），无需查表
+    explicit StringTableBuilder(size_t expected) : offsets_(2, 0) {
+        size_t capacity = 64;
+        while (capacity < expected * 2) {
+            capacity <<= 1;
+        }
+        slots_.assign(capacity, Slot{0, 0});
+        offsets_.reserve(expected + 2);
+        arena_.reserve(expected * 8);
+        byHandle_.reserve(expected);
+    }
+
+    uint32_t intern(std::string_view value) {
+        if (value.empty()) {
+            return 0;
+        }
+        if ((count() + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        uint64_t hash = std::hash<std::string_view>()(value);
+        uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            Slot& entry = slots_[slot];
+            if (entry.id == 0) {
+                entry = Slot{tag, static_cast<uint32_t>(offsets_.size() - 1)};
+                arena_.append(value.data(), value.size());
+                offsets_.push_back(arena_.size());
+                return entry.id;
+            }
+            if (entry.tag == tag && view(entry.id) == value) {
+                return entry.id;
+            }
+        }
+    }
+
+    // 驻留句柄先按整数查缓存，同一 ID 只做一次字符串散列
+    uint32_t intern(StringInterner::Handle handle) {
+        if (handle == StringInterner::kInvalidHandle) {
+            return 0;
+        }
+        if (const uint32_t* id = byHandle_.find(handle)) {
+            return *id;
+        }
+        return intern(handle, StringInterner::getInstance().resolve(handle));
+    }
+
+    // 调用方手头已有句柄对应的字符串（如任务自身的 ID）时不必再经驻留表解析
+    uint32_t intern(StringInterner::Handle handle, std::string_view value) {
+        uint32_t id = intern(value);
+        if (handle != StringInterner::kInvalidHandle) {
+            byHandle_.emplace(handle, id);
+        }
+        return id;
+    }
+
+    void write(BinaryWriter& writer) const {
+        writer.writeVarint(count());
+        for (size_t id = 0; id < count(); ++id) {
+            std::string_view value = view(id);
+            writer.writeVarint(value.size());
+            writer.writeBytes(value.data(), value.size());
+        }
+    }
+
+private:
+    struct Slot {
+        uint32_t tag;
+        uint32_t id;   // 0 表示空槽
+    };
+
+    size_t count() const { return offsets_.size() - 1; }
+
+    std::string_view view(size_t id) const {
+        return std::string_view(arena_.data() + offsets_[id], offsets_[id + 1] - offsets_[id]);
+    }
+
+    void grow() {
+        std::vector<Slot> old(slots_.size() * 2, Slot{0, 0});
+        old.swap(slots_);
+        size_t mask = slots_.size() - 1;
+        for (const Slot& entry : old) {
+            if (entry.id == 0) {
+                continue;
+            }
+            size_t slot = std::hash<std::string_view>()(view(entry.id)) & mask;
+            while (slots_[slot].id != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots_[slot] = entry;
+        }
+    }
+
+    std::string arena_;              // 全部字符串首尾相接
+    std::vector<size_t> offsets_;    // 字符串 i 为 arena_ 的 [offsets_[i], offsets_[i + 1])
+    std::vector<Slot> slots_;
+    FlatHandleMap<uint32_t> byHandle_;
+};
+
+// 只读映射整个快照文件
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                ::madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(data);
+                size_ = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_{nullptr};
+    size_t size_{0};
+};
+
+// 读取字符串索引并在表中查找，越界时使读取器进入失败状态
+class StringTableReader {
+public:
+    bool read(BinaryReader& reader) {
+        uint64_t count = 0;
+        if (!reader.readVarint(count) || count > reader.remaining()) {
+            return false;
+        }
+        // 表项直接引用映射内存；只有写入任务配置（std::string 字段）时才拷贝
+        strings_.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t length = 0;
+            if (!reader.readVarint(length)) {
+                return false;
+            }
+            const char* data = reader.current();
+            if (!reader.skip(length)) {
+                return false;
+            }
+            strings_.emplace_back(data, length);
+        }
+        return reader.ok();
+    }
+
+    bool get(BinaryReader& reader, std::string& out) const {
+        uint64_t id = 0;
+        return get(reader, out, id);
+    }
+
+    // 同时返回表下标，便于之后为该表项登记已知的驻留句柄
+    bool get(BinaryReader& reader, std::string& out, uint64_t& id) const {
+        id = 0;
+        if (!reader.readVarint(id) || id >= strings_.size()) {
+            failed_ = true;
+            id = 0;
+            return false;
+        }
+        if (id == 0) {
+            out.clear();
+            return true;
+        }
+        out.assign(strings_[id].data(), strings_[id].size());
+        return true;
+    }
+
+    // 读取任务 ID：直接以映射内存中的视图 acquire 一个引用（交给 Task 接管），
+    // 并登记句柄，之后依赖表等对同一 ID 的引用不再查驻留表
+    StringInterner::Handle acquire(BinaryReader& reader, std::string& out) {
+        uint64_t id = 0;
+        if (!get(reader, out, id) || id == 0) {
+            failed_ = true;
+            return StringInterner::kInvalidHandle;
+        }
+        StringInterner::Handle handle = StringInterner::getInstance().acquire(strings_[id]);
+        if (handles_.empty()) {
+            handles_.resize(strings_.size(), StringInterner::kInvalidHandle);
+        }
+        handles_[id] = handle;
+        return handle;
+    }
+
+    // 读取字符串索引并返回驻留句柄，每个表项只驻留一次
+    StringInterner::Handle handle(BinaryReader& reader) {
+        uint64_t id = 0;
+        if (!reader.readVarint(id) || id >= strings_.size()) {
+            failed_ = true;
+            return StringInterner::kInvalidHandle;
+        }
+        if (handles_.empty()) {
+            handles_.resize(strings_.size(), StringInterner::kInvalidHandle);
+        }
+        if (id != 0 && handles_[id] == StringInterner::kInvalidHandle) {
+            handles_[id] = StringInterner::getInstance().intern(strings_[id]);
+        }
+        return handles_[id];
+    }
+
+    bool failed() const { return failed_; }
+
+private:
+    std::vector<std::string_view> strings_;
+    std::vector<StringInterner::Handle> handles_;
+    mutable bool failed_{false};
+};
+
+} // namespace
+
+bool TaskScheduler::snapshot(const std::string& path) const {
+    // 锁内只复制结构（任务指针、状态、队列顺序、依赖与分配表、统计），编码与写盘在锁外进行，
+    // 调度线程与提交方只被阻塞一次内存复制的时间
+    struct TaskCapture {
+        TaskPtr task;
+        TaskStatus status;
+    };
+    std::vector<TaskCapture> tasks;
+    FlatHandleMap<uint32_t> positions;
+    std::vector<TaskPtr> queued;
+    std::vector<std::pair<Handle, size_t>> blocked;
+    std::vector<std::pair<Handle, std::vector<Handle>>> dependents;
+    std::vector<std::pair<Handle, Handle>> taskAgents;
+    Stats stats;
+
+    size_t queueMaxSize = taskQueue_.maxSize();
+    size_t maxConcurrent = maxConcurrentTasks_;
+
+    {
+        // 锁顺序与其余代码一致：statsMutex_ -> tasksMutex_ -> 队列锁
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
+        std::lock_guard<std::mutex> tasksLock(tasksMutex_);
+
+        // 任务在捕获数组中的下标即写入顺序，队列按句柄查出下标记录
+        stats = stats_;
+        tasks.reserve(allTasks_.size());
+        positions.reserve(allTasks_.size());
+        for (const auto& pair : allTasks_) {
+            positions.emplace(pair.first, static_cast<uint32_t>(tasks.size()));
+            tasks.push_back({pair.second, pair.second->getStatus()});
+        }
+        queued = taskQueue_.getTopTasks(taskQueue_.size());
+        blocked.reserve(blockedTasks_.size());
+        for (const auto& pair : blockedTasks_) {
+            blocked.push_back(pair);
+        }
+        dependents.reserve(dependents_.size());
+        for (const auto& pair : dependents_) {
+            dependents.push_back(pair);
+        }
+        taskAgents.reserve(taskAgentMap_.size());
+        for (const auto& pair : taskAgentMap_) {
+            taskAgents.push_back(pair);
+        }
+    }
+
+    std::string records;
+    BinaryWriter writer(records);
+    StringTableBuilder strings(tasks.size() * 2);
+
+    writer.writeVarint(tasks.size());
+    for (const auto& captured : tasks) {
+        const auto& task = captured.task;
+        const auto& config = task->getConfig();
+        const auto info = task->getExecutionInfo();
+
+        writer.writeVarint(strings.intern(task->getHandle(), task->getId()));
+        writer.writeVarint(strings.intern(config.name));
+        writer.writeVarint(strings.intern(config.description));
+        writer.writeU8(static_cast<uint8_t>(config.type));
+        writer.writeU8(static_cast<uint8_t>(config.priority));
+        writer.writeU8(static_cast<uint8_t>(captured.status));
+
+        writer.writeVarint(config.parameters.size());
+        for (const auto& param : config.parameters) {
+            writer.writeVarint(strings.intern(param.first));
+            writer.writeVarint(strings.intern(param.second));
+        }
+        writer.writeVarint(config.dependencies.size());
+        for (const auto& dep : config.dependencies) {
+            writer.writeVarint(strings.intern(dep));
+        }
+
+        writer.writeVarint(config.resourceRequirements.memoryMB);
+        writer.writeVarint(config.resourceRequirements.cpuCores);
+        writer.writeDouble(config.resourceRequirements.cpuUsage);
+        writer.writeVarint(strings.intern(config.assignedAgentId));
+        writer.writeVarint(config.timeoutSeconds);
+        writer.writeVarint(config.maxRetries);
+
+        writer.writeVarint(strings.intern(info.agentId));
+        writer.writeVarint(strings.intern(info.currentPhase));
+        writer.writeU64(static_cast<uint64_t>(toMillis(info.startTime)));
+        writer.writeU64(static_cast<uint64_t>(toMillis(info.endTime)));
+        writer.writeVarint(static_cast<uint64_t>(info.elapsedTime.count()));
+        writer.writeVarint(info.retryCount);
+        writer.writeDouble(info.progress);
+    }
+
+    // 队列按出队顺序记录任务下标
+    writer.writeVarint(queued.size());
+    for (const auto& task : queued) {
+        writer.writeVarint(*positions.find(task->getHandle()));
+    }
+
+    writer.writeVarint(blocked.size());
+    for (const auto& pair : blocked) {
+        writer.writeVarint(strings.intern(pair.first));
+        writer.writeVarint(pair.second);
+    }
+
+    writer.writeVarint(dependents.size());
+    for (const auto& pair : dependents) {
+        writer.writeVarint(strings.intern(pair.first));
+        writer.writeVarint(pair.second.size());
+        for (Handle dependent : pair.second) {
+            writer.writeVarint(strings.intern(dependent));
+        }
+    }
+
+    writer.writeVarint(taskAgents.size());
+    for (const auto& pair : taskAgents) {
+        writer.writeVarint(strings.intern(pair.first));
+        writer.writeVarint(strings.intern(pair.second));
+    }
+
+    writer.writeVarint(stats.totalScheduled);
+    writer.writeVarint(stats.totalCompleted);
+    writer.writeVarint(stats.totalFailed);
+    writer.writeVarint(stats.totalCancelled);
+    writer.writeDouble(stats.totalExecutionTimeMs);
+
+    std::string stringTable;
+    BinaryWriter tableWriter(stringTable);
+    strings.write(tableWriter);
+
+    std::string image;
+    image.reserve(stringTable.size() + records.size() + 64);
+    BinaryWriter header(image);
+    header.writeU32(kSnapshotMagic);
+    header.writeU32(kSnapshotVersion);
+    header.writeVarint(maxConcurrent);
+    header.writeVarint(queueMaxSize);
+    image.append(stringTable);
+    image.append(records);
+    header.writeU64(fnv1a(image.data(), image.size()));
+
+    // 先写临时文件并落盘，再原子替换并同步目录：崩溃时要么是旧快照，要么是完整的新快照
+    if (!writeFileDurably(path, image.data(), image.size())) {
+        Logger::getInstance().error("TaskScheduler", "Failed to write snapshot: " + path);
+        return false;
+    }
+
+    Logger::getInstance().info("TaskScheduler", "Snapshot written: " + path +
+                               " (" + std::to_string(image.size()) + " bytes)");
+    return true;
+}
+
+bool TaskScheduler::restore(const std::string& path) {
+    if (running_) {
+        Logger::getInstance().error("TaskScheduler", "Cannot restore while scheduler is running");
+        return false;
+    }
+
+    MappedFile file(path);
+    if (!file.data() || file.size() < 16) {
+        Logger::getInstance().error("TaskScheduler", "Failed to map snapshot: " + path);
+        return false;
+    }
+
+    size_t bodySize = file.size() - 8;
+    uint64_t expected = 0;
+    BinaryReader trailer(file.data() + bodySize, 8);
+    trailer.readU64(expected);
+    if (fnv1a(file.data(), bodySize) != expected) {
+        Logger::getInstance().error("TaskScheduler", "Snapshot checksum mismatch: " + path);
+        return false;
+    }
+
+    BinaryReader reader(file.data(), bodySize);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    reader.readU32(magic);
+    reader.readU32(version);
+    if (magic != kSnapshotMagic || version != kSnapshotVersion) {
+        Logger::getInstance().error("TaskScheduler", "Unsupported snapshot format: " + path);
+        return false;
+    }
+
+    uint64_t maxConcurrent = 0;
+    uint64_t queueMaxSize = 0;
+    reader.readVarint(maxConcurrent);
+    reader.readVarint(queueMaxSize);
+
+    StringTableReader strings;
+    if (!strings.read(reader)) {
+        Logger::getInstance().error("TaskScheduler", "Corrupted snapshot string table: " + path);
+        return false;
+    }
+
+    uint64_t taskCount = 0;
+    reader.readVarint(taskCount);
+    if (taskCount > reader.remaining()) {
+        Logger::getInstance().error("TaskScheduler", "Corrupted snapshot task table: " + path);
+        return false;
+    }
+
+    std::vector<TaskPtr> tasks;
+    tasks.reserve(taskCount);
+    std::vector<TaskPtr> interrupted;   // 快照时正在运行，恢复后重新排队
+
+    for (uint64_t i = 0; i < taskCount && reader.ok() && !strings.failed(); ++i) {
+        TaskConfig config;
+        uint8_t type = 0, priority = 0, status = 0;
+        uint64_t count = 0;
+
+        Handle handle = strings.acquire(reader, config.id);
+        strings.get(reader, config.name);
+        strings.get(reader, config.description);
+        reader.readU8(type);
+        reader.readU8(priority);
+        reader.readU8(status);
+        config.type = static_cast<TaskType>(type);
+        config.priority = static_cast<TaskPriority>(priority);
+
+        reader.readVarint(count);
+        for (uint64_t j = 0; j < count && reader.ok(); ++j) {
+            std::string key, value;
+            strings.get(reader, key);
+            strings.get(reader, value);
+            config.parameters.emplace(std::move(key), std::move(value));
+        }
+        reader.readVarint(count);
+        config.dependencies.resize(std::min<uint64_t>(count, reader.remaining()));
+        for (auto& dep : config.dependencies) {
+            strings.get(reader, dep);
+        }
+
+        uint64_t memoryMB = 0, cpuCores = 0, timeoutSeconds = 0, maxRetries = 0;
+        reader.readVarint(memoryMB);
+        reader.readVarint(cpuCores);
+        reader.readDouble(config.resourceRequirements.cpuUsage);
+        strings.get(reader, config.assignedAgentId);
+        reader.readVarint(timeoutSeconds);
+        reader.readVarint(maxRetries);
+        config.resourceRequirements.memoryMB = memoryMB;
+        config.resourceRequirements.cpuCores = cpuCores;
+        config.timeoutSeconds = timeoutSeconds;
+        config.maxRetries = maxRetries;
+
+        TaskExecutionInfo info;
+        uint64_t startMs = 0, endMs = 0, elapsedMs = 0, retryCount = 0;
+        info.taskId = config.id;
+        info.status = static_cast<TaskStatus>(status);
+        strings.get(reader, info.agentId);
+        strings.get(reader, info.currentPhase);
+        reader.readU64(startMs);
+        reader.readU64(endMs);
+        reader.readVarint(elapsedMs);
+        reader.readVarint(retryCount);
+        reader.readDouble(info.progress);
+        info.startTime = fromMillis(static_cast<int64_t>(startMs));
+        info.endTime = fromMillis(static_cast<int64_t>(endMs));
+        info.elapsedTime = std::chrono::milliseconds(elapsedMs);
+        info.retryCount = retryCount;
+
+        // 执行中的工作随进程一起丢失，任务回到待执行状态
+        bool wasRunning = info.status == TaskStatus::RUNNING;
+        if (wasRunning) {
+            info.status = TaskStatus::PENDING;
+        }
+
+        if (handle == StringInterner::kInvalidHandle) {
+            Logger::getInstance().error("TaskScheduler", "Cannot intern task id from snapshot: " + path);
+            return false;
+        }
+        auto task = std::make_shared<Task>(std::move(config), handle);
+        task->setExecutionInfo(std::move(info));
+        if (wasRunning) {
+            interrupted.push_back(task);
+        }
+        tasks.push_back(std::move(task));
+    }
+
+    bool corrupted = false;
+    std::vector<TaskPtr> queued;
+    uint64_t count = 0;
+    reader.readVarint(count);
+    queued.reserve(std::min<uint64_t>(count, tasks.size()) + interrupted.size());
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        uint64_t position = 0;
+        if (!reader.readVarint(position) || position >= tasks.size()) {
+            corrupted = true;
+            break;
+        }
+        queued.push_back(tasks[position]);
+    }
+    queued.insert(queued.end(), interrupted.begin(), interrupted.end());
+
+    FlatHandleMap<size_t> blocked;
+    reader.readVarint(count);
+    blocked.reserve(std::min<uint64_t>(count, reader.remaining()));
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        Handle task = strings.handle(reader);
+        uint64_t unmet = 0;
+        reader.readVarint(unmet);
+        blocked.emplace(task, unmet);
+    }
+
+    FlatHandleMap<std::vector<Handle>> dependents;
+    reader.readVarint(count);
+    dependents.reserve(std::min<uint64_t>(count, reader.remaining()));
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        Handle dep = strings.handle(reader);
+        uint64_t edges = 0;
+        reader.readVarint(edges);
+        std::vector<Handle> waiting(std::min<uint64_t>(edges, reader.remaining()));
+        for (auto& dependent : waiting) {
+            dependent = strings.handle(reader);
+        }
+        dependents.emplace(dep, std::move(waiting));
+    }
+
+    FlatHandleMap<Handle> assignments;
+    reader.readVarint(count);
+    assignments.reserve(std::min<uint64_t>(count, reader.remaining()));
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+        Handle task = strings.handle(reader);
+        Handle agent = strings.handle(reader);
+        assignments.emplace(task, agent);
+    }
+
+    Stats stats;
+    uint64_t scheduled = 0, completed = 0, failed = 0, cancelled = 0;
+    reader.readVarint(scheduled);
+    reader.readVarint(completed);
+    reader.readVarint(failed);
+    reader.readVarint(cancelled);
+    reader.readDouble(stats.totalExecutionTimeMs);
+    stats.totalScheduled = scheduled;
+    stats.totalCompleted = completed;
+    stats.totalFailed = failed;
+    stats.totalCancelled = cancelled;
+
+    if (corrupted || !reader.ok() || strings.failed() || reader.remaining() != 0) {
+        Logger::getInstance().error("TaskScheduler", "Corrupted snapshot: " + path);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
+        std::lock_guard<std::mutex> tasksLock(tasksMutex_);
+
+        if (!allTasks_.empty()) {
+            Logger::getInstance().error("TaskScheduler", "Cannot restore into a non-empty scheduler");
+            return false;
+        }
+
+        allTasks_.reserve(tasks.size());
+        for (auto& task : tasks) {
+            Handle handle = task->getHandle();
+            allTasks_.emplace(handle, std::move(task));
+        }
+        blockedTasks_ = std::move(blocked);
+        dependents_ = std::move(dependents);
+        taskAgentMap_ = std::move(assignments);
+        stats_ = stats;
+
+        maxConcurrentTasks_ = maxConcurrent;
+        taskQueue_.setMaxSize(queueMaxSize);
+        taskQueue_.assign(queued);
+    }
+
+    Logger::getInstance().info("TaskScheduler", "Restored " + std::to_string(taskCount) +
+                               " tasks from snapshot: " + path);
+    return true;
+}
+
+} // namespace openclaw
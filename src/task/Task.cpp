@@ -1,4 +1,6 @@
 #include "task/Task.h"
+#include "common/BinaryCodec.h"
+#include "common/TokenStream.h"
 #include <algorithm>
 
 namespace openclaw {
@@ -10,11 +12,98 @@ bool TaskConfig::validate() const {
     return true;
 }
 
-Task::Task(const TaskConfig& config) : config_(config) {
+void TaskConfig::serialize(BinaryWriter& writer) const {
+    writer.writeString(id);
+    writer.writeString(name);
+    writer.writeString(description);
+    writer.writeU8(static_cast<uint8_t>(type));
+    writer.writeU8(static_cast<uint8_t>(priority));
+    writer.writeVarint(parameters.size());
+    for (const auto& pair : parameters) {
+        writer.writeString(pair.first);
+        writer.writeString(pair.second);
+    }
+    writer.writeVarint(dependencies.size());
+    for (const auto& dep : dependencies) {
+        writer.writeString(dep);
+    }
+    writer.writeVarint(resourceRequirements.memoryMB);
+    writer.writeVarint(resourceRequirements.cpuCores);
+    writer.writeDouble(resourceRequirements.cpuUsage);
+    writer.writeString(assignedAgentId);
+    writer.writeVarint(timeoutSeconds);
+    writer.writeVarint(maxRetries);
+}
+
+bool TaskConfig::deserialize(BinaryReader& reader, TaskConfig& config) {
+    uint8_t type = 0;
+    uint8_t priority = 0;
+    uint64_t count = 0;
+    
+    reader.readString(config.id);
+    reader.readString(config.name);
+    reader.readString(config.description);
+    reader.readU8(type);
+    reader.readU8(priority);
+    config.type = static_cast<TaskType>(type);
+    config.priority = static_cast<TaskPriority>(priority);
+    
+    config.parameters.clear();
+    if (reader.readVarint(count)) {
+        for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+            std::string key, value;
+            reader.readString(key);
+            reader.readString(value);
+            config.parameters[key] = value;
+        }
+    }
+    
+    config.dependencies.clear();
+    if (reader.readVarint(count)) {
+        for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+            std::string dep;
+            reader.readString(dep);
+            config.dependencies.push_back(dep);
+        }
+    }
+    
+    uint64_t memoryMB = 0, cpuCores = 0, timeoutSeconds = 0, maxRetries = 0;
+    reader.readVarint(memoryMB);
+    reader.readVarint(cpuCores);
+    reader.readDouble(config.resourceRequirements.cpuUsage);
+    reader.readString(config.assignedAgentId);
+    reader.readVarint(timeoutSeconds);
+    reader.readVarint(maxRetries);
+    config.resourceRequirements.memoryMB = memoryMB;
+    config.resourceRequirements.cpuCores = cpuCores;
+    config.timeoutSeconds = timeoutSeconds;
+    config.maxRetries = maxRetries;
+    
+    return reader.ok();
+}
+
+Task::Task(const TaskConfig& config)
+    : config_(config), handle_(StringInterner::getInstance().acquire(config.id)) {
     executionInfo_.taskId = config.id;
     status_ = TaskStatus::PENDING;
 }
 
+Task::Task(TaskConfig&& config)
+    : config_(std::move(config)), handle_(StringInterner::getInstance().acquire(config_.id)) {
+    executionInfo_.taskId = config_.id;
+    status_ = TaskStatus::PENDING;
+}
+
+Task::Task(TaskConfig&& config, StringInterner::Handle handle)
+    : config_(std::move(config)), handle_(handle) {
+    executionInfo_.taskId = config_.id;
+    status_ = TaskStatus::PENDING;
+}
+
+Task::~Task() {
+    StringInterner::getInstance().release(handle_);
+}
+
 void Task::setStatus(TaskStatus status) {
     status_ = status;
     executionInfo_.status = status;
@@ -33,35 +122,88 @@ void Task::setPhase(const std::string& phase) {
     executionInfo_.currentPhase = phase;
 }
 
+void Task::setExecutionInfo(const TaskExecutionInfo& info) {
+    executionInfo_ = info;
+    status_ = info.status;
+}
+
+void Task::setExecutionInfo(TaskExecutionInfo&& info) {
+    status_ = info.status;
+    executionInfo_ = std::move(info);
+}
+
 void Task::markStarted() {
     setStatus(TaskStatus::RUNNING);
     executionInfo_.startTime = std::chrono::system_clock::now();
 }
 
-void Task::markCompleted(const TaskResult& /*result*/) {
+void Task::markCompleted(const TaskResult& result) {
     setStatus(TaskStatus::COMPLETED);
     executionInfo_.endTime = std::chrono::system_clock::now();
     executionInfo_.elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
         executionInfo_.endTime - executionInfo_.startTime);
     executionInfo_.progress = 100.0;
+    
+    auto text = result.output.find("text");
+    finishOutputStream(true, text != result.output.end() ? text->second : std::string(), std::string());
 }
 
-void Task::markFailed(const std::string& /*error*/) {
+void Task::markFailed(const std::string& error) {
     setStatus(TaskStatus::FAILED);
     executionInfo_.endTime = std::chrono::system_clock::now();
     executionInfo_.elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
         executionInfo_.endTime - executionInfo_.startTime);
     executionInfo_.retryCount++;
+    finishOutputStream(false, std::string(), error);
 }
 
 void Task::markCancelled() {
     setStatus(TaskStatus::CANCELLED);
     executionInfo_.endTime = std::chrono::system_clock::now();
+    finishOutputStream(false, std::string(), "Task cancelled");
 }
 
 void Task::markTimeout() {
     setStatus(TaskStatus::TIMEOUT);
     executionInfo_.endTime = std::chrono::system_clock::now();
+    finishOutputStream(false, std::string(), "Task timed out");
+}
+
+std::shared_ptr<TokenStream> Task::openOutputStream() {
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    // 状态在 finishOutputStream 取锁之前写入：这里要么看到结束状态，要么打开的流会被它结束
+    if (status_ == TaskStatus::COMPLETED || status_ == TaskStatus::FAILED ||
+        status_ == TaskStatus::CANCELLED || status_ == TaskStatus::TIMEOUT) {
+        return nullptr;
+    }
+    if (!outputStream_ || outputStream_->isFinished()) {
+        outputStream_ = TokenStream::create();
+    }
+    return outputStream_;
+}
+
+std::shared_ptr<TokenStream> Task::getOutputStream() const {
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    if (outputStream_ && !outputStream_->isFinished()) {
+        return outputStream_;
+    }
+    return nullptr;
+}
+
+void Task::finishOutputStream(bool success, const std::string& text, const std::string& error) {
+    std::shared_ptr<TokenStream> stream;
+    {
+        std::lock_guard<std::mutex> lock(outputMutex_);
+        stream.swap(outputStream_);
+    }
+    // 流式执行的智能体已自行结束流；否则在锁外补写完整输出，write 可能等待慢读者
+    if (!stream || stream->isFinished()) {
+        return;
+    }
+    if (success && !text.empty()) {
+        stream->write(text);
+    }
+    stream->finish(success, error);
 }
 
 bool Task::areDependenciesMet(const std::vector<std::string>& completedTasks) const {
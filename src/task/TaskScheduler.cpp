@@ -2,6 +2,7 @@
 #include "logging/Logger.h"
 #include "events/EventDispatcher.h"
 #include <chrono>
+#include <algorithm>
 
 namespace openclaw {
 
@@ -16,13 +17,15 @@ bool TaskQueue::push(TaskPtr task) {
         return false;
     }
     
-    if (taskMap_.find(task->getId()) != taskMap_.end()) {
+    if (taskMap_.contains(task->getHandle())) {
         Logger::getInstance().warning("TaskQueue", "Task already exists: " + task->getId());
         return false;
     }
     
-    queue_.push(task);
-    taskMap_[task->getId()] = task;
+    Entry entry{task, nextSeq_++};
+    heap_.push_back(entry);
+    std::push_heap(heap_.begin(), heap_.end(), EntryComparator());
+    taskMap_.emplace(task->getHandle(), std::move(entry));
     
     return true;
 }
@@ -30,61 +33,59 @@ bool TaskQueue::push(TaskPtr task) {
 TaskQueue::TaskPtr TaskQueue::pop() {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (queue_.empty()) {
-        return nullptr;
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), EntryComparator());
+        Entry entry = std::move(heap_.back());
+        heap_.pop_back();
+        
+        if (isLive(entry)) {
+            taskMap_.erase(entry.task->getHandle());
+            return entry.task;
+        }
     }
     
-    auto task = queue_.top();
-    queue_.pop();
-    taskMap_.erase(task->getId());
-    
-    return task;
+    return nullptr;
 }
 
 bool TaskQueue::remove(const std::string& taskId) {
+    return remove(StringInterner::getInstance().find(taskId));
+}
+
+bool TaskQueue::remove(StringInterner::Handle taskHandle) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = taskMap_.find(taskId);
-    if (it == taskMap_.end()) {
+    // 惰性删除：堆中的旧条目在 pop/遍历时跳过，必要时整体压缩
+    if (!taskMap_.erase(taskHandle)) {
         return false;
     }
-    
-    // 重建队列（不支持直接删除）
-    std::priority_queue<TaskPtr, std::vector<TaskPtr>, TaskPriorityComparator> newQueue;
-    while (!queue_.empty()) {
-        auto task = queue_.top();
-        queue_.pop();
-        if (task->getId() != taskId) {
-            newQueue.push(task);
-        }
-    }
-    queue_ = std::move(newQueue);
-    taskMap_.erase(it);
+    compactIfNeeded();
     
     return true;
 }
 
 bool TaskQueue::contains(const std::string& taskId) const {
+    StringInterner::Handle handle = StringInterner::getInstance().find(taskId);
     std::lock_guard<std::mutex> lock(mutex_);
-    return taskMap_.find(taskId) != taskMap_.end();
+    return taskMap_.contains(handle);
 }
 
 size_t TaskQueue::size() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
+    return taskMap_.size();
 }
 
 bool TaskQueue::empty() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.empty();
+    return taskMap_.empty();
 }
 
 std::vector<TaskQueue::TaskPtr> TaskQueue::getAllTasks() const {
     std::lock_guard<std::mutex> lock(mutex_);
     
     std::vector<TaskPtr> tasks;
+    tasks.reserve(taskMap_.size());
     for (const auto& pair : taskMap_) {
-        tasks.push_back(pair.second);
+        tasks.push_back(pair.second.task);
     }
     return tasks;
 }
@@ -92,48 +93,121 @@ std::vector<TaskQueue::TaskPtr> TaskQueue::getAllTasks() const {
 TaskQueue::TaskPtr TaskQueue::getHighestPriorityPendingTask() const {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (queue_.empty()) {
-        return nullptr;
+    // 按堆序遍历，返回第一个处于 PENDING 状态的任务
+    std::vector<size_t> frontier;
+    if (!heap_.empty()) {
+        frontier.push_back(0);
     }
+    auto cmp = [this](size_t a, size_t b) { return EntryComparator()(heap_[a], heap_[b]); };
     
-    for (const auto& pair : taskMap_) {
-        if (pair.second->getStatus() == TaskStatus::PENDING) {
-            return pair.second;
+    while (!frontier.empty()) {
+        std::pop_heap(frontier.begin(), frontier.end(), cmp);
+        size_t index = frontier.back();
+        frontier.pop_back();
+        
+        const auto& entry = heap_[index];
+        if (isLive(entry) && entry.task->getStatus() == TaskStatus::PENDING) {
+            return entry.task;
+        }
+        for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < heap_.size(); ++child) {
+            frontier.push_back(child);
+            std::push_heap(frontier.begin(), frontier.end(), cmp);
         }
     }
     
     return nullptr;
 }
 
-size_t TaskQueue::cleanupCompletedTasks() {
+std::vector<TaskQueue::TaskPtr> TaskQueue::getTopTasks(size_t limit) const {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    size_t count = 0;
-    std::vector<std::string> toRemove;
+    std::vector<TaskPtr> result;
+    if (limit == 0 || heap_.empty()) {
+        return result;
+    }
+    result.reserve(std::min(limit, taskMap_.size()));
     
-    for (const auto& pair : taskMap_) {
-        auto status = pair.second->getStatus();
-        if (status == TaskStatus::COMPLETED || 
-            status == TaskStatus::FAILED || 
-            status == TaskStatus::CANCELLED ||
-            status == TaskStatus::TIMEOUT) {
-            toRemove.push_back(pair.first);
-            count++;
+    // 以堆下标为元素的辅助堆：只展开被取出节点的子节点，复杂度 O(limit * log(limit))
+    std::vector<size_t> frontier{0};
+    auto cmp = [this](size_t a, size_t b) { return EntryComparator()(heap_[a], heap_[b]); };
+    
+    while (!frontier.empty() && result.size() < limit) {
+        std::pop_heap(frontier.begin(), frontier.end(), cmp);
+        size_t index = frontier.back();
+        frontier.pop_back();
+        
+        if (isLive(heap_[index])) {
+            result.push_back(heap_[index].task);
+        }
+        for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < heap_.size(); ++child) {
+            frontier.push_back(child);
+            std::push_heap(frontier.begin(), frontier.end(), cmp);
         }
     }
     
-    for (const auto& id : toRemove) {
-        taskMap_.erase(id);
+    return result;
+}
+
+size_t TaskQueue::cleanupCompletedTasks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    size_t count = taskMap_.eraseIf([](const std::pair<StringInterner::Handle, Entry>& pair) {
+        auto status = pair.second.task->getStatus();
+        return status == TaskStatus::COMPLETED || 
+               status == TaskStatus::FAILED || 
+               status == TaskStatus::CANCELLED ||
+               status == TaskStatus::TIMEOUT;
+    });
+    
+    rebuildHeap();
+    
+    return count;
+}
+
+void TaskQueue::assign(const std::vector<TaskPtr>& ordered) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    heap_.clear();
+    taskMap_.clear();
+    heap_.reserve(ordered.size());
+    taskMap_.reserve(ordered.size());
+    
+    // 序号按出队顺序递增，同优先级的先后关系得以保留
+    nextSeq_ = 0;
+    for (const auto& task : ordered) {
+        Entry entry{task, nextSeq_++};
+        if (taskMap_.emplace(task->getHandle(), entry).second) {
+            heap_.push_back(std::move(entry));
+        }
+    }
+    std::make_heap(heap_.begin(), heap_.end(), EntryComparator());
+}
+
+bool TaskQueue::isLive(const Entry& entry) const {
+    const Entry* live = taskMap_.find(entry.task->getHandle());
+    return live && live->seq == entry.seq;
+}
+
+void TaskQueue::compactIfNeeded() {
+    // 堆顶的旧条目立即弹出（派发的通常就是堆顶任务），避免遍历时反复跳过
+    while (!heap_.empty() && !isLive(heap_.front())) {
+        std::pop_heap(heap_.begin(), heap_.end(), EntryComparator());
+        heap_.pop_back();
     }
     
-    // 重建队列
-    std::priority_queue<TaskPtr, std::vector<TaskPtr>, TaskPriorityComparator> newQueue;
+    // 其余旧条目超过存活条目一倍时重建，均摊 O(log n)
+    if (heap_.size() > 2 * taskMap_.size() + 64) {
+        rebuildHeap();
+    }
+}
+
+void TaskQueue::rebuildHeap() {
+    heap_.clear();
+    heap_.reserve(taskMap_.size());
     for (const auto& pair : taskMap_) {
-        newQueue.push(pair.second);
+        heap_.push_back(pair.second);
     }
-    queue_ = std::move(newQueue);
-    
-    return count;
+    std::make_heap(heap_.begin(), heap_.end(), EntryComparator());
 }
 
 // DefaultExecutionStrategy 实现
@@ -141,15 +215,34 @@ std::vector<std::shared_ptr<Task>> DefaultExecutionStrategy::selectTasksToExecut
     const TaskQueue& queue,
     const std::vector<Agent::Ptr>& availableAgents) {
     
-    std::vector<std::shared_ptr<Task>> selectedTasks;
-    auto tasks = queue.getAllTasks();
+    // 在可用智能体数之外多看若干任务，组任务等待时供回填选择
+    static constexpr size_t kBackfillLookahead = 32;
     
-    for (const auto& task : tasks) {
-        if (task->getStatus() == TaskStatus::PENDING) {
-            selectedTasks.push_back(task);
-            if (selectedTasks.size() >= availableAgents.size()) {
+    // 当前凑不齐的组任务不计入窗口，否则排在前面的大批组任务会把低优先级任务一直挤在窗口外。
+    // 只有第一个这样的组任务需要交给调度器取得预留，其余的跳过；窗口不满时加倍重取，直到取空队列
+    const size_t want = availableAgents.size() + kBackfillLookahead;
+    std::vector<std::shared_ptr<Task>> selectedTasks;
+    for (size_t fetch = want; ; fetch *= 2) {
+        auto tasks = queue.getTopTasks(fetch);
+        selectedTasks.clear();
+        size_t counted = 0;
+        bool gangPassed = false;
+        for (const auto& task : tasks) {
+            if (task->getStatus() != TaskStatus::PENDING) {
+                continue;
+            }
+            if (TaskScheduler::gangWidth(task) > availableAgents.size()) {
+                if (gangPassed) {
+                    continue;
+                }
+                gangPassed = true;
+            } else if (++counted > want) {
                 break;
             }
+            selectedTasks.push_back(task);
+        }
+        if (counted >= want || tasks.size() < fetch) {
+            break;
         }
     }
     
@@ -157,7 +250,7 @@ std::vector<std::shared_ptr<Task>> DefaultExecutionStrategy::selectTasksToExecut
 }
 
 Agent::Ptr DefaultExecutionStrategy::selectAgentForTask(
-    const std::shared_ptr<Task>& task,
+    const std::shared_ptr<Task>& /*task*/,
     const std::vector<Agent::Ptr>& availableAgents) {
     
     if (availableAgents.empty()) {
@@ -172,9 +265,37 @@ Agent::Ptr DefaultExecutionStrategy::selectAgentForTask(
     return agent;
 }
 
+// ShortestQueueExecutionStrategy 实现
+Agent::Ptr ShortestQueueExecutionStrategy::selectAgentForTask(
+    const std::shared_ptr<Task>& /*task*/,
+    const std::vector<Agent::Ptr>& availableAgents) {
+    
+    if (availableAgents.empty()) {
+        return nullptr;
+    }
+    
+    // 从轮转起点开始扫描，积压相同的智能体之间均匀分配
+    size_t count = availableAgents.size();
+    size_t start = nextStart_++ % count;
+    Agent::Ptr best;
+    size_t bestDepth = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const auto& agent = availableAgents[(start + i) % count];
+        size_t depth = agent->getQueueDepth();
+        if (!best || depth < bestDepth) {
+            best = agent;
+            bestDepth = depth;
+            if (depth == 0) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
 // TaskScheduler 实现
 TaskScheduler::TaskScheduler(AgentManager& agentManager) 
-    : agentManager_(agentManager) {
+    : agentManager_(agentManager), clock_([] { return std::chrono::system_clock::now(); }) {
     executionStrategy_ = std::make_unique<DefaultExecutionStrategy>();
 }
 
@@ -195,22 +316,91 @@ void TaskScheduler::setExecutionStrategy(std::unique_ptr<ExecutionStrategy> stra
     executionStrategy_ = std::move(strategy);
 }
 
-void TaskScheduler::scheduleTask(const TaskConfig& config) {
+void TaskScheduler::setClock(Clock clock) {
+    clock_ = std::move(clock);
+}
+
+bool TaskScheduler::scheduleTask(const TaskConfig& config) {
     if (!config.validate()) {
         Logger::getInstance().error("TaskScheduler", "Invalid task config");
-        return;
+        return false;
     }
     
     auto task = std::make_shared<Task>(config);
+    const Handle handle = task->getHandle();
+    if (handle == StringInterner::kInvalidHandle) {
+        Logger::getInstance().error("TaskScheduler", "Cannot intern task id: " + config.id);
+        return false;
+    }
     
-    {
-        std::lock_guard<std::mutex> lock(tasksMutex_);
-        allTasks_[config.id] = task;
+    // 组任务比全部具备该能力的智能体还宽时永远凑不齐，只会一直占着预留
+    const size_t width = gangWidth(task);
+    if (width > 1) {
+        size_t capable = agentManager_.getRegisteredAgentCountForTaskType(config.type);
+        if (width > capable) {
+            Logger::getInstance().error("TaskScheduler",
+                "Task " + config.id + " needs " + std::to_string(width) +
+                " agents but only " + std::to_string(capable) + " can execute it");
+            return false;
+        }
     }
     
-    if (!taskQueue_.push(task)) {
-        Logger::getInstance().error("TaskScheduler", "Failed to queue task: " + config.id);
-        return;
+    // 依赖必须是已调度且尚未清理的任务：只能依赖先提交的任务，依赖图因此不会成环；
+    // 已被清理或从未调度的任务无从判断结果，等待它们会永远挂起
+    auto& interner = StringInterner::getInstance();
+    std::vector<Handle> dependencies;
+    dependencies.reserve(config.dependencies.size());
+    for (const auto& dep : config.dependencies) {
+        if (dep == config.id) {
+            Logger::getInstance().error("TaskScheduler", "Task depends on itself: " + config.id);
+            return false;
+        }
+        dependencies.push_back(interner.find(dep));
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        if (allTasks_.contains(handle)) {
+            Logger::getInstance().error("TaskScheduler", "Task already exists: " + config.id);
+            return false;
+        }
+        
+        // 只保留未完成的依赖；依赖已失败、取消或超时的任务直接拒绝
+        std::vector<Handle> unmet;
+        for (size_t i = 0; i < dependencies.size(); ++i) {
+            const TaskPtr* existing = allTasks_.find(dependencies[i]);
+            if (!existing) {
+                Logger::getInstance().error("TaskScheduler",
+                    "Task " + config.id + " depends on unknown task: " + config.dependencies[i]);
+                return false;
+            }
+            TaskStatus status = (*existing)->getStatus();
+            if (status == TaskStatus::COMPLETED) {
+                continue;
+            }
+            if (isTerminal(status)) {
+                Logger::getInstance().error("TaskScheduler",
+                    "Task " + config.id + " depends on a task that did not complete: " + config.dependencies[i]);
+                return false;
+            }
+            if (std::find(unmet.begin(), unmet.end(), dependencies[i]) == unmet.end()) {
+                unmet.push_back(dependencies[i]);
+            }
+        }
+        dependencies.swap(unmet);
+        
+        if (dependencies.empty() && !taskQueue_.push(task)) {
+            Logger::getInstance().error("TaskScheduler", "Failed to queue task: " + config.id);
+            return false;
+        }
+        
+        allTasks_.emplace(handle, task);
+        if (!dependencies.empty()) {
+            blockedTasks_[handle] = dependencies.size();
+            for (Handle dep : dependencies) {
+                dependents_[dep].push_back(handle);
+            }
+        }
     }
     
     {
@@ -223,6 +413,8 @@ void TaskScheduler::scheduleTask(const TaskConfig& config) {
     
     Logger::getInstance().info("TaskScheduler", 
         "Scheduled task: " + config.id + " (" + config.name + ")");
+    
+    return true;
 }
 
 bool TaskScheduler::cancelTask(const std::string& taskId) {
@@ -233,27 +425,39 @@ bool TaskScheduler::cancelTask(const std::string& taskId) {
     
     task->markCancelled();
     
-    std::lock_guard<std::mutex> lock(tasksMutex_);
-    runningTasks_.erase(taskId);
-    taskQueue_.remove(taskId);
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        runningTasks_.erase(task->getHandle());
+        blockedTasks_.erase(task->getHandle());
+        taskQueue_.remove(task->getHandle());
+    }
     
     {
         std::lock_guard<std::mutex> statsLock(statsMutex_);
         stats_.totalCancelled++;
     }
     
+    cancelDependents(task->getHandle());
+    
     Logger::getInstance().info("TaskScheduler", "Cancelled task: " + taskId);
     
     return true;
 }
 
 TaskScheduler::TaskPtr TaskScheduler::getTask(const std::string& taskId) {
+    Handle handle = StringInterner::getInstance().find(taskId);
     std::lock_guard<std::mutex> lock(tasksMutex_);
-    auto it = allTasks_.find(taskId);
-    if (it != allTasks_.end()) {
-        return it->second;
+    const TaskPtr* task = allTasks_.find(handle);
+    return task ? *task : nullptr;
+}
+
+TokenStream::Reader TaskScheduler::subscribeOutput(const std::string& taskId) {
+    auto task = getTask(taskId);
+    if (!task) {
+        return TokenStream::Reader();
     }
-    return nullptr;
+    auto stream = task->openOutputStream();
+    return stream ? stream->subscribe() : TokenStream::Reader();
 }
 
 TaskStatus TaskScheduler::getTaskStatus(const std::string& taskId) {
@@ -267,6 +471,7 @@ TaskStatus TaskScheduler::getTaskStatus(const std::string& taskId) {
 std::vector<TaskScheduler::TaskPtr> TaskScheduler::getAllTasks() const {
     std::lock_guard<std::mutex> lock(tasksMutex_);
     std::vector<TaskPtr> tasks;
+    tasks.reserve(allTasks_.size());
     for (const auto& pair : allTasks_) {
         tasks.push_back(pair.second);
     }
@@ -286,17 +491,39 @@ std::vector<TaskScheduler::TaskPtr> TaskScheduler::getTasksByStatus(TaskStatus s
 
 std::vector<TaskScheduler::TaskPtr> TaskScheduler::getTasksByAgent(const std::string& agentId) const {
     std::vector<TaskPtr> result;
-    std::lock_guard<std::mutex> lock(tasksMutex_);
+    Handle agentHandle = StringInterner::getInstance().find(agentId);
+    if (agentHandle == StringInterner::kInvalidHandle) {
+        return result;
+    }
     
-    for (const auto& pair : allTasks_) {
-        if (pair.second->getExecutionInfo().agentId == agentId) {
-            result.push_back(pair.second);
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    for (const auto& pair : taskAgentMap_) {
+        if (pair.second == agentHandle) {
+            const TaskPtr* task = allTasks_.find(pair.first);
+            if (task) {
+                result.push_back(*task);
+            }
         }
     }
     
     return result;
 }
 
+std::vector<std::string> TaskScheduler::getReservedAgents(const std::string& taskId) const {
+    auto& interner = StringInterner::getInstance();
+    Handle handle = interner.find(taskId);
+    
+    std::vector<std::string> agentIds;
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    const Reservation* reservation = reservations_.find(handle);
+    if (reservation) {
+        for (Handle agent : reservation->agents) {
+            agentIds.push_back(interner.resolve(agent));
+        }
+    }
+    return agentIds;
+}
+
 void TaskScheduler::start() {
     if (running_.exchange(true)) {
         return; // 已在运行
@@ -333,10 +560,68 @@ bool TaskScheduler::isRunning() const {
     return running_.load();
 }
 
+void TaskScheduler::runSchedulingRound() {
+    processSchedulingRound();
+}
+
+size_t TaskScheduler::cleanupFinishedTasks() {
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    
+    return allTasks_.eraseIf([this](const std::pair<Handle, TaskPtr>& pair) {
+        if (!isTerminal(pair.second->getStatus())) {
+            return false;
+        }
+        taskAgentMap_.erase(pair.first);
+        return true;
+    });
+}
+
+std::vector<TaskConfig> TaskScheduler::releaseReadyTasks(size_t maxTasks) {
+    std::vector<TaskConfig> released;
+    if (maxTasks == 0) {
+        return released;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        auto candidates = taskQueue_.getTopTasks(taskQueue_.size());
+        
+        // 从最低优先级一端开始取，本节点保留最紧急的任务
+        for (auto it = candidates.rbegin(); it != candidates.rend() && released.size() < maxTasks; ++it) {
+            const auto& task = *it;
+            const auto& config = task->getConfig();
+            if (task->getStatus() != TaskStatus::PENDING ||
+                gangWidth(task) > 1 ||
+                config.parameters.count("partitionKey") > 0 ||
+                dependents_.contains(task->getHandle())) {
+                continue;
+            }
+            
+            taskQueue_.remove(task->getHandle());
+            allTasks_.erase(task->getHandle());
+            released.push_back(config);
+            // 已入队说明依赖都已完成；接收方没有这些任务，带着依赖会被拒绝
+            released.back().dependencies.clear();
+        }
+    }
+    
+    if (!released.empty()) {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.totalScheduled -= std::min(stats_.totalScheduled, released.size());
+    }
+    
+    return released;
+}
+
+size_t TaskScheduler::getAvailableAgentCount() const {
+    FlatHandleMap<size_t> freeSlots;
+    return getAvailableAgents(freeSlots).size();
+}
+
 TaskScheduler::SchedulerStats TaskScheduler::getStats() const {
     std::lock_guard<std::mutex> lock(statsMutex_);
     
-    SchedulerStats stats;
+    SchedulerStats stats{};
     stats.totalTasksScheduled = stats_.totalScheduled;
     stats.totalTasksCompleted = stats_.totalCompleted;
     stats.totalTasksFailed = stats_.totalFailed;
@@ -385,54 +670,325 @@ void TaskScheduler::processSchedulingRound() {
         return;
     }
     
-    auto availableAgents = getAvailableAgents();
+    FlatHandleMap<size_t> freeSlots;
+    auto availableAgents = getAvailableAgents(freeSlots);
     if (availableAgents.empty()) {
         return;
     }
     
     auto selectedTasks = executionStrategy_->selectTasksToExecute(taskQueue_, availableAgents);
     
+    // 按任务类型取候选智能体。所有可接收任务的智能体都具备该能力时（常见情况）直接使用可用列表；
+    // 否则从能力索引取出该类型的智能体，与本轮仍空闲者求交。每种类型每轮只查一次索引
+    std::array<std::vector<Agent::Ptr>, kTaskTypeCount> restricted;
+    std::array<uint8_t, kTaskTypeCount> lookup{};   // 0 未查询，1 不受限，2 受限
+    std::vector<Handle> full;                       // 本轮已分配满的智能体
+    auto candidatesFor = [&](TaskType type) -> std::vector<Agent::Ptr>& {
+        size_t index = std::min(static_cast<size_t>(type), kTaskTypeCount - 1);
+        auto& candidates = restricted[index];
+        if (lookup[index] == 0) {
+            lookup[index] = agentManager_.allReadyAgentsCanExecute(type) ? 1 : 2;
+            if (lookup[index] == 2) {
+                // 按在可用列表中的位置排序，轮询等策略的行为不受索引内部顺序影响
+                FlatHandleMap<size_t> positions;
+                for (size_t i = 0; i < availableAgents.size(); ++i) {
+                    positions.emplace(availableAgents[i]->getHandle(), i);
+                }
+                std::vector<size_t> found;
+                agentManager_.forEachAgentForTaskType(type, [&](Agent& agent) {
+                    if (const size_t* position = positions.find(agent.getHandle())) {
+                        found.push_back(*position);
+                    }
+                });
+                std::sort(found.begin(), found.end());
+                candidates.reserve(found.size());
+                for (size_t position : found) {
+                    candidates.push_back(availableAgents[position]);
+                }
+            }
+        } else if (lookup[index] == 2) {
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                            [&full](const Agent::Ptr& a) {
+                                                return std::find(full.begin(), full.end(),
+                                                                 a->getHandle()) != full.end();
+                                            }),
+                             candidates.end());
+        }
+        return lookup[index] == 1 ? availableAgents : candidates;
+    };
+    
+    // 回填约束：第一个无法启动的组任务获得预留，此后的任务只有在
+    // 预计完成时间早于预留时刻、或只占用预留之外的富余智能体时才能启动
+    bool hasReservation = false;
+    std::chrono::system_clock::time_point shadowTime;
+    size_t extraAgents = 0;
+    
     for (auto& task : selectedTasks) {
-        if (!canScheduleMoreTasks()) {
+        if (!canScheduleMoreTasks() || availableAgents.empty()) {
             break;
         }
         
-        auto agent = executionStrategy_->selectAgentForTask(task, availableAgents);
+        auto& candidates = candidatesFor(task->getType());
+        const size_t width = gangWidth(task);
+        if (width > candidates.size()) {
+            if (!hasReservation) {
+                hasReservation = computeShadowTime(width, candidates.size(), shadowTime, extraAgents);
+            }
+            continue;
+        }
+        
+        if (hasReservation) {
+            auto expectedEnd = clock_() + std::chrono::seconds(task->getConfig().timeoutSeconds);
+            if (expectedEnd > shadowTime) {
+                if (width > extraAgents) {
+                    continue;
+                }
+                extraAgents -= width;
+            }
+        }
+        
+        auto agent = executionStrategy_->selectAgentForTask(task, candidates);
         if (!agent) {
             continue;
         }
         
-        executeTask(task, agent);
+        // 执行者之外的协作者按候选列表顺序补足，整组一次性预留
+        std::vector<Agent::Ptr> gang{agent};
+        for (const auto& candidate : candidates) {
+            if (gang.size() >= width) {
+                break;
+            }
+            if (candidate != agent) {
+                gang.push_back(candidate);
+            }
+        }
+        
+        // 智能体的空闲槽位用完后本轮不再分配
+        size_t filled = full.size();
+        for (const auto& member : gang) {
+            if (--*freeSlots.find(member->getHandle()) == 0) {
+                full.push_back(member->getHandle());
+            }
+        }
+        if (full.size() > filled) {
+            availableAgents.erase(std::remove_if(availableAgents.begin(), availableAgents.end(),
+                                                 [&full, filled](const Agent::Ptr& a) {
+                                                     return std::find(full.begin() + static_cast<long>(filled), full.end(),
+                                                                      a->getHandle()) != full.end();
+                                                 }),
+                                  availableAgents.end());
+        }
+        
+        executeTask(task, gang);
     }
 }
 
-void TaskScheduler::executeTask(TaskPtr task, Agent::Ptr agent) {
-    task->markStarted();
+void TaskScheduler::executeTask(TaskPtr task, const std::vector<Agent::Ptr>& agents) {
+    const auto& agent = agents.front();
     
     {
+        // 预留在同一临界区内完成：要么整组成功，要么一个都不占用
         std::lock_guard<std::mutex> lock(tasksMutex_);
-        runningTasks_.insert(task->getId());
-        taskAgentMap_[task->getId()] = agent->getId();
+        for (const auto& member : agents) {
+            const size_t* load = agentLoad_.find(member->getHandle());
+            if (load && *load >= member->getConcurrency()) {
+                return;
+            }
+        }
+        if (!taskQueue_.remove(task->getHandle())) {
+            return;
+        }
+        
+        Reservation reservation;
+        reservation.expectedEnd = clock_() + std::chrono::seconds(task->getConfig().timeoutSeconds);
+        for (const auto& member : agents) {
+            agentLoad_[member->getHandle()]++;
+            reservation.agents.push_back(member->getHandle());
+        }
+        reservations_[task->getHandle()] = std::move(reservation);
+        runningTasks_.insert(task->getHandle());
+        taskAgentMap_[task->getHandle()] = agent->getHandle();
     }
     
+    task->setAssignedAgent(agent->getId());
+    task->markStarted();
+    
     if (taskStartedCallback_) {
         taskStartedCallback_(task);
     }
     
-    // 简化实现：这里应该是异步执行任务
-    // 实际实现应该启动线程或使用线程池
-    task->markCompleted(TaskResult());
+    // 智能体可以同步完成，也可以稍后在其他线程中回调
+    agent->submitTask(task, [this, task](std::shared_ptr<TaskResult> result) {
+        onTaskFinished(task, result);
+    });
+}
+
+void TaskScheduler::onTaskFinished(const TaskPtr& task, const std::shared_ptr<TaskResult>& result) {
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        runningTasks_.erase(task->getHandle());
+        const Reservation* reservation = reservations_.find(task->getHandle());
+        if (reservation) {
+            for (Handle agent : reservation->agents) {
+                size_t* load = agentLoad_.find(agent);
+                if (load && --*load == 0) {
+                    agentLoad_.erase(agent);
+                }
+            }
+            reservations_.erase(task->getHandle());
+        }
+    }
+    
+    // 任务在执行期间被取消
+    if (task->getStatus() == TaskStatus::CANCELLED) {
+        return;
+    }
+    
+    if (result && result->success) {
+        task->markCompleted(*result);
+        updateStats(task, true);
+        
+        EventDispatcher::getInstance().dispatchEvent(EventType::TASK_COMPLETED);
+        if (taskCompletedCallback_) {
+            taskCompletedCallback_(task);
+        }
+        
+        releaseDependents(task->getHandle());
+        return;
+    }
+    
+    task->markFailed(result ? result->errorMessage : "No result returned");
+    
+    // 未超过重试次数则重新排队
+    if (task->getExecutionInfo().retryCount <= task->getConfig().maxRetries) {
+        task->setStatus(TaskStatus::PENDING);
+        if (taskQueue_.push(task)) {
+            Logger::getInstance().debug("TaskScheduler", "Retrying task: " + task->getId());
+            return;
+        }
+        task->setStatus(TaskStatus::FAILED);
+    }
+    
+    updateStats(task, false);
+    
+    EventDispatcher::getInstance().dispatchEvent(EventType::TASK_FAILED);
+    if (taskFailedCallback_) {
+        taskFailedCallback_(task);
+    }
+    
+    cancelDependents(task->getHandle());
+}
+
+void TaskScheduler::releaseDependents(Handle taskHandle) {
+    std::vector<TaskPtr> ready;
     
     {
         std::lock_guard<std::mutex> lock(tasksMutex_);
-        runningTasks_.erase(task->getId());
+        const std::vector<Handle>* waiting = dependents_.find(taskHandle);
+        if (!waiting) {
+            return;
+        }
+        
+        for (Handle dependent : *waiting) {
+            size_t* unmet = blockedTasks_.find(dependent);
+            if (!unmet) {
+                continue;
+            }
+            if (--*unmet == 0) {
+                blockedTasks_.erase(dependent);
+                const TaskPtr* task = allTasks_.find(dependent);
+                if (task) {
+                    ready.push_back(*task);
+                }
+            }
+        }
+        dependents_.erase(taskHandle);
     }
     
-    updateStats(task, true);
+    for (const auto& task : ready) {
+        if (!taskQueue_.push(task)) {
+            Logger::getInstance().error("TaskScheduler", "Failed to queue task: " + task->getId());
+            task->markFailed("Task queue is full");
+            updateStats(task, false);
+            cancelDependents(task->getHandle());
+        }
+    }
+}
+
+void TaskScheduler::cancelDependents(Handle taskHandle) {
+    std::vector<Handle> pending{taskHandle};
+    size_t cancelled = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        while (!pending.empty()) {
+            Handle current = pending.back();
+            pending.pop_back();
+            
+            const std::vector<Handle>* waiting = dependents_.find(current);
+            if (!waiting) {
+                continue;
+            }
+            
+            for (Handle dependent : *waiting) {
+                if (!blockedTasks_.erase(dependent)) {
+                    continue;
+                }
+                const TaskPtr* task = allTasks_.find(dependent);
+                if (task) {
+                    (*task)->markCancelled();
+                }
+                pending.push_back(dependent);
+                cancelled++;
+            }
+            dependents_.erase(current);
+        }
+    }
+    
+    // 先释放 tasksMutex_，与 getStats 的加锁顺序保持一致
+    if (cancelled > 0) {
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
+        stats_.totalCancelled += cancelled;
+    }
+}
+
+bool TaskScheduler::isTerminal(TaskStatus status) {
+    return status == TaskStatus::COMPLETED ||
+           status == TaskStatus::FAILED ||
+           status == TaskStatus::CANCELLED ||
+           status == TaskStatus::TIMEOUT;
+}
+
+size_t TaskScheduler::gangWidth(const TaskPtr& task) {
+    return std::max<size_t>(1, task->getConfig().resourceRequirements.cpuCores);
+}
+
+bool TaskScheduler::computeShadowTime(size_t width, size_t freeAgents,
+                                      std::chrono::system_clock::time_point& shadowTime,
+                                      size_t& extraAgents) const {
+    std::vector<std::pair<std::chrono::system_clock::time_point, size_t>> releases;
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        releases.reserve(reservations_.size());
+        for (const auto& pair : reservations_) {
+            releases.emplace_back(pair.second.expectedEnd, pair.second.agents.size());
+        }
+    }
+    std::sort(releases.begin(), releases.end());
     
-    if (taskCompletedCallback_) {
-        taskCompletedCallback_(task);
+    // 按预计结束时间累加释放的智能体，直到足够启动该组任务
+    size_t projected = freeAgents;
+    for (const auto& release : releases) {
+        projected += release.second;
+        if (projected >= width) {
+            shadowTime = release.first;
+            extraAgents = projected - width;
+            return true;
+        }
     }
+    
+    // 即使全部运行任务结束也凑不齐，不设预留以免阻塞其他任务
+    return false;
 }
 
 bool TaskScheduler::canScheduleMoreTasks() const {
@@ -440,9 +996,23 @@ bool TaskScheduler::canScheduleMoreTasks() const {
     return runningTasks_.size() < maxConcurrentTasks_;
 }
 
-std::vector<Agent::Ptr> TaskScheduler::getAvailableAgents() const {
+std::vector<Agent::Ptr> TaskScheduler::getAvailableAgents(FlatHandleMap<size_t>& freeSlots) const {
     std::vector<Agent::Ptr> agents;
-    // 简化实现：获取所有运行中的智能体
+    
+    // 只遍历运行与休眠状态桶（休眠的智能体收到任务时自动恢复），排除执行中的任务已占满
+    // 并发数的智能体；实测资源超限的智能体暂不派发，利用率回落后自动恢复
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    auto collect = [&](Agent& agent) {
+        const size_t* load = agentLoad_.find(agent.getHandle());
+        size_t concurrency = agent.getConcurrency();
+        size_t used = load ? *load : 0;
+        if (used < concurrency && !agent.exceedsResourceLimits()) {
+            agents.push_back(agent.shared_from_this());
+            freeSlots.emplace(agent.getHandle(), concurrency - used);
+        }
+    };
+    agentManager_.forEachAgentWithStatus(AgentStatus::RUNNING, collect);
+    agentManager_.forEachAgentWithStatus(AgentStatus::HIBERNATED, collect);
     return agents;
 }
 
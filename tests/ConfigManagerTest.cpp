@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include "config/ConfigManager.h"
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
 
 using namespace openclaw;
 
@@ -126,4 +131,117 @@ TEST(ConfigManagerTest, IniFileParsing) {
     EXPECT_EQ(config.getString("log_level"), "INFO");
     EXPECT_EQ(config.getInt("max_log_size"), 10);
     EXPECT_TRUE(config.getBool("debug_mode"));
-}
\ No newline at end of file
+}
+
+// 测试从文件重新加载：修改文件后 reloadConfig 读到新值
+TEST(ConfigManagerTest, ReloadFromFile) {
+    ConfigManager& config = ConfigManager::getInstance();
+    std::string path = ::testing::TempDir() + "openclaw-reload-test.json";
+    {
+        std::ofstream file(path);
+        file << "{\n  \"reload_key\": \"first\"\n}\n";
+    }
+    ASSERT_TRUE(config.loadConfig(path));
+    EXPECT_EQ(config.getString("reload_key"), "first");
+
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "{\n  \"reload_key\": \"second\"\n}\n";
+    }
+    ASSERT_TRUE(config.reloadConfig());
+    EXPECT_EQ(config.getString("reload_key"), "second");
+
+    config.clear();
+    std::remove(path.c_str());
+}
+
+// 测试 JSON 解析：成员之间的逗号不属于值
+TEST(ConfigManagerTest, JsonMembersDropSeparatingComma) {
+    ConfigManager& config = ConfigManager::getInstance();
+    std::string path = ::testing::TempDir() + "openclaw-json-comma-test.json";
+    {
+        std::ofstream file(path);
+        file << "{\n  \"first\": \"a, b\",\n  \"second\": 42,\n  \"third\": \"last\"\n}\n";
+    }
+    ASSERT_TRUE(config.loadConfig(path));
+    EXPECT_EQ(config.getString("first"), "a, b");
+    EXPECT_EQ(config.getInt("second"), 42);
+    EXPECT_EQ(config.getString("third"), "last");
+
+    config.clear();
+    std::remove(path.c_str());
+}
+
+// 测试注销监听器：等待其他线程上进行中的调用结束后才返回
+TEST(ConfigManagerTest, RemoveListenerWaitsForRunningCallback) {
+    ConfigManager& config = ConfigManager::getInstance();
+    std::string path = ::testing::TempDir() + "openclaw-listener-test.json";
+    {
+        std::ofstream file(path);
+        file << "{\n  \"listener_key\": \"value\"\n}\n";
+    }
+    ASSERT_TRUE(config.loadConfig(path));
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    size_t id = config.addReloadListener([&entered, &finished] {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+    std::thread reloader([&config] { config.reloadConfig(); });
+    while (!entered) {
+        std::this_thread::yield();
+    }
+    config.removeReloadListener(id);
+    EXPECT_TRUE(finished.load());
+    reloader.join();
+
+    // 监听器注销自身不会死锁
+    size_t selfId = 0;
+    int calls = 0;
+    selfId = config.addReloadListener([&config, &selfId, &calls] {
+        calls++;
+        config.removeReloadListener(selfId);
+    });
+    ASSERT_TRUE(config.reloadConfig());
+    ASSERT_TRUE(config.reloadConfig());
+    EXPECT_EQ(calls, 1);
+
+    config.clear();
+    std::remove(path.c_str());
+}
+
+// 测试重新加载监听：开启不重复登记，关闭与销毁后不再回调
+TEST(ConfigManagerTest, ReloadWatchStartsOnceAndStopsOnDestruction) {
+    ConfigManager& config = ConfigManager::getInstance();
+    std::string path = ::testing::TempDir() + "openclaw-watch-test.json";
+    {
+        std::ofstream file(path);
+        file << "{\n  \"watch_key\": \"value\"\n}\n";
+    }
+    ASSERT_TRUE(config.loadConfig(path));
+
+    int calls = 0;
+    {
+        ConfigReloadWatch watch([&calls] { calls++; });
+        EXPECT_FALSE(watch.isWatching());
+        watch.start();
+        watch.start();
+        EXPECT_TRUE(watch.isWatching());
+        ASSERT_TRUE(config.reloadConfig());
+        EXPECT_EQ(calls, 1);
+
+        watch.stop();
+        EXPECT_FALSE(watch.isWatching());
+        ASSERT_TRUE(config.reloadConfig());
+        EXPECT_EQ(calls, 1);
+
+        watch.start();
+    }
+    ASSERT_TRUE(config.reloadConfig());
+    EXPECT_EQ(calls, 1);
+
+    config.clear();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,9 @@
+#include <gtest/gtest.h>
+#include "agent/RemoteAgent.h"
+
+int main(int argc, char** argv) {
+    // 测试程序同时是 RemoteAgent 子进程的宿主：被重新执行时直接进入服务循环，不运行测试
+    openclaw::RemoteAgent::serveIfHost();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
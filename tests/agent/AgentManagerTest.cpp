@@ -0,0 +1,891 @@
+#include <gtest/gtest.h>
+#include "agent/AgentManager.h"
+#include "agent/LazyAgent.h"
+#include "common/EpochManager.h"
+#include "task/Task.h"
+#include "logging/Logger.h"
+#include "../support/TestAgent.h"
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace openclaw;
+
+namespace {
+
+// 测试用邮箱智能体：记录执行线程，可阻塞执行以观察积压
+class MailboxTestAgent : public TestAgent {
+public:
+    using TestAgent::TestAgent;
+    ~MailboxTestAgent() override { shutdownMailbox(); }
+
+    std::shared_ptr<TaskResult> executeTask(const Task& /*task*/) override {
+        while (blocked) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        return std::make_shared<TaskResult>(true);
+    }
+
+    std::atomic<bool> blocked{false};
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+};
+
+AgentConfig makeAgent(const std::string& id) {
+    AgentConfig config;
+    config.id = id;
+    config.name = id;
+    config.type = AgentType::ARCHITECT;
+    return config;
+}
+
+class AgentManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().setConsoleOutputEnabled(false);
+        AgentFactory::getInstance().registerAgent(AgentType::ARCHITECT,
+            [](const AgentConfig& config) { return std::make_shared<TestAgent>(config); });
+    }
+};
+
+} // namespace
+
+// 测试读临界区内退休的对象要等读者离开后才回收
+TEST(EpochManagerTest, DefersReclaimUntilReadersLeave) {
+    auto& epochs = EpochManager::getInstance();
+    epochs.synchronize();
+
+    std::atomic<bool> freed{false};
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+
+    std::thread reader([&] {
+        EpochManager::Guard guard;
+        entered = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!entered) {
+        std::this_thread::yield();
+    }
+
+    epochs.retire([&freed] { freed = true; });
+    epochs.reclaim();
+    EXPECT_FALSE(freed);
+
+    release = true;
+    reader.join();
+    epochs.synchronize();
+    EXPECT_TRUE(freed);
+}
+
+// 测试注册表的增删查询
+TEST_F(AgentManagerTest, RegistryReflectsCreateAndDelete) {
+    AgentManager manager;
+    ASSERT_NE(manager.createAgent(makeAgent("registry-a")), nullptr);
+    ASSERT_NE(manager.createAgent(makeAgent("registry-b")), nullptr);
+    EXPECT_EQ(manager.createAgent(makeAgent("registry-a")), nullptr);
+
+    EXPECT_EQ(manager.getAgentCount(), 2u);
+    EXPECT_TRUE(manager.withAgent("registry-b", [](const Agent::Ptr& agent) {
+        EXPECT_EQ(agent->getId(), "registry-b");
+    }));
+
+    manager.getAgent("registry-a")->start();
+    EXPECT_EQ(manager.getAgentCountByStatus(AgentStatus::RUNNING), 1u);
+    EXPECT_EQ(manager.getAgentStatusDistribution()[AgentStatus::STOPPED], 1u);
+
+    EXPECT_TRUE(manager.deleteAgent("registry-b"));
+    EXPECT_EQ(manager.getAgent("registry-b"), nullptr);
+    EXPECT_EQ(manager.listAgents().size(), 1u);
+
+    manager.getAgent("registry-a")->stop();
+    EXPECT_EQ(manager.cleanupStoppedAgents(), 1u);
+    EXPECT_EQ(manager.getAgentCount(), 0u);
+}
+
+// 测试增量层多次合并后查询与遍历顺序仍与逐个增删一致
+TEST_F(AgentManagerTest, RegistryKeepsCreationOrderAcrossCompaction) {
+    AgentManager manager;
+    std::vector<std::string> expected;
+    std::vector<std::string> deleted;
+    for (int i = 0; i < 2000; ++i) {
+        std::string id = "order-" + std::to_string(i);
+        ASSERT_NE(manager.createAgent(makeAgent(id)), nullptr);
+        expected.push_back(id);
+        // 每隔几个删除一个较早的智能体，其中一部分随后以同一 ID 重新创建
+        if (i % 3 == 2) {
+            std::string victim = expected[expected.size() / 2];
+            ASSERT_TRUE(manager.deleteAgent(victim));
+            expected.erase(expected.begin() + static_cast<long>(expected.size() / 2));
+            if (i % 9 == 2) {
+                ASSERT_NE(manager.createAgent(makeAgent(victim)), nullptr);
+                expected.push_back(victim);
+            } else {
+                deleted.push_back(victim);
+            }
+        }
+    }
+
+    EXPECT_EQ(manager.getAgentCount(), expected.size());
+    std::vector<std::string> listed;
+    for (const auto& agent : manager.listAgents()) {
+        listed.push_back(agent->getId());
+    }
+    EXPECT_EQ(listed, expected);
+    for (const auto& id : expected) {
+        EXPECT_NE(manager.getAgent(id), nullptr);
+    }
+    for (const auto& id : deleted) {
+        EXPECT_EQ(manager.getAgent(id), nullptr);
+    }
+}
+
+// 测试读者与写者并发：读者始终看到完整一致的快照
+TEST_F(AgentManagerTest, ConcurrentReadersSeeConsistentSnapshots) {
+    AgentManager manager;
+    for (int i = 0; i < 8; ++i) {
+        manager.createAgent(makeAgent("stable-" + std::to_string(i)));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> inconsistencies{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            while (!stop) {
+                size_t stable = 0;
+                manager.forEachAgent([&stable](const Agent::Ptr& agent) {
+                    if (agent->getId().rfind("stable-", 0) == 0) {
+                        stable++;
+                    }
+                });
+                if (stable != 8 || !manager.getAgent("stable-3")) {
+                    inconsistencies++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 500; ++i) {
+        std::string id = "churn-" + std::to_string(i);
+        manager.createAgent(makeAgent(id));
+        manager.deleteAgent(id);
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(inconsistencies, 0u);
+    EXPECT_EQ(manager.getAgentCount(), 8u);
+    EpochManager::getInstance().synchronize();
+    EXPECT_EQ(EpochManager::getInstance().pendingCount(), 0u);
+}
+
+// 测试状态变更经由管理器维护计数、分桶并触发回调
+TEST_F(AgentManagerTest, StatusTransitionsUpdateCountersAndBuckets) {
+    AgentManager manager;
+    std::vector<std::pair<std::string, AgentStatus>> changes;
+    manager.setStatusCallback([&changes](const std::string& id, AgentStatus status) {
+        changes.emplace_back(id, status);
+    });
+
+    for (int i = 0; i < 4; ++i) {
+        manager.createAgent(makeAgent("bucket-" + std::to_string(i)));
+    }
+    EXPECT_EQ(manager.getAgentCountByStatus(AgentStatus::STOPPED), 4u);
+
+    manager.getAgent("bucket-0")->start();
+    manager.getAgent("bucket-1")->start();
+    manager.getAgent("bucket-1")->pause();
+    manager.getAgent("bucket-2")->stop();   // 状态未变化，不通知
+
+    auto distribution = manager.getAgentStatusDistribution();
+    EXPECT_EQ(distribution[AgentStatus::RUNNING], 1u);
+    EXPECT_EQ(distribution[AgentStatus::PAUSED], 1u);
+    EXPECT_EQ(distribution[AgentStatus::STOPPED], 2u);
+
+    auto running = manager.listAgentsByStatus(AgentStatus::RUNNING);
+    ASSERT_EQ(running.size(), 1u);
+    EXPECT_EQ(running[0]->getId(), "bucket-0");
+    EXPECT_EQ(manager.listAgentsByStatus(AgentStatus::STOPPED).size(), 2u);
+
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(changes[2], std::make_pair(std::string("bucket-1"), AgentStatus::PAUSED));
+
+    // 删除后的智能体不再计入，也不再触发回调
+    auto removed = manager.getAgent("bucket-0");
+    EXPECT_TRUE(manager.deleteAgent("bucket-0"));
+    EXPECT_EQ(manager.getAgentCountByStatus(AgentStatus::RUNNING), 0u);
+    size_t before = changes.size();
+    removed->start();
+    EXPECT_EQ(changes.size(), before);
+    EXPECT_EQ(manager.getAgentCountByStatus(AgentStatus::RUNNING), 0u);
+}
+
+// 测试执行任务期间心跳超时在一个超时周期内被检测到，任务完成后恢复健康；空闲智能体不因没有心跳被判定
+TEST_F(AgentManagerTest, MonitorDetectsMissedHeartbeat) {
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<MailboxTestAgent>(config); });
+    AgentManager manager;
+    AgentConfig config = makeAgent("heartbeat-a");
+    config.type = AgentType::DEVELOPER;
+    config.useMailbox = true;
+    auto agent = std::static_pointer_cast<MailboxTestAgent>(manager.createAgent(config));
+    auto idle = manager.createAgent(makeAgent("heartbeat-idle"));
+    agent->start();
+    idle->start();
+
+    AgentMonitor monitor(manager);
+    monitor.setHeartbeatTimeout(std::chrono::milliseconds(200));
+    monitor.startMonitoring(60);
+
+    TaskConfig taskConfig;
+    taskConfig.id = "heartbeat-task";
+    taskConfig.name = "heartbeat-task";
+    taskConfig.type = TaskType::DEVELOPMENT;
+    EXPECT_TRUE(idle->executeTask(Task(taskConfig))->success);
+    std::atomic<bool> done{false};
+    idle->submitTask(std::make_shared<Task>(taskConfig), [&done](std::shared_ptr<TaskResult>) { done = true; });
+    EXPECT_TRUE(done);
+
+    // 任务阻塞期间由执行方持续心跳，保持健康
+    agent->blocked = true;
+    std::atomic<bool> finished{false};
+    agent->submitTask(std::make_shared<Task>(taskConfig),
+                      [&finished](std::shared_ptr<TaskResult>) { finished = true; });
+    for (int i = 0; i < 10; ++i) {
+        agent->heartbeat();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_TRUE(agent->isHealthy());
+    EXPECT_EQ(monitor.getStats().missedHeartbeats, 0u);
+
+    // 停止心跳后很快被判定为不健康
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (agent->isHealthy() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_FALSE(agent->isHealthy());
+    EXPECT_EQ(monitor.getStats().missedHeartbeats, 1u);
+    EXPECT_EQ(manager.getUnhealthyAgents(), std::vector<std::string>{"heartbeat-a"});
+
+    // 任务完成时的心跳恢复健康；之后空闲不再被判定
+    agent->blocked = false;
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!finished && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(finished);
+    EXPECT_TRUE(agent->isHealthy());
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_TRUE(agent->isHealthy());
+    EXPECT_TRUE(idle->isHealthy());
+    EXPECT_EQ(monitor.getStats().missedHeartbeats, 1u);
+    monitor.stopMonitoring();
+}
+
+// 测试长超时下停止监控也能立即返回
+TEST_F(AgentManagerTest, StopMonitoringIsImmediate) {
+    AgentManager manager;
+    auto agent = manager.createAgent(makeAgent("heartbeat-b"));
+    agent->start();
+    agent->heartbeat();
+
+    AgentMonitor monitor(manager);
+    monitor.startMonitoring(60);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto start = std::chrono::steady_clock::now();
+    monitor.stopMonitoring();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_FALSE(monitor.isMonitoring());
+}
+
+// 测试邮箱：多生产者非阻塞投递，专属线程执行，并导出积压深度
+TEST_F(AgentManagerTest, MailboxRunsTasksOnDedicatedThreads) {
+    AgentConfig config = makeAgent("mailbox-a");
+    config.useMailbox = true;
+    config.resourceLimits.maxThreads = 2;
+    auto agent = std::make_shared<MailboxTestAgent>(config);
+    agent->blocked = true;
+
+    TaskConfig taskConfig;
+    taskConfig.id = "mailbox-task";
+    taskConfig.name = "mailbox-task";
+    taskConfig.type = TaskType::DEVELOPMENT;
+    auto task = std::make_shared<Task>(taskConfig);
+
+    std::atomic<size_t> completed{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([&] {
+            for (int i = 0; i < 50; ++i) {
+                agent->submitTask(task, [&completed](std::shared_ptr<TaskResult> result) {
+                    if (result && result->success) {
+                        completed++;
+                    }
+                });
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    // 执行被阻塞时投递仍立即返回，积压可见
+    EXPECT_EQ(agent->getQueueDepth(), 200u);
+    agent->blocked = false;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (completed < 200 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(completed, 200u);
+    EXPECT_EQ(agent->getQueueDepth(), 0u);
+    EXPECT_LE(agent->threads.size(), 2u);
+    EXPECT_EQ(agent->threads.count(std::this_thread::get_id()), 0u);
+
+    // 关闭后投递被拒绝，任务以失败结果回调
+    agent->shutdownMailbox();
+    EXPECT_FALSE(agent->post([] {}));
+    bool failed = false;
+    agent->submitTask(task, [&failed](std::shared_ptr<TaskResult> result) {
+        failed = result && !result->success;
+    });
+    EXPECT_TRUE(failed);
+}
+
+// 测试排队的任务持有智能体：调用方释放最后的引用后任务仍会执行，智能体在执行线程上析构
+TEST_F(AgentManagerTest, MailboxKeepsAgentAliveForQueuedTasks) {
+    AgentConfig config = makeAgent("mailbox-owner");
+    config.useMailbox = true;
+    auto agent = std::make_shared<MailboxTestAgent>(config);
+    agent->blocked = true;
+    std::weak_ptr<MailboxTestAgent> weak = agent;
+
+    TaskConfig taskConfig;
+    taskConfig.id = "mailbox-orphan";
+    taskConfig.name = "mailbox-orphan";
+    taskConfig.type = TaskType::DEVELOPMENT;
+    std::atomic<bool> done{false};
+    agent->submitTask(std::make_shared<Task>(taskConfig), [&done](std::shared_ptr<TaskResult> result) {
+        done = result && result->success;
+    });
+
+    MailboxTestAgent* raw = agent.get();
+    agent.reset();
+    EXPECT_FALSE(weak.expired());
+    raw->blocked = false;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((!done || !weak.expired()) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(done);
+    EXPECT_TRUE(weak.expired());
+}
+
+// 测试删除智能体时在锁外回收邮箱：积压任务未处理完之前，其他智能体的创建不被阻塞
+TEST_F(AgentManagerTest, DeleteDrainsMailboxOutsideRegistryLock) {
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<MailboxTestAgent>(config); });
+    AgentManager manager;
+    AgentConfig config = makeAgent("mailbox-delete");
+    config.type = AgentType::DEVELOPER;
+    config.useMailbox = true;
+    auto agent = std::static_pointer_cast<MailboxTestAgent>(manager.createAgent(config));
+    agent->start();
+    agent->blocked = true;
+
+    TaskConfig taskConfig;
+    taskConfig.id = "mailbox-pending";
+    taskConfig.name = "mailbox-pending";
+    taskConfig.type = TaskType::DEVELOPMENT;
+    std::atomic<bool> done{false};
+    agent->submitTask(std::make_shared<Task>(taskConfig), [&done](std::shared_ptr<TaskResult> result) {
+        done = result && result->success;
+    });
+
+    std::atomic<bool> deleted{false};
+    std::thread deleter([&] { deleted = manager.deleteAgent("mailbox-delete"); });
+    while (manager.getAgent("mailbox-delete")) {
+        std::this_thread::yield();
+    }
+    EXPECT_NE(manager.createAgent(makeAgent("after-delete")), nullptr);
+    EXPECT_EQ(manager.getAgentCount(), 1u);
+    EXPECT_FALSE(deleted);
+    EXPECT_FALSE(done);
+
+    agent->blocked = false;
+    deleter.join();
+    EXPECT_TRUE(deleted);
+    EXPECT_TRUE(done);
+    EXPECT_EQ(agent->getStatus(), AgentStatus::STOPPED);
+}
+
+namespace {
+
+// 测试用慢启动智能体：启动耗时可配置，可模拟启动失败
+class SlowStartAgent : public TestAgent {
+public:
+    using TestAgent::TestAgent;
+
+    void start() override {
+        std::this_thread::sleep_for(delay);
+        setStatus(fail ? AgentStatus::ERROR : AgentStatus::RUNNING);
+    }
+
+    std::chrono::milliseconds delay{100};
+    bool fail{false};
+};
+
+} // namespace
+
+// 测试批量启动并行执行，并分别报告成功、失败和超时
+TEST_F(AgentManagerTest, BulkStartRunsInParallelWithDeadlines) {
+    AgentFactory::getInstance().registerAgent(AgentType::PROJECT_MANAGER,
+        [](const AgentConfig& config) { return std::make_shared<SlowStartAgent>(config); });
+
+    AgentManager manager;
+    for (int i = 0; i < 12; ++i) {
+        AgentConfig config = makeAgent("bulk-" + std::to_string(i));
+        config.type = AgentType::PROJECT_MANAGER;
+        manager.createAgent(config);
+    }
+    std::static_pointer_cast<SlowStartAgent>(manager.getAgent("bulk-3"))->fail = true;
+    std::static_pointer_cast<SlowStartAgent>(manager.getAgent("bulk-7"))->delay = std::chrono::milliseconds(1500);
+
+    // 4 个工作线程处理 12 个各需 100ms 的智能体，加上一个卡住的智能体被替补线程绕过
+    auto report = manager.startAllAgents(std::chrono::milliseconds(400), 4);
+    EXPECT_EQ(report.succeeded.size(), 10u);
+    EXPECT_EQ(report.failed, std::vector<std::string>{"bulk-3"});
+    EXPECT_EQ(report.timedOut, std::vector<std::string>{"bulk-7"});
+    EXPECT_FALSE(report.allSucceeded());
+    EXPECT_LT(report.elapsed, std::chrono::milliseconds(1200));
+
+    // 超时的调用仍在后台完成；出错的智能体不适用 stop，被跳过
+    auto slow = manager.getAgent("bulk-7");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (slow->getStatus() != AgentStatus::RUNNING && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto stopped = manager.stopAllAgents();
+    EXPECT_TRUE(stopped.allSucceeded());
+    EXPECT_EQ(stopped.succeeded.size(), 11u);
+    EXPECT_EQ(stopped.skipped, std::vector<std::string>{"bulk-3"});
+}
+
+// 测试管理器析构等待进行中的状态通知结束，超时分离的启停线程不会回调已释放的管理器
+TEST_F(AgentManagerTest, DestructorWaitsForInFlightStatusNotifications) {
+    auto manager = std::make_unique<AgentManager>();
+    auto agent = manager->createAgent(makeAgent("notify-late"));
+    agent->start();
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> hold{true};
+    manager->setStatusCallback([&](const std::string&, AgentStatus) {
+        entered = true;
+        while (hold) {
+            std::this_thread::yield();
+        }
+    });
+    std::thread notifier([agent] { agent->pause(); });
+    while (!entered) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<bool> destroyed{false};
+    std::thread destroyer([&] {
+        manager.reset();
+        destroyed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(destroyed);
+
+    hold = false;
+    notifier.join();
+    destroyer.join();
+    EXPECT_TRUE(destroyed);
+    EXPECT_EQ(agent->getStatus(), AgentStatus::PAUSED);
+    // 解除观察者后的变更不再通知
+    agent->resume();
+}
+
+namespace {
+
+// 测试用有状态智能体：累计执行过的任务数，并通过 serializeState 在休眠前后保留
+class CountingAgent : public TestAgent {
+public:
+    explicit CountingAgent(const AgentConfig& config) : TestAgent(config) {
+        constructed++;
+    }
+
+    std::shared_ptr<TaskResult> executeTask(const Task& /*task*/) override {
+        count++;
+        return std::make_shared<TaskResult>(true);
+    }
+
+    std::string serializeState() const override { return std::to_string(count.load()); }
+    bool restoreState(const std::string& state) override {
+        count = std::stoi(state);
+        return true;
+    }
+
+    static std::atomic<int> constructed;
+    std::atomic<int> count{0};
+};
+
+std::atomic<int> CountingAgent::constructed{0};
+
+} // namespace
+
+// 测试延迟智能体：首个任务到达时才构造，休眠释放真实智能体并在下次任务时带状态恢复
+TEST_F(AgentManagerTest, LazyAgentMaterializesOnDemandAndHibernates) {
+    AgentFactory::getInstance().registerAgent(AgentType::TESTER,
+        [](const AgentConfig& config) { return std::make_shared<CountingAgent>(config); });
+    CountingAgent::constructed = 0;
+
+    AgentManager manager;
+    AgentConfig config = makeAgent("lazy-a");
+    config.type = AgentType::TESTER;
+    config.lazy = true;
+    auto agent = std::dynamic_pointer_cast<LazyAgent>(manager.createAgent(config));
+    ASSERT_TRUE(agent);
+    EXPECT_TRUE(manager.startAllAgents().allSucceeded());
+    EXPECT_EQ(agent->getStatus(), AgentStatus::HIBERNATED);
+    EXPECT_TRUE(agent->isHealthy());
+    EXPECT_EQ(CountingAgent::constructed, 0);
+
+    TaskConfig taskConfig;
+    taskConfig.id = "lazy-task";
+    taskConfig.name = "lazy-task";
+    taskConfig.type = TaskType::TESTING;
+    Task task(taskConfig);
+    EXPECT_TRUE(agent->executeTask(task)->success);
+    EXPECT_TRUE(agent->executeTask(task)->success);
+    EXPECT_TRUE(agent->isMaterialized());
+    EXPECT_EQ(agent->getStatus(), AgentStatus::RUNNING);
+    EXPECT_EQ(CountingAgent::constructed, 1);
+
+    // 空闲不足期限时不休眠
+    EXPECT_EQ(manager.hibernateIdleAgents(std::chrono::hours(1)), 0u);
+    EXPECT_EQ(manager.hibernateIdleAgents(std::chrono::milliseconds(0)), 1u);
+    EXPECT_FALSE(agent->isMaterialized());
+    EXPECT_EQ(manager.getAgentCountByStatus(AgentStatus::HIBERNATED), 1u);
+
+    // 恢复后的新实例带着休眠前的计数继续
+    bool done = false;
+    agent->submitTask(std::make_shared<Task>(taskConfig), [&done](std::shared_ptr<TaskResult> result) {
+        done = result && result->success;
+    });
+    EXPECT_TRUE(done);
+    EXPECT_EQ(CountingAgent::constructed, 2);
+    EXPECT_TRUE(agent->hibernate());
+    EXPECT_TRUE(agent->executeTask(task)->success);
+    EXPECT_EQ(CountingAgent::constructed, 3);
+    EXPECT_EQ(agent->getStatus(), AgentStatus::RUNNING);
+
+    // 停止时释放真实智能体；未注册类型的延迟智能体在登记时即被拒绝
+    EXPECT_TRUE(manager.stopAllAgents().allSucceeded());
+    EXPECT_FALSE(agent->isMaterialized());
+    EXPECT_EQ(agent->getStatus(), AgentStatus::STOPPED);
+    AgentConfig unknown = makeAgent("lazy-unknown");
+    unknown.type = AgentType::UNKNOWN;
+    unknown.lazy = true;
+    EXPECT_EQ(manager.createAgent(unknown), nullptr);
+}
+
+namespace {
+
+// 测试用智能体：构造较慢，且未实现状态序列化，不允许休眠
+class SlowBuildAgent : public TestAgent {
+public:
+    explicit SlowBuildAgent(const AgentConfig& config) : TestAgent(config) {
+        constructed++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    bool supportsHibernation() const override { return false; }
+
+    static std::atomic<int> constructed;
+};
+
+std::atomic<int> SlowBuildAgent::constructed{0};
+
+} // namespace
+
+// 测试并发到达的任务只构造一次真实智能体，且构造期间不阻塞其他查询；不支持休眠的智能体保持驻留
+TEST_F(AgentManagerTest, LazyAgentMaterializesOnceAndRefusesUnsafeHibernation) {
+    AgentFactory::getInstance().registerAgent(AgentType::PROJECT_MANAGER,
+        [](const AgentConfig& config) { return std::make_shared<SlowBuildAgent>(config); });
+    SlowBuildAgent::constructed = 0;
+
+    AgentConfig config = makeAgent("lazy-slow");
+    config.type = AgentType::PROJECT_MANAGER;
+    config.lazy = true;
+    auto agent = std::make_shared<LazyAgent>(config);
+    agent->start();
+
+    TaskConfig taskConfig;
+    taskConfig.id = "slow-task";
+    taskConfig.name = "slow-task";
+    taskConfig.type = TaskType::DEVELOPMENT;
+    Task task(taskConfig);
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 4; ++i) {
+        callers.emplace_back([&] {
+            if (agent->executeTask(task)->success) {
+                succeeded++;
+            }
+        });
+    }
+    // 构造在锁外进行，期间查询不必等待
+    auto start = std::chrono::steady_clock::now();
+    agent->getQueueDepth();
+    agent->isMaterialized();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(40));
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(succeeded, 4);
+    EXPECT_EQ(SlowBuildAgent::constructed, 1);
+
+    EXPECT_FALSE(agent->hibernate());
+    EXPECT_TRUE(agent->isMaterialized());
+    agent->stop();
+}
+
+// 测试监控线程按期休眠空闲的延迟智能体
+TEST_F(AgentManagerTest, MonitorHibernatesIdleLazyAgents) {
+    AgentManager manager;
+    AgentConfig config = makeAgent("lazy-idle");
+    config.lazy = true;
+    auto agent = std::dynamic_pointer_cast<LazyAgent>(manager.createAgent(config));
+    ASSERT_TRUE(agent);
+    agent->start();
+
+    TaskConfig taskConfig;
+    taskConfig.id = "idle-task";
+    taskConfig.name = "idle-task";
+    taskConfig.type = TaskType::DEVELOPMENT;
+    EXPECT_TRUE(agent->executeTask(Task(taskConfig))->success);
+    EXPECT_TRUE(agent->isMaterialized());
+
+    manager.setHibernateAfter(std::chrono::milliseconds(30));
+    AgentMonitor monitor(manager);
+    monitor.startMonitoring(1);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (agent->isMaterialized() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    monitor.stopMonitoring();
+    EXPECT_FALSE(agent->isMaterialized());
+    EXPECT_EQ(agent->getStatus(), AgentStatus::HIBERNATED);
+}
+
+// 测试能力索引随创建、删除、状态变更与配置更新同步维护
+TEST_F(AgentManagerTest, CapabilityIndexFollowsStatusAndConfig) {
+    AgentManager manager;
+    AgentConfig generalist = makeAgent("cap-any");
+    AgentConfig tester = makeAgent("cap-tester");
+    tester.capabilities = {TaskType::TESTING};
+    AgentConfig reviewer = makeAgent("cap-reviewer");
+    reviewer.capabilities = {TaskType::TESTING, TaskType::ARCHITECTURE};
+    for (const auto& config : {generalist, tester, reviewer}) {
+        manager.createAgent(config);
+    }
+
+    // 未启动的智能体不在索引中
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::TESTING), 0u);
+    manager.startAllAgents();
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::TESTING), 3u);
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::ARCHITECTURE), 2u);
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::DEVELOPMENT), 1u);
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::UNKNOWN), 3u);
+
+    std::set<std::string> architects;
+    manager.forEachAgentForTaskType(TaskType::ARCHITECTURE, [&architects](Agent& agent) {
+        architects.insert(agent.getId());
+    });
+    EXPECT_EQ(architects, (std::set<std::string>{"cap-any", "cap-reviewer"}));
+
+    manager.getAgent("cap-any")->pause();
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::ARCHITECTURE), 1u);
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::DEVELOPMENT), 0u);
+    manager.getAgent("cap-any")->resume();
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::DEVELOPMENT), 1u);
+
+    tester.capabilities = {TaskType::DEVELOPMENT};
+    EXPECT_TRUE(manager.updateAgentConfig("cap-tester", tester));
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::DEVELOPMENT), 2u);
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::TESTING), 2u);
+
+    EXPECT_TRUE(manager.deleteAgent("cap-reviewer"));
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::ARCHITECTURE), 1u);
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::TESTING), 1u);
+    manager.stopAllAgents();
+    for (size_t type = 0; type < kTaskTypeCount; ++type) {
+        EXPECT_EQ(manager.getAgentCountForTaskType(static_cast<TaskType>(type)), 0u);
+    }
+}
+
+// 测试按状态与能力遍历读取快照：回调中改变状态不会死锁，也不影响本次遍历
+TEST_F(AgentManagerTest, IndexTraversalAllowsStatusChangesInCallback) {
+    AgentManager manager;
+    for (int i = 0; i < 4; ++i) {
+        manager.createAgent(makeAgent("walk-" + std::to_string(i)));
+    }
+    manager.startAllAgents();
+
+    size_t visited = 0;
+    manager.forEachAgentWithStatus(AgentStatus::RUNNING, [&visited](Agent& agent) {
+        agent.pause();
+        visited++;
+    });
+    EXPECT_EQ(visited, 4u);
+    EXPECT_EQ(manager.getAgentCountByStatus(AgentStatus::RUNNING), 0u);
+    EXPECT_EQ(manager.getAgentCountByStatus(AgentStatus::PAUSED), 4u);
+
+    manager.resumeAllAgents();
+    visited = 0;
+    manager.forEachAgentForTaskType(TaskType::DEVELOPMENT, [&visited](Agent& agent) {
+        agent.stop();
+        visited++;
+    });
+    EXPECT_EQ(visited, 4u);
+    EXPECT_EQ(manager.getAgentCountForTaskType(TaskType::DEVELOPMENT), 0u);
+    EXPECT_EQ(manager.getAgentCountByStatus(AgentStatus::STOPPED), 4u);
+}
+
+// 测试配置更新整体替换快照：读者始终看到某一版完整的配置
+TEST_F(AgentManagerTest, ConfigUpdatesPublishWholeSnapshots) {
+    AgentConfig config = makeAgent("config-swap");
+    config.name = "name-" + std::to_string(config.resourceLimits.maxThreads);
+    auto agent = std::make_shared<TestAgent>(config);
+
+    std::atomic<bool> done{false};
+    std::atomic<size_t> torn{0};
+    std::thread reader([&] {
+        while (!done) {
+            AgentConfig current = agent->getConfig();
+            // 两个字段总是在同一次更新中一起修改
+            if (current.name != "name-" + std::to_string(current.resourceLimits.maxThreads)) {
+                torn++;
+            }
+            agent->exceedsResourceLimits();
+            EXPECT_EQ(agent->getId(), "config-swap");
+        }
+    });
+    for (size_t i = 1; i <= 2000; ++i) {
+        config.name = "name-" + std::to_string(i);
+        config.resourceLimits.maxThreads = i;
+        EXPECT_TRUE(agent->updateConfig(config));
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(agent->getName(), "name-2000");
+
+    config.id = "renamed";
+    EXPECT_FALSE(agent->updateConfig(config));
+}
+
+namespace {
+
+// 测试用智能体：状态为一块可修改的内存
+class MemoryAgent : public TestAgent {
+public:
+    explicit MemoryAgent(const AgentConfig& config) : TestAgent(config) {}
+
+    std::string serializeState() const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return memory;
+    }
+    bool restoreState(const std::string& state) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        memory = state;
+        return true;
+    }
+
+    mutable std::mutex mutex;
+    std::string memory;
+};
+
+} // namespace
+
+// 测试检查点：首次完整写入，之后只追加变化的块；新实例可从检查点恢复，忽略写了一半的尾帧
+TEST_F(AgentManagerTest, CheckpointsAgentStateIncrementally) {
+    std::string directory = ::testing::TempDir() + "openclaw-checkpoint-test";
+    CheckpointStore(directory).remove("mem/a");
+
+    AgentConfig config = makeAgent("mem/a");
+    std::string expected;
+    {
+        AgentManager manager;
+        auto agent = std::make_shared<MemoryAgent>(config);
+        AgentFactory::getInstance().registerAgent(AgentType::PROJECT_MANAGER,
+            [agent](const AgentConfig&) { return agent; });
+        config.type = AgentType::PROJECT_MANAGER;
+        ASSERT_EQ(manager.createAgent(config), agent);
+        EXPECT_FALSE(manager.checkpointAgent("mem/a"));   // 尚未设置目录
+
+        manager.setCheckpointDirectory(directory);
+        agent->memory.assign(64 * CheckpointStore::kBlockSize, 'a');
+        EXPECT_TRUE(manager.checkpointAgent("mem/a"));
+        agent->memory[10 * CheckpointStore::kBlockSize + 7] = 'b';
+        agent->memory.append("tail");
+        EXPECT_TRUE(manager.checkpointAgent("mem/a"));
+        EXPECT_EQ(manager.checkpointAllAgents(), 1u);   // 未变化，不写入
+        expected = agent->memory;
+    }
+
+    CheckpointStore store(directory);
+    std::string state;
+    ASSERT_TRUE(store.load("mem/a", state));
+    EXPECT_EQ(state, expected);
+
+    // 增量帧只包含变化的两个块
+    std::string path = directory + "/mem%2Fa.ckpt";
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    size_t fileSize = static_cast<size_t>(in.tellg());
+    EXPECT_LT(fileSize, expected.size() + 3 * CheckpointStore::kBlockSize);
+
+    // 模拟写入中途崩溃：尾部残缺的帧被忽略，下次保存重写完整文件
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("\x40\x00\x00\x00partial", 11);
+    }
+    ASSERT_TRUE(store.load("mem/a", state));
+    EXPECT_EQ(state, expected);
+    EXPECT_TRUE(store.save("mem/a", expected + "!"));
+    EXPECT_EQ(store.getStats().fullCheckpoints, 1u);
+    EXPECT_EQ(store.getStats().deltaCheckpoints, 0u);
+    EXPECT_FALSE(std::ifstream(path + ".tmp").good());
+
+    // 只保留块散列仍能找出变化的块
+    expected[3] = 'c';
+    EXPECT_TRUE(store.save("mem/a", expected + "!"));
+    EXPECT_EQ(store.getStats().deltaCheckpoints, 1u);
+    ASSERT_TRUE(CheckpointStore(directory).load("mem/a", state));
+    EXPECT_EQ(state, expected + "!");
+
+    // 重新创建同 ID 的智能体并恢复
+    AgentManager manager;
+    manager.setCheckpointDirectory(directory);
+    auto restored = std::make_shared<MemoryAgent>(config);
+    AgentFactory::getInstance().registerAgent(AgentType::PROJECT_MANAGER,
+        [restored](const AgentConfig&) { return restored; });
+    ASSERT_TRUE(manager.createAgent(config));
+    EXPECT_TRUE(manager.restoreAgent("mem/a"));
+    EXPECT_EQ(restored->memory, expected + "!");
+    EXPECT_FALSE(manager.restoreAgent("missing"));
+    EXPECT_TRUE(store.remove("mem/a"));
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "agent/AgentManager.h"
+#include "agent/ModelAgent.h"
+#include "task/TaskScheduler.h"
+#include "logging/Logger.h"
+#include <chrono>
+#include <thread>
+
+using namespace openclaw;
+
+namespace {
+
+class ModelAgentTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().setConsoleOutputEnabled(false);
+        provider_ = std::make_shared<MockModelProvider>("mock");
+        provider_->setResponder([](const ModelRequest& request) { return "echo " + request.prompt + " done"; });
+        gateway_.registerProvider(provider_);
+
+        ModelGateway& gateway = gateway_;
+        AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+            [&gateway](const AgentConfig& config) { return std::make_shared<ModelAgent>(config, gateway); });
+
+        AgentConfig config;
+        config.id = "model-dev";
+        config.name = "Model developer";
+        config.type = AgentType::DEVELOPER;
+        config.properties["model"] = "mock/test";
+        auto agent = manager_.createAgent(config);
+        ASSERT_TRUE(agent);
+        agent->start();
+    }
+
+    void TearDown() override {
+        // 工厂是全局的，不能留下引用本测试网关的创建函数
+        AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+            [](const AgentConfig& config) { return std::make_shared<ModelAgent>(config); });
+        Logger::getInstance().setConsoleOutputEnabled(true);
+    }
+
+    static TaskConfig makeTask(const std::string& id, const std::string& prompt) {
+        TaskConfig config;
+        config.id = id;
+        config.name = id;
+        config.type = TaskType::DEVELOPMENT;
+        config.maxRetries = 0;
+        config.parameters["prompt"] = prompt;
+        return config;
+    }
+
+    ModelGateway gateway_;
+    std::shared_ptr<MockModelProvider> provider_;
+    AgentManager manager_;
+};
+
+} // namespace
+
+// 测试订阅任务输出后，调度器派发的任务经 ModelGateway::stream 逐块输出，首块先于任务完成到达
+TEST_F(ModelAgentTest, StreamsSubscribedTaskOutput) {
+    provider_->setChunkDelay(std::chrono::milliseconds(20));
+    TaskScheduler scheduler(manager_);
+    ASSERT_TRUE(scheduler.scheduleTask(makeTask("answer", "hello")));
+
+    auto reader = scheduler.subscribeOutput("answer");
+    ASSERT_TRUE(reader);
+
+    std::string received;
+    size_t chunks = 0;
+    std::chrono::steady_clock::time_point firstChunk;
+    std::thread consumer([&] {
+        std::string chunk;
+        while (reader.next(chunk)) {
+            if (chunks++ == 0) {
+                firstChunk = std::chrono::steady_clock::now();
+            }
+            received += chunk;
+        }
+    });
+
+    scheduler.runSchedulingRound();
+    auto finished = std::chrono::steady_clock::now();
+    consumer.join();
+
+    EXPECT_EQ(scheduler.getTaskStatus("answer"), TaskStatus::COMPLETED);
+    EXPECT_EQ(received, "echo hello done");
+    EXPECT_EQ(chunks, 3u);
+    EXPECT_LT(firstChunk, finished);
+    EXPECT_TRUE(reader.stream()->succeeded());
+    EXPECT_EQ(gateway_.getStats().streamed, 1u);
+
+    // 已结束的任务不再提供输出流
+    EXPECT_FALSE(scheduler.subscribeOutput("answer"));
+    EXPECT_FALSE(scheduler.subscribeOutput("missing"));
+}
+
+// 测试没有订阅方时照常非流式执行，失败时订阅方收到带错误的结束
+TEST_F(ModelAgentTest, CompletesWithoutSubscribersAndReportsFailure) {
+    TaskScheduler scheduler(manager_);
+    ASSERT_TRUE(scheduler.scheduleTask(makeTask("plain", "quiet")));
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("plain"), TaskStatus::COMPLETED);
+    EXPECT_EQ(gateway_.getStats().streamed, 0u);
+
+    provider_->setFailing(true);
+    ASSERT_TRUE(scheduler.scheduleTask(makeTask("broken", "oops")));
+    auto reader = scheduler.subscribeOutput("broken");
+    ASSERT_TRUE(reader);
+    scheduler.runSchedulingRound();
+
+    std::string chunk;
+    EXPECT_EQ(reader.next(chunk, std::chrono::milliseconds(100)), StreamStatus::FINISHED);
+    EXPECT_FALSE(reader.stream()->succeeded());
+    EXPECT_EQ(scheduler.getTaskStatus("broken"), TaskStatus::FAILED);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "agent/AgentManager.h"
+#include "agent/RemoteAgent.h"
+#include "common/ShmRing.h"
+#include "logging/Logger.h"
+#include "../support/TestAgent.h"
+#include <csignal>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace openclaw;
+
+namespace {
+
+// 测试用智能体：在子进程中回报自己的 pid，参数 crash 使进程直接退出
+class ProcessAgent : public TestAgent {
+public:
+    using TestAgent::TestAgent;
+
+    std::shared_ptr<TaskResult> executeTask(const Task& task) override {
+        if (task.getConfig().parameters.count("crash")) {
+            _exit(3);
+        }
+        if (task.getConfig().parameters.count("hang")) {
+            std::this_thread::sleep_for(std::chrono::hours(1));
+        }
+        if (task.getConfig().parameters.count("freeze")) {
+            raise(SIGSTOP);   // 整个进程停止，心跳随之中断
+        }
+        auto result = std::make_shared<TaskResult>(true);
+        result->output["pid"] = std::to_string(getpid());
+        result->output["echo"] = task.getConfig().parameters.count("echo") ? task.getConfig().parameters.at("echo") : "";
+        return result;
+    }
+};
+
+// 测试程序被作为子进程宿主重新执行时，main 进入服务循环前登记测试智能体
+const bool kHostAgentRegistered = RemoteAgent::isHostProcess() && [] {
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<ProcessAgent>(config); });
+    return true;
+}();
+
+Task makeTask(const std::string& id) {
+    TaskConfig config;
+    config.id = id;
+    config.name = id;
+    config.type = TaskType::DEVELOPMENT;
+    return Task(config);
+}
+
+} // namespace
+
+// 测试共享内存环的环绕读写与容量限制
+TEST(ShmRingTest, WrapsAroundAndRejectsWhenFull) {
+    constexpr size_t kCapacity = 64;
+    std::vector<char> memory(ShmRing::bytesFor(kCapacity) + 64);
+    void* aligned = memory.data() + (64 - reinterpret_cast<uintptr_t>(memory.data()) % 64) % 64;
+    ShmRing ring = ShmRing::create(aligned, kCapacity);
+
+    std::string out;
+    EXPECT_FALSE(ring.pop(out));
+    EXPECT_FALSE(ring.fits(kCapacity));
+    for (int round = 0; round < 20; ++round) {
+        std::string message(20 + round % 7, static_cast<char>('a' + round));
+        ASSERT_TRUE(ring.push(message));
+        ASSERT_TRUE(ring.push(message));
+        EXPECT_FALSE(ring.push(std::string(30, 'x')));
+        ASSERT_TRUE(ring.pop(out));
+        EXPECT_EQ(out, message);
+        ASSERT_TRUE(ring.pop(out));
+        EXPECT_EQ(out, message);
+    }
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.wait(std::chrono::milliseconds(1)));
+}
+
+// 测试任务在子进程中执行，结果经共享内存环返回
+TEST(RemoteAgentTest, RunsTasksInChildProcess) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<ProcessAgent>(config); });
+
+    AgentManager manager;
+    AgentConfig config;
+    config.id = "remote-a";
+    config.name = "remote-a";
+    config.type = AgentType::DEVELOPER;
+    config.outOfProcess = true;
+    auto agent = std::dynamic_pointer_cast<RemoteAgent>(manager.createAgent(config));
+    ASSERT_TRUE(agent);
+    agent->start();
+    ASSERT_EQ(agent->getStatus(), AgentStatus::RUNNING);
+    ASSERT_GT(agent->getPid(), 0);
+    EXPECT_NE(agent->getPid(), getpid());
+
+    auto task = makeTask("remote-task");
+    std::string large(100000, 'z');
+    TaskConfig echoConfig = task.getConfig();
+    echoConfig.parameters["echo"] = large;
+    auto result = agent->executeTask(Task(echoConfig));
+    ASSERT_TRUE(result->success);
+    EXPECT_EQ(result->output["pid"], std::to_string(agent->getPid()));
+    EXPECT_EQ(result->output["echo"], large);
+
+    // 异步提交的任务全部按各自的请求回调
+    std::atomic<int> completed{0};
+    for (int i = 0; i < 100; ++i) {
+        agent->submitTask(std::make_shared<Task>(makeTask("async-" + std::to_string(i)).getConfig()),
+                          [&completed](std::shared_ptr<TaskResult> r) {
+                              if (r && r->success) {
+                                  completed++;
+                              }
+                          });
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (completed < 100 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(completed, 100);
+
+    int pid = agent->getPid();
+    agent->stop();
+    EXPECT_EQ(agent->getStatus(), AgentStatus::STOPPED);
+    EXPECT_EQ(agent->getPid(), -1);
+    EXPECT_NE(kill(pid, 0), 0);   // 子进程已回收
+    Logger::getInstance().setConsoleOutputEnabled(true);
+}
+
+// 测试子进程崩溃后未完成的任务失败，随后自动重新派生
+TEST(RemoteAgentTest, RespawnsAfterCrash) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<ProcessAgent>(config); });
+
+    AgentConfig config;
+    config.id = "remote-crash";
+    config.name = "remote-crash";
+    config.type = AgentType::DEVELOPER;
+    auto agent = std::make_shared<RemoteAgent>(config);
+    agent->start();
+    int firstPid = agent->getPid();
+
+    TaskConfig crashConfig = makeTask("crash").getConfig();
+    crashConfig.parameters["crash"] = "1";
+    auto crashed = agent->executeTask(Task(crashConfig));
+    EXPECT_FALSE(crashed->success);
+    EXPECT_NE(crashed->errorMessage.find("exited unexpectedly"), std::string::npos);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (agent->getRestartCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(agent->getRestartCount(), 1u);
+    EXPECT_EQ(agent->getStatus(), AgentStatus::RUNNING);
+
+    auto result = agent->executeTask(makeTask("after-crash"));
+    EXPECT_TRUE(result->success);
+    EXPECT_NE(result->output["pid"], std::to_string(firstPid));
+    agent->stop();
+    Logger::getInstance().setConsoleOutputEnabled(true);
+}
+
+// 测试任务超过期限或子进程停止心跳时，任务失败、子进程被结束并重新派生
+TEST(RemoteAgentTest, RestartsHungProcess) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    AgentConfig config;
+    config.id = "remote-hang";
+    config.name = "remote-hang";
+    config.type = AgentType::DEVELOPER;
+    auto agent = std::make_shared<RemoteAgent>(config);
+    agent->start();
+    ASSERT_EQ(agent->getStatus(), AgentStatus::RUNNING);
+
+    TaskConfig hangConfig = makeTask("hang").getConfig();
+    hangConfig.parameters["hang"] = "1";
+    hangConfig.timeoutSeconds = 1;
+    auto start = std::chrono::steady_clock::now();
+    auto hung = agent->executeTask(Task(hangConfig));
+    EXPECT_FALSE(hung->success);
+    EXPECT_NE(hung->errorMessage.find("timed out"), std::string::npos);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(3));
+
+    TaskConfig freezeConfig = makeTask("freeze").getConfig();
+    freezeConfig.parameters["freeze"] = "1";
+    auto frozen = agent->executeTask(Task(freezeConfig));
+    EXPECT_FALSE(frozen->success);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (agent->getRestartCount() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(agent->getRestartCount(), 2u);
+    EXPECT_TRUE(agent->executeTask(makeTask("after-hang"))->success);
+    agent->stop();
+    Logger::getInstance().setConsoleOutputEnabled(true);
+}
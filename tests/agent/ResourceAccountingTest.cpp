@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "agent/AgentManager.h"
+#include "agent/ResourceAccounting.h"
+#include "task/TaskScheduler.h"
+#include "logging/Logger.h"
+#include "../support/TestAgent.h"
+#include <thread>
+
+using namespace openclaw;
+
+namespace {
+
+// 测试用智能体：每个任务在当前线程上消耗约 burn 的 CPU 时间
+class BurnAgent : public TestAgent {
+public:
+    using TestAgent::TestAgent;
+
+    std::shared_ptr<TaskResult> executeTask(const Task& /*task*/) override {
+        int64_t until = ResourceAccounting::threadCpuNanos() + burn.count();
+        while (ResourceAccounting::threadCpuNanos() < until) {
+        }
+        return std::make_shared<TaskResult>(true);
+    }
+
+    std::chrono::nanoseconds burn{std::chrono::milliseconds(100)};
+};
+
+} // namespace
+
+// 测试 AccountedAllocator 的分配记到绑定的句柄名下，在其他线程释放时同样扣除；普通分配不计入
+TEST(ResourceAccountingTest, ChargesAccountedAllocations) {
+    auto& accounting = ResourceAccounting::getInstance();
+    auto handle = StringInterner::getInstance().intern("accounting-memory");
+    auto other = StringInterner::getInstance().intern("accounting-other");
+
+    using AccountedBuffer = std::vector<char, AccountedAllocator<char>>;
+    AccountedBuffer* buffer = nullptr;
+    AccountedBuffer* nested = nullptr;
+    std::vector<char>* untracked = nullptr;
+    {
+        ResourceAccounting::Scope scope(handle);
+        EXPECT_EQ(ResourceAccounting::currentAccount(), handle);
+        buffer = new AccountedBuffer(1 << 20);
+        untracked = new std::vector<char>(1 << 20);
+        {
+            ResourceAccounting::Scope inner(other);
+            nested = new AccountedBuffer(4096);
+        }
+        EXPECT_EQ(ResourceAccounting::currentAccount(), handle);
+    }
+    EXPECT_EQ(ResourceAccounting::currentAccount(), StringInterner::kInvalidHandle);
+
+    EXPECT_EQ(accounting.getUsage(handle).memoryBytes, 1 << 20);
+    EXPECT_EQ(accounting.getUsage(other).memoryBytes, 4096);
+
+    std::thread([buffer, nested, untracked] {
+        delete buffer;
+        delete nested;
+        delete untracked;
+    }).join();
+    EXPECT_EQ(accounting.getUsage(handle).memoryBytes, 0);
+    EXPECT_EQ(accounting.getUsage(other).memoryBytes, 0);
+    EXPECT_EQ(accounting.getUsage(handle).peakMemoryBytes, 1 << 20);
+
+    // 显式绑定句柄，与所在 Scope 无关
+    AccountedBuffer bound{AccountedAllocator<char>(other)};
+    bound.resize(1000);
+    EXPECT_EQ(accounting.getUsage(other).memoryBytes, 1000);
+}
+
+// 测试槽位被复用（代数已增长）的句柄照常计量，且不继承槽位上一个句柄的计数
+TEST(ResourceAccountingTest, AccountsHandlesOfReusedSlots) {
+    auto& accounting = ResourceAccounting::getInstance();
+    auto& interner = StringInterner::getInstance();
+
+    // 先让一批任务 ID 反复驻留、释放，直到新驻留的句柄代数不小于 16
+    StringInterner::Handle first = interner.acquire("accounting-churn-first");
+    accounting.chargeMemory(first, 4096);
+    interner.release(first);
+    StringInterner::Handle late = StringInterner::kInvalidHandle;
+    for (int i = 0; i < (1 << 20); ++i) {
+        auto handle = interner.acquire("accounting-churn-" + std::to_string(i));
+        if ((handle >> StringInterner::kIndexBits) >= 16) {
+            late = handle;
+            break;
+        }
+        interner.release(handle);
+    }
+    ASSERT_NE(late, StringInterner::kInvalidHandle);
+
+    accounting.chargeMemory(late, 1 << 20);
+    EXPECT_EQ(accounting.getUsage(late).memoryBytes, 1 << 20);
+    EXPECT_EQ(accounting.getUsage(late).allocations, 1u);
+    accounting.releaseMemory(late, 1 << 20);
+    interner.release(late);
+
+    // first 所在槽位被新句柄复用后，新句柄从零开始计数，旧句柄也读不到新句柄的计数
+    StringInterner::Handle reused = StringInterner::kInvalidHandle;
+    for (int i = 0; i < (1 << 20) && reused == StringInterner::kInvalidHandle; ++i) {
+        auto handle = interner.acquire("accounting-reuse-" + std::to_string(i));
+        if (StringInterner::slotOf(handle) == StringInterner::slotOf(first)) {
+            reused = handle;
+        } else {
+            interner.release(handle);
+        }
+    }
+    ASSERT_NE(reused, StringInterner::kInvalidHandle);
+    EXPECT_NE(reused, first);
+    accounting.chargeMemory(reused, 100);
+    EXPECT_EQ(accounting.getUsage(reused).memoryBytes, 100);
+    EXPECT_EQ(accounting.getUsage(reused).peakMemoryBytes, 100);
+    EXPECT_EQ(accounting.getUsage(first).memoryBytes, 0);
+    accounting.releaseMemory(reused, 100);
+    interner.release(reused);
+}
+
+// 测试实测 CPU 利用率超过 maxCpuUsage 的智能体暂停派发，利用率回落后恢复
+TEST(ResourceAccountingTest, SchedulerThrottlesAgentsOverCpuLimit) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    auto& accounting = ResourceAccounting::getInstance();
+    auto window = accounting.getUtilizationWindow();
+    accounting.setUtilizationWindow(std::chrono::milliseconds(500));
+
+    AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+        [](const AgentConfig& config) { return std::make_shared<BurnAgent>(config); });
+    AgentManager manager;
+    AgentConfig config;
+    config.id = "accounting-cpu";
+    config.name = config.id;
+    config.type = AgentType::DEVELOPER;
+    config.resourceLimits.maxCpuUsage = 5.0;
+    auto agent = manager.createAgent(config);
+    agent->start();
+
+    TaskScheduler scheduler(manager);
+    EXPECT_EQ(scheduler.getAvailableAgentCount(), 1u);
+    TaskConfig task;
+    task.id = "burn";
+    task.name = "burn";
+    task.type = TaskType::DEVELOPMENT;
+    EXPECT_TRUE(scheduler.scheduleTask(task));
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("burn"), TaskStatus::COMPLETED);
+
+    // 100ms CPU / 500ms 窗口 ≈ 20%，超过 5% 的上限
+    auto usage = agent->getResourceUsage();
+    EXPECT_GE(usage.cpuTime, std::chrono::milliseconds(100));
+    EXPECT_GT(usage.cpuPercent, 5.0);
+    EXPECT_TRUE(agent->exceedsResourceLimits());
+    EXPECT_EQ(scheduler.getAvailableAgentCount(), 0u);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (agent->exceedsResourceLimits() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    EXPECT_LE(agent->getResourceUsage().cpuPercent, 5.0);
+    EXPECT_EQ(scheduler.getAvailableAgentCount(), 1u);
+
+    // 未设上限时按 maxThreads 个核计，同样的负载不会暂停派发
+    AgentConfig unlimited = config;
+    unlimited.resourceLimits.maxCpuUsage = 0.0;
+    ASSERT_TRUE(agent->updateConfig(unlimited));
+    TaskConfig second = task;
+    second.id = "burn-2";
+    second.name = "burn-2";
+    EXPECT_TRUE(scheduler.scheduleTask(second));
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("burn-2"), TaskStatus::COMPLETED);
+    EXPECT_FALSE(agent->exceedsResourceLimits());
+
+    accounting.setUtilizationWindow(window);
+    Logger::getInstance().setConsoleOutputEnabled(true);
+}
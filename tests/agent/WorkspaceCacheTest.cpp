@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "agent/WorkspaceCache.h"
+#include "logging/Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace openclaw;
+
+namespace {
+
+std::string makeWorkspace(const std::string& name) {
+    std::string dir = ::testing::TempDir() + name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir + "/src/nested");
+    return WorkspaceCache::normalizePath(dir);
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    // 先写临时文件再 rename，与智能体写工作区的方式一致
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+    std::rename(tmp.c_str(), path.c_str());
+}
+
+// 等待监视线程处理完事件，直到 condition 成立或超时
+template <typename Condition>
+bool waitFor(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return condition();
+}
+
+} // namespace
+
+// 测试命中返回同一映射、目录树索引与按字节预算淘汰
+TEST(WorkspaceCacheTest, ServesMappedViewsAndEvictsOverBudget) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    std::string root = makeWorkspace("openclaw-workspace-cache");
+    writeFile(root + "/README.md", "readme");
+    writeFile(root + "/src/main.cpp", std::string(3000, 'm'));
+    writeFile(root + "/src/nested/util.h", std::string(3000, 'u'));
+
+    WorkspaceCacheOptions options;
+    options.maxBytes = 4096;
+    options.watch = false;
+    WorkspaceCache cache(options);
+    ASSERT_TRUE(cache.addWorkspace(root));
+    EXPECT_FALSE(cache.addWorkspace(root + "/missing"));
+
+    EXPECT_EQ(cache.listFiles(root + "/src"),
+              (std::vector<std::string>{root + "/src/main.cpp", root + "/src/nested/util.h"}));
+    EXPECT_EQ(cache.listFiles(root).size(), 3u);
+
+    auto first = cache.read(root + "/src/main.cpp");
+    ASSERT_TRUE(first);
+    auto second = cache.read(root + "/src/../src/main.cpp");
+    EXPECT_EQ(second.data().data(), first.data().data());   // 同一映射，没有拷贝
+    EXPECT_EQ(second.hash(), first.hash());
+    EXPECT_EQ(cache.getStats().hits, 1u);
+    EXPECT_FALSE(cache.read(root + "/nope.txt"));
+
+    // 第二个大文件超出预算，最久未用的被淘汰，已取得的 View 仍然有效
+    auto util = cache.read(root + "/src/nested/util.h");
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_LE(stats.cachedBytes, options.maxBytes);
+    EXPECT_EQ(first.data(), std::string(3000, 'm'));
+
+    // 未启用监视时需要手动失效
+    EXPECT_EQ(cache.read(root + "/README.md").data(), "readme");
+    writeFile(root + "/README.md", "changed");
+    EXPECT_EQ(cache.read(root + "/README.md").data(), "readme");
+    cache.invalidate(root + "/README.md");
+    EXPECT_EQ(cache.read(root + "/README.md").data(), "changed");
+
+    // 只统计确实移出缓存的条目，未缓存的路径不计入
+    cache.invalidate(root + "/never-read.txt");
+    EXPECT_EQ(cache.getStats().invalidations, 1u);
+
+    std::filesystem::remove_all(root);
+}
+
+// 测试 inotify 驱动的失效与索引更新
+TEST(WorkspaceCacheTest, InvalidatesOnFileSystemEvents) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    std::string root = makeWorkspace("openclaw-workspace-watch");
+    writeFile(root + "/src/task.txt", "version 1");
+
+    WorkspaceCache cache;
+    ASSERT_TRUE(cache.addWorkspace(root));
+    EXPECT_GE(cache.getStats().watchedDirectories, 3u);
+    auto original = cache.read(root + "/src/task.txt");
+    ASSERT_EQ(original.data(), "version 1");
+    uint64_t hash = original.hash();
+
+    writeFile(root + "/src/task.txt", "version 2");
+    EXPECT_TRUE(waitFor([&] { return cache.read(root + "/src/task.txt").data() == "version 2"; }));
+    EXPECT_NE(cache.read(root + "/src/task.txt").hash(), hash);
+    EXPECT_EQ(original.data(), "version 1");   // 旧 View 仍指向旧内容
+
+    // 新建目录自动加入监视与索引
+    std::filesystem::create_directories(root + "/generated");
+    EXPECT_TRUE(waitFor([&] { return cache.getStats().watchedDirectories >= 4; }));
+    writeFile(root + "/generated/out.txt", "artifact");
+    EXPECT_TRUE(waitFor([&] { return cache.listFiles(root + "/generated").size() == 1; }));
+
+    std::filesystem::remove(root + "/src/task.txt");
+    EXPECT_TRUE(waitFor([&] { return !cache.read(root + "/src/task.txt"); }));
+    EXPECT_TRUE(cache.listFiles(root + "/src").empty());
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+#include "cluster/ClusterNode.h"
+#include "common/BinaryCodec.h"
+#include "logging/Logger.h"
+#include "../support/TestAgent.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace openclaw;
+
+namespace {
+
+TaskConfig makeTask(const std::string& id) {
+    TaskConfig config;
+    config.id = id;
+    config.name = id;
+    config.type = TaskType::DEVELOPMENT;
+    return config;
+}
+
+ClusterConfig makeConfig(const std::vector<std::string>& seeds = {}) {
+    ClusterConfig config;
+    config.seeds = seeds;
+    config.heartbeatInterval = std::chrono::milliseconds(50);
+    config.failureTimeout = std::chrono::milliseconds(500);
+    return config;
+}
+
+template <typename Predicate>
+bool waitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (predicate()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return predicate();
+}
+
+// 每个节点拥有独立的智能体管理器与调度器，节点之间通过 127.0.0.1 上的真实 TCP 通信
+struct NodeHarness {
+    AgentManager manager;
+    TaskScheduler scheduler{manager};
+    std::unique_ptr<ClusterNode> node;
+
+    explicit NodeHarness(const ClusterConfig& config)
+        : node(std::make_unique<ClusterNode>(scheduler, config)) {}
+
+    void addAgent(const std::string& id) {
+        AgentConfig config;
+        config.id = id;
+        config.name = id;
+        config.type = AgentType::ARCHITECT;
+        manager.createAgent(config)->start();
+    }
+};
+
+class ClusterNodeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().setConsoleOutputEnabled(false);
+        AgentFactory::getInstance().registerAgent(AgentType::ARCHITECT,
+            [](const AgentConfig& config) { return std::make_shared<TestAgent>(config); });
+    }
+
+    void TearDown() override {
+        Logger::getInstance().setConsoleOutputEnabled(true);
+    }
+};
+
+} // namespace
+
+TEST(TaskConfigCodecTest, RoundTrip) {
+    TaskConfig config = makeTask("t1");
+    config.priority = TaskPriority::CRITICAL;
+    config.parameters["partitionKey"] = "dag-1";
+    config.dependencies = {"t0"};
+    config.resourceRequirements.cpuCores = 4;
+    config.timeoutSeconds = 42;
+
+    std::string buffer;
+    BinaryWriter writer(buffer);
+    config.serialize(writer);
+
+    TaskConfig decoded;
+    BinaryReader reader(buffer);
+    ASSERT_TRUE(TaskConfig::deserialize(reader, decoded));
+    EXPECT_EQ(decoded.id, "t1");
+    EXPECT_EQ(decoded.priority, TaskPriority::CRITICAL);
+    EXPECT_EQ(decoded.parameters.at("partitionKey"), "dag-1");
+    EXPECT_EQ(decoded.dependencies, std::vector<std::string>{"t0"});
+    EXPECT_EQ(decoded.resourceRequirements.cpuCores, 4u);
+    EXPECT_EQ(decoded.timeoutSeconds, 42u);
+
+    // 截断的数据必须被拒绝
+    BinaryReader truncated(buffer.data(), buffer.size() / 2);
+    EXPECT_FALSE(TaskConfig::deserialize(truncated, decoded));
+}
+
+TEST_F(ClusterNodeTest, MembershipConvergesAndExpiresFailedNodes) {
+    NodeHarness a(makeConfig());
+    ASSERT_TRUE(a.node->start());
+    NodeHarness b(makeConfig({a.node->getNodeId()}));
+    ASSERT_TRUE(b.node->start());
+    NodeHarness c(makeConfig({a.node->getNodeId()}));
+    ASSERT_TRUE(c.node->start());
+
+    // C 只知道 A，需要经 gossip 得知 B
+    EXPECT_TRUE(waitFor([&] {
+        return a.node->getMembers().size() == 3 &&
+               b.node->getMembers().size() == 3 &&
+               c.node->getMembers().size() == 3;
+    }));
+
+    c.node->stop();
+    EXPECT_TRUE(waitFor([&] {
+        return a.node->getMembers().size() == 2 && b.node->getMembers().size() == 2;
+    }));
+}
+
+TEST_F(ClusterNodeTest, ForwardsSubmissionsToPartitionOwner) {
+    NodeHarness a(makeConfig());
+    ASSERT_TRUE(a.node->start());
+    NodeHarness b(makeConfig({a.node->getNodeId()}));
+    ASSERT_TRUE(b.node->start());
+    ASSERT_TRUE(waitFor([&] {
+        return a.node->getMembers().size() == 2 && b.node->getMembers().size() == 2;
+    }));
+
+    size_t ownedByB = 0;
+    for (int i = 0; i < 40; ++i) {
+        auto config = makeTask("t" + std::to_string(i));
+        std::string owner = a.node->ownerOf(config);
+        EXPECT_EQ(owner, b.node->ownerOf(config));
+        ASSERT_TRUE(a.node->submitTask(config));
+
+        TaskScheduler& expected = (owner == a.node->getNodeId()) ? a.scheduler : b.scheduler;
+        EXPECT_NE(expected.getTask(config.id), nullptr) << config.id;
+        if (owner == b.node->getNodeId()) {
+            ownedByB++;
+        }
+    }
+    EXPECT_GT(ownedByB, 0u);
+    EXPECT_LT(ownedByB, 40u);
+    EXPECT_EQ(a.node->getStats().forwardedTasks, ownedByB);
+    EXPECT_EQ(b.node->getStats().receivedTasks, ownedByB);
+
+    // 相同 partitionKey 的任务落在同一节点
+    std::string groupOwner;
+    for (int i = 0; i < 8; ++i) {
+        auto config = makeTask("g" + std::to_string(i));
+        config.parameters["partitionKey"] = "dag-7";
+        if (groupOwner.empty()) {
+            groupOwner = a.node->ownerOf(config);
+        }
+        EXPECT_EQ(a.node->ownerOf(config), groupOwner);
+    }
+}
+
+TEST_F(ClusterNodeTest, IdleNodeStealsReadyTasks) {
+    NodeHarness busy(makeConfig());
+    ASSERT_TRUE(busy.node->start());
+    NodeHarness idle(makeConfig({busy.node->getNodeId()}));
+    idle.addAgent("idle-agent");
+
+    // 被依赖的任务不可迁移，其余任务可被窃取
+    auto root = makeTask("root");
+    ASSERT_TRUE(busy.scheduler.scheduleTask(root));
+    auto parent = makeTask("root-missing");
+    ASSERT_TRUE(busy.scheduler.scheduleTask(parent));
+    auto child = makeTask("child");
+    child.dependencies = {"root-missing"};
+    ASSERT_TRUE(busy.scheduler.scheduleTask(child));
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(busy.scheduler.scheduleTask(makeTask("ready" + std::to_string(i))));
+    }
+
+    ASSERT_TRUE(idle.node->start());
+    ASSERT_TRUE(waitFor([&] { return idle.node->getStats().stolenTasks > 0; }));
+
+    // 空闲节点只有一个智能体，窃取一个任务后不再有空闲容量
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(idle.node->getStats().stolenTasks, 1u);
+    EXPECT_EQ(busy.node->getStats().givenTasks, 1u);
+    EXPECT_EQ(idle.scheduler.getStats().currentPendingCount, 1u);
+    EXPECT_EQ(busy.scheduler.getAllTasks().size(), 10u);
+    EXPECT_NE(busy.scheduler.getTask("root-missing"), nullptr);
+
+    // 已迁出的任务在原节点上未知，之后依赖它的任务被拒绝而不是永远挂起
+    auto stolen = idle.scheduler.getAllTasks();
+    ASSERT_EQ(stolen.size(), 1u);
+    EXPECT_EQ(busy.scheduler.getTask(stolen[0]->getId()), nullptr);
+    auto late = makeTask("late");
+    late.dependencies = {stolen[0]->getId()};
+    EXPECT_FALSE(busy.scheduler.scheduleTask(late));
+}
+
+TEST_F(ClusterNodeTest, RequeuesTasksTheThiefDoesNotAcknowledge) {
+    NodeHarness busy(makeConfig());
+    ASSERT_TRUE(busy.node->start());
+    NodeHarness idle(makeConfig({busy.node->getNodeId()}));
+    idle.addAgent("idle-agent");
+
+    // 窃取方已有同 ID 的任务（已完成），收到后拒绝调度、不确认，原节点放回
+    ASSERT_TRUE(idle.scheduler.scheduleTask(makeTask("ready7")));
+    idle.scheduler.runSchedulingRound();
+    ASSERT_EQ(idle.scheduler.getTaskStatus("ready7"), TaskStatus::COMPLETED);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(busy.scheduler.scheduleTask(makeTask("ready" + std::to_string(i))));
+    }
+
+    ASSERT_TRUE(idle.node->start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    idle.node->stop();
+    EXPECT_EQ(idle.node->getStats().stolenTasks, 0u);
+    EXPECT_EQ(busy.node->getStats().givenTasks, 0u);
+    EXPECT_EQ(busy.scheduler.getAllTasks().size(), 8u);
+    EXPECT_EQ(busy.scheduler.getTaskStatus("ready7"), TaskStatus::PENDING);
+    EXPECT_EQ(busy.scheduler.getStats().currentPendingCount, 8u);
+}
+
+TEST_F(ClusterNodeTest, UnresponsiveSeedsDoNotEvictHealthyMembers) {
+    // 只 listen 不 accept 的地址：连接能建立，请求一直等到 I/O 超时
+    std::vector<int> blackholes;
+    std::vector<std::string> seeds;
+    for (int i = 0; i < 4; ++i) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        ASSERT_EQ(::listen(fd, 64), 0);
+        socklen_t len = sizeof(addr);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        blackholes.push_back(fd);
+        seeds.push_back("127.0.0.1:" + std::to_string(ntohs(addr.sin_port)));
+    }
+
+    NodeHarness a(makeConfig(seeds));
+    ASSERT_TRUE(a.node->start());
+    seeds.push_back(a.node->getNodeId());
+    NodeHarness b(makeConfig(seeds));
+    ASSERT_TRUE(b.node->start());
+    ASSERT_TRUE(waitFor([&] {
+        return a.node->getMembers().size() == 2 && b.node->getMembers().size() == 2;
+    }));
+
+    // 每个失效地址都要等满超时，串行联系时一轮就超过失效时间；健康成员必须一直保留
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(2000);
+    while (std::chrono::steady_clock::now() < deadline) {
+        ASSERT_EQ(a.node->getMembers().size(), 2u);
+        ASSERT_EQ(b.node->getMembers().size(), 2u);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    a.node->stop();
+    b.node->stop();
+    for (int fd : blackholes) {
+        ::close(fd);
+    }
+}
@@ -0,0 +1,24 @@
+#include <gtest/gtest.h>
+#include "common/FileNameEscape.h"
+#include <string>
+#include <vector>
+
+using namespace openclaw;
+
+// 测试转义规则固定（已写入检查点与会话目录的文件名），且转义可逆
+TEST(FileNameEscapeTest, EscapesUnsafeBytesAndRoundTrips) {
+    EXPECT_EQ(escapeFileName("agent-1_v2.final"), "agent-1_v2.final");
+    EXPECT_EQ(escapeFileName("chat/room 1"), "chat%2Froom%201");
+    EXPECT_EQ(escapeFileName("."), "%2E");
+    EXPECT_EQ(escapeFileName(".."), "%2E.");
+    EXPECT_EQ(escapeFileName(".hidden"), "%2Ehidden");
+    EXPECT_EQ(escapeFileName("100%"), "100%25");
+    EXPECT_EQ(escapeFileName(std::string("\xE4\xB8\xAD", 3)), "%E4%B8%AD");
+
+    std::vector<std::string> ids = {"", ".", "..", "a/b\\c", "100%25", "%zz", std::string("\0\xFF", 2)};
+    for (const auto& id : ids) {
+        EXPECT_EQ(unescapeFileName(escapeFileName(id)), id);
+    }
+    EXPECT_EQ(unescapeFileName("%e4%b8%ad"), "\xE4\xB8\xAD");
+    EXPECT_EQ(unescapeFileName("50%"), "50%");
+}
@@ -0,0 +1,16 @@
+#include <gtest/gtest.h>
+#include "common/Fnv1a.h"
+#include <string>
+
+using namespace openclaw;
+
+// 测试散列值固定（写入文件与跨节点分区依赖它），且分段累加与整体计算结果相同
+TEST(Fnv1aTest, StableAndChains) {
+    EXPECT_EQ(fnv1a(std::string_view()), kFnv1aOffsetBasis);
+    EXPECT_EQ(fnv1a(std::string_view("a")), 4953267810257967366ULL);
+    EXPECT_EQ(fnv1a(std::string_view("foobar")), 9870438755804841970ULL);
+
+    std::string whole = "partition-key";
+    EXPECT_EQ(fnv1a(whole), fnv1a(whole.data(), whole.size()));
+    EXPECT_EQ(fnv1a(std::string_view("-key"), fnv1a(std::string_view("partition"))), fnv1a(whole));
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "common/FlatHandleMap.h"
+#include "common/StringInterner.h"
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+using namespace openclaw;
+
+// 测试驻留与还原，以及空字符串映射到无效句柄
+TEST(StringInternerTest, InternFindResolve) {
+    auto& interner = StringInterner::getInstance();
+
+    auto a = interner.intern("interner-test-a");
+    auto b = interner.intern("interner-test-b");
+    EXPECT_NE(a, StringInterner::kInvalidHandle);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(interner.intern("interner-test-a"), a);
+    EXPECT_EQ(interner.find("interner-test-b"), b);
+    EXPECT_EQ(interner.resolve(a), "interner-test-a");
+
+    EXPECT_EQ(interner.find("interner-test-never-interned"), StringInterner::kInvalidHandle);
+    EXPECT_EQ(interner.intern(""), StringInterner::kInvalidHandle);
+    EXPECT_EQ(interner.resolve(StringInterner::kInvalidHandle), "");
+}
+
+// 测试多线程并发驻留同一批字符串得到一致的句柄
+TEST(StringInternerTest, ConcurrentInternIsConsistent) {
+    auto& interner = StringInterner::getInstance();
+    constexpr int kThreads = 4;
+    constexpr int kStrings = 5000;
+
+    std::vector<std::vector<StringInterner::Handle>> results(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&results, &interner, t] {
+            for (int i = 0; i < kStrings; ++i) {
+                int index = (i * 7 + t * 131) % kStrings;
+                results[t].push_back(interner.intern("concurrent-" + std::to_string(index)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < kStrings; ++i) {
+        auto handle = interner.find("concurrent-" + std::to_string(i));
+        ASSERT_NE(handle, StringInterner::kInvalidHandle);
+        EXPECT_EQ(interner.resolve(handle), "concurrent-" + std::to_string(i));
+    }
+    for (int t = 0; t < kThreads; ++t) {
+        for (int i = 0; i < kStrings; ++i) {
+            int index = (i * 7 + t * 131) % kStrings;
+            EXPECT_EQ(results[t][i], interner.find("concurrent-" + std::to_string(index)));
+        }
+    }
+}
+
+// 测试引用计数驻留：最后一个引用释放后槽位回收，旧句柄失效，常驻句柄不受 release 影响
+TEST(StringInternerTest, ReleasesAndReusesSlots) {
+    auto& interner = StringInterner::getInstance();
+    size_t before = interner.size();
+
+    auto a = interner.acquire("interner-refcounted-a");
+    ASSERT_NE(a, StringInterner::kInvalidHandle);
+    EXPECT_EQ(interner.acquire("interner-refcounted-a"), a);
+    EXPECT_EQ(interner.size(), before + 1);
+
+    interner.release(a);
+    EXPECT_EQ(interner.find("interner-refcounted-a"), a);
+    interner.release(a);
+    EXPECT_EQ(interner.find("interner-refcounted-a"), StringInterner::kInvalidHandle);
+    EXPECT_EQ(interner.resolve(a), "");
+    EXPECT_EQ(interner.size(), before);
+
+    // 之后分配的句柄都与旧句柄不同，旧句柄仍然无效
+    auto b = interner.acquire("interner-refcounted-b");
+    EXPECT_NE(b, a);
+    EXPECT_EQ(interner.resolve(b), "interner-refcounted-b");
+    EXPECT_EQ(interner.resolve(a), "");
+    interner.release(a);
+    EXPECT_EQ(interner.resolve(b), "interner-refcounted-b");
+
+    // 转为常驻后不再回收
+    EXPECT_EQ(interner.intern("interner-refcounted-b"), b);
+    interner.release(b);
+    interner.release(b);
+    EXPECT_EQ(interner.find("interner-refcounted-b"), b);
+
+    // 大量短期 ID 进出后驻留数不增长，且远超 256 次回收后旧句柄也不会被重新分配出去
+    for (int i = 0; i < 100000; ++i) {
+        auto transient = interner.acquire("interner-transient-" + std::to_string(i));
+        EXPECT_NE(transient, a);
+        interner.release(transient);
+    }
+    EXPECT_EQ(interner.size(), before + 1);
+    EXPECT_EQ(interner.resolve(a), "");
+}
+
+// 随机插入/删除与 std::unordered_map 对照，覆盖删除时的后移逻辑
+TEST(FlatHandleMapTest, MatchesReferenceMap) {
+    FlatHandleMap<int> map;
+    std::unordered_map<StringInterner::Handle, int> reference;
+    std::mt19937 rng(7);
+
+    for (int i = 0; i < 20000; ++i) {
+        StringInterner::Handle key = 1 + rng() % 2000;
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(map.erase(key), reference.erase(key) > 0);
+        } else {
+            map[key] = i;
+            reference[key] = i;
+        }
+    }
+
+    ASSERT_EQ(map.size(), reference.size());
+    for (const auto& pair : reference) {
+        const int* value = map.find(pair.first);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, pair.second);
+    }
+
+    size_t visited = 0;
+    for (const auto& pair : map) {
+        EXPECT_EQ(reference.at(pair.first), pair.second);
+        visited++;
+    }
+    EXPECT_EQ(visited, reference.size());
+
+    size_t removed = map.eraseIf([](const std::pair<StringInterner::Handle, int>& pair) {
+        return pair.second % 2 == 0;
+    });
+    size_t expectedRemoved = 0;
+    for (const auto& pair : reference) {
+        if (pair.second % 2 == 0) {
+            expectedRemoved++;
+        } else {
+            EXPECT_TRUE(map.contains(pair.first));
+        }
+    }
+    EXPECT_EQ(removed, expectedRemoved);
+    EXPECT_EQ(map.size(), reference.size() - expectedRemoved);
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "common/TokenStream.h"
+#include "communication/MessageSystem.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace openclaw;
+
+// 测试多个读者各自按序读到全部分块，慢读者通过背压限制生产者
+TEST(TokenStreamTest, DeliversToEveryReaderInOrder) {
+    auto stream = TokenStream::create(8);
+    const int chunks = 2000;
+
+    std::vector<std::thread> consumers;
+    std::vector<int> received(3, 0);
+    std::vector<int> mismatches(3, 0);
+    for (int r = 0; r < 3; ++r) {
+        auto reader = std::make_shared<TokenStream::Reader>(stream->subscribe());
+        consumers.emplace_back([reader, r, &received, &mismatches] {
+            std::string chunk;
+            while (reader->next(chunk)) {
+                if (chunk != std::to_string(received[r])) {
+                    mismatches[r]++;
+                }
+                received[r]++;
+                if (r == 0 && received[r] % 100 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < chunks; ++i) {
+        ASSERT_TRUE(stream->write(std::to_string(i)));
+    }
+    stream->finish();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+    for (int r = 0; r < 3; ++r) {
+        EXPECT_EQ(received[r], chunks);
+        EXPECT_EQ(mismatches[r], 0);
+    }
+    EXPECT_TRUE(stream->succeeded());
+    EXPECT_GT(stream->getTimeToFirstChunk().count(), 0);
+    EXPECT_FALSE(stream->write("late"));
+
+    // 没有读者时不阻塞
+    auto unread = TokenStream::create(2);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(unread->write("x"));
+    }
+}
+
+// 测试背压与取消：读者不读时生产者停在环满处，取消会唤醒它
+TEST(TokenStreamTest, BlocksWhenFullAndCancels) {
+    auto stream = TokenStream::create(2);
+    auto reader = stream->subscribe();
+
+    std::atomic<int> written{0};
+    std::thread producer([&] {
+        for (int i = 0; i < 4; ++i) {
+            if (!stream->write("chunk" + std::to_string(i))) {
+                return;
+            }
+            written++;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(written.load(), 2);
+
+    std::string chunk;
+    EXPECT_EQ(reader.next(chunk, std::chrono::milliseconds(100)), StreamStatus::CHUNK);
+    EXPECT_EQ(chunk, "chunk0");
+    for (int i = 0; i < 200 && written.load() < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(written.load(), 3);
+
+    stream->cancel();
+    producer.join();
+    EXPECT_EQ(written.load(), 3);
+    EXPECT_EQ(reader.next(chunk, std::chrono::milliseconds(10)), StreamStatus::FINISHED);
+    EXPECT_FALSE(stream->succeeded());
+
+    // 结束前写入的分块仍可读到，读完后才得到 FINISHED
+    auto finished = TokenStream::create();
+    auto late = finished->subscribe();
+    EXPECT_EQ(late.next(chunk, std::chrono::milliseconds(5)), StreamStatus::TIMEOUT);
+    finished->write("a");
+    finished->finish();
+    EXPECT_EQ(late.next(chunk, std::chrono::milliseconds(5)), StreamStatus::CHUNK);
+    EXPECT_EQ(late.next(chunk, std::chrono::milliseconds(5)), StreamStatus::FINISHED);
+}
+
+// 测试转发到消息系统：订阅者逐块收到 STREAM_CHUNK，最后收到 STREAM_END
+TEST(TokenStreamTest, ForwardsChunksAsMessages) {
+    MessageSystem messages;
+    ASSERT_TRUE(messages.initialize());
+
+    std::mutex mutex;
+    std::condition_variable ended;
+    std::string text;
+    std::string endCorrelation;
+    bool done = false;
+    messages.subscribe(MessageType::STREAM_CHUNK, "downstream", [&](const Message& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        text += message.getContent();
+    });
+    messages.subscribe(MessageType::STREAM_END, "downstream", [&](const Message& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        endCorrelation = message.getHeader().correlationId;
+        done = true;
+        ended.notify_all();
+    });
+
+    auto stream = TokenStream::create();
+    auto reader = stream->subscribe();
+    std::thread producer([&stream] {
+        for (const char* chunk : {"Hello", ", ", "world"}) {
+            stream->write(chunk);
+        }
+        stream->finish();
+    });
+    EXPECT_EQ(messages.forwardStream(reader, "agent-a", "agent-b", "stream-1"), 3u);
+    producer.join();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(ended.wait_for(lock, std::chrono::seconds(2), [&done] { return done; }));
+    EXPECT_EQ(text, "Hello, world");
+    EXPECT_EQ(endCorrelation, "stream-1");
+    lock.unlock();
+    messages.shutdown();
+}
+
+// 测试消息系统未运行时停止转发：关闭读者，生产者不再被背压阻塞
+TEST(TokenStreamTest, StopsForwardingWhenSystemIsDown) {
+    MessageSystem messages;
+    auto stream = TokenStream::create(2);
+    auto reader = stream->subscribe();
+    std::thread producer([&stream] {
+        for (int i = 0; i < 100; ++i) {
+            stream->write("chunk");
+        }
+        stream->finish();
+    });
+    EXPECT_EQ(messages.forwardStream(reader, "agent-a", "agent-b", "stream-2"), 0u);
+    EXPECT_FALSE(reader);
+    producer.join();
+    EXPECT_EQ(stream->getChunkCount(), 100u);
+}
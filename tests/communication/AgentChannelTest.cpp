@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "communication/AgentChannel.h"
+#include "logging/Logger.h"
+#include <thread>
+
+using namespace openclaw;
+
+// 测试允许列表在建立通道时生效，每个有序对只有一条通道
+TEST(AgentChannelTest, EnforcesAllowListAtCreation) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    AgentChannelRegistry registry;
+    registry.setAllowList({"coder", "tester"});
+    EXPECT_EQ(registry.openChannel("coder", "tester"), nullptr);   // 未启用
+
+    registry.setEnabled(true);
+    auto channel = registry.openChannel("coder", "tester", 8);
+    ASSERT_NE(channel, nullptr);
+    EXPECT_EQ(channel->capacity(), 8u);
+    EXPECT_EQ(registry.openChannel("coder", "tester"), channel);
+    EXPECT_NE(registry.openChannel("tester", "coder"), nullptr);
+    EXPECT_EQ(registry.openChannel("coder", "project-manager"), nullptr);
+    EXPECT_EQ(registry.openChannel("coder", "coder"), nullptr);
+    EXPECT_EQ(registry.getChannelCount(), 2u);
+
+    registry.setAllowList({"*"});
+    EXPECT_NE(registry.openChannel("coder", "project-manager"), nullptr);
+
+    EXPECT_EQ(registry.closeChannelsOf("coder"), 3u);
+    EXPECT_TRUE(channel->isClosed());
+    EXPECT_FALSE(channel->send("artifact", makeChannelPayload("late")));
+    EXPECT_EQ(registry.getChannel("coder", "tester"), nullptr);
+}
+
+// 测试交接大负载只传递指针，通道满时发送失败且不丢失负载
+TEST(AgentChannelTest, HandsOffPayloadWithoutCopying) {
+    AgentChannel channel("coder", "tester", 2);
+    ChannelPayload artifact = makeChannelPayload(std::string(8 << 20, 'a'));
+    const char* bytes = artifact->data();
+
+    ASSERT_TRUE(channel.send("artifact", artifact));
+    ASSERT_TRUE(channel.send("note", makeChannelPayload("second")));
+    EXPECT_FALSE(channel.send("overflow", artifact));
+    EXPECT_EQ(artifact.use_count(), 2);   // 调用方与环中各一份
+
+    ChannelMessage message;
+    ASSERT_TRUE(channel.receive(message));
+    EXPECT_EQ(message.topic, "artifact");
+    EXPECT_EQ(message.payload.get(), artifact.get());
+    EXPECT_EQ(message.payload->data(), bytes);
+    ASSERT_TRUE(channel.receive(message));
+    EXPECT_EQ(*message.payload, "second");
+    EXPECT_EQ(artifact.use_count(), 1);   // 取出后环不再持有
+    EXPECT_FALSE(channel.receive(message));
+    EXPECT_FALSE(channel.receive(message, std::chrono::milliseconds(5)));
+}
+
+// 测试跨线程按序收发，接收方阻塞等待
+TEST(AgentChannelTest, DeliversInOrderAcrossThreads) {
+    AgentChannel channel("coder", "tester", 64);
+    const int count = 100000;
+    std::thread producer([&channel] {
+        for (int i = 0; i < count; ++i) {
+            auto payload = makeChannelPayload(std::to_string(i));
+            while (!channel.send("seq", payload)) {
+                std::this_thread::yield();
+            }
+        }
+        channel.close();
+    });
+
+    int expected = 0;
+    ChannelMessage message;
+    while (channel.receive(message, std::chrono::milliseconds(1000))) {
+        ASSERT_EQ(*message.payload, std::to_string(expected));
+        expected++;
+    }
+    producer.join();
+    EXPECT_EQ(expected, count);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "communication/BindingRouter.h"
+#include "config/ConfigManager.h"
+#include "logging/Logger.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+using namespace openclaw;
+
+// 测试精确匹配与通配回退的优先级
+TEST(BindingRouterTest, ResolvesExactThenWildcardBindings) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    BindingRouter router;
+    EXPECT_EQ(router.resolve("telegram", "alice"), "");
+
+    std::vector<Binding> bindings;
+    for (int i = 0; i < 5000; ++i) {
+        bindings.push_back({"whatsapp", "+1555" + std::to_string(i), "agent-" + std::to_string(i % 7)});
+    }
+    bindings.push_back({"telegram", "alice", "coder"});
+    bindings.push_back({"telegram", "*", "support"});
+    bindings.push_back({"*", "ops-bot", "ops"});
+    bindings.push_back({"*", "*", "main"});
+    bindings.push_back({"telegram", "alice", "reviewer"});   // 覆盖先前的绑定
+    router.setBindings(bindings);
+
+    EXPECT_EQ(router.getBindingCount(), 5004u);
+    EXPECT_EQ(router.resolve("whatsapp", "+15554321"), "agent-2");
+    EXPECT_EQ(router.resolve("telegram", "alice"), "reviewer");
+    EXPECT_EQ(router.resolve("telegram", "bob"), "support");
+    EXPECT_EQ(router.resolve("slack", "ops-bot"), "ops");
+    EXPECT_EQ(router.resolve("telegram", "ops-bot"), "support");
+    EXPECT_EQ(router.resolve("slack", "carol"), "main");
+
+    router.setBindings({{"telegram", "alice", "coder"}});
+    std::string agentId;
+    EXPECT_FALSE(router.resolve("slack", "carol", agentId));
+    EXPECT_TRUE(router.resolve("telegram", "alice", agentId));
+    EXPECT_EQ(agentId, "coder");
+}
+
+// 测试配置重新加载时整体替换，读者在替换期间始终读到某个完整版本
+TEST(BindingRouterTest, SwapsTableOnConfigReload) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    std::string path = ::testing::TempDir() + "openclaw-binding-test.json";
+    auto writeConfig = [&path](const std::string& agent) {
+        std::ofstream file(path, std::ios::trunc);
+        file << "{\n  \"binding.discord.guild.42\": \"" << agent << "\",\n  \"binding.*.*\": \"main\",\n}\n";
+    };
+    writeConfig("coder");
+    auto& config = ConfigManager::getInstance();
+    ASSERT_TRUE(config.loadConfig(path));
+
+    BindingRouter router;
+    router.loadConfig();
+    router.watchConfig();
+    EXPECT_EQ(router.resolve("discord", "guild.42"), "coder");
+    EXPECT_EQ(router.resolve("discord", "guild.7"), "main");
+
+    std::atomic<bool> running{true};
+    std::atomic<size_t> unexpected{0};
+    std::thread reader([&] {
+        while (running) {
+            std::string agent = router.resolve("discord", "guild.42");
+            if (agent != "coder" && agent != "tester") {
+                unexpected++;
+            }
+        }
+    });
+    for (int i = 0; i < 50; ++i) {
+        writeConfig(i % 2 == 0 ? "tester" : "coder");
+        ASSERT_TRUE(config.reloadConfig());
+    }
+    running = false;
+    reader.join();
+    EXPECT_EQ(unexpected.load(), 0u);
+    EXPECT_EQ(router.resolve("discord", "guild.42"), "coder");
+
+    router.unwatchConfig();
+    config.clear();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "communication/MentionRouter.h"
+#include "config/ConfigManager.h"
+#include "logging/Logger.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace openclaw;
+
+// 测试匹配：大小写不敏感、重叠模式、标识符边界，按首次提及顺序去重
+TEST(MentionRouterTest, RoutesMessagesToMentionedAgents) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    MentionRouter router;
+    router.setPatterns({
+        {"coder", {"@coder", "@code-bot"}},
+        {"pm", {"@project-manager", "@pm"}},
+        {"project", {"@project"}},
+        {"reviewer", {"@Reviewer"}},
+    });
+    EXPECT_EQ(router.getPatternCount(), 6u);
+
+    EXPECT_EQ(router.route("@PM please ask @coder and @reviewer, then @Coder again"),
+              (std::vector<std::string>{"pm", "coder", "reviewer"}));
+    // "@project" 不应在 "@project-manager" 内部命中
+    EXPECT_EQ(router.route("ping @project-manager"), (std::vector<std::string>{"pm"}));
+    EXPECT_EQ(router.route("ping @project."), (std::vector<std::string>{"project"}));
+    // 紧接标识符字符的不算提及
+    EXPECT_TRUE(router.route("mail me@coder.dev about @coders and @code-bot2").empty());
+    EXPECT_EQ(router.route("请@code-bot看一下"), (std::vector<std::string>{"coder"}));
+
+    auto mentions = router.findMentions("hi @pm, @code-bot");
+    ASSERT_EQ(mentions.size(), 2u);
+    EXPECT_EQ(mentions[0].agentId, "pm");
+    EXPECT_EQ(mentions[0].offset, 3u);
+    EXPECT_EQ(mentions[1].pattern, "@code-bot");
+    EXPECT_EQ(mentions[1].offset, 8u);
+
+    router.setPatterns({});
+    EXPECT_TRUE(router.route("@coder").empty());
+}
+
+// 测试配置重新加载后自动重建自动机
+TEST(MentionRouterTest, RebuildsOnConfigReload) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    std::string path = ::testing::TempDir() + "openclaw-mention-test.json";
+    {
+        std::ofstream file(path);
+        file << "{\n  \"mention_patterns.coder\": \"@coder, @dev\",\n}\n";
+    }
+    auto& config = ConfigManager::getInstance();
+    ASSERT_TRUE(config.loadConfig(path));
+
+    MentionRouter router;
+    router.loadConfig();
+    router.watchConfig();
+    EXPECT_EQ(router.route("@dev ping"), (std::vector<std::string>{"coder"}));
+    uint64_t version = router.getVersion();
+
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "{\n  \"mention_patterns.coder\": \"@coder\",\n  \"mention_patterns.tester\": \"@qa\",\n}\n";
+    }
+    ASSERT_TRUE(config.reloadConfig());
+    EXPECT_GT(router.getVersion(), version);
+    EXPECT_TRUE(router.route("@dev ping").empty());
+    EXPECT_EQ(router.route("@qa and @coder"), (std::vector<std::string>{"tester", "coder"}));
+
+    // 注销后不再跟随配置
+    router.unwatchConfig();
+    version = router.getVersion();
+    ASSERT_TRUE(config.reloadConfig());
+    EXPECT_EQ(router.getVersion(), version);
+
+    config.clear();
+    std::remove(path.c_str());
+}
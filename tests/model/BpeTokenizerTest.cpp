@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "model/BpeTokenizer.h"
+#include "logging/Logger.h"
+#include <cstdio>
+
+using namespace openclaw;
+
+namespace {
+
+const char* kCorpus =
+    "The agent reads the task queue and the scheduler assigns the next task to the agent.\n"
+    "Agents report results back to the scheduler; the scheduler records 128 results per batch.\n"
+    "    indented code: for (int i = 0; i < 1024; ++i) { total += values[i]; }\n"
+    "多语言文本也按字节处理，上下文窗口按词元计数。\n";
+
+std::shared_ptr<BpeTokenizer> trainedTokenizer() {
+    std::string corpus;
+    for (int i = 0; i < 8; ++i) {
+        corpus += kCorpus;
+    }
+    return BpeTokenizer::train(corpus, 400);
+}
+
+std::vector<std::string> chunksOf(const std::string& text) {
+    std::vector<std::pair<size_t, size_t>> chunks;
+    BpeTokenizer::pretokenize(text.data(), text.size(), chunks);
+    std::vector<std::string> result;
+    for (const auto& chunk : chunks) {
+        result.push_back(text.substr(chunk.first, chunk.second - chunk.first));
+    }
+    return result;
+}
+
+} // namespace
+
+// 测试预分词：单个前导空格并入单词，数字至多 3 位，长空白最后一个空格留给后面的单词
+TEST(BpeTokenizerTest, PretokenizesIntoIndependentChunks) {
+    EXPECT_EQ(chunksOf("hello world, 1234567    x\n\né!"),
+              (std::vector<std::string>{"hello", " world", ",", " 123", "456", "7", "   ", " x", "\n\n", "é", "!"}));
+
+    // 超过 16 字节的游程（走 SIMD 路径）与截断
+    std::string longWord(40, 'a');
+    EXPECT_EQ(chunksOf(longWord + " " + longWord), (std::vector<std::string>{longWord, " " + longWord}));
+    std::string huge(BpeTokenizer::kMaxChunk + 10, 'z');
+    auto chunks = chunksOf(huge);
+    ASSERT_EQ(chunks.size(), 2u);
+    EXPECT_EQ(chunks[0].size(), BpeTokenizer::kMaxChunk);
+}
+
+// 测试编码：解码还原原文，训练出的合并确实压缩了文本，词表可保存并重新加载
+TEST(BpeTokenizerTest, EncodesRoundTripsAndReloadsVocabulary) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    auto tokenizer = trainedTokenizer();
+    ASSERT_NE(tokenizer, nullptr);
+    EXPECT_EQ(tokenizer->vocabSize(), 400u);
+
+    std::string text = std::string(kCorpus) + "unseen words: zyzzyva \x01\xff tail";
+    auto tokens = tokenizer->encode(text);
+    EXPECT_EQ(tokenizer->decode(tokens), text);
+    EXPECT_LT(tokens.size(), text.size() / 2);
+    EXPECT_EQ(tokenizer->countTokens(text), tokens.size());
+    EXPECT_EQ(tokenizer->encode(" the").size(), 1u);
+
+    std::string path = ::testing::TempDir() + "openclaw-bpe-test.tiktoken";
+    ASSERT_TRUE(tokenizer->saveToFile(path));
+    auto loaded = BpeTokenizer::loadFromFile(path);
+    std::remove(path.c_str());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->vocabSize(), tokenizer->vocabSize());
+    EXPECT_EQ(loaded->encode(text), tokens);
+
+    // 缺少单字节词元的词表无法加载
+    EXPECT_EQ(BpeTokenizer::fromTokens({"a", "b", "ab"}), nullptr);
+    EXPECT_EQ(BpeTokenizer::loadFromFile(::testing::TempDir() + "missing.tiktoken"), nullptr);
+}
+
+// 测试合并顺序（序号相同时先合并靠左的一对），以及片段缓存不会把一个词表的结果用于另一个词表
+TEST(BpeTokenizerTest, MergesLeftmostFirstAndCachesPerVocabulary) {
+    std::vector<std::string> bytes;
+    for (int b = 0; b < 256; ++b) {
+        bytes.push_back(std::string(1, static_cast<char>(b)));
+    }
+    auto withTokens = [&bytes](std::vector<std::string> extra) {
+        std::vector<std::string> tokens = bytes;
+        tokens.insert(tokens.end(), extra.begin(), extra.end());
+        return BpeTokenizer::fromTokens(tokens);
+    };
+    auto left = withTokens({"aa", "ab"});
+    auto right = withTokens({"bc", "aa"});
+    ASSERT_NE(left, nullptr);
+    ASSERT_NE(right, nullptr);
+
+    EXPECT_EQ(left->encode("aaa"), (std::vector<BpeTokenizer::TokenId>{256, 'a'}));
+    for (int round = 0; round < 2; ++round) {
+        EXPECT_EQ(left->encode("abc"), (std::vector<BpeTokenizer::TokenId>{257, 'c'}));
+        EXPECT_EQ(right->encode("abc"), (std::vector<BpeTokenizer::TokenId>{'a', 256}));
+    }
+}
+
+// 测试增量编码与按预算保留末尾
+TEST(BpeTokenizerTest, IncrementalEncodingMatchesFullEncoding) {
+    auto tokenizer = trainedTokenizer();
+    ASSERT_NE(tokenizer, nullptr);
+
+    std::string text;
+    for (int i = 0; i < 4; ++i) {
+        text += kCorpus;
+    }
+    IncrementalTokenizer incremental(tokenizer);
+    // 以不同步长追加，切分点会落在单词、数字和空白中间
+    size_t offset = 0;
+    for (size_t step = 1; offset < text.size(); step = step % 7 + 1) {
+        incremental.append(text.substr(offset, step));
+        offset += step;
+        ASSERT_EQ(incremental.tokens(), tokenizer->encode(text.substr(0, offset))) << "at " << offset;
+    }
+    EXPECT_EQ(incremental.text(), text);
+
+    std::string tail = tokenizer->keepLastTokens(text, 50);
+    EXPECT_LE(tokenizer->countTokens(tail), 50u);
+    EXPECT_GT(tokenizer->countTokens(tail), 40u);
+    EXPECT_EQ(text.compare(text.size() - tail.size(), tail.size(), tail), 0);
+    EXPECT_EQ(tokenizer->keepLastTokens(text, 1000000), text);
+
+    incremental.clear();
+    EXPECT_EQ(incremental.tokenCount(), 0u);
+}
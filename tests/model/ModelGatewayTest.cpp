@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include "model/ModelGateway.h"
+#include "common/TokenStream.h"
+#include "logging/Logger.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace openclaw;
+
+namespace {
+
+class ModelGatewayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().setConsoleOutputEnabled(false);
+    }
+
+    // 并发执行 count 个请求，prompt(i) 决定每个请求的提示词
+    template <typename PromptFn>
+    std::vector<ModelResponse> runConcurrently(ModelGateway& gateway, size_t count, PromptFn prompt,
+                                               bool subagent = false) {
+        std::vector<ModelResponse> responses(count);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < count; ++i) {
+            threads.emplace_back([&, i] {
+                ModelRequest request;
+                request.model = "mock/test";
+                request.prompt = prompt(i);
+                request.subagent = subagent;
+                responses[i] = gateway.complete(request);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return responses;
+    }
+};
+
+} // namespace
+
+// 测试分层并发限制：主智能体与子智能体各自的额度，以及提供方自身的上限
+TEST_F(ModelGatewayTest, EnforcesLaneAndProviderLimits) {
+    ModelGateway gateway;
+    auto provider = std::make_shared<MockModelProvider>("mock", std::chrono::milliseconds(30));
+    ASSERT_TRUE(gateway.registerProvider(provider));
+    EXPECT_FALSE(gateway.registerProvider(provider));
+
+    auto responses = runConcurrently(gateway, 12, [](size_t i) { return "main " + std::to_string(i); });
+    for (size_t i = 0; i < responses.size(); ++i) {
+        EXPECT_TRUE(responses[i].success);
+        EXPECT_EQ(responses[i].text, "mock:main " + std::to_string(i));
+    }
+    EXPECT_LE(gateway.getStats().peakMainInFlight, 4u);
+    EXPECT_LE(provider->getMaxInFlight(), 4u);
+
+    runConcurrently(gateway, 16, [](size_t i) { return "sub " + std::to_string(i); }, true);
+    EXPECT_LE(gateway.getStats().peakSubagentInFlight, 8u);
+    EXPECT_EQ(provider->getRequestCount(), 28u);
+
+    // 提供方上限更严时以提供方为准
+    ModelGateway limited;
+    auto slow = std::make_shared<MockModelProvider>("mock", std::chrono::milliseconds(20));
+    ASSERT_TRUE(limited.registerProvider(slow, 2));
+    runConcurrently(limited, 8, [](size_t i) { return std::to_string(i); }, true);
+    EXPECT_LE(slow->getMaxInFlight(), 2u);
+
+    // 未知提供方直接失败
+    ModelRequest unknown;
+    unknown.model = "missing/model";
+    EXPECT_FALSE(gateway.complete(unknown).success);
+}
+
+// 测试合并：相同的进行中请求只调用一次提供方
+TEST_F(ModelGatewayTest, CoalescesIdenticalInFlightRequests) {
+    ModelGateway gateway;
+    auto provider = std::make_shared<MockModelProvider>("mock", std::chrono::milliseconds(200));
+    ASSERT_TRUE(gateway.registerProvider(provider));
+
+    auto responses = runConcurrently(gateway, 6, [](size_t) { return std::string("same prompt"); });
+    size_t coalesced = 0;
+    for (const auto& response : responses) {
+        EXPECT_TRUE(response.success);
+        EXPECT_EQ(response.text, "mock:same prompt");
+        coalesced += response.coalesced ? 1 : 0;
+    }
+    EXPECT_EQ(provider->getCallCount(), 1u);
+    EXPECT_EQ(coalesced, 5u);
+    EXPECT_EQ(gateway.getStats().coalesced, 5u);
+
+    // 完成后再发出的相同请求重新调用
+    provider->setLatency(std::chrono::milliseconds(0));
+    ModelRequest request;
+    request.model = "mock/test";
+    request.prompt = "same prompt";
+    EXPECT_FALSE(gateway.complete(request).coalesced);
+    EXPECT_EQ(provider->getCallCount(), 2u);
+
+    // 采样且不可缓存的请求各自调用提供方
+    provider->setLatency(std::chrono::milliseconds(100));
+    request.temperature = 0.7;
+    request.cacheable = false;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> sampledCoalesced{0};
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            if (gateway.complete(request).coalesced) {
+                sampledCoalesced++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(sampledCoalesced, 0u);
+    EXPECT_EQ(provider->getCallCount(), 6u);
+
+    // 键按位编码 temperature，格式化后相同的取值也能区分
+    ModelRequest nearby = request;
+    nearby.temperature = 0.7 + 1e-9;
+    EXPECT_NE(ResponseCache::makeKey(request), ResponseCache::makeKey(nearby));
+}
+
+// 测试微批量：等待提供方额度时排队的请求合并为批次
+TEST_F(ModelGatewayTest, BatchesQueuedRequests) {
+    ModelGateway gateway;
+    ModelGatewayLimits limits;
+    limits.subagentMaxConcurrent = 16;
+    gateway.setLimits(limits);
+    auto provider = std::make_shared<MockModelProvider>("mock", std::chrono::milliseconds(50), 8);
+    ASSERT_TRUE(gateway.registerProvider(provider, 1));
+
+    auto responses = runConcurrently(gateway, 16, [](size_t i) { return "batch " + std::to_string(i); }, true);
+    for (size_t i = 0; i < responses.size(); ++i) {
+        EXPECT_TRUE(responses[i].success);
+        EXPECT_EQ(responses[i].text, "mock:batch " + std::to_string(i));
+    }
+    EXPECT_EQ(provider->getRequestCount(), 16u);
+    EXPECT_LT(provider->getCallCount(), 16u);
+    EXPECT_EQ(provider->getMaxInFlight(), 1u);
+    EXPECT_GT(gateway.getStats().batchedRequests, 0u);
+
+    // 提供方失败时每个请求都得到失败结果
+    provider->setFailing(true);
+    responses = runConcurrently(gateway, 4, [](size_t i) { return "fail " + std::to_string(i); }, true);
+    for (const auto& response : responses) {
+        EXPECT_FALSE(response.success);
+        EXPECT_FALSE(response.error.empty());
+    }
+}
+
+// 测试流式请求：第一个分块在提供方首个词元到达时就可读，不必等整段生成
+TEST_F(ModelGatewayTest, StreamsChunksBeforeCompletion) {
+    ModelGateway gateway;
+    auto provider = std::make_shared<MockModelProvider>("mock", std::chrono::milliseconds(10));
+    provider->setChunkDelay(std::chrono::milliseconds(15));
+    provider->setResponder([](const ModelRequest&) { return std::string("one two three four five six"); });
+    ASSERT_TRUE(gateway.registerProvider(provider));
+
+    ModelRequest request;
+    request.model = "mock/test";
+    request.prompt = "stream";
+    auto stream = TokenStream::create(4);
+    auto reader = stream->subscribe();
+
+    std::chrono::steady_clock::duration firstChunk{};
+    std::string received;
+    std::thread consumer([&] {
+        auto start = std::chrono::steady_clock::now();
+        std::string chunk;
+        while (reader.next(chunk)) {
+            if (received.empty()) {
+                firstChunk = std::chrono::steady_clock::now() - start;
+            }
+            received += chunk;
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    ModelResponse response = gateway.stream(request, stream);
+    auto total = std::chrono::steady_clock::now() - start;
+    stream->finish(response.success, response.error);
+    consumer.join();
+
+    EXPECT_TRUE(response.success);
+    EXPECT_EQ(response.text, "one two three four five six");
+    EXPECT_EQ(received, response.text);
+    EXPECT_EQ(stream->getChunkCount(), 6u);
+    EXPECT_LT(firstChunk, total / 2);
+    EXPECT_EQ(gateway.getStats().streamed, 1u);
+
+    // 取消后提供方停止输出
+    auto cancelled = TokenStream::create();
+    cancelled->cancel();
+    EXPECT_FALSE(gateway.stream(request, cancelled).success);
+}
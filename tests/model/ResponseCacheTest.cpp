@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "model/ModelGateway.h"
+#include "model/ResponseCache.h"
+#include "logging/Logger.h"
+#include <cstdio>
+
+using namespace openclaw;
+
+namespace {
+
+ModelRequest makeRequest(const std::string& prompt, const std::string& agentId = "agent") {
+    ModelRequest request;
+    request.model = "mock/test";
+    request.prompt = prompt;
+    request.agentId = agentId;
+    return request;
+}
+
+ModelResponse makeResponse(const std::string& text) {
+    ModelResponse response;
+    response.success = true;
+    response.text = text;
+    response.inputTokens = 100;
+    response.outputTokens = 50;
+    return response;
+}
+
+} // namespace
+
+// 测试内存层：规范化后的键命中，超出预算时按 LRU 淘汰
+TEST(ResponseCacheTest, NormalizesKeysAndEvictsLeastRecentlyUsed) {
+    ResponseCacheOptions options;
+    options.shards = 1;
+    options.memoryBytes = 2048;
+    ResponseCache cache(options);
+
+    ModelResponse response;
+    EXPECT_FALSE(cache.lookup(makeRequest("hello  world"), response));
+    cache.store(makeRequest("hello  world"), makeResponse("hi"));
+    ASSERT_TRUE(cache.lookup(makeRequest("  hello world\n"), response));
+    EXPECT_TRUE(response.cached);
+    EXPECT_EQ(response.text, "hi");
+    EXPECT_EQ(response.latency.count(), 0);
+
+    // 参数不同不命中
+    ModelRequest other = makeRequest("hello world");
+    other.temperature = 0.7;
+    EXPECT_FALSE(cache.lookup(other, response));
+
+    for (int i = 0; i < 20; ++i) {
+        cache.store(makeRequest("filler " + std::to_string(i)), makeResponse(std::string(200, 'x')));
+    }
+    auto stats = cache.getStats();
+    EXPECT_GT(stats.evictions, 0u);
+    EXPECT_LE(stats.memoryBytes, options.memoryBytes);
+    EXPECT_FALSE(cache.lookup(makeRequest("hello world"), response));
+    EXPECT_TRUE(cache.lookup(makeRequest("filler 19"), response));
+}
+
+// 测试磁盘层：内存淘汰后仍可命中，重新打开文件后保留，写满后覆盖最旧的记录
+TEST(ResponseCacheTest, DiskTierSurvivesReopenAndWrapsAround) {
+    std::string path = ::testing::TempDir() + "openclaw-response-cache-test.bin";
+    std::remove(path.c_str());
+
+    ResponseCacheOptions options;
+    options.memoryBytes = 0;   // 只用磁盘层
+    options.diskPath = path;
+    options.diskBytes = 64 * 1024;
+    {
+        ResponseCache cache(options);
+        cache.store(makeRequest("persisted"), makeResponse("from disk"));
+        ModelResponse response;
+        ASSERT_TRUE(cache.lookup(makeRequest("persisted"), response));
+        EXPECT_EQ(response.inputTokens, 100u);
+        EXPECT_EQ(cache.getStats().diskHits, 1u);
+    }
+    {
+        ResponseCache cache(options);
+        EXPECT_EQ(cache.getStats().diskEntries, 1u);
+        ModelResponse response;
+        ASSERT_TRUE(cache.lookup(makeRequest("persisted"), response));
+        EXPECT_EQ(response.text, "from disk");
+
+        // 写入超过容量的数据后最早的记录被覆盖
+        for (int i = 0; i < 200; ++i) {
+            cache.store(makeRequest("wrap " + std::to_string(i)), makeResponse(std::string(1000, 'y')));
+        }
+        EXPECT_FALSE(cache.lookup(makeRequest("persisted"), response));
+        EXPECT_TRUE(cache.lookup(makeRequest("wrap 199"), response));
+        EXPECT_LT(cache.getStats().diskEntries, 200u);
+
+        cache.clear();
+    }
+    {
+        ResponseCache cache(options);
+        EXPECT_EQ(cache.getStats().diskEntries, 0u);
+    }
+    std::remove(path.c_str());
+}
+
+// 测试网关集成：命中不经过提供方，按智能体统计命中率与节省的费用
+TEST(ResponseCacheTest, GatewayServesHitsAndTracksSavingsPerAgent) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    ModelGateway gateway;
+    auto provider = std::make_shared<MockModelProvider>("mock", std::chrono::milliseconds(20));
+    ModelCost cost;
+    cost.input = 3.0;
+    cost.output = 15.0;
+    cost.cacheRead = 0.3;
+    cost.cacheWrite = 3.75;
+    provider->setCost(cost);
+    ASSERT_TRUE(gateway.registerProvider(provider));
+    auto cache = std::make_shared<ResponseCache>();
+    gateway.setResponseCache(cache);
+
+    ModelRequest request = makeRequest("summarize the design document", "coder");
+    ModelResponse first = gateway.complete(request);
+    ASSERT_TRUE(first.success);
+    EXPECT_FALSE(first.cached);
+    ModelResponse second = gateway.complete(request);
+    EXPECT_TRUE(second.cached);
+    EXPECT_EQ(second.text, first.text);
+    EXPECT_EQ(provider->getCallCount(), 1u);
+    EXPECT_EQ(gateway.getStats().cacheHits, 1u);
+
+    auto stats = cache->getAgentStats("coder");
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_DOUBLE_EQ(stats.hitRatio(), 0.5);
+    EXPECT_EQ(stats.tokensSaved, first.inputTokens + first.outputTokens);
+    double expected = (cost.input * first.inputTokens + cost.output * first.outputTokens -
+                       cost.cacheRead * first.inputTokens) / 1e6;
+    EXPECT_DOUBLE_EQ(stats.costSaved, expected);
+    EXPECT_GT(stats.cacheWriteCost, 0.0);
+    EXPECT_EQ(cache->getAgentStats("tester").hits, 0u);
+
+    // 不可缓存的请求总是调用提供方
+    request.cacheable = false;
+    EXPECT_FALSE(gateway.complete(request).cached);
+    EXPECT_EQ(provider->getCallCount(), 2u);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "model/ModelGateway.h"
+#include "model/SessionHistory.h"
+#include "logging/Logger.h"
+
+using namespace openclaw;
+
+namespace {
+
+// 每个字节一个词元，便于预期词元数
+std::shared_ptr<BpeTokenizer> byteTokenizer() {
+    std::vector<std::string> tokens;
+    for (int b = 0; b < 256; ++b) {
+        tokens.emplace_back(1, static_cast<char>(b));
+    }
+    return BpeTokenizer::fromTokens(tokens);
+}
+
+CompactionOptions smallWindow() {
+    CompactionOptions options;
+    options.contextWindow = 4000;
+    options.chunkTokens = 500;
+    options.keepRecentTokens = 1000;
+    options.summaryTokens = 40;
+    return options;
+}
+
+} // namespace
+
+// 测试增量压缩：超过阈值后逐块摘要，每块原文只交给摘要函数一次，最近原文保留
+TEST(SessionHistoryTest, CompactsOldestChunksIncrementally) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    size_t calls = 0;
+    SessionHistory history(byteTokenizer(), smallWindow(), [&calls](const std::string&, size_t) {
+        calls++;
+        return std::string("earlier turns discussed the build");
+    });
+
+    std::string message(90, 'm');
+    for (int i = 0; i < 200; ++i) {
+        history.append(i % 2 == 0 ? "user" : "assistant", message + std::to_string(i));
+        EXPECT_LE(history.tokenCount(), 3200u) << "after message " << i;
+    }
+
+    auto stats = history.getStats();
+    EXPECT_GT(stats.compactedChunks, 0u);
+    EXPECT_EQ(stats.failures, 0u);
+    // 交给摘要函数的字节数与追加的内容同一量级，而不是随历史长度平方增长
+    EXPECT_LT(stats.summarizedBytes, stats.appendedTokens);
+    EXPECT_EQ(calls, stats.compactedChunks + stats.summaryMerges);
+
+    std::string context = history.render();
+    EXPECT_EQ(context.size(), history.tokenCount());
+    EXPECT_NE(context.find("[summary] earlier turns discussed the build\n"), std::string::npos);
+    EXPECT_NE(context.find("assistant: " + message + "199\n"), std::string::npos);
+    EXPECT_NE(context.find("user: " + message + "196\n"), std::string::npos);
+}
+
+// 测试摘要过长时回退为截断，摘要堆积时合并最早的两段；mode 为 off 时不压缩
+TEST(SessionHistoryTest, MergesSummariesAndHonorsModeOff) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    CompactionOptions options = smallWindow();
+    options.keepRecentTokens = 0;
+    options.summaryTokens = 400;
+    SessionHistory history(byteTokenizer(), options, [](const std::string& text, size_t) {
+        return text.size() > 700 ? std::string(2000, 'x') : text.substr(0, 300);
+    });
+    for (int i = 0; i < 100; ++i) {
+        history.append("tool", std::string(240, 'a' + i % 26));
+    }
+    auto stats = history.getStats();
+    EXPECT_GT(stats.summaryMerges, 0u);
+    EXPECT_GT(stats.failures, 0u);
+    EXPECT_LE(history.tokenCount(), 3200u);
+
+    options.mode = "off";
+    SessionHistory raw(byteTokenizer(), options);
+    for (int i = 0; i < 100; ++i) {
+        raw.append("tool", std::string(240, 'a'));
+    }
+    EXPECT_EQ(raw.getStats().compactedChunks, 0u);
+    EXPECT_EQ(raw.tokenCount(), raw.getStats().appendedTokens);
+    EXPECT_EQ(raw.render().size(), raw.tokenCount());
+}
+
+// 测试经模型网关生成摘要
+TEST(SessionHistoryTest, SummarizesThroughGateway) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    ModelGateway gateway;
+    auto provider = std::make_shared<MockModelProvider>("mock");
+    provider->setResponder([](const ModelRequest& request) {
+        return "summary of " + std::to_string(request.prompt.size()) + " bytes";
+    });
+    ASSERT_TRUE(gateway.registerProvider(provider));
+
+    SessionHistory history(byteTokenizer(), smallWindow(), makeGatewaySummarizer("mock/small", "coder", gateway));
+    for (int i = 0; i < 60; ++i) {
+        history.append("user", std::string(100, 'q'));
+    }
+    EXPECT_GT(provider->getCallCount(), 0u);
+    EXPECT_NE(history.render().find("[summary] summary of "), std::string::npos);
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "model/SessionStore.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace openclaw;
+
+namespace {
+
+std::string makeStoreDir(const std::string& name) {
+    std::string dir = ::testing::TempDir() + name;
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+SessionStoreOptions smallSegments() {
+    SessionStoreOptions options;
+    options.segmentBytes = 4096;
+    options.indexStride = 8;
+    return options;
+}
+
+} // namespace
+
+TEST(SessionStoreTest, ReadsAcrossSegmentsAndReopens) {
+    std::string dir = makeStoreDir("session_store_reopen");
+    {
+        SessionStore store(dir, smallSegments());
+        for (int i = 0; i < 500; ++i) {
+            EXPECT_EQ(store.append("chat/room 1", i % 2 ? "assistant" : "user", "message " + std::to_string(i)),
+                      static_cast<uint64_t>(i));
+        }
+        // 未落盘的追加也能读到
+        auto last = store.readLast("chat/room 1", 3);
+        ASSERT_EQ(last.size(), 3u);
+        EXPECT_EQ(last[0].index, 497u);
+        EXPECT_EQ(last[2].text, "message 499");
+        EXPECT_EQ(last[2].role, "assistant");
+        EXPECT_EQ(store.getTurnCount("missing"), 0u);
+        EXPECT_TRUE(store.readLast("missing", 5).empty());
+    }
+
+    size_t segments = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        segments += entry.path().extension() == ".seg";
+    }
+    EXPECT_GT(segments, 3u);
+
+    SessionStore store(dir, smallSegments());
+    EXPECT_EQ(store.listSessions(), std::vector<std::string>{"chat/room 1"});
+    EXPECT_EQ(store.getTurnCount("chat/room 1"), 500u);
+
+    // 跨越多个段的区间
+    auto range = store.read("chat/room 1", 95, 250);
+    ASSERT_EQ(range.size(), 250u);
+    for (size_t i = 0; i < range.size(); ++i) {
+        EXPECT_EQ(range[i].index, 95 + i);
+        EXPECT_EQ(range[i].text, "message " + std::to_string(95 + i));
+    }
+    EXPECT_GT(range[0].timestamp, 0);
+    EXPECT_EQ(store.read("chat/room 1", 498, 10).size(), 2u);
+
+    EXPECT_EQ(store.append("chat/room 1", "user", "after reopen"), 500u);
+    EXPECT_EQ(store.readLast("chat/room 1", 1)[0].text, "after reopen");
+}
+
+TEST(SessionStoreTest, TruncatesTornTail) {
+    std::string dir = makeStoreDir("session_store_torn");
+    {
+        SessionStore store(dir);
+        for (int i = 0; i < 10; ++i) {
+            store.append("s", "user", "turn " + std::to_string(i));
+        }
+    }
+
+    // 模拟崩溃：在段尾追加半条记录
+    std::string segment;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if (entry.path().extension() == ".seg") {
+            segment = entry.path().string();
+        }
+    }
+    ASSERT_FALSE(segment.empty());
+    auto intact = std::filesystem::file_size(segment);
+    {
+        std::ofstream file(segment, std::ios::binary | std::ios::app);
+        file.write("\x40\x00\x00\x00partial", 11);
+    }
+
+    SessionStore store(dir);
+    EXPECT_EQ(store.getTurnCount("s"), 10u);
+    EXPECT_EQ(store.getStats().truncatedBytes, 11u);
+    EXPECT_EQ(std::filesystem::file_size(segment), intact);
+    EXPECT_EQ(store.append("s", "user", "turn 10", true), 10u);
+    auto last = store.readLast("s", 2);
+    ASSERT_EQ(last.size(), 2u);
+    EXPECT_EQ(last[0].text, "turn 9");
+    EXPECT_EQ(last[1].text, "turn 10");
+}
+
+TEST(SessionStoreTest, SyncAppendsShareCommits) {
+    std::string dir = makeStoreDir("session_store_group");
+    SessionStoreOptions options;
+    options.commitInterval = std::chrono::milliseconds(20);
+    SessionStore store(dir, options);
+
+    const int threads = 8;
+    const int perThread = 25;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&store, t] {
+            for (int i = 0; i < perThread; ++i) {
+                EXPECT_NE(store.append("session-" + std::to_string(t % 2), "user", "x", true), UINT64_MAX);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    auto stats = store.getStats();
+    EXPECT_EQ(stats.appendedTurns, static_cast<size_t>(threads * perThread));
+    EXPECT_LT(stats.commits, stats.appendedTurns);
+    EXPECT_EQ(store.getTurnCount("session-0") + store.getTurnCount("session-1"),
+              static_cast<uint64_t>(threads * perThread));
+}
+
+TEST(SessionStoreTest, ClosesLeastRecentlyUsedSessions) {
+    std::string dir = makeStoreDir("session_store_evict");
+    SessionStoreOptions options;
+    options.maxOpenSessions = 2;
+    SessionStore store(dir, options);
+
+    for (int i = 0; i < 6; ++i) {
+        std::string id = "evict-" + std::to_string(i);
+        EXPECT_EQ(store.append(id, "user", "first", true), 0u);
+        EXPECT_EQ(store.append(id, "user", "second"), 1u);
+    }
+    store.flush();
+    EXPECT_EQ(store.append("evict-5", "user", "third", true), 2u);
+
+    // 超出上限的已落盘会话被关闭，最近使用的保持打开
+    auto stats = store.getStats();
+    EXPECT_LE(stats.openSessions, 2u);
+    EXPECT_GE(stats.evictedSessions, 4u);
+
+    // 关闭的会话再次访问时从文件恢复，继续追加序号
+    auto turns = store.read("evict-0", 0, 10);
+    ASSERT_EQ(turns.size(), 2u);
+    EXPECT_EQ(turns[1].text, "second");
+    EXPECT_EQ(store.append("evict-0", "user", "third", true), 2u);
+    EXPECT_EQ(store.readLast("evict-0", 1)[0].text, "third");
+}
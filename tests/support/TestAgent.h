@@ -0,0 +1,20 @@
+#pragma once
+
+#include "agent/Agent.h"
+
+namespace openclaw {
+
+// 测试与基准共用的智能体：生命周期沿用 Agent 的默认实现，任务直接成功返回。
+// 需要特定执行行为时派生并覆盖 executeTask / submitTask；没有内部状态，允许休眠
+class TestAgent : public Agent {
+public:
+    explicit TestAgent(const AgentConfig& config) : Agent(config) {}
+
+    std::shared_ptr<TaskResult> executeTask(const Task& /*task*/) override {
+        return std::make_shared<TaskResult>(true);
+    }
+
+    bool supportsHibernation() const override { return true; }
+};
+
+} // namespace openclaw
@@ -0,0 +1,518 @@
+#include <gtest/gtest.h>
+#include "task/TaskScheduler.h"
+#include "agent/LazyAgent.h"
+#include "logging/Logger.h"
+#include "../support/TestAgent.h"
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+using namespace openclaw;
+
+namespace {
+
+// 测试用智能体：同步执行，可按任务ID配置失败
+class RecordingAgent : public TestAgent {
+public:
+    using TestAgent::TestAgent;
+    
+    std::shared_ptr<TaskResult> executeTask(const Task& task) override {
+        executed.push_back(task.getId());
+        return std::make_shared<TaskResult>(task.getConfig().parameters.count("fail") == 0);
+    }
+    
+    std::vector<std::string> executed;
+};
+
+// 测试用智能体：保存完成回调，由测试决定何时完成
+class HoldingAgent : public TestAgent {
+public:
+    using TestAgent::TestAgent;
+    
+    void submitTask(const std::shared_ptr<Task>& task, TaskCompletion done) override {
+        pending[task->getId()] = std::move(done);
+    }
+    
+    void complete(const std::string& taskId) {
+        auto done = std::move(pending.at(taskId));
+        pending.erase(taskId);
+        done(std::make_shared<TaskResult>(true));
+    }
+    
+    std::unordered_map<std::string, TaskCompletion> pending;
+};
+
+// 测试用智能体：邮箱有两个工作线程，可同时持有两个任务
+class PairAgent : public HoldingAgent {
+public:
+    using HoldingAgent::HoldingAgent;
+    
+    size_t getConcurrency() const override { return 2; }
+    size_t getQueueDepth() const override { return pending.size(); }
+};
+
+// 测试用智能体：可设置邮箱积压深度
+class DepthAgent : public TestAgent {
+public:
+    using TestAgent::TestAgent;
+    
+    size_t getQueueDepth() const override { return depth; }
+    
+    size_t depth{0};
+};
+
+TaskConfig makeTask(const std::string& id, TaskPriority priority = TaskPriority::MEDIUM) {
+    TaskConfig config;
+    config.id = id;
+    config.name = id;
+    config.type = TaskType::DEVELOPMENT;
+    config.priority = priority;
+    return config;
+}
+
+class TaskSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().setConsoleOutputEnabled(false);
+        AgentFactory::getInstance().registerAgent(AgentType::DEVELOPER,
+            [](const AgentConfig& config) { return std::make_shared<RecordingAgent>(config); });
+        
+        AgentConfig config;
+        config.id = "dev-1";
+        config.name = "Developer";
+        config.type = AgentType::DEVELOPER;
+        agent_ = std::static_pointer_cast<RecordingAgent>(manager_.createAgent(config));
+        agent_->start();
+    }
+    
+    void TearDown() override {
+        Logger::getInstance().setConsoleOutputEnabled(true);
+    }
+    
+    AgentManager manager_;
+    std::shared_ptr<RecordingAgent> agent_;
+};
+
+} // namespace
+
+// 测试任务队列按优先级出队，同优先级先入先出
+TEST(TaskQueueTest, PriorityThenFifoOrder) {
+    TaskQueue queue(10);
+    queue.push(std::make_shared<Task>(makeTask("low", TaskPriority::LOW)));
+    queue.push(std::make_shared<Task>(makeTask("first", TaskPriority::HIGH)));
+    queue.push(std::make_shared<Task>(makeTask("second", TaskPriority::HIGH)));
+    queue.push(std::make_shared<Task>(makeTask("critical", TaskPriority::CRITICAL)));
+    
+    auto top = queue.getTopTasks(3);
+    ASSERT_EQ(top.size(), 3u);
+    EXPECT_EQ(top[0]->getId(), "critical");
+    EXPECT_EQ(top[1]->getId(), "first");
+    EXPECT_EQ(top[2]->getId(), "second");
+    
+    EXPECT_TRUE(queue.remove("first"));
+    EXPECT_EQ(queue.size(), 3u);
+    EXPECT_EQ(queue.pop()->getId(), "critical");
+    EXPECT_EQ(queue.pop()->getId(), "second");
+    EXPECT_EQ(queue.pop()->getId(), "low");
+    EXPECT_EQ(queue.pop(), nullptr);
+}
+
+// 测试依赖任务在前置任务完成后才执行
+TEST_F(TaskSchedulerTest, DependenciesReleaseInOrder) {
+    TaskScheduler scheduler(manager_);
+    
+    auto child = makeTask("child", TaskPriority::CRITICAL);
+    child.dependencies = {"parent"};
+    EXPECT_TRUE(scheduler.scheduleTask(makeTask("parent", TaskPriority::LOW)));
+    EXPECT_TRUE(scheduler.scheduleTask(child));
+    
+    scheduler.runSchedulingRound();
+    scheduler.runSchedulingRound();
+    
+    ASSERT_EQ(agent_->executed.size(), 2u);
+    EXPECT_EQ(agent_->executed[0], "parent");
+    EXPECT_EQ(agent_->executed[1], "child");
+    EXPECT_EQ(scheduler.getTaskStatus("child"), TaskStatus::COMPLETED);
+    EXPECT_EQ(scheduler.getStats().totalTasksCompleted, 2u);
+}
+
+// 测试休眠的延迟智能体同样参与调度，收到任务时自动恢复
+TEST_F(TaskSchedulerTest, DispatchesToHibernatedLazyAgent) {
+    agent_->stop();
+    AgentConfig config;
+    config.id = "lazy-dev";
+    config.name = "Lazy developer";
+    config.type = AgentType::DEVELOPER;
+    config.lazy = true;
+    auto lazy = std::dynamic_pointer_cast<LazyAgent>(manager_.createAgent(config));
+    ASSERT_TRUE(lazy);
+    lazy->start();
+    EXPECT_EQ(lazy->getStatus(), AgentStatus::HIBERNATED);
+    
+    TaskScheduler scheduler(manager_);
+    EXPECT_EQ(scheduler.getAvailableAgentCount(), 1u);
+    EXPECT_TRUE(scheduler.scheduleTask(makeTask("wake")));
+    scheduler.runSchedulingRound();
+    
+    EXPECT_EQ(scheduler.getTaskStatus("wake"), TaskStatus::COMPLETED);
+    EXPECT_TRUE(lazy->isMaterialized());
+    EXPECT_EQ(lazy->getStatus(), AgentStatus::RUNNING);
+    EXPECT_TRUE(agent_->executed.empty());
+}
+
+// 测试任务只派发给具备对应能力的智能体
+TEST_F(TaskSchedulerTest, RoutesTasksByCapability) {
+    AgentConfig config;
+    config.id = "dev-tester";
+    config.name = "Tester";
+    config.type = AgentType::DEVELOPER;
+    config.capabilities = {TaskType::TESTING};
+    auto tester = std::static_pointer_cast<RecordingAgent>(manager_.createAgent(config));
+    tester->start();
+    
+    TaskScheduler scheduler(manager_);
+    auto testing = makeTask("test-a");
+    testing.type = TaskType::TESTING;
+    EXPECT_TRUE(scheduler.scheduleTask(makeTask("develop", TaskPriority::HIGH)));
+    EXPECT_TRUE(scheduler.scheduleTask(testing));
+    
+    // 开发任务优先级更高，但只有 dev-1 能执行；测试任务随后分给专职智能体
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(agent_->executed, std::vector<std::string>{"develop"});
+    EXPECT_EQ(tester->executed, std::vector<std::string>{"test-a"});
+    
+    // 专职智能体不接收开发任务，即使 dev-1 不可用
+    agent_->stop();
+    EXPECT_TRUE(scheduler.scheduleTask(makeTask("develop-2")));
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("develop-2"), TaskStatus::PENDING);
+    EXPECT_EQ(tester->executed.size(), 1u);
+}
+
+// 测试失败任务按 maxRetries 重试，最终失败时取消依赖它的任务
+TEST_F(TaskSchedulerTest, RetriesThenCancelsDependents) {
+    TaskScheduler scheduler(manager_);
+    
+    auto failing = makeTask("failing");
+    failing.parameters["fail"] = "1";
+    failing.maxRetries = 2;
+    auto dependent = makeTask("dependent");
+    dependent.dependencies = {"failing"};
+    
+    EXPECT_TRUE(scheduler.scheduleTask(failing));
+    EXPECT_TRUE(scheduler.scheduleTask(dependent));
+    
+    for (int i = 0; i < 5; ++i) {
+        scheduler.runSchedulingRound();
+    }
+    
+    EXPECT_EQ(agent_->executed.size(), 3u);
+    EXPECT_EQ(scheduler.getTaskStatus("failing"), TaskStatus::FAILED);
+    EXPECT_EQ(scheduler.getTaskStatus("dependent"), TaskStatus::CANCELLED);
+    
+    auto stats = scheduler.getStats();
+    EXPECT_EQ(stats.totalTasksFailed, 1u);
+    EXPECT_EQ(stats.totalTasksCancelled, 1u);
+    EXPECT_EQ(scheduler.cleanupFinishedTasks(), 2u);
+    
+    // 清理后任务 ID 不再驻留
+    EXPECT_EQ(StringInterner::getInstance().find("dependent"), StringInterner::kInvalidHandle);
+}
+
+// 测试依赖自身、未知任务或未成功完成的任务时拒绝调度，失败沿依赖链逐级取消
+TEST_F(TaskSchedulerTest, RejectsUnsatisfiableDependencies) {
+    TaskScheduler scheduler(manager_);
+    
+    auto self = makeTask("self");
+    self.dependencies = {"self"};
+    EXPECT_FALSE(scheduler.scheduleTask(self));
+    auto orphan = makeTask("orphan");
+    orphan.dependencies = {"never-scheduled"};
+    EXPECT_FALSE(scheduler.scheduleTask(orphan));
+    EXPECT_EQ(scheduler.getTask("self"), nullptr);
+    EXPECT_EQ(scheduler.getTask("orphan"), nullptr);
+    
+    // a <- b <- c：a 最终失败时 b、c 都被取消
+    auto a = makeTask("a");
+    a.parameters["fail"] = "1";
+    a.maxRetries = 0;
+    auto b = makeTask("b");
+    b.dependencies = {"a"};
+    auto c = makeTask("c");
+    c.dependencies = {"b", "a"};
+    EXPECT_TRUE(scheduler.scheduleTask(a));
+    EXPECT_TRUE(scheduler.scheduleTask(b));
+    EXPECT_TRUE(scheduler.scheduleTask(c));
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("a"), TaskStatus::FAILED);
+    EXPECT_EQ(scheduler.getTaskStatus("b"), TaskStatus::CANCELLED);
+    EXPECT_EQ(scheduler.getTaskStatus("c"), TaskStatus::CANCELLED);
+    EXPECT_EQ(scheduler.getStats().totalTasksCancelled, 2u);
+    
+    // 之后提交的任务依赖失败或已取消的任务时直接拒绝
+    auto late = makeTask("late");
+    late.dependencies = {"a"};
+    EXPECT_FALSE(scheduler.scheduleTask(late));
+    late.dependencies = {"c"};
+    EXPECT_FALSE(scheduler.scheduleTask(late));
+    
+    // 已完成的依赖视为满足；清理后无法判断结果，拒绝
+    EXPECT_TRUE(scheduler.scheduleTask(makeTask("done")));
+    scheduler.runSchedulingRound();
+    late.dependencies = {"done"};
+    EXPECT_TRUE(scheduler.scheduleTask(late));
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("late"), TaskStatus::COMPLETED);
+    EXPECT_EQ(scheduler.cleanupFinishedTasks(), 5u);
+    auto afterCleanup = makeTask("after-cleanup");
+    afterCleanup.dependencies = {"done"};
+    EXPECT_FALSE(scheduler.scheduleTask(afterCleanup));
+}
+
+// 测试组任务整组预留，以及等待期间短任务的回填
+TEST(GangSchedulingTest, ReservesWholeGangAndBackfills) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    AgentFactory::getInstance().registerAgent(AgentType::TESTER,
+        [](const AgentConfig& config) { return std::make_shared<HoldingAgent>(config); });
+    
+    AgentManager manager;
+    std::vector<std::shared_ptr<HoldingAgent>> agents;
+    for (int i = 0; i < 2; ++i) {
+        AgentConfig config;
+        config.id = "tester-" + std::to_string(i);
+        config.name = config.id;
+        config.type = AgentType::TESTER;
+        agents.push_back(std::static_pointer_cast<HoldingAgent>(manager.createAgent(config)));
+        agents.back()->start();
+    }
+    auto ownerOf = [&agents](const std::string& taskId) -> std::shared_ptr<HoldingAgent> {
+        for (auto& agent : agents) {
+            if (agent->pending.count(taskId)) {
+                return agent;
+            }
+        }
+        return nullptr;
+    };
+    
+    TaskScheduler scheduler(manager);
+    EXPECT_TRUE(scheduler.scheduleTask(makeTask("running")));
+    scheduler.runSchedulingRound();
+    ASSERT_NE(ownerOf("running"), nullptr);
+    
+    // 组任务需要 2 个智能体，当前只有 1 个空闲，必须等待
+    auto gang = makeTask("gang", TaskPriority::CRITICAL);
+    gang.resourceRequirements.cpuCores = 2;
+    auto longTask = makeTask("long", TaskPriority::LOW);
+    longTask.timeoutSeconds = 3600;
+    auto shortTask = makeTask("short", TaskPriority::LOW);
+    shortTask.timeoutSeconds = 1;
+    EXPECT_TRUE(scheduler.scheduleTask(gang));
+    EXPECT_TRUE(scheduler.scheduleTask(longTask));
+    EXPECT_TRUE(scheduler.scheduleTask(shortTask));
+    
+    // 长任务会推迟组任务，不允许回填；短任务在预留时刻前结束，可以回填
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("gang"), TaskStatus::PENDING);
+    EXPECT_EQ(scheduler.getTaskStatus("long"), TaskStatus::PENDING);
+    EXPECT_EQ(scheduler.getTaskStatus("short"), TaskStatus::RUNNING);
+    
+    ownerOf("running")->complete("running");
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("gang"), TaskStatus::PENDING);
+    
+    ownerOf("short")->complete("short");
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("gang"), TaskStatus::RUNNING);
+    EXPECT_EQ(scheduler.getReservedAgents("gang").size(), 2u);
+    EXPECT_EQ(scheduler.getTaskStatus("long"), TaskStatus::PENDING);
+    
+    ownerOf("gang")->complete("gang");
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("gang"), TaskStatus::COMPLETED);
+    EXPECT_EQ(scheduler.getTaskStatus("long"), TaskStatus::RUNNING);
+    EXPECT_TRUE(scheduler.getReservedAgents("gang").empty());
+    
+    Logger::getInstance().setConsoleOutputEnabled(true);
+}
+
+// 测试比全部智能体还宽的组任务在提交时被拒绝，大批等待中的组任务不会饿死低优先级任务
+TEST(GangSchedulingTest, RejectsOversizeGangsAndSkipsBlockedGangs) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    AgentFactory::getInstance().registerAgent(AgentType::TESTER,
+        [](const AgentConfig& config) { return std::make_shared<HoldingAgent>(config); });
+    
+    AgentManager manager;
+    for (int i = 0; i < 2; ++i) {
+        AgentConfig config;
+        config.id = "wide-tester-" + std::to_string(i);
+        config.name = config.id;
+        config.type = AgentType::TESTER;
+        manager.createAgent(config)->start();
+    }
+    
+    TaskScheduler scheduler(manager);
+    auto oversize = makeTask("oversize");
+    oversize.resourceRequirements.cpuCores = 3;
+    EXPECT_FALSE(scheduler.scheduleTask(oversize));
+    
+    EXPECT_TRUE(scheduler.scheduleTask(makeTask("running")));
+    scheduler.runSchedulingRound();
+    ASSERT_EQ(scheduler.getTaskStatus("running"), TaskStatus::RUNNING);
+    
+    // 只剩 1 个空闲智能体，排在前面的组任务都无法启动，且数量超过回填窗口
+    for (int i = 0; i < 40; ++i) {
+        auto gang = makeTask("blocked-gang-" + std::to_string(i), TaskPriority::CRITICAL);
+        gang.resourceRequirements.cpuCores = 2;
+        EXPECT_TRUE(scheduler.scheduleTask(gang));
+    }
+    auto shortTask = makeTask("short", TaskPriority::LOW);
+    shortTask.timeoutSeconds = 1;
+    EXPECT_TRUE(scheduler.scheduleTask(shortTask));
+    
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("short"), TaskStatus::RUNNING);
+    EXPECT_EQ(scheduler.getTaskStatus("blocked-gang-0"), TaskStatus::PENDING);
+    
+    Logger::getInstance().setConsoleOutputEnabled(true);
+}
+
+// 测试快照恢复后队列顺序、依赖关系与统计保持一致
+TEST_F(TaskSchedulerTest, SnapshotRestoresQueueDependenciesAndStats) {
+    const std::string path = "scheduler_snapshot_test.bin";
+    
+    {
+        TaskScheduler scheduler(manager_);
+        EXPECT_TRUE(scheduler.scheduleTask(makeTask("done")));
+        scheduler.runSchedulingRound();
+        
+        auto child = makeTask("child", TaskPriority::CRITICAL);
+        child.dependencies = {"parent"};
+        child.parameters["partitionKey"] = "dag";
+        EXPECT_TRUE(scheduler.scheduleTask(makeTask("parent", TaskPriority::LOW)));
+        EXPECT_TRUE(scheduler.scheduleTask(child));
+        EXPECT_TRUE(scheduler.scheduleTask(makeTask("urgent", TaskPriority::HIGH)));
+        EXPECT_TRUE(scheduler.scheduleTask(makeTask("later", TaskPriority::HIGH)));
+        ASSERT_TRUE(scheduler.snapshot(path));
+    }
+    
+    agent_->executed.clear();
+    TaskScheduler restored(manager_);
+    ASSERT_TRUE(restored.restore(path));
+    EXPECT_FALSE(restored.restore(path));   // 非空调度器不允许再次恢复
+    std::remove(path.c_str());
+    
+    EXPECT_EQ(restored.getAllTasks().size(), 5u);
+    EXPECT_EQ(restored.getTaskStatus("done"), TaskStatus::COMPLETED);
+    EXPECT_EQ(restored.getTask("child")->getConfig().parameters.at("partitionKey"), "dag");
+    EXPECT_EQ(restored.getTasksByAgent("dev-1").size(), 1u);
+    
+    auto stats = restored.getStats();
+    EXPECT_EQ(stats.totalTasksScheduled, 5u);
+    EXPECT_EQ(stats.totalTasksCompleted, 1u);
+    EXPECT_EQ(stats.currentPendingCount, 3u);
+    
+    for (int i = 0; i < 4; ++i) {
+        restored.runSchedulingRound();
+    }
+    ASSERT_EQ(agent_->executed.size(), 4u);
+    EXPECT_EQ(agent_->executed[0], "urgent");
+    EXPECT_EQ(agent_->executed[1], "later");
+    EXPECT_EQ(agent_->executed[2], "parent");
+    EXPECT_EQ(agent_->executed[3], "child");
+}
+
+// 测试损坏的快照被拒绝
+TEST_F(TaskSchedulerTest, RejectsCorruptedSnapshot) {
+    const std::string path = "scheduler_snapshot_corrupt.bin";
+    
+    {
+        TaskScheduler scheduler(manager_);
+        EXPECT_TRUE(scheduler.scheduleTask(makeTask("a")));
+        ASSERT_TRUE(scheduler.snapshot(path));
+    }
+    
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(12);
+        file.put('\x7f');
+    }
+    
+    TaskScheduler restored(manager_);
+    EXPECT_FALSE(restored.restore(path));
+    EXPECT_FALSE(restored.restore("missing_snapshot.bin"));
+    EXPECT_TRUE(restored.getAllTasks().empty());
+    std::remove(path.c_str());
+}
+
+// 测试最短队列优先策略选择积压最少的智能体
+TEST(ExecutionStrategyTest, ShortestQueuePicksLeastLoadedAgent) {
+    std::vector<std::shared_ptr<DepthAgent>> agents;
+    for (int i = 0; i < 3; ++i) {
+        AgentConfig config;
+        config.id = "jsq-" + std::to_string(i);
+        config.name = config.id;
+        config.type = AgentType::DEVELOPER;
+        agents.push_back(std::make_shared<DepthAgent>(config));
+    }
+    agents[0]->depth = 4;
+    agents[1]->depth = 1;
+    agents[2]->depth = 3;
+    std::vector<Agent::Ptr> available(agents.begin(), agents.end());
+    
+    ShortestQueueExecutionStrategy strategy;
+    auto task = std::make_shared<Task>(makeTask("jsq-task"));
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(strategy.selectAgentForTask(task, available), agents[1]);
+    }
+    
+    // 积压相同时轮流分配
+    for (auto& agent : agents) {
+        agent->depth = 0;
+    }
+    std::set<Agent::Ptr> chosen;
+    for (int i = 0; i < 3; ++i) {
+        chosen.insert(strategy.selectAgentForTask(task, available));
+    }
+    EXPECT_EQ(chosen.size(), 3u);
+    EXPECT_EQ(strategy.selectAgentForTask(task, {}), nullptr);
+}
+
+// 测试调度器按智能体并发数派发，最短队列策略把新任务分给积压较少的智能体
+TEST(ExecutionStrategyTest, DispatchesUpToAgentConcurrency) {
+    Logger::getInstance().setConsoleOutputEnabled(false);
+    AgentFactory::getInstance().registerAgent(AgentType::ARCHITECT,
+        [](const AgentConfig& config) { return std::make_shared<PairAgent>(config); });
+    
+    AgentManager manager;
+    std::vector<std::shared_ptr<PairAgent>> agents;
+    for (int i = 0; i < 2; ++i) {
+        AgentConfig config;
+        config.id = "pair-" + std::to_string(i);
+        config.name = config.id;
+        config.type = AgentType::ARCHITECT;
+        agents.push_back(std::static_pointer_cast<PairAgent>(manager.createAgent(config)));
+        agents.back()->start();
+    }
+    
+    TaskScheduler scheduler(manager);
+    scheduler.setExecutionStrategy(std::make_unique<ShortestQueueExecutionStrategy>());
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(scheduler.scheduleTask(makeTask("pair-task-" + std::to_string(i))));
+    }
+    
+    // 两个智能体各有两个槽位，一轮派发 4 个任务，第 5 个等待
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(agents[0]->pending.size(), 2u);
+    EXPECT_EQ(agents[1]->pending.size(), 2u);
+    EXPECT_EQ(scheduler.getTaskStatus("pair-task-4"), TaskStatus::PENDING);
+    EXPECT_EQ(scheduler.getAvailableAgentCount(), 0u);
+    
+    // pair-0 完成一个任务后空出槽位，等待的任务分给它
+    agents[0]->complete(agents[0]->pending.begin()->first);
+    scheduler.runSchedulingRound();
+    EXPECT_EQ(scheduler.getTaskStatus("pair-task-4"), TaskStatus::RUNNING);
+    EXPECT_EQ(agents[0]->pending.count("pair-task-4"), 1u);
+    EXPECT_EQ(agents[1]->pending.size(), 2u);
+    
+    Logger::getInstance().setConsoleOutputEnabled(true);
+}